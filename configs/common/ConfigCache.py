@@ -0,0 +1,112 @@
+# Cache of resolved configurations for --config-cache. The first run with
+# a given command line copies its config.ini into the cache directory, and
+# later runs with the same command line build their system from that file
+# with m5.instantiateFromIni() instead of constructing the Python object
+# graph. This needs a gem5 built with --with-cxx-config.
+#
+# The key covers the script and its arguments, every configuration script,
+# the gem5 binary and the environment variables that select the GCPT
+# restorer and the reference model. The checkpoint file given to
+# --generic-rv-cpt is not part of the key, it is set on the cached
+# configuration instead, so sampling jobs over the checkpoints of one
+# configuration share a single entry.
+
+import glob
+import hashlib
+import os
+import shutil
+import sys
+
+import m5
+from m5.util import warn
+
+# Options whose value does not change the configuration, or that is
+# applied on top of the cached one
+_UNKEYED_VALUES = ['--generic-rv-cpt', '--config-cache']
+_ENV_PREFIXES = ('GCB', 'NEMU')
+
+_key = None
+
+def _script_args():
+    args = []
+    skip = False
+    for arg in sys.argv:
+        if skip:
+            skip = False
+            continue
+        name = arg.split('=', 1)[0]
+        if name in _UNKEYED_VALUES:
+            args.append(name)
+            skip = '=' not in arg
+            continue
+        args.append(arg)
+    return args
+
+def _cache_key():
+    global _key
+    if _key:
+        return _key
+
+    h = hashlib.sha1()
+    for arg in _script_args():
+        h.update(arg.encode() + b'\0')
+    for name in sorted(os.environ):
+        if name.startswith(_ENV_PREFIXES):
+            h.update(('%s=%s\0' % (name, os.environ[name])).encode())
+
+    exe = os.path.realpath('/proc/self/exe')
+    st = os.stat(exe)
+    h.update(('%s %d %d\0' % (exe, st.st_size, st.st_mtime_ns)).encode())
+
+    configs = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    for path in sorted(glob.glob(os.path.join(configs, '**', '*.py'),
+                                 recursive=True)):
+        with open(path, 'rb') as f:
+            h.update(f.read())
+
+    _key = h.hexdigest()
+    return _key
+
+def _entry(options):
+    return os.path.join(options.config_cache, _cache_key() + '.ini')
+
+def lookup(options):
+    """Return the cached config.ini for this command line, or None."""
+    if not options.config_cache:
+        return None
+    unsupported = [opt for opt, on in [
+        ('--take-checkpoints', options.take_checkpoints),
+        ('--enable-arch-db', options.enable_arch_db),
+        ('--stats-root', options.stats_root)] if on]
+    if unsupported:
+        warn("--config-cache does not support %s, building the "
+             "configuration in Python", ', '.join(unsupported))
+        return None
+    path = _entry(options)
+    return path if os.path.exists(path) else None
+
+def store(options):
+    """Copy the config.ini written by m5.instantiate() into the cache."""
+    if not options.config_cache:
+        return
+    if not m5.options.dump_config:
+        warn("--config-cache needs --dump-config, not caching")
+        return
+    os.makedirs(options.config_cache, exist_ok=True)
+    dst = _entry(options)
+    # Jobs started together may store the same entry
+    tmp = '%s.%d' % (dst, os.getpid())
+    shutil.copyfile(os.path.join(m5.options.outdir, m5.options.dump_config),
+                    tmp)
+    os.replace(tmp, dst)
+
+def instantiate(options, ini_file):
+    """Instantiate the cached ini_file with the checkpoint of this run."""
+    print("Instantiating cached configuration", ini_file)
+    if m5.options.dump_config:
+        shutil.copyfile(ini_file,
+            os.path.join(m5.options.outdir, m5.options.dump_config))
+    overrides = []
+    if getattr(options, 'generic_rv_cpt', None):
+        overrides.append(('system', 'gcpt_file', options.generic_rv_cpt))
+    m5.instantiateFromIni(ini_file, overrides)
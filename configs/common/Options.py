@@ -219,6 +219,44 @@ def addNoISAOptions(parser, configure_xiangshan=False):
                         default=False,
                         help="enable rolling perfcnt "
                         "(note that rolling is dependent on archdb)")
+    parser.add_argument("--arch-db-inst-window", action="store", type=str,
+                        default=None, metavar="BEGIN:END",
+                        help="Record arch database rows between these "
+                        "committed instruction counts, END may be empty")
+    parser.add_argument("--arch-db-pc-range", action="store", type=str,
+                        default=None, metavar="LOW:HIGH",
+                        help="Record arch database rows after an "
+                        "instruction in [LOW, HIGH) commits")
+    parser.add_argument("--arch-db-pc-insts", action="store", type=int,
+                        default=100000,
+                        help="Instructions recorded after a "
+                        "--arch-db-pc-range hit")
+    parser.add_argument("--arch-db-mpki-above", action="store", type=float,
+                        default=0,
+                        help="Record arch database rows while L1 MPKI is "
+                        "above this")
+    parser.add_argument("--arch-db-ipc-below", action="store", type=float,
+                        default=0,
+                        help="Record arch database rows while IPC is "
+                        "below this")
+    parser.add_argument("--arch-db-trigger-interval", action="store",
+                        type=int, default=100000,
+                        help="Interval of the MPKI and IPC triggers")
+    parser.add_argument("--arch-db-work-items", action="store_true",
+                        help="Record arch database rows between m5 "
+                        "workbegin and workend")
+    parser.add_argument("--arch-db-max-windows", action="store", type=int,
+                        default=0,
+                        help="Stop recording after this many windows")
+    parser.add_argument("--lifetime-sample-period", action="store",
+                        type=int, default=0,
+                        help="Record the pipeline lifetime of 1 in this "
+                        "many instructions into <cpu>.lifetime.db, "
+                        "without --enable-arch-db")
+    parser.add_argument("--lifetime-sample-burst", action="store", type=int,
+                        default=1,
+                        help="Consecutive instructions recorded per "
+                        "lifetime sample")
 
     parser.add_argument("--memchecker", action="store_true")
 
@@ -337,6 +375,19 @@ def addCommonOptions(parser, configure_xiangshan=False):
     parser.add_argument("--warmup-insts-no-switch", action="store", type=int,
         default=20*10**6,
         help="Warmup period in total instructions, reset stats without switch")
+    parser.add_argument("--warm-cache-record", action="store_true",
+        help="Record the contents of every classic cache at the end of "
+        "warmup into <cache path>.warm in the output directory")
+    parser.add_argument("--warm-cache-replay", action="store", type=str,
+        default=None,
+        help="Output directory of a --warm-cache-record run whose cache "
+        "contents are loaded before simulating")
+    parser.add_argument("--config-cache", action="store", type=str,
+        default=None,
+        help="Directory of configurations resolved by earlier runs. Runs "
+        "with the same command line and any --generic-rv-cpt instantiate "
+        "the cached config.ini without building the configuration in "
+        "Python (needs a gem5 built with --with-cxx-config)")
 
     parser.add_argument(
         "--stats-root", action="append", default=[],
@@ -483,6 +534,16 @@ def addCommonOptions(parser, configure_xiangshan=False):
         help="switch from timing to Detailed CPU after warmup period of <N>")
     parser.add_argument("-p", "--prog-interval", type=str,
                         help="CPU Progress Interval")
+    parser.add_argument("--metrics-port", action="store", type=int,
+                        default=0,
+                        help="Serve live metrics as JSON on this local "
+                        "port, needs --listener-mode=on in batch runs")
+    parser.add_argument("--metrics-socket", action="store", type=str,
+                        help="Serve live metrics as JSON on this "
+                        "UNIX-domain socket in the output directory")
+    parser.add_argument("--metrics-stats", action="store", type=str,
+                        help="Comma separated statistics to add to the "
+                        "live metrics, e.g. system.cpu.ipc")
 
     # Fastforwarding and simpoint related materials
     parser.add_argument(
@@ -659,7 +720,18 @@ def addXiangshanFSOptions(parser):
                         action="store_true",
                         help="use NEMU as ref to do difftest")
 
+    parser.add_argument("--disable-difftest",
+                        action="store_true",
+                        help="run without NEMU in configurations that "
+                        "enable difftest by default")
+
     parser.add_argument("--difftest-ref-so",
                         action="store",
                         default=None,
                         help="The shared lib file used to do difftest")
+
+    parser.add_argument("--diff-store-commit-batch",
+                        action="store", type=int, default=0,
+                        help="Check committed stores against the ref in "
+                        "batches of this size, needs a ref built with store "
+                        "commit support")
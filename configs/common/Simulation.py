@@ -37,10 +37,12 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+import os
 import sys
 from os import getcwd
 from os.path import join as joinpath
 
+from common import ConfigCache
 from common import CpuConfig
 from common import ObjectList
 
@@ -115,6 +117,48 @@ def setWorkCountOptions(system, options):
     if options.work_cpus_checkpoint_count != None:
         system.work_cpus_ckpt_count = options.work_cpus_checkpoint_count
 
+def setWarmCacheTraces(options, testsys):
+    if not options.warm_cache_record and not options.warm_cache_replay:
+        return
+    for obj in testsys.descendants():
+        if not isinstance(obj, BaseCache):
+            continue
+        trace = obj.path() + ".warm"
+        if options.warm_cache_record:
+            obj.warm_trace_out = trace
+        if options.warm_cache_replay:
+            path = joinpath(options.warm_cache_replay, trace)
+            if os.path.exists(path):
+                obj.warm_trace_in = path
+            else:
+                warn("No warm trace for %s in %s", obj.path(),
+                     options.warm_cache_replay)
+
+def setMetricsServer(options, testsys):
+    if not options.metrics_port and not options.metrics_socket:
+        return
+    testsys.metrics_server = MetricsServer(
+        port=options.metrics_port,
+        path=options.metrics_socket or "",
+        stats=options.metrics_stats.split(',') if options.metrics_stats
+        else [])
+
+def setArchDBTriggers(options, arch_db):
+    if options.arch_db_inst_window:
+        begin, end = options.arch_db_inst_window.split(':')
+        arch_db.trigger_inst_begin = int(begin or 0)
+        arch_db.trigger_inst_end = int(end or 0)
+    if options.arch_db_pc_range:
+        low, high = options.arch_db_pc_range.split(':')
+        arch_db.trigger_pc_low = int(low, 0)
+        arch_db.trigger_pc_high = int(high, 0)
+        arch_db.trigger_pc_insts = options.arch_db_pc_insts
+    arch_db.trigger_mpki = options.arch_db_mpki_above
+    arch_db.trigger_ipc = options.arch_db_ipc_below
+    arch_db.trigger_interval = options.arch_db_trigger_interval
+    arch_db.trigger_work_items = options.arch_db_work_items
+    arch_db.trigger_max_windows = options.arch_db_max_windows
+
 def findCptDir(options, cptdir, testsys):
     """Figures out the directory from which the checkpointed state is read.
 
@@ -648,6 +692,8 @@ def run(options, root, testsys, cpu_class):
     checkpoint_dir = None
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
+    setWarmCacheTraces(options, testsys)
+    setMetricsServer(options, testsys)
     root.apply_config(options.param)
     m5.instantiate(checkpoint_dir)
 
@@ -820,9 +866,20 @@ def run_vanilla(options, root, testsys, cpu_class):
             testsys.cpu[i].warmupInstCount = options.warmup_insts_no_switch
 
     checkpoint_dir = None
+    setWarmCacheTraces(options, testsys)
+    setMetricsServer(options, testsys)
     root.apply_config(options.param)
     m5.instantiate(checkpoint_dir)
+    ConfigCache.store(options)
+
+    simulate_vanilla(options, testsys)
 
+def run_from_config_cache(options, ini_file):
+    """run_vanilla() for a configuration found by ConfigCache.lookup()"""
+    ConfigCache.instantiate(options, ini_file)
+    simulate_vanilla(options, None)
+
+def simulate_vanilla(options, testsys):
     # Handle the max tick settings now that tick frequency was resolved
     # during system instantiation
     # NOTE: the maxtick variable here is in absolute ticks, so it must
@@ -854,3 +911,74 @@ def run_vanilla(options, root, testsys, cpu_class):
 
     if exit_event.getCode() != 0:
         print("Simulated exit code not 0! Exit code is", exit_event.getCode())
+
+def run_sweep(options, root, testsys, sweep):
+    """Restore once and fork one child per configuration of a sweep.
+
+    sweep is a list of (name, cpus) pairs, cpus being switched out CPUs,
+    one per testsys.cpu. The parent restores the checkpoint, optionally
+    runs options.sweep_warmup_insts instructions on testsys.cpu, and then
+    forks up to options.sweep_jobs children at a time. Each child switches
+    to its own cpus and writes its output to <outdir>/<name>, while the
+    memory restored by the parent stays shared copy-on-write.
+    """
+    import os
+
+    for name, cpus in sweep:
+        for cpu in cpus:
+            if options.warmup_insts_no_switch != None:
+                cpu.warmupInstCount = options.warmup_insts_no_switch
+            if options.maxinsts:
+                cpu.max_insts_any_thread = options.maxinsts
+
+    # Listeners can not be forked
+    m5.disableAllListeners()
+    root.apply_config(options.param)
+    m5.instantiate()
+
+    if options.sweep_warmup_insts:
+        cause = "sweep warmup done"
+        testsys.cpu[0].scheduleInstStop(0, options.sweep_warmup_insts, cause)
+        exit_event = m5.simulate()
+        if exit_event.getCause() != cause:
+            fatal("Shared warmup ended @ tick %i because %s",
+                  m5.curTick(), exit_event.getCause())
+        print("Shared warmup done @ tick %i" % m5.curTick())
+
+    running = {}
+    failed = []
+
+    def reap():
+        pid, status = os.wait()
+        name = running.pop(pid)
+        if os.WIFSIGNALED(status):
+            failed.append(name)
+            print("Sweep configuration %s killed by signal %d" %
+                  (name, os.WTERMSIG(status)))
+            return
+        code = os.WEXITSTATUS(status)
+        if code != 0:
+            failed.append(name)
+        print("Sweep configuration %s finished with status %d" %
+              (name, code))
+
+    for name, cpus in sweep:
+        while len(running) >= options.sweep_jobs:
+            reap()
+        pid = m5.fork(joinpath("%(parent)s", name))
+        if pid == 0:
+            m5.switchCpus(testsys, list(zip(testsys.cpu, cpus)))
+            m5.stats.reset()
+            print("**** REAL SIMULATION (%s) ****" % name)
+            exit_event = benchCheckpoints(testsys, options, m5.MaxTick,
+                                          cptdir=None)
+            print('Exiting @ tick %i because %s' %
+                  (m5.curTick(), exit_event.getCause()))
+            sys.exit(exit_event.getCode())
+        running[pid] = name
+
+    while running:
+        reap()
+
+    if failed:
+        fatal("Sweep configurations failed: %s", ", ".join(failed))
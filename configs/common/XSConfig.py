@@ -130,3 +130,5 @@ def config_difftest(cpu_list, args, sys):
             # cpu_list[0].enable_mem_dedup = True
             cpu_list[0].enable_difftest = True
             cpu_list[0].difftest_ref_so = args.difftest_ref_so
+    for cpu in cpu_list:
+        cpu.diff_store_commit_batch = args.diff_store_commit_batch
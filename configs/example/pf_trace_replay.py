@@ -0,0 +1,51 @@
+# Replay a prefetcher training trace, recorded with the train_trace
+# parameter of a prefetcher, on a queued prefetcher without any CPU or
+# cache. Coverage and accuracy are reported in stats.txt, e.g.
+#
+#   gem5.opt configs/example/pf_trace_replay.py \
+#       --trace m5out/l1d.pf.trace --prefetcher BertiPrefetcher \
+#       --param history_table_entries=64
+#
+# XSStridePrefetcher, BertiPrefetcher and BOPPrefetcher are trained the way
+# XSCompositePrefetcher trains them; CDP cannot be replayed.
+
+import argparse
+
+import m5
+from m5.objects import *
+
+parser = argparse.ArgumentParser(
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+parser.add_argument("--trace", required=True,
+                    help="Training trace to replay")
+parser.add_argument("--prefetcher", default="BertiPrefetcher",
+                    help="QueuedPrefetcher class to replay on")
+parser.add_argument("--param", action="append", default=[],
+                    metavar="NAME=VALUE",
+                    help="Set a prefetcher parameter (repeatable)")
+parser.add_argument("--window-lines", type=int, default=4096,
+                    help="Prefetched lines remembered for the metrics")
+parser.add_argument("--clock", default="3GHz",
+                    help="Clock of the prefetcher")
+args = parser.parse_args()
+
+prefetcher = getattr(m5.objects, args.prefetcher)()
+for assignment in args.param:
+    name, value = assignment.split("=", 1)
+    setattr(prefetcher, name, value)
+
+system = System()
+system.clk_domain = SrcClockDomain(clock=args.clock,
+                                   voltage_domain=VoltageDomain())
+system.prefetcher = prefetcher
+system.replayer = PrefetchTraceReplayer(trace=args.trace,
+                                        prefetcher=prefetcher,
+                                        window_lines=args.window_lines)
+
+root = Root(full_system=False, system=system)
+m5.instantiate()
+
+# Records are replayed at their recorded ticks
+exit_event = m5.simulate()
+print('Replayed', args.trace, 'on', args.prefetcher, 'because',
+      exit_event.getCause())
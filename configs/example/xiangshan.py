@@ -16,6 +16,7 @@ from common.SysPaths import *
 from common.Benchmarks import *
 from common import Simulation
 from common import CacheConfig
+from common import ConfigCache
 from common import CpuConfig
 from common import MemConfig
 from common import ObjectList
@@ -61,6 +62,48 @@ class XiangshanECore2Read(XiangshanCore):
     numPhysRMiscRegs = 40
     scheduler = ECore2ReadScheduler()
 
+def config_mmu(cpu, args):
+    cpu.mmu.pma_checker = PMAChecker(
+        uncacheable=[AddrRange(0, size=0x80000000)])
+    cpu.mmu.functional = args.functional_tlb
+    cpu.mmu.enable_sv48 = args.open_sv48
+
+def config_branch_predictor(cpu, args):
+    if args.bp_type is None or args.bp_type == 'DecoupledBPUWithFTB' or args.bp_type == 'DecoupledBPUWithBTB':
+        enable_bp_db = len(args.enable_bp_db) > 1
+        if enable_bp_db:
+            bp_db_switches = args.enable_bp_db[1] + ['basic']
+            print("BP db switches:", bp_db_switches)
+        else:
+            bp_db_switches = []
+        # for DecoupledBPUWithBTB, loop predictor and jump ahead predictor are not supported
+        #if args.bp_type == 'DecoupledBPUWithBTB':
+        if args.enable_loop_predictor or args.enable_loop_buffer:
+            print("loop predictor and loop buffer not supported for DecoupledBPUWithBTB")
+            args.enable_loop_predictor = False
+            args.enable_loop_buffer = False
+        if args.enable_jump_ahead_predictor:
+            print("jump ahead predictor not supported for DecoupledBPUWithBTB")
+            args.enable_jump_ahead_predictor = False
+
+        BPClass = DecoupledBPUWithBTB() if args.bp_type == 'DecoupledBPUWithBTB' else DecoupledBPUWithFTB()
+        cpu.branchPred = BPClass(
+                                bpDBSwitches=bp_db_switches,
+                                enableLoopBuffer=args.enable_loop_buffer,
+                                enableLoopPredictor=args.enable_loop_predictor,
+                                enableJumpAheadPredictor=args.enable_jump_ahead_predictor
+                                )
+        cpu.branchPred.tage.enableSC = not args.disable_sc
+        cpu.branchPred.isDumpMisspredPC = True
+    else:
+        cpu.branchPred = ObjectList.bp_list.get(args.bp_type)
+
+    if args.indirect_bp_type:
+        IndirectBPClass = ObjectList.indirect_bp_list.get(
+            args.indirect_bp_type)
+        cpu.branchPred.indirectBranchPred = \
+            IndirectBPClass()
+
 def build_test_system(np, args):
     assert buildEnv['TARGET_ISA'] == "riscv"
 
@@ -104,10 +147,7 @@ def build_test_system(np, args):
     test_sys.cpu = [TestCPUClass(clk_domain=test_sys.cpu_clk_domain, cpu_id=i)
                     for i in range(np)]
     for cpu in test_sys.cpu:
-        cpu.mmu.pma_checker = PMAChecker(
-            uncacheable=[AddrRange(0, size=0x80000000)])
-        cpu.mmu.functional = args.functional_tlb
-        cpu.mmu.enable_sv48 = args.open_sv48
+        config_mmu(cpu, args)
 
     # configure BP
     args.enable_loop_predictor = True
@@ -117,41 +157,7 @@ def build_test_system(np, args):
     for i in range(np):
         if args.kmh_align:
             test_sys.cpu[i].enable_storeSet_train = False
-
-        if args.bp_type is None or args.bp_type == 'DecoupledBPUWithFTB' or args.bp_type == 'DecoupledBPUWithBTB':
-            enable_bp_db = len(args.enable_bp_db) > 1
-            if enable_bp_db:
-                bp_db_switches = args.enable_bp_db[1] + ['basic']
-                print("BP db switches:", bp_db_switches)
-            else:
-                bp_db_switches = []
-            # for DecoupledBPUWithBTB, loop predictor and jump ahead predictor are not supported
-            #if args.bp_type == 'DecoupledBPUWithBTB':
-            if args.enable_loop_predictor or args.enable_loop_buffer:
-                print("loop predictor and loop buffer not supported for DecoupledBPUWithBTB")
-                args.enable_loop_predictor = False
-                args.enable_loop_buffer = False
-            if args.enable_jump_ahead_predictor:
-                print("jump ahead predictor not supported for DecoupledBPUWithBTB")
-                args.enable_jump_ahead_predictor = False
-
-            BPClass = DecoupledBPUWithBTB() if args.bp_type == 'DecoupledBPUWithBTB' else DecoupledBPUWithFTB()
-            test_sys.cpu[i].branchPred = BPClass(
-                                            bpDBSwitches=bp_db_switches,
-                                            enableLoopBuffer=args.enable_loop_buffer,
-                                            enableLoopPredictor=args.enable_loop_predictor,
-                                            enableJumpAheadPredictor=args.enable_jump_ahead_predictor
-                                            )
-            test_sys.cpu[i].branchPred.tage.enableSC = not args.disable_sc
-            test_sys.cpu[i].branchPred.isDumpMisspredPC = True
-        else:
-            test_sys.cpu[i].branchPred = ObjectList.bp_list.get(args.bp_type)
-
-        if args.indirect_bp_type:
-            IndirectBPClass = ObjectList.indirect_bp_list.get(
-                args.indirect_bp_type)
-            test_sys.cpu[i].branchPred.indirectBranchPred = \
-                    IndirectBPClass()
+        config_branch_predictor(test_sys.cpu[i], args)
 
     # configure memory related
     if args.mem_type == 'DRAMsim3':
@@ -232,6 +238,13 @@ def build_test_system(np, args):
         for cpu in test_sys.cpu:
             cpu.enable_riscv_vector = True
 
+    if args.lifetime_sample_period:
+        for cpu in test_sys.cpu:
+            if not isinstance(cpu, BaseO3CPU):
+                fatal("--lifetime-sample-period needs an O3 CPU")
+            cpu.lifetime_sample_period = args.lifetime_sample_period
+            cpu.lifetime_sample_burst = args.lifetime_sample_burst
+
     # config arch db
     if args.enable_arch_db:
         perfCCT_cmd = "CREATE TABLE LifeTimeCommitTrace(ID INTEGER PRIMARY KEY AUTOINCREMENT,"
@@ -245,6 +258,7 @@ def build_test_system(np, args):
         test_sys.arch_db = ArchDBer(arch_db_file=args.arch_db_file)
         test_sys.arch_db.dump_from_start = args.arch_db_fromstart
         test_sys.arch_db.enable_rolling = args.enable_rolling
+        Simulation.setArchDBTriggers(args, test_sys.arch_db)
         test_sys.arch_db.dump_l1_pf_trace = False
         test_sys.arch_db.dump_mem_trace = False
         test_sys.arch_db.dump_l1_evict_trace = False
@@ -436,20 +450,31 @@ if __name__ == '__m5_main__':
         FutureClass = None
 
     args.xiangshan_system = True
-    args.enable_difftest = True
+    args.enable_difftest = not args.disable_difftest
     args.enable_riscv_vector = True
 
     assert not args.external_memory_system
 
-    # Match the memories with the CPUs, based on the options for the test system
-    TestMemClass = Simulation.setMemClass(args)
+    cached_config = ConfigCache.lookup(args)
+    if cached_config:
+        Simulation.run_from_config_cache(args, cached_config)
+    else:
+        # Match the memories with the CPUs, based on the options for the test system
+        TestMemClass = Simulation.setMemClass(args)
+
+        test_sys = build_test_system(args.num_cpus, args)
 
-    test_sys = build_test_system(args.num_cpus, args)
+        # Set ideal parameters here with the highest priority, over command-line arguments
+        if args.ideal_kmhv3:
+            setKmhV3IdealParams(args, test_sys)
 
-    # Set ideal parameters here with the highest priority, over command-line arguments
-    if args.ideal_kmhv3:
-        setKmhV3IdealParams(args, test_sys)
+        root = Root(full_system=True, system=test_sys)
 
-    root = Root(full_system=True, system=test_sys)
+        if args.ruby and args.ruby_partition_mode == "parallel":
+            # Ruby synchronises its partitions itself, the generic quantum
+            # only bounds other events crossing event queues
+            root.sim_quantum = m5.ticks.fromSeconds(
+                test_sys.ruby._partition_quantum_cycles /
+                m5.util.convert.toFrequency(args.ruby_clock))
 
-    Simulation.run_vanilla(args, root, test_sys, FutureClass)
+        Simulation.run_vanilla(args, root, test_sys, FutureClass)
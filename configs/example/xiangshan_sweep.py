@@ -0,0 +1,139 @@
+# Sweep several core configurations over one checkpoint. The checkpoint is
+# restored once and optionally warmed up on the default core, then one
+# child is forked per configuration. Each child switches to its own core,
+# built with that configuration's overrides, and writes its output to
+# <outdir>/<name>. The restored memory is shared copy-on-write.
+#
+# Each line of the sweep file names a configuration, followed by
+# parameter overrides relative to the core, '#' starts a comment. Values
+# are converted by the parameter type, vectors are comma-separated:
+#
+#   base
+#   rob256      numROBEntries=256
+#   tage4way    branchPred.tage.numWays=4
+#   tage1k      branchPred.tage.tableSizes=1024,1024,1024,1024
+#
+#   gem5.opt configs/example/xiangshan_sweep.py --generic-rv-cpt=<gcpt> \
+#       --sweep sweep.txt --sweep-jobs 8 --sweep-warmup-insts 50000000 \
+#       --warmup-insts-no-switch 20000000 --maxinsts 40000000
+#
+# Only the core can differ between configurations: caches, memory and the
+# rest of the system are built once before the fork. The swept cores start
+# from the default core class without difftest, --ideal-kmhv3 only applies
+# to the core used for the shared warmup.
+
+import argparse
+import sys
+
+import m5
+from m5.defines import buildEnv
+from m5.objects import *
+from m5.util import addToPath, fatal, warn
+
+addToPath('../')
+
+from common import Simulation
+from common import Options
+from example.xiangshan import *
+
+def parse_sweep(path):
+    sweep = []
+    with open(path) as f:
+        for line in f:
+            fields = line.split('#', 1)[0].split()
+            if not fields:
+                continue
+            overrides = [field.split('=', 1) for field in fields[1:]]
+            for override in overrides:
+                if len(override) != 2:
+                    fatal("Bad override '%s' in sweep configuration %s",
+                          override[0], fields[0])
+            sweep.append((fields[0], overrides))
+
+    names = [name for name, _ in sweep]
+    if not names:
+        fatal("No configuration in sweep file %s", path)
+    if len(set(names)) != len(names):
+        fatal("Sweep configuration names must be unique")
+    return sweep
+
+def apply_override(cpu, path, value):
+    *parents, param = path.split('.')
+    obj = cpu
+    try:
+        for attr in parents:
+            obj = getattr(obj, attr)
+        setattr(obj, param, value)
+    except (AttributeError, TypeError, ValueError) as e:
+        fatal("Bad override %s=%s: %s", path, value, e)
+
+def build_sweep_cpus(test_sys, args, overrides):
+    cpus = []
+    for i, test_cpu in enumerate(test_sys.cpu):
+        cpu = type(test_cpu)(switched_out=True, cpu_id=i)
+        cpu.system = test_sys
+        cpu.workload = test_cpu.workload
+        cpu.clk_domain = test_cpu.clk_domain
+        cpu.isa = test_cpu.isa
+        cpu.decoder = test_cpu.decoder
+        cpu.progress_interval = test_cpu.progress_interval
+        for param in ['enable_storeSet_train', 'store_prefetch_train',
+                      'enable_riscv_vector']:
+            setattr(cpu, param, getattr(test_cpu, param))
+        config_mmu(cpu, args)
+        config_branch_predictor(cpu, args)
+
+        for path, value in overrides:
+            apply_override(cpu, path, value)
+
+        cpu.createThreads()
+        cpus.append(cpu)
+    return cpus
+
+if __name__ == '__m5_main__':
+    # Add args
+    parser = argparse.ArgumentParser()
+    Options.addCommonOptions(parser, configure_xiangshan=True)
+    Options.addXiangshanFSOptions(parser)
+
+    parser.add_argument("--sweep", action="store", type=str, required=True,
+                        help="File with one core configuration per line")
+    parser.add_argument("--sweep-jobs", action="store", type=int, default=1,
+                        help="Number of configurations simulated at once")
+    parser.add_argument("--sweep-warmup-insts", action="store", type=int,
+                        default=0,
+                        help="Instructions run on the default core before "
+                        "forking, shared by all configurations")
+
+    args = parser.parse_args()
+
+    if args.ruby:
+        fatal("Sweeps need the classic memory system")
+    if args.sweep_jobs < 1:
+        fatal("--sweep-jobs must be at least 1")
+
+    if args.xiangshan_ecore:
+        args.cpu_clock = '2.4GHz'
+
+    args.xiangshan_system = True
+    args.enable_difftest = True
+    args.enable_riscv_vector = True
+
+    assert not args.external_memory_system
+
+    # Match the memories with the CPUs, based on the options for the test system
+    TestMemClass = Simulation.setMemClass(args)
+
+    test_sys = build_test_system(args.num_cpus, args)
+
+    # Set ideal parameters here with the highest priority, over command-line arguments
+    if args.ideal_kmhv3:
+        setKmhV3IdealParams(args, test_sys)
+
+    sweep = [(name, build_sweep_cpus(test_sys, args, overrides))
+             for name, overrides in parse_sweep(args.sweep)]
+    test_sys.sweep_cpus = [cpu for _, cpus in sweep for cpu in cpus]
+
+    root = Root(full_system=True, system=test_sys)
+
+    Simulation.run_sweep(args, root, test_sys, sweep)
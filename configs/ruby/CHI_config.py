@@ -532,7 +532,8 @@ class CHI_RNF(CHI_Node):
             )
 
             cpu.l1d = CHI_L1Controller(
-                ruby_system, cpu.data_sequencer, l1d_cache, l1d_pf, is_dcache=True, enable_difftest = True
+                ruby_system, cpu.data_sequencer, l1d_cache, l1d_pf, is_dcache=True,
+                enable_difftest=getattr(options, 'enable_difftest', True)
             )
 
             cpu.inst_sequencer.dcache = NULL
@@ -125,6 +125,17 @@ def define_options(parser):
         help="Recycle latency for ruby controller input buffers",
     )
 
+    parser.add_argument(
+        "--ruby-partition-mode",
+        choices=["off", "serial", "parallel"],
+        default="off",
+        help="Give each core, its sequencers, private controllers and "
+        "routers a Ruby partition of its own. Partitions only exchange "
+        "messages at quantum boundaries, so 'parallel' runs each one on "
+        "its own event queue and thread. 'serial' keeps the same "
+        "synchronisation on one queue, its results must match 'parallel'.",
+    )
+
     protocol = buildEnv["PROTOCOL"]
     exec(f"from . import {protocol}")
     eval(f"{protocol}.define_options(parser)")
@@ -273,6 +284,8 @@ def create_system(
     # Initialize network based on topology
     Network.init_network(options, network, InterfaceClass)
 
+    partition_network(options, ruby, network, cpus)
+
     # Create a port proxy for connecting the system port. This is
     # independent of the protocol and kept in the protocol-agnostic
     # part (i.e. here).
@@ -306,6 +319,67 @@ def create_system(
         )
 
 
+def partition_network(options, ruby, network, cpus):
+    if options.ruby_partition_mode == "off":
+        return
+
+    if buildEnv["PROTOCOL"] != "CHI" or options.network != "simple":
+        fatal("Ruby partitions need the CHI protocol and the simple network")
+
+    cpus = list(cpus)
+
+    # CHI makes the private controllers and sequencers children of their
+    # core, so they follow the core to its partition
+    def partition_of(obj):
+        while obj is not None:
+            for i, cpu in enumerate(cpus):
+                if obj is cpu:
+                    return i + 1
+            obj = obj._parent
+        return 0
+
+    router_partitions = {}
+    for link in network.ext_links:
+        router_partitions.setdefault(id(link.int_node), set()).add(
+            partition_of(link.ext_node)
+        )
+
+    parallel = options.ruby_partition_mode == "parallel"
+    if parallel and getattr(options, "enable_difftest", False):
+        # Every core checks against the same reference and golden memory
+        fatal(
+            "--ruby-partition-mode=parallel cannot run with difftest, use "
+            "'serial' or --disable-difftest"
+        )
+
+    for router in network.routers:
+        partitions = router_partitions.get(id(router), {0})
+        router.partition = partitions.pop() if len(partitions) == 1 else 0
+        if parallel:
+            router.eventq_index = router.partition
+    if parallel:
+        # Each core runs on its own thread, so it cannot use the static
+        # decode cache the RISC-V decoders share by default. Decoders are
+        # often created after this, hence also change the class default.
+        if ISA.RISCV in get_supported_isas():
+            RiscvDecoder.shared_decode_cache = False
+        for i, cpu in enumerate(cpus):
+            cpu.eventq_index = i + 1
+            for decoder in cpu.decoder:
+                if hasattr(decoder, "shared_decode_cache"):
+                    decoder.shared_decode_cache = False
+
+    # The quantum is the shortest link between partitions
+    latencies = [
+        int(link.latency)
+        for link in network.int_links
+        if int(link.src_node.partition) != int(link.dst_node.partition)
+    ]
+    if not latencies:
+        fatal("The topology has no link between Ruby partitions")
+    ruby._partition_quantum_cycles = min(latencies)
+
+
 def create_directories(options, bootmem, ruby_system, system):
     dir_cntrl_nodes = []
     for i in range(options.num_dirs):
@@ -29,6 +29,7 @@
 #ifndef __ARCH_GENERIC_DECODE_CACHE_HH__
 #define __ARCH_GENERIC_DECODE_CACHE_HH__
 
+#include "base/compiler.hh"
 #include "base/types.hh"
 #include "cpu/decode_cache.hh"
 #include "cpu/static_inst_fwd.hh"
@@ -76,6 +77,65 @@ class BasicDecodeCache
     }
 };
 
+/// A decode cache with one flat array of decoded instructions per page of
+/// code, indexed directly by the instruction's offset in the page, so a
+/// hit costs no hashing beyond the page lookup. Entries still remember
+/// the machine instruction they were decoded from and are re-decoded on a
+/// mismatch, so self-modifying code is always decoded correctly; the
+/// invalidation hooks only release stale pages. A single instance may be
+/// shared by the decoders of several cores.
+template <typename Decoder, typename EMI, Addr SlotShift = 0>
+class PageDecodeCache
+{
+  private:
+    decode_cache::InstMap<EMI> instMap;
+    struct PageEntry
+    {
+        StaticInstPtr inst;
+        EMI machInst;
+    };
+    decode_cache::PageMap<PageEntry, 12, SlotShift> decodePages;
+
+  public:
+    /// Decode a machine instruction.
+    /// @param mach_inst The binary instruction to decode.
+    /// @param addr The address the instruction was fetched from.
+    /// @retval A pointer to the corresponding StaticInst object.
+    StaticInstPtr
+    decode(Decoder *const decoder, EMI mach_inst, Addr addr)
+    {
+        auto &entry = decodePages.lookup(addr);
+        if (GEM5_LIKELY(entry.inst && entry.machInst == mach_inst))
+            return entry.inst;
+
+        entry.machInst = mach_inst;
+
+        auto iter = instMap.find(mach_inst);
+        if (iter != instMap.end()) {
+            entry.inst = iter->second;
+            return entry.inst;
+        }
+
+        entry.inst = decoder->decodeInst(mach_inst);
+        instMap[mach_inst] = entry.inst;
+        return entry.inst;
+    }
+
+    /// Drop the pages overlapping a range that has been written.
+    unsigned
+    invalidate(Addr addr, Addr size)
+    {
+        return decodePages.invalidate(addr, size);
+    }
+
+    /// Drop all pages, e.g. on an instruction fence. Decoded instructions
+    /// are kept in the machine instruction map since they only depend on
+    /// the instruction bits.
+    void invalidateAll() { decodePages.clear(); }
+
+    size_t numPages() const { return decodePages.numPages(); }
+};
+
 } // namespace GenericISA
 } // namespace gem5
 
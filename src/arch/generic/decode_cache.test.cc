@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "arch/generic/decode_cache.hh"
+#include "cpu/static_inst.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Remembers the machine instruction it was decoded from. */
+class FakeInst : public StaticInst
+{
+  public:
+    const uint32_t machInst;
+
+    FakeInst(uint32_t mach_inst)
+        : StaticInst("fake", No_OpClass), machInst(mach_inst)
+    {}
+
+    Fault execute(ExecContext *, Trace::InstRecord *) const override
+    {
+        return NoFault;
+    }
+
+    void advancePC(PCStateBase &) const override {}
+
+  protected:
+    std::string
+    generateDisassembly(Addr, const loader::SymbolTable *) const override
+    {
+        return mnemonic;
+    }
+};
+
+struct FakeDecoder
+{
+    unsigned decodes = 0;
+
+    StaticInstPtr
+    decodeInst(uint32_t mach_inst)
+    {
+        decodes++;
+        return new FakeInst(mach_inst);
+    }
+};
+
+/** Slots are default constructed, plain integers would be garbage. */
+struct Value
+{
+    uint64_t v = 0;
+};
+
+uint32_t
+machInstOf(StaticInstPtr inst)
+{
+    return static_cast<FakeInst *>(inst.get())->machInst;
+}
+
+} // anonymous namespace
+
+/** PageMap keeps values where AddrMap, which it replaces, would. */
+TEST(DecodeCacheTest, PageMapMatchesAddrMap)
+{
+    decode_cache::AddrMap<Value> addr_map;
+    decode_cache::PageMap<Value, 12, 1> page_map;
+
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 50000; i++) {
+        // A handful of pages so that slots are revisited
+        Addr addr = 0x80000000 + (rng() % 8) * 0x1000 + (rng() % 2048) * 2;
+        uint64_t value = rng();
+        ASSERT_EQ(page_map.lookup(addr).v, addr_map.lookup(addr).v);
+        page_map.lookup(addr).v = value;
+        addr_map.lookup(addr).v = value;
+    }
+    EXPECT_EQ(page_map.numPages(), 8);
+}
+
+TEST(DecodeCacheTest, PageMapInvalidate)
+{
+    decode_cache::PageMap<Value, 12, 1> map;
+    for (Addr page = 0; page < 4; page++)
+        map.lookup(page * 0x1000 + 0x10).v = 1;
+    ASSERT_EQ(map.numPages(), 4);
+
+    // Ranges ending one byte into a page, and empty ranges
+    EXPECT_EQ(map.invalidate(0x1ffe, 3), 2);
+    EXPECT_EQ(map.invalidate(0x1000, 0x1000), 0);
+    EXPECT_EQ(map.invalidate(0x3000, 0), 0);
+    EXPECT_EQ(map.numPages(), 2);
+
+    // A dropped page comes back empty
+    EXPECT_EQ(map.lookup(0x1010).v, 0);
+    EXPECT_EQ(map.lookup(0x3010).v, 1);
+
+    map.clear();
+    EXPECT_EQ(map.numPages(), 0);
+    EXPECT_EQ(map.lookup(0x10).v, 0);
+}
+
+/**
+ * PageDecodeCache returns the instruction BasicDecodeCache returns, also
+ * when code is rewritten in place and across invalidations.
+ */
+TEST(DecodeCacheTest, PageDecodeCacheMatchesBasic)
+{
+    FakeDecoder basic_decoder, page_decoder;
+    GenericISA::BasicDecodeCache<FakeDecoder, uint32_t> basic;
+    GenericISA::PageDecodeCache<FakeDecoder, uint32_t, 1> paged;
+
+    // Memory image of four pages of 16-bit slots
+    std::vector<uint32_t> code(4 * 2048);
+    std::mt19937_64 rng(2);
+    for (auto &word : code)
+        word = rng() % 64;
+
+    for (int i = 0; i < 50000; i++) {
+        size_t slot = rng() % code.size();
+        Addr addr = 0x80000000 + slot * 2;
+        switch (rng() % 16) {
+          case 0:
+            // Self-modifying code, not announced
+            code[slot] = rng() % 64;
+            break;
+          case 1:
+            code[slot] = rng() % 64;
+            paged.invalidate(addr, 2);
+            break;
+          case 2:
+            paged.invalidateAll();
+            break;
+          default:
+            break;
+        }
+        StaticInstPtr expect = basic.decode(&basic_decoder, code[slot], addr);
+        StaticInstPtr got = paged.decode(&page_decoder, code[slot], addr);
+        ASSERT_EQ(machInstOf(got), code[slot]);
+        ASSERT_EQ(machInstOf(got), machInstOf(expect));
+    }
+    // Both share decoded instructions through their machine instruction
+    // maps, so each distinct encoding is decoded once
+    EXPECT_EQ(page_decoder.decodes, basic_decoder.decodes);
+    EXPECT_LE(page_decoder.decodes, 64);
+}
@@ -92,6 +92,15 @@ class InstDecoder : public SimObject
         outOfBytes = old->outOfBytes;
     }
 
+    /**
+     * Notify the decoder that [addr, addr + size) has been written, so
+     * any cached decodings of code in that range may be stale.
+     */
+    virtual void invalidateCodeRange(Addr addr, Addr size) {}
+
+    /** Drop all cached decodings, e.g. on an instruction fence. */
+    virtual void flushDecodeCache() {}
+
     void *moreBytesPtr() const { return _moreBytesPtr; }
     size_t moreBytesSize() const { return _moreBytesSize; }
     Addr pcMask() const { return _pcMask; }
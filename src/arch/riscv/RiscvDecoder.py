@@ -23,9 +23,14 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+from m5.params import *
+
 from m5.objects.InstDecoder import InstDecoder
 
 class RiscvDecoder(InstDecoder):
     type = 'RiscvDecoder'
     cxx_class = 'gem5::RiscvISA::Decoder'
     cxx_header = "arch/riscv/decoder.hh"
+
+    shared_decode_cache = Param.Bool(True, "Share the decoded instruction "
+        "cache with every other decoder that has this set")
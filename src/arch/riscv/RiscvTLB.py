@@ -52,6 +52,9 @@ class RiscvPagetableWalker(ClockedObject):
     pma_checker = Param.PMAChecker(Parent.any, "PMA Checker")
     pmp = Param.PMP(Parent.any, "PMP")
     open_nextline = Param.Bool(True, "open nextline pre")
+    functional_pte_cache_lines = Param.Unsigned(0,
+            "Lines of page table memory cached for functional walks "
+            "(0 to disable)")
 
 class RiscvTLB(BaseTLB):
     type = 'RiscvTLB'
@@ -38,7 +38,7 @@ namespace gem5
 namespace RiscvISA
 {
 
-GenericISA::BasicDecodeCache<Decoder, ExtMachInst> Decoder::defaultCache;
+Decoder::DecodeCache Decoder::sharedCache;
 
 void Decoder::reset()
 {
@@ -81,7 +81,7 @@ Decoder::decode(ExtMachInst mach_inst, Addr addr)
     DPRINTF(Decode, "Decoding instruction 0x%08x at address %#x\n",
             mach_inst.instBits, addr);
 
-    StaticInstPtr si = defaultCache.decode(this, mach_inst, addr);
+    StaticInstPtr si = decodeCache->decode(this, mach_inst, addr);
 
     DPRINTF(Decode, "Decode: Decoded %s instruction: %#x\n",
             si->getName(), mach_inst);
@@ -150,5 +150,22 @@ Decoder::stall() {
     return !vtypeReady;
 }
 
+void
+Decoder::invalidateCodeRange(Addr addr, Addr size)
+{
+    if (decodeCache->invalidate(addr, size)) {
+        DPRINTF(Decode, "Store to %#x invalidated decoded code page\n",
+                addr);
+    }
+}
+
+void
+Decoder::flushDecodeCache()
+{
+    DPRINTF(Decode, "Flushing %d decoded code pages\n",
+            decodeCache->numPages());
+    decodeCache->invalidateAll();
+}
+
 } // namespace RiscvISA
 } // namespace gem5
@@ -30,6 +30,8 @@
 #ifndef __ARCH_RISCV_DECODER_HH__
 #define __ARCH_RISCV_DECODER_HH__
 
+#include <memory>
+
 #include "arch/generic/decode_cache.hh"
 #include "arch/generic/decoder.hh"
 #include "arch/riscv/insts/vector.hh"
@@ -57,9 +59,15 @@ class Decoder : public InstDecoder
     bool vtypeReady = true;
     VTYPE machVtype;
 
-    /// A cache of decoded instruction objects.
-    static GenericISA::BasicDecodeCache<Decoder, ExtMachInst> defaultCache;
-    friend class GenericISA::BasicDecodeCache<Decoder, ExtMachInst>;
+    /// A cache of decoded instruction objects, one slot per halfword of
+    /// code so compressed instructions get their own entries.
+    typedef GenericISA::PageDecodeCache<Decoder, ExtMachInst, 1> DecodeCache;
+    friend class GenericISA::PageDecodeCache<Decoder, ExtMachInst, 1>;
+
+    /// Cache shared by every decoder with shared_decode_cache set.
+    static DecodeCache sharedCache;
+    std::unique_ptr<DecodeCache> privateCache;
+    DecodeCache *decodeCache;
 
     StaticInstPtr decodeInst(ExtMachInst mach_inst);
 
@@ -71,6 +79,12 @@ class Decoder : public InstDecoder
   public:
     Decoder(const RiscvDecoderParams &p) : InstDecoder(p, &machInst)
     {
+        if (p.shared_decode_cache) {
+            decodeCache = &sharedCache;
+        } else {
+            privateCache = std::make_unique<DecodeCache>();
+            decodeCache = privateCache.get();
+        }
         reset();
     }
 
@@ -96,6 +110,10 @@ class Decoder : public InstDecoder
     void clearVtype();
 
     bool stall() override;
+
+    void invalidateCodeRange(Addr addr, Addr size) override;
+
+    void flushDecodeCache() override;
 };
 
 } // namespace RiscvISA
@@ -41,6 +41,19 @@ namespace gem5
 namespace RiscvISA
 {
 
+bool vecFastPathCheck = false;
+
+void
+vecFastPathVerify(const char *mnemonic, const uint8_t *fast,
+                  const uint8_t *generic)
+{
+    for (size_t i = 0; i < VLENB; i++) {
+        panic_if(fast[i] != generic[i],
+                 "%s: vector fast path byte %d is %#x, generic loop "
+                 "gives %#x\n", mnemonic, i, fast[i], generic[i]);
+    }
+}
+
 std::string
 VConfOp::generateDisassembly(Addr pc, const loader::SymbolTable *symtab) const
 {
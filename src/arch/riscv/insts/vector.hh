@@ -29,6 +29,7 @@
 #ifndef __ARCH_RISCV_INSTS_VECTOR_HH__
 #define __ARCH_RISCV_INSTS_VECTOR_HH__
 
+#include <cstring>
 #include <string>
 
 #include "arch/riscv/faults.hh"
@@ -91,6 +92,39 @@ class VConfOp : public RiscvStaticInst
     std::string generateZimmDisassembly() const;
 };
 
+/**
+ * Vector arithmetic micro-ops run their element loop without per-element
+ * predication when every element they cover is active, which lets the
+ * host compiler vectorize it. When this is set the generic, predicated
+ * loop is re-run afterwards and the two results are compared.
+ */
+extern bool vecFastPathCheck;
+
+/** Panic if a fast path and the generic loop disagree on a register. */
+void vecFastPathVerify(const char *mnemonic, const uint8_t *fast,
+                       const uint8_t *generic);
+
+/**
+ * Apply a bitwise mask-register operation a whole 64-bit word at a time,
+ * leaving the bits from the last full word up to vl to the caller.
+ * @return The number of mask bits written.
+ */
+template <typename Op>
+inline uint32_t
+maskLogicWords(uint8_t *vd, const uint8_t *vs2, const uint8_t *vs1,
+               uint32_t vl, Op op)
+{
+    const uint32_t words = vl / 64;
+    for (uint32_t w = 0; w < words; w++) {
+        uint64_t a, b;
+        memcpy(&a, vs2 + w * 8, 8);
+        memcpy(&b, vs1 + w * 8, 8);
+        const uint64_t d = op(a, b);
+        memcpy(vd + w * 8, &d, 8);
+    }
+    return words * 64;
+}
+
 inline uint8_t checked_vtype(bool vill, uint8_t vtype) {
     panic_if(vill, "vill has been set");
     const uint8_t vsew = bits(vtype, 5, 3);
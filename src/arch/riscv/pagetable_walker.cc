@@ -50,6 +50,7 @@
 
 #include "arch/riscv/pagetable_walker.hh"
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 
@@ -74,13 +75,78 @@ namespace gem5
 
 namespace RiscvISA {
 
+Walker::~Walker()
+{
+    for (void *mem : freeStates)
+        ::operator delete(mem);
+}
+
+Walker::WalkerState *
+Walker::allocState(BaseMMU::Translation *translation, const RequestPtr &req)
+{
+    void *mem;
+    if (freeStates.empty()) {
+        mem = ::operator new(sizeof(WalkerState));
+    } else {
+        mem = freeStates.back();
+        freeStates.pop_back();
+    }
+    return new (mem) WalkerState(this, translation, req);
+}
+
+void
+Walker::freeState(WalkerState *state)
+{
+    state->~WalkerState();
+    freeStates.push_back(state);
+}
+
+void
+Walker::addState(WalkerState *state)
+{
+    state->walkId = nextWalkId++;
+    currStates.push_back(state);
+    walksByPage.emplace(state->matchPage(), state);
+}
+
+std::list<Walker::WalkerState *>::iterator
+Walker::removeState(std::list<WalkerState *>::iterator it)
+{
+    auto [first, last] = walksByPage.equal_range((*it)->matchPage());
+    for (auto w = first; w != last; w++) {
+        if (w->second == *it) {
+            walksByPage.erase(w);
+            break;
+        }
+    }
+    return currStates.erase(it);
+}
+
 std::pair<bool, Fault>
 Walker::tryCoalesce(ThreadContext *_tc, BaseMMU::Translation *translation,
                     const RequestPtr &req, BaseMMU::Mode mode, bool from_l2tlb,
                     Addr asid, bool from_forward_pre_req, bool from_back_pre_req)
 {
     assert(currStates.size());
-    for (auto it: currStates) {
+    // A walk can only take requests for its own page, so only those
+    // walks are tried, in the order they entered currStates.
+    Addr page;
+    if (from_back_pre_req) {
+        page = req->getBackPreVaddr() >> PageShift;
+    } else if (from_forward_pre_req) {
+        page = req->getForwardPreVaddr() >> PageShift;
+    } else {
+        page = req->getVaddr() >> PageShift;
+    }
+    std::vector<WalkerState *> candidates;
+    auto [first, last] = walksByPage.equal_range(page);
+    for (auto it = first; it != last; it++)
+        candidates.push_back(it->second);
+    std::sort(candidates.begin(), candidates.end(),
+              [](const WalkerState *a, const WalkerState *b) {
+                  return a->walkId < b->walkId;
+              });
+    for (auto it: candidates) {
         auto &ws = *it;
         auto [coalesced, fault] =
             ws.tryCoalesce(_tc, translation, req, mode, from_l2tlb, asid, from_forward_pre_req, from_back_pre_req);
@@ -116,7 +182,7 @@ Walker::start(Addr ppn, ThreadContext *_tc, BaseMMU::Translation *_translation,
             tryCoalesce(_tc, _translation, _req, _mode, from_l2tlb, asid, from_forward_pre_req, from_back_pre_req);
         if (!coalesced) {
             // create state
-            WalkerState *newState = new WalkerState(this, _translation, _req);
+            WalkerState *newState = allocState(_translation, _req);
             newState->initState(_tc, _req, _mode, sys->isTimingMode(), from_forward_pre_req, from_back_pre_req);
             assert(newState->isTiming());
             // TODO: add to requestors
@@ -124,7 +190,7 @@ Walker::start(Addr ppn, ThreadContext *_tc, BaseMMU::Translation *_translation,
                     "Walks in progress: %d, push req pc: %#lx, addr: %#lx "
                     "into currStates\n",
                     currStates.size(), _req->getPC(), _req->getVaddr());
-            currStates.push_back(newState);
+            addState(newState);
             Fault fault = newState->startWalk(ppn, f_level, from_l2tlb, openNextLine, autoOpenNextLine,
                                               from_forward_pre_req, from_back_pre_req);
             if (!newState->isTiming()) {
@@ -139,14 +205,14 @@ Walker::start(Addr ppn, ThreadContext *_tc, BaseMMU::Translation *_translation,
             return fault;
         }
     } else {
-        WalkerState *newState = new WalkerState(this, _translation, _req);
+        WalkerState *newState = allocState(_translation, _req);
         newState->initState(_tc, _req, _mode, sys->isTimingMode(), from_forward_pre_req, from_back_pre_req);
-        currStates.push_back(newState);
+        addState(newState);
         Fault fault = newState->startWalk(ppn, f_level, from_l2tlb, openNextLine, autoOpenNextLine,
                                           from_forward_pre_req, from_back_pre_req);
         if (!newState->isTiming()) {
-            currStates.pop_front();
-            delete newState;
+            removeState(currStates.begin());
+            freeState(newState);
         }
         return fault;
     }
@@ -183,6 +249,52 @@ Walker::startFunctional(RequestPtr req, ThreadContext * _tc, Addr &addr, unsigne
                                      autoOpenNextLine, false, false);
 }
 
+void
+Walker::sendFunctionalPte(PacketPtr pkt)
+{
+    Addr addr = pkt->getAddr();
+    Addr line_addr = addr & ~Addr(PteLineBytes - 1);
+    if (pteCacheLines.empty() ||
+        addr + pkt->getSize() > line_addr + PteLineBytes) {
+        port.sendFunctional(pkt);
+        return;
+    }
+
+    PteLine &line =
+        pteCacheLines[(line_addr / PteLineBytes) % pteCacheLines.size()];
+    if (line.addr != line_addr) {
+        RequestPtr req = makeRequest(
+            line_addr, PteLineBytes, pkt->req->getFlags(), requestorId);
+        Packet fill(req, MemCmd::ReadReq);
+        fill.dataStatic(line.data.data());
+        port.sendFunctional(&fill);
+        line.addr = line_addr;
+        DPRINTF(PageTableWalker, "Functional PTE cache fill %#lx\n",
+                line_addr);
+    }
+    pkt->setData(line.data.data() + (addr - line_addr));
+    pkt->makeResponse();
+}
+
+void
+Walker::invalidatePteLine(Addr addr)
+{
+    if (pteCacheLines.empty())
+        return;
+    Addr line_addr = addr & ~Addr(PteLineBytes - 1);
+    PteLine &line =
+        pteCacheLines[(line_addr / PteLineBytes) % pteCacheLines.size()];
+    if (line.addr == line_addr)
+        line.addr = MaxAddr;
+}
+
+void
+Walker::flushPteCache()
+{
+    for (auto &line : pteCacheLines)
+        line.addr = MaxAddr;
+}
+
 bool
 Walker::WalkerPort::recvTimingResp(PacketPtr pkt)
 {
@@ -207,11 +319,11 @@ Walker::recvTimingResp(PacketPtr pkt)
                 DPRINTF(PageTableWalker,
                         "Walk complete for %#lx (pc=%#lx), erase it\n",
                         senderWalk->mainReq->getVaddr(), senderWalk->mainReq->getPC());
-                iter = currStates.erase(iter);
+                iter = removeState(iter);
                 break;
             }
         }
-        delete senderWalk;
+        freeState(senderWalk);
         // Since we block requests when another is outstanding, we
         // need to check if there is a waiting request to be serviced
 
@@ -553,7 +665,7 @@ Walker::WalkerState::startFunctional(Addr &addr, unsigned &logBytes,
               from_back_pre_req);
 
     do {
-        walker->port.sendFunctional(read);
+        walker->sendFunctionalPte(read);
         // On a functional access (page table lookup), writes should
         // not happen so this pointer is ignored after stepWalk
         PacketPtr write = NULL;
@@ -795,7 +907,7 @@ Walker::WalkerState::twoStageStepWalk(PacketPtr &write)
             if (!tlbHit) {
                 delete oldRead;
                 oldRead = nullptr;
-                RequestPtr request = std::make_shared<Request>(nextRead, oldSize, flags, walker->requestorId);
+                RequestPtr request = makeRequest(nextRead, oldSize, flags, walker->requestorId);
                 DPRINTF(PageTableWalkerTwoStage,
                         "twoStageStepWalk nextRead %lx vaddr %lx gpaddr %lx level %d twolevel %d\n", nextRead,
                         entry.vaddr, gPaddr, level, twoStageLevel);
@@ -1334,7 +1446,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
                         nextlineEntry.vaddr =
                             entry.vaddr + (l2tlbLineSize << (nextlineLevel * LEVEL_BITS + PageShift));
 
-                        RequestPtr request = std::make_shared<Request>(
+                        RequestPtr request = makeRequest(
                             nextRead, oldRead->getSize(), flags,
                             walker->requestorId);
                         if (nextRead == 0)
@@ -1398,7 +1510,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
         endWalk();
     } else {
         //If we didn't return, we're setting up another read.
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = makeRequest(
             nextRead, oldRead->getSize(), flags, walker->requestorId);
         if (nextRead == 0)
             panic("nextread can't be 0\n");
@@ -1466,7 +1578,7 @@ Walker::WalkerState::startTwoStageWalkFromTLBNotInG(Addr ppn, Addr vaddr)
     if (nextRead == 0)
         panic("nextread can't be 0\n");
     Request::Flags flags = Request::PHYSICAL;
-    RequestPtr request = std::make_shared<Request>(nextRead, 64, flags, walker->requestorId);
+    RequestPtr request = makeRequest(nextRead, 64, flags, walker->requestorId);
     DPRINTF(PageTableWalkerTwoStage, "twoStageStepWalk nextRead %lx vaddr %lx gpaddr %lx level %d twolevel %d\n",
             nextRead, entry.vaddr, gPaddr, level, twoStageLevel);
     read = new Packet(request, MemCmd::ReadReq);
@@ -1483,7 +1595,7 @@ Walker::WalkerState::startTwoStageWalkFromTLBInG(Addr ppn, Addr vaddr)
     nextRead = (nextRead >> 6) << 6;
     if (nextRead == 0)
         panic("nextread can't be 0\n");
-    RequestPtr request = std::make_shared<Request>(nextRead, 64, flags, walker->requestorId);
+    RequestPtr request = makeRequest(nextRead, 64, flags, walker->requestorId);
     read = new Packet(request, MemCmd::ReadReq);
     read->allocate();
     return NoFault;
@@ -1506,7 +1618,7 @@ Walker::WalkerState::startTwoStageWalk(Addr ppn, Addr vaddr)
         TwoLevelTopAddr = (hgatp.ppn << PageShift) + (idx * sizeof(PTESv39));
 
         Request::Flags flags = Request::PHYSICAL;
-        RequestPtr request = std::make_shared<Request>(TwoLevelTopAddr, 64, flags, walker->requestorId);
+        RequestPtr request = makeRequest(TwoLevelTopAddr, 64, flags, walker->requestorId);
         DPRINTF(PageTableWalkerTwoStage, "twoStageStepWalk pte %lx vaddr %lx gpaddr %lx level %d twolevel %d\n",
                 TwoLevelTopAddr, entry.vaddr, gPaddr, level, twoStageLevel);
         if (TwoLevelTopAddr == 0)
@@ -1682,7 +1794,7 @@ Walker::WalkerState::setupWalk(Addr ppn, Addr vaddr, int f_level, bool from_l2tl
         inl2Entry.preSign = false;
         finishDefaultTranslate = false;
         Request::Flags flags = Request::PHYSICAL;
-        RequestPtr request = std::make_shared<Request>(topAddr, 64, flags, walker->requestorId);
+        RequestPtr request = makeRequest(topAddr, 64, flags, walker->requestorId);
         if (topAddr == 0)
             panic("topAddr can't be 0\n");
         DPRINTF(PageTableWalker, " sv39 size is %d\n", sizeof(PTESv39));
@@ -1948,6 +2060,7 @@ Walker::WalkerState::sendPackets()
     while (writes.size()) {
         PacketPtr write = writes.back();
         writes.pop_back();
+        walker->invalidatePteLine(write->getAddr());
         inflight++;
         if (!walker->sendTiming(this, write)) {
             retrying = true;
@@ -1961,6 +2074,18 @@ Walker::WalkerState::sendPackets()
     }
 }
 
+Addr
+Walker::WalkerState::matchPage() const
+{
+    if (fromPre) {
+        return mainReq->getForwardPreVaddr() >> PageShift;
+    } else if (fromBackPre) {
+        return mainReq->getBackPreVaddr() >> PageShift;
+    } else {
+        return mainReq->getVaddr() >> PageShift;
+    }
+}
+
 unsigned
 Walker::WalkerState::numInflight() const
 {
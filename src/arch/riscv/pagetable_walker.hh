@@ -39,6 +39,8 @@
 #ifndef __ARCH_RISCV_TABLE_WALKER_HH__
 #define __ARCH_RISCV_TABLE_WALKER_HH__
 
+#include <array>
+#include <unordered_map>
 #include <vector>
 
 #include "arch/generic/mmu.hh"
@@ -231,6 +233,10 @@ namespace RiscvISA
             void retry();
             std::string name() const {return walker->name();}
 
+            /** Page of the address this walk translates, used as the
+             *  coalescing key. */
+            Addr matchPage() const;
+
             bool anyRequestorSquashed() const;
             bool allRequestorSquashed() const;
             Fault setupWalk(Addr ppn, Addr vaddr, int f_level, bool from_l2tlb,
@@ -252,6 +258,9 @@ namespace RiscvISA
             Fault pageFaultOnRequestor(RequestorState &requestor, bool G);
             Addr getGVPNi(Addr vaddr, int level);
             Addr VpniShift(int level);
+
+            /** Order in which the walk entered currStates. */
+            uint64_t walkId = 0;
         };
 
         struct L2TlbState
@@ -272,9 +281,39 @@ namespace RiscvISA
         // State for timing and atomic accesses (need multiple per walker in
         // the case of multiple outstanding requests in timing mode)
         std::list<WalkerState *> currStates;
+        // In-flight walks by matchPage(), so coalescing only has to try
+        // the walks of the requested page
+        std::unordered_multimap<Addr, WalkerState *> walksByPage;
+        uint64_t nextWalkId = 0;
+        // Storage of finished walk states, reused by allocState()
+        std::vector<void *> freeStates;
         // State for functional accesses (only need one of these per walker)
         WalkerState funcState;
 
+        WalkerState *allocState(BaseMMU::Translation *translation,
+                                const RequestPtr &req);
+        void freeState(WalkerState *state);
+        void addState(WalkerState *state);
+        std::list<WalkerState *>::iterator
+        removeState(std::list<WalkerState *>::iterator it);
+
+        /**
+         * Direct-mapped cache of page table lines for functional walks,
+         * which otherwise issue one functional access per level. Disabled
+         * when pteCacheLines is empty. Lines written by the walker itself
+         * are dropped, and the whole cache is flushed with the TLB.
+         */
+        static constexpr unsigned PteLineBytes = 64;
+        struct PteLine
+        {
+            Addr addr = MaxAddr;
+            std::array<uint8_t, PteLineBytes> data;
+        };
+        std::vector<PteLine> pteCacheLines;
+
+        void sendFunctionalPte(PacketPtr pkt);
+        void invalidatePteLine(Addr addr);
+
         struct WalkerSenderState : public Packet::SenderState
         {
             WalkerState * senderWalk;
@@ -309,6 +348,9 @@ namespace RiscvISA
 
         Fault startFunctional(RequestPtr req, ThreadContext * _tc, Addr &addr,
                 unsigned &logBytes, BaseMMU::Mode mode);
+
+        /** Drop all lines of the functional page table cache. */
+        void flushPteCache();
         Port &getPort(const std::string &if_name,
                       PortID idx=InvalidPortID) override;
       protected:
@@ -380,7 +422,10 @@ namespace RiscvISA
             openSv48(false),
             doL2TLBHitEvent([this]{dol2TLBHit();},name())
         {
+            pteCacheLines.resize(params.functional_pte_cache_lines);
         }
+
+        ~Walker();
     };
 
 } // namespace RiscvISA
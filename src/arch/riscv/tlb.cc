@@ -783,6 +783,10 @@ TLB::demapPage(Addr vpn, uint64_t asid)
     DPRINTF(TLBGPre, "flush(vpn=%#x, asid=%#x)\n", vpn, asid);
     asid &= 0xFFFF;
 
+    // An sfence.vma makes page table writes visible to the walker.
+    if (is_L1tlb)
+        walker->flushPteCache();
+
     size_t i;
 
     TLB *l2tlb;
@@ -930,6 +934,8 @@ void
 TLB::flushAll()
 {
     size_t i;
+    if (is_L1tlb)
+        walker->flushPteCache();
     if (is_L1tlb) {
         for (i = 0; i < size; i++) {
             if (tlb[i].trieHandle)
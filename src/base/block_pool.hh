@@ -0,0 +1,108 @@
+#ifndef __BASE_BLOCK_POOL_HH__
+#define __BASE_BLOCK_POOL_HH__
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace gem5
+{
+
+/**
+ * Per-thread free list of memory blocks of one size. Blocks come from
+ * the global heap, so a block may be freed by another thread than the
+ * one that allocated it; it then joins that thread's list.
+ *
+ * @tparam Size Size of every block in bytes.
+ */
+template <size_t Size>
+class BlockPool
+{
+  public:
+    /** Blocks kept per thread; more are given back to the heap. */
+    static constexpr size_t MaxFree = 4096;
+
+    static void *
+    alloc()
+    {
+        auto &blocks = freeList().blocks;
+        if (blocks.empty())
+            return ::operator new(Size);
+        void *block = blocks.back();
+        blocks.pop_back();
+        return block;
+    }
+
+    static void
+    free(void *block)
+    {
+        auto &blocks = freeList().blocks;
+        if (blocks.size() < MaxFree)
+            blocks.push_back(block);
+        else
+            ::operator delete(block);
+    }
+
+    /** Number of free blocks held by the calling thread. */
+    static size_t numFree() { return freeList().blocks.size(); }
+
+  private:
+    struct FreeList
+    {
+        std::vector<void *> blocks;
+
+        ~FreeList()
+        {
+            for (void *block : blocks)
+                ::operator delete(block);
+        }
+    };
+
+    static FreeList &
+    freeList()
+    {
+        thread_local FreeList list;
+        return list;
+    }
+};
+
+/**
+ * Allocator drawing single objects from a BlockPool, e.g. to let
+ * std::allocate_shared put an object and its reference count in one
+ * pooled block. Arrays go to the heap.
+ */
+template <class T>
+class PoolAllocator
+{
+  public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <class U> PoolAllocator(const PoolAllocator<U> &) {}
+
+    T *
+    allocate(size_t n)
+    {
+        if (n == 1)
+            return static_cast<T *>(BlockPool<sizeof(T)>::alloc());
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *p, size_t n)
+    {
+        if (n == 1)
+            BlockPool<sizeof(T)>::free(p);
+        else
+            ::operator delete(p);
+    }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U> &) const { return true; }
+    template <class U>
+    bool operator!=(const PoolAllocator<U> &) const { return false; }
+};
+
+} // namespace gem5
+
+#endif // __BASE_BLOCK_POOL_HH__
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <thread>
+
+#include "base/block_pool.hh"
+
+using namespace gem5;
+
+TEST(BlockPoolTest, ReusesFreedBlocks)
+{
+    using Pool = BlockPool<48>;
+    void *a = Pool::alloc();
+    void *b = Pool::alloc();
+    EXPECT_NE(a, b);
+    size_t free_before = Pool::numFree();
+    Pool::free(a);
+    EXPECT_EQ(Pool::numFree(), free_before + 1);
+    EXPECT_EQ(Pool::alloc(), a);
+    Pool::free(a);
+    Pool::free(b);
+}
+
+TEST(BlockPoolTest, FreeOnOtherThread)
+{
+    using Pool = BlockPool<40>;
+    void *a = Pool::alloc();
+    std::thread t([a] {
+        Pool::free(a);
+        EXPECT_EQ(Pool::numFree(), 1);
+    });
+    t.join();
+}
+
+struct Counted
+{
+    int value;
+    explicit Counted(int v) : value(v) {}
+};
+
+TEST(BlockPoolTest, AllocateShared)
+{
+    PoolAllocator<Counted> alloc;
+    std::weak_ptr<Counted> weak;
+    {
+        auto p = std::allocate_shared<Counted>(alloc, 7);
+        EXPECT_EQ(p->value, 7);
+        weak = p;
+        auto q = p;
+        EXPECT_EQ(weak.use_count(), 2);
+    }
+    EXPECT_TRUE(weak.expired());
+}
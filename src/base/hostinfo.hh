@@ -41,6 +41,13 @@ namespace gem5
  */
 uint64_t memUsage();
 
+/**
+ * Determine the simulator process' resident set size.
+ *
+ * @return Resident memory in kilobytes
+ */
+uint64_t rssUsage();
+
 } // namespace gem5
 
 #endif // __HOSTINFO_HH__
@@ -35,9 +35,11 @@
 #include <netinet/tcp.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 #include <cerrno>
+#include <cstring>
 
 #include "base/logging.hh"
 #include "base/types.hh"
@@ -115,6 +117,8 @@ ListenSocket::~ListenSocket()
 {
     if (fd != -1)
         close(fd);
+    if (!unixPath.empty())
+        unlink(unixPath.c_str());
 }
 
 // Create a socket and configure it for listening
@@ -169,6 +173,39 @@ ListenSocket::listen(int port, bool reuse)
     return true;
 }
 
+bool
+ListenSocket::listenUnix(const std::string &path)
+{
+    if (listening)
+        panic("Socket already listening!");
+
+    struct sockaddr_un sockaddr = {};
+    sockaddr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(sockaddr.sun_path)) {
+        warn("UNIX socket path %s is too long", path);
+        return false;
+    }
+    std::strcpy(sockaddr.sun_path, path.c_str());
+
+    if (fd == -1) {
+        fd = socketCloexec(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+            panic("Can't create socket:%s !", strerror(errno));
+    }
+
+    unlink(path.c_str());
+    if (::bind(fd, (struct sockaddr *)&sockaddr, sizeof(sockaddr)) != 0 ||
+            ::listen(fd, 1) == -1) {
+        warn("Can't listen on %s: %s", path, strerror(errno));
+        close(fd);
+        fd = -1;
+        return false;
+    }
+
+    unixPath = path;
+    listening = true;
+    return true;
+}
 
 // Open a connection.  Accept will block, so if you don't want it to,
 // make sure a connection is ready before you call accept.
@@ -32,6 +32,8 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include <string>
+
 namespace gem5
 {
 
@@ -56,6 +58,8 @@ class ListenSocket
   protected:
     bool listening;
     int fd;
+    /** Path of the UNIX-domain socket file, removed on destruction */
+    std::string unixPath;
 
     /*
      * cleanup resets the static variables back to their default values.
@@ -74,6 +78,13 @@ class ListenSocket
 
     virtual bool listen(int port, bool reuse = true);
 
+    /**
+     * Listen on a UNIX-domain socket, replacing a stale socket file at
+     * path. Unlike ports, such sockets are reachable only from this host
+     * and are not affected by disableAll() or loopbackOnly().
+     */
+    bool listenUnix(const std::string &path);
+
     int getfd() const { return fd; }
     bool islistening() const { return listening; }
 
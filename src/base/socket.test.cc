@@ -28,6 +28,13 @@
 
 #include <gtest/gtest.h>
 
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
 #include "base/gtest/logging.hh"
 #include "base/socket.hh"
 
@@ -158,3 +165,27 @@ TEST(SocketTest, AcceptError)
     MockListenSocket listen_socket;
     EXPECT_EQ(-1, listen_socket.accept());
 }
+
+TEST(SocketTest, ListenUnix)
+{
+    std::string path = "socket_test." + std::to_string(getpid());
+    {
+        MockListenSocket listen_socket;
+        EXPECT_TRUE(listen_socket.listenUnix(path));
+        EXPECT_TRUE(listen_socket.islistening());
+        EXPECT_FALSE(listen_socket.allDisabled());
+
+        int client = socket(AF_UNIX, SOCK_STREAM, 0);
+        struct sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        std::strcpy(addr.sun_path, path.c_str());
+        EXPECT_EQ(0, connect(client, (struct sockaddr *)&addr, sizeof(addr)));
+
+        int server = listen_socket.accept();
+        EXPECT_NE(-1, server);
+        close(server);
+        close(client);
+    }
+    // The socket file goes away with the listener
+    EXPECT_NE(0, access(path.c_str(), F_OK));
+}
@@ -162,6 +162,9 @@ class BaseCPU(ClockedObject):
     enable_riscv_vector = Param.Bool(False, "Enable riscv vector extension")
     enable_riscv_h = Param.Bool(True, "Enable riscv vector extension")
     enable_mem_dedup = Param.Bool(False, "Enable memory deduplication for difftest and golden memory")
+    diff_store_commit_batch = Param.Unsigned(0, "Check committed scalar "
+        "stores against the ref's store commit queue in batches of this "
+        "size, 0 disables. Needs a ref built with store commit support")
 
     def createInterruptController(self):
         self.interrupts = [
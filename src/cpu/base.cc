@@ -43,6 +43,7 @@
 
 #include "cpu/base.hh"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -50,6 +51,7 @@
 #include "arch/generic/tlb.hh"
 #include "arch/riscv/insts/static_inst.hh"
 #include "arch/riscv/regs/misc.hh"
+#include "base/bitfield.hh"
 #include "base/cprintf.hh"
 #include "base/loader/symtab.hh"
 #include "base/logging.hh"
@@ -167,7 +169,8 @@ BaseCPU::BaseCPU(const Params &p, bool is_checker)
       enableRVV(p.enable_riscv_vector),
       enableRVHDIFF(p.enable_riscv_h),
       noHypeMode(false),
-      enableMemDedup(p.enable_mem_dedup)
+      enableMemDedup(p.enable_mem_dedup),
+      diffStoreCommitBatch(p.diff_store_commit_batch)
 {
     // if Python did not provide a valid ID, do it here
     if (_cpuId == -1 ) {
@@ -243,6 +246,11 @@ BaseCPU::BaseCPU(const Params &p, bool is_checker)
         diffAllStates->hasCommit = true;
     }
 
+    if (diffStoreCommitBatch) {
+        // Check the stores of the last, partial batch
+        registerExitCallback([this]() { flushDiffStores(); });
+    }
+
     if (dumpCommitFlag) {
         registerExitCallback([this]() {
             auto out_handle = simout.create("dumpCommit.txt", false, true);
@@ -267,6 +275,8 @@ BaseCPU::~BaseCPU()
 void
 BaseCPU::postInterrupt(ThreadID tid, int int_num, int index)
 {
+    // Interrupt controllers may run on another event queue than the CPU
+    EventQueue::ScopedMigration migrate(eventQueue(), inParallelMode);
     interrupts[tid]->post(int_num, index);
     // Only wake up syscall emulation if it is not waiting on a futex.
     // This is to model the fact that instructions such as ARM SEV
@@ -275,6 +285,13 @@ BaseCPU::postInterrupt(ThreadID tid, int int_num, int index)
         wakeup(tid);
 }
 
+void
+BaseCPU::clearInterrupt(ThreadID tid, int int_num, int index)
+{
+    EventQueue::ScopedMigration migrate(eventQueue(), inParallelMode);
+    interrupts[tid]->clear(int_num, index);
+}
+
 void
 BaseCPU::armMonitor(ThreadID tid, Addr address)
 {
@@ -628,6 +645,10 @@ BaseCPU::switchOut()
     assert(!_switchedOut);
     _switchedOut = true;
 
+    // The ref already executed the queued stores, check them before the
+    // difftest state moves to the next CPU
+    flushDiffStores();
+
     // Flush all TLBs in the CPU to avoid having stale translations if
     // it gets switched in later.
     flushTLBs();
@@ -919,6 +940,11 @@ BaseCPU::diffWithNEMU(ThreadID tid, InstSeqNum seq)
         DPRINTF(Diff, "Step NEMU\n");
         diffAllStates->proxy->exec(1);
         diffAllStates->proxy->regcpy(diffAllStates->diff.nemu_reg, REF_TO_DIFFTEST);
+        if (diffStoreCommitBatch) {
+            queueDiffStore(seq);
+            if (diffStores.addr.size() >= diffStoreCommitBatch)
+                diff_at = diffStoreCommits();
+        }
 
         uint64_t next_pc = diffAllStates->diff.nemu_reg->pc;
         // replace with "this pc" for checking
@@ -1440,6 +1466,71 @@ BaseCPU::diffWithNEMU(ThreadID tid, InstSeqNum seq)
     return std::make_pair(diff_at, npc_match);
 }
 
+void
+BaseCPU::queueDiffStore(InstSeqNum seq)
+{
+    const auto &inst = diffInfo.inst;
+    if (!inst->isStore() || inst->isAtomic() || inst->isVector() || diffInfo.effSize > 8 ||
+        (inst->isStoreConditional() && !diffAllStates->diff.sync.lrscValid)) {
+        return;
+    }
+
+    // Split into 8-byte aligned words as the ref records them
+    Addr addr = diffInfo.physEffAddr;
+    unsigned done = 0;
+    while (done < diffInfo.effSize) {
+        unsigned offset = (addr + done) & 0x7;
+        unsigned n = std::min<unsigned>(8 - offset, diffInfo.effSize - done);
+        uint64_t data = (diffInfo.storeData >> (done * 8)) & mask(n * 8);
+        diffStores.addr.push_back((addr + done) & ~Addr(0x7));
+        diffStores.data.push_back(data << (offset * 8));
+        diffStores.mask.push_back(((1 << n) - 1) << offset);
+        diffStores.seq.push_back(seq);
+        done += n;
+    }
+}
+
+int
+BaseCPU::diffStoreCommits()
+{
+    int n = diffStores.addr.size();
+    int diff_at = NoneDiff;
+    if (n == 0)
+        return diff_at;
+
+    std::vector<uint64_t> dut_addr = diffStores.addr;
+    std::vector<uint64_t> dut_data = diffStores.data;
+    std::vector<uint8_t> dut_mask = diffStores.mask;
+    int bad = diffAllStates->proxy->storeCommit(diffStores.addr.data(), diffStores.data.data(),
+                                                diffStores.mask.data(), n);
+    if (bad) {
+        int i = bad - 1;
+        diffMsg << csprintf("Store commit mismatch at [sn:%lli], %d of %d in batch\n",
+                            diffStores.seq[i], i, n);
+        diffMsg << csprintf("  Ref  addr: %#lx, data: %#lx, mask: %#x\n", diffStores.addr[i],
+                            diffStores.data[i], diffStores.mask[i]);
+        diffMsg << csprintf("  GEM5 addr: %#lx, data: %#lx, mask: %#x\n", dut_addr[i],
+                            dut_data[i], dut_mask[i]);
+        diff_at = ValueDiff;
+    }
+    diffStores.addr.clear();
+    diffStores.data.clear();
+    diffStores.mask.clear();
+    diffStores.seq.clear();
+    return diff_at;
+}
+
+void
+BaseCPU::flushDiffStores()
+{
+    if (!enableDifftest || diffStores.addr.empty())
+        return;
+    if (diffStoreCommits() != NoneDiff) {
+        reportDiffMismatch(0, 0);
+        panic("Difftest failed on queued stores!\n");
+    }
+}
+
 void
 BaseCPU::clearDiffMismatch(ThreadID tid, InstSeqNum seq) {
     diffMsg.str(std::string());
@@ -273,11 +273,7 @@ class BaseCPU : public ClockedObject
 
     void postInterrupt(ThreadID tid, int int_num, int index);
 
-    void
-    clearInterrupt(ThreadID tid, int int_num, int index)
-    {
-        interrupts[tid]->clear(int_num, index);
-    }
+    void clearInterrupt(ThreadID tid, int int_num, int index);
 
     void
     clearInterrupts(ThreadID tid)
@@ -714,6 +710,24 @@ class BaseCPU : public ClockedObject
     void reportDiffMismatch(ThreadID tid, InstSeqNum seq);
     void clearDiffMismatch(ThreadID tid, InstSeqNum seq);
 
+    /** Number of committed stores checked against the ref per call, 0 disables */
+    const unsigned diffStoreCommitBatch{0};
+
+    /** Committed stores waiting for diffStoreCommits() */
+    struct
+    {
+        std::vector<uint64_t> addr;
+        std::vector<uint64_t> data;
+        std::vector<uint8_t> mask;
+        std::vector<InstSeqNum> seq;
+    } diffStores;
+
+    void queueDiffStore(InstSeqNum seq);
+    /** @return DiffAt::ValueDiff on a store mismatch, NoneDiff otherwise */
+    int diffStoreCommits();
+    /** Check the queued stores now, at exit and on switch out. */
+    void flushDiffStores();
+
 
     // NoHype mode split memory space into distinct regions for different cores
     const bool noHypeMode{false};
@@ -744,6 +758,7 @@ class BaseCPU : public ClockedObject
         gem5::Addr effSize;
         uint8_t *goldenValue;
         uint64_t amoOldGoldenValue;
+        uint64_t storeData;
         // Register address causing difftest error
         bool errorRegsValue[diffAllNum];
         bool errorCsrsValue[diffCsrNum];  // CsrRegIndex
@@ -136,6 +136,130 @@ class AddrMap
     }
 };
 
+/// A sparse map from an instruction address to a Value, with one flat
+/// array of slots per page. Instructions are assumed to be aligned to
+/// 1 << SlotShift bytes, so a 4 KiB page with SlotShift = 1 (RVC) holds
+/// 2048 slots. Pages can be dropped individually when the code in them
+/// may have changed.
+template<class Value, Addr PageShift = 12, Addr SlotShift = 0>
+class PageMap
+{
+  protected:
+    static constexpr Addr PageBytes = 1ULL << PageShift;
+    static constexpr Addr SlotsPerPage = 1ULL << (PageShift - SlotShift);
+
+    static constexpr Addr
+    slotIndex(Addr addr)
+    {
+        return (addr & (PageBytes - 1)) >> SlotShift;
+    }
+
+    static constexpr Addr
+    pageStart(Addr addr)
+    {
+        return addr & ~(PageBytes - 1);
+    }
+
+    struct Page
+    {
+        Value slots[SlotsPerPage];
+    };
+    typedef typename std::unordered_map<Addr, Page *> PageTable;
+    typedef typename PageTable::iterator PageIt;
+    // Mini cache of recent lookups.
+    PageIt recent[2];
+    PageTable pages;
+
+    void
+    update(PageIt recentest)
+    {
+        recent[1] = recent[0];
+        recent[0] = recentest;
+    }
+
+    Page *
+    getPage(Addr addr)
+    {
+        Addr page_addr = pageStart(addr);
+
+        if (recent[0] != pages.end()) {
+            if (recent[0]->first == page_addr)
+                return recent[0]->second;
+            if (recent[1] != pages.end() && recent[1]->first == page_addr) {
+                update(recent[1]);
+                return recent[0]->second;
+            }
+        }
+
+        PageIt it = pages.find(page_addr);
+        if (it != pages.end()) {
+            update(it);
+            return it->second;
+        }
+
+        Page *new_page = new Page;
+        update(pages.emplace(page_addr, new_page).first);
+        return new_page;
+    }
+
+  public:
+    PageMap()
+    {
+        recent[0] = recent[1] = pages.end();
+    }
+
+    ~PageMap()
+    {
+        for (auto &p : pages)
+            delete p.second;
+    }
+
+    PageMap(const PageMap &) = delete;
+    PageMap &operator=(const PageMap &) = delete;
+
+    Value &
+    lookup(Addr addr)
+    {
+        return getPage(addr)->slots[slotIndex(addr)];
+    }
+
+    /// Drop every page overlapping [addr, addr + size).
+    /// @retval The number of pages dropped.
+    unsigned
+    invalidate(Addr addr, Addr size)
+    {
+        if (pages.empty() || size == 0)
+            return 0;
+        unsigned dropped = 0;
+        Addr last = pageStart(addr + size - 1);
+        for (Addr page_addr = pageStart(addr); ; page_addr += PageBytes) {
+            PageIt it = pages.find(page_addr);
+            if (it != pages.end()) {
+                delete it->second;
+                pages.erase(it);
+                dropped++;
+            }
+            if (page_addr == last)
+                break;
+        }
+        if (dropped)
+            recent[0] = recent[1] = pages.end();
+        return dropped;
+    }
+
+    /// Drop all pages.
+    void
+    clear()
+    {
+        for (auto &p : pages)
+            delete p.second;
+        pages.clear();
+        recent[0] = recent[1] = pages.end();
+    }
+
+    size_t numPages() const { return pages.size(); }
+};
+
 } // namespace decode_cache
 } // namespace gem5
 
@@ -66,6 +66,18 @@ skipPerfCntCsr()
     }
 }
 
+int
+RefProxy::storeCommit(uint64_t *saddr, uint64_t *sdata, uint8_t *smask, int n)
+{
+    if (store_commit_batch)
+        return store_commit_batch(saddr, sdata, smask, n);
+    for (int i = 0; i < n; i++) {
+        if (store_commit(&saddr[i], &sdata[i], &smask[i]))
+            return i + 1;
+    }
+    return 0;
+}
+
 NemuProxy::NemuProxy(int coreid, const char *ref_so, bool enable_sdcard_diff, bool enable_mem_dedup, bool multi_core)
 {
     handle = dlmopen(LM_ID_NEWLM, ref_so, RTLD_LAZY | RTLD_DEEPBIND);
@@ -115,6 +127,8 @@ NemuProxy::NemuProxy(int coreid, const char *ref_so, bool enable_sdcard_diff, bo
     store_commit = (int (*)(uint64_t *, uint64_t *, uint8_t *))dlsym(
         handle, "difftest_store_commit");
     assert(store_commit);
+    store_commit_batch = (int (*)(uint64_t *, uint64_t *, uint8_t *, int))dlsym(
+        handle, "difftest_store_commit_batch");
 
     raise_intr = (void (*)(uint64_t))dlsym(handle, "difftest_raise_intr");
     assert(raise_intr);
@@ -195,6 +209,8 @@ SpikeProxy::SpikeProxy(int coreid, const char *ref_so, bool enable_sdcard_diff)
     store_commit = (int (*)(uint64_t *, uint64_t *, uint8_t *))dlsym(
         handle, "difftest_store_commit");
     assert(store_commit);
+    store_commit_batch = (int (*)(uint64_t *, uint64_t *, uint8_t *, int))dlsym(
+        handle, "difftest_store_commit_batch");
 
     raise_intr = (void (*)(uint64_t))dlsym(handle, "difftest_raise_intr");
     assert(raise_intr);
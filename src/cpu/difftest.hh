@@ -185,6 +185,9 @@ class RefProxy
     void (*uarchstatus_cpy)(void *dut, bool direction) = nullptr;
     int (*store_commit)(uint64_t *saddr, uint64_t *sdata,
                         uint8_t *smask) = nullptr;
+    // Optional, checks n stores in one call
+    int (*store_commit_batch)(uint64_t *saddr, uint64_t *sdata,
+                              uint8_t *smask, int n) = nullptr;
     void (*exec)(uint64_t n) = nullptr;
     vaddr_t (*guided_exec)(void *disambiguate_para) = nullptr;
     vaddr_t (*update_config)(void *config) = nullptr;
@@ -196,6 +199,14 @@ class RefProxy
                         const char *sd_cpt_bin_path) = nullptr;
     virtual void initState(int coreid, uint8_t *golden_mem) = 0;
 
+    /**
+     * Check n committed stores against the ref, with 8-byte aligned
+     * addresses and data and byte masks shifted to match. On a mismatch
+     * the ref's store is written back into that slot.
+     * @return 1 + the index of the first mismatching store, or 0
+     */
+    int storeCommit(uint64_t *saddr, uint64_t *sdata, uint8_t *smask, int n);
+
   protected:
     bool multiCore;
 
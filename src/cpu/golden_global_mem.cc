@@ -18,11 +18,17 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
+#include "sim/byteswap.hh"
 #include "mem/mem_util.hh"
 
 namespace gem5
@@ -54,25 +60,84 @@ GoldenGloablMem::goldenMemFinish()
     // do nothing because memory is released in dedupMemManager
 }
 
+namespace
+{
+
+// Byte mask to 64-bit blend mask, e.g. 0b101 -> 0x0000000000ff00ff
+constexpr std::array<uint64_t, 256>
+makeBlendTable()
+{
+    std::array<uint64_t, 256> table{};
+    for (int m = 0; m < 256; m++) {
+        for (int b = 0; b < 8; b++) {
+            if (m & (1 << b))
+                table[m] |= 0xffULL << (b * 8);
+        }
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, 256> blendTable = makeBlendTable();
+
+} // anonymous namespace
+
 void
 GoldenGloablMem::updateGoldenMem(uint64_t addr, void *data, uint64_t mask, int len)
 {
     uint8_t *dataArray = (uint8_t *)data;
-    for (int i = 0; i < len; i++) {
-        if (((mask >> i) & 1) != 0) {
-            pmemWriteCheck(addr + i, dataArray[i], 1);
+    if (len > 64 || !inPmem(addr) || !inPmem(addr + len - 1)) {
+        // Slow path, reports the first byte outside pmem
+        for (int i = 0; i < len; i++) {
+            if (((mask >> i) & 1) != 0) {
+                pmemWriteCheck(addr + i, dataArray[i], 1);
+            }
+        }
+        return;
+    }
+
+    uint8_t *dst = &goldenMem[addr - pmemBase];
+    for (int off = 0; off < len; off += 8) {
+        int n = std::min(8, len - off);
+        uint8_t m = (mask >> off) & (0xff >> (8 - n));
+        if (m == 0)
+            continue;
+#ifdef ENABLE_STORE_LOG
+        if (goldenmem_store_log_enable) {
+            // An unaligned chunk can touch two words, log both
+            Addr first = (addr + off + ctz64(m)) & ~Addr(0x7);
+            Addr last = (addr + off + floorLog2(m)) & ~Addr(0x7);
+            pmem_record_store(first);
+            if (last != first)
+                pmem_record_store(last);
+        }
+#endif  // ENABLE_STORE_LOG
+        if (m == (0xff >> (8 - n))) {
+            std::memcpy(dst + off, dataArray + off, n);
+            continue;
         }
+        uint64_t old_val = 0, new_val = 0;
+        std::memcpy(&old_val, dst + off, n);
+        std::memcpy(&new_val, dataArray + off, n);
+        old_val = letoh(old_val);
+        new_val = letoh(new_val);
+        uint64_t blend = blendTable[m];
+        old_val = htole((old_val & ~blend) | (new_val & blend));
+        std::memcpy(dst + off, &old_val, n);
     }
 }
 
 void
 GoldenGloablMem::updateGoldenMem(uint64_t addr, void *data, const std::vector<bool>& mask, int len)
 {
+    // Pack the byte enables into bit masks and reuse the word path
     uint8_t *dataArray = (uint8_t *)data;
-    for (int i = 0; i < len; i++) {
-        if (mask[i]) {
-            pmemWriteCheck(addr + i, dataArray[i], 1);
+    for (int base = 0; base < len; base += 64) {
+        int n = std::min(64, len - base);
+        uint64_t packed = 0;
+        for (int i = 0; i < n; i++) {
+            packed |= uint64_t(mask[base + i]) << i;
         }
+        updateGoldenMem(addr + base, dataArray + base, packed, n);
     }
 }
 
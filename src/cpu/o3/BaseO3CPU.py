@@ -71,7 +71,7 @@ class PerfRecord(ScopedEnum):
 
 class PerfDetail(ScopedEnum):
     vals = [
-        'pdst', 'psrcs', 'result', 'ldstAddr', 'cachemisslevel', 'arbfail'
+        'fetchstall', 'iqwait', 'arbfail', 'cachemisslevel', 'ldstaddr'
     ]
 
 class BaseO3CPU(BaseCPU):
@@ -141,6 +141,9 @@ class BaseO3CPU(BaseCPU):
     commitToRenameDelay = Param.Cycles(1, "Commit to rename delay")
     decodeToRenameDelay = Param.Cycles(1, "Decode to rename delay")
     renameWidth = Param.Unsigned(6, "Rename width")
+    numRenameCheckpoints = Param.Unsigned(0, "Number of rename map "
+            "checkpoints per thread taken at branches, restored in one step "
+            "on a squash (0: undo the history buffer entry by entry)")
 
     commitToIEWDelay = Param.Cycles(1, "Commit to "
                "Issue/Execute/Writeback delay")
@@ -196,6 +199,9 @@ class BaseO3CPU(BaseCPU):
     LSQCheckLoads = Param.Bool(True,
         "Should dependency violations be checked for "
         "loads & stores or just stores")
+    LSQAddrIndex = Param.Bool(True,
+        "Find the loads and stores an access may overlap through a "
+        "cache-line address index instead of scanning the queues")
     store_set_clear_period = Param.Unsigned(250000,
             "Number of load/store insts before the dep predictor "
             "should be invalidated")
@@ -249,8 +255,22 @@ class BaseO3CPU(BaseCPU):
     scheduler = Param.Scheduler("")
 
     arch_db = Param.ArchDBer(Parent.any, "Arch DB")
+    lifetime_sample_period = Param.Unsigned(0, "Record the lifetime of the "
+        "first lifetime_sample_burst of every this many instructions, "
+        "0 disables")
+    lifetime_sample_burst = Param.Unsigned(1, "Consecutive instructions "
+        "recorded per lifetime sample")
+    lifetime_sample_file = Param.String("", "SQLite file of the lifetime "
+        "samples in the output directory, <cpu name>.lifetime.db if empty")
 
     store_prefetch_train = Param.Bool(True, "Training store prefetcher with store addresses")
 
     enableConstantFolding = Param.Bool(False, "Enable Constant Folding (add-immediate elimination)")
     enableMovImmElimination = Param.Bool(False, "Enable MOVI elimination")
+
+    hotCounterSamplePeriod = Param.Unsigned(0, "Snapshot the hot pipeline "
+        "counters every N cycles (0 to disable)")
+    hotCounterSampleDepth = Param.Unsigned(4096, "Number of hot counter "
+        "snapshots kept in the ring buffer")
+    hotCounterSampleList = VectorParam.String([], "Hot counters to sample, "
+        "empty for all")
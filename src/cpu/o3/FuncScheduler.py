@@ -96,3 +96,9 @@ class Scheduler(SimObject):
     specWakeupNetwork = VectorParam.SpecWakeupChannel([], "")
     xbarWakeup = Param.Bool(False, "use xbar wakeup network, (will override specWakeupNetwork)")
     useOldDisp = Param.Bool(False, "Use old dispatch algorithm")
+    matrixScheduler = Param.Bool(False,
+        "Track wakeup and age-ordered select with bit matrices instead of "
+        "per-register consumer lists and sorted ready lists")
+    matrixCrossCheck = Param.Bool(False,
+        "Debug: with matrixScheduler, also keep the sorted ready lists and "
+        "panic if they would select a different instruction in any cycle")
@@ -0,0 +1,105 @@
+#include "cpu/o3/comm.hh"
+
+#include "cpu/o3/dyn_inst.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+namespace
+{
+
+/** Drop the instruction references held by a slot. */
+template <size_t N>
+void
+clearInsts(DynInstPtr (&insts)[N])
+{
+    for (auto &inst : insts) {
+        if (inst) {
+            inst = nullptr;
+        }
+    }
+}
+
+} // anonymous namespace
+
+void
+FetchStruct::reset()
+{
+    size = 0;
+    clearInsts(insts);
+    fetchFault = NoFault;
+    fetchFaultSN = 0;
+    clearFetchFault = false;
+    fetchStallReason.clear();
+}
+
+void
+DecodeStruct::reset()
+{
+    size = 0;
+    clearInsts(insts);
+    fetchStallReason.clear();
+    decodeStallReason.clear();
+}
+
+void
+RenameStruct::reset()
+{
+    size = 0;
+    clearInsts(insts);
+    fetchStallReason.clear();
+    decodeStallReason.clear();
+    renameStallReason.clear();
+}
+
+void
+IEWStruct::reset()
+{
+    size = 0;
+    clearInsts(insts);
+    clearInsts(mispredictInst);
+    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
+        mispredPC[tid] = 0;
+        squashedSeqNum[tid] = 0;
+        squashedStreamId[tid] = 0;
+        squashedTargetId[tid] = 0;
+        squashedLoopIter[tid] = 0;
+        pc[tid].reset();
+        squash[tid] = false;
+        branchMispredict[tid] = false;
+        branchTaken[tid] = false;
+        includeSquashInst[tid] = false;
+    }
+}
+
+void
+IssueStruct::reset()
+{
+    size = 0;
+    clearInsts(insts);
+}
+
+void
+TimeStruct::reset()
+{
+    // Value-initialisation zeroes the plain members just like the
+    // memset of a fresh slot; only PCs set by a squash own memory.
+    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
+        decodeInfo[tid] = DecodeComm();
+        renameInfo[tid] = RenameComm();
+        iewInfo[tid] = IewComm();
+        commitInfo[tid] = CommitComm();
+        decodeBlock[tid] = false;
+        decodeUnblock[tid] = false;
+        renameBlock[tid] = false;
+        renameUnblock[tid] = false;
+        iewBlock[tid] = false;
+        iewUnblock[tid] = false;
+    }
+}
+
+} // namespace o3
+} // namespace gem5
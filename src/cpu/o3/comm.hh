@@ -115,6 +115,9 @@ struct FetchStruct
     InstSeqNum fetchFaultSN;
     bool clearFetchFault;
     std::vector<StallReason> fetchStallReason;
+
+    /** Recycle the TimeBuffer slot, keeping the vector capacity. */
+    void reset();
 };
 
 /** Struct that defines the information passed from decode to rename. */
@@ -125,6 +128,9 @@ struct DecodeStruct
     DynInstPtr insts[MaxWidth];
     std::vector<StallReason> fetchStallReason;
     std::vector<StallReason> decodeStallReason;
+
+    /** Recycle the TimeBuffer slot, keeping the vector capacity. */
+    void reset();
 };
 
 /** Struct that defines the information passed from rename to IEW. */
@@ -136,6 +142,9 @@ struct RenameStruct
     std::vector<StallReason> fetchStallReason;
     std::vector<StallReason> decodeStallReason;
     std::vector<StallReason> renameStallReason;
+
+    /** Recycle the TimeBuffer slot, keeping the vector capacity. */
+    void reset();
 };
 
 /** Struct that defines the information passed from IEW to commit. */
@@ -156,6 +165,9 @@ struct IEWStruct
     bool branchMispredict[MaxThreads];
     bool branchTaken[MaxThreads];
     bool includeSquashInst[MaxThreads];
+
+    /** Recycle the TimeBuffer slot in place. */
+    void reset();
 };
 
 struct IssueStruct
@@ -163,6 +175,9 @@ struct IssueStruct
     int size;
 
     DynInstPtr insts[MaxWidth];
+
+    /** Recycle the TimeBuffer slot in place. */
+    void reset();
 };
 
 struct SquashVersion
@@ -328,6 +343,9 @@ struct TimeStruct
     bool renameUnblock[MaxThreads];
     bool iewBlock[MaxThreads];
     bool iewUnblock[MaxThreads];
+
+    /** Recycle the TimeBuffer slot in place. */
+    void reset();
 };
 
 } // namespace o3
@@ -198,6 +198,11 @@ Commit::Commit(CPU *_cpu, branch_prediction::BPredUnit *_bp, const BaseO3CPUPara
 
     cpu->schedule(stuckCheckEvent,
                    cpu->clockEdge(Cycles(40000)));
+
+    hotInstsCommitted = cpu->hotCounters.bind("commit.instsCommitted",
+                                              stats.instsCommitted);
+    hotOpsCommitted = cpu->hotCounters.bind("commit.opsCommitted",
+                                            stats.opsCommitted);
 }
 
 std::string Commit::name() const { return cpu->name() + ".commit"; }
@@ -1191,6 +1196,9 @@ Commit::commitInsts()
 
             if (commit_success) {
                 cpu->perfCCT->updateInstPos(head_inst->seqNum, PerfRecord::AtCommit);
+                if (head_inst->isMemRef()) {
+                    cpu->perfCCT->updateInstDetail(head_inst->seqNum, PerfDetail::ldstaddr, head_inst->physEffAddr);
+                }
                 cpu->perfCCT->commitMeta(head_inst->seqNum);
                 head_inst->printDisassemblyAndResult(cpu->name());
                 if (ismispred) {
@@ -1469,6 +1477,10 @@ Commit::diffInst(ThreadID tid, const DynInstPtr &inst) {
     cpu->diffInfo.physEffAddr = inst->physEffAddr;
     cpu->diffInfo.effSize = inst->effSize;
     cpu->diffInfo.goldenValue = inst->getGolden();
+    cpu->diffInfo.storeData = 0;
+    if (inst->isStore() && inst->memData && inst->effSize <= 8) {
+        memcpy(&cpu->diffInfo.storeData, inst->memData, inst->effSize);
+    }
     cpu->difftestStep(tid, inst->seqNum);
 }
 
@@ -1832,8 +1844,8 @@ Commit::updateComInstStats(const DynInstPtr &inst)
     ThreadID tid = inst->threadNumber;
 
     if (!inst->isMicroop() || inst->isLastMicroop())
-        stats.instsCommitted[tid]++;
-    stats.opsCommitted[tid]++;
+        cpu->hotCounters.inc(hotInstsCommitted + tid);
+    cpu->hotCounters.inc(hotOpsCommitted + tid);
 
     // To match the old model, don't count nops and instruction
     // prefetches towards the total commit count.
@@ -53,6 +53,7 @@
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/hot_counters.hh"
 #include "cpu/o3/iew.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/rename_map.hh"
@@ -571,6 +572,10 @@ class Commit
         statistics::Formula totalSquash;
     } stats;
 
+    /** Hot counter bases of the per-thread commit counts. */
+    HotCounters::Id hotInstsCommitted;
+    HotCounters::Id hotOpsCommitted;
+
     bool ismispred = false;
 
     Tick lastCommitTick;
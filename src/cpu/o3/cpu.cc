@@ -45,6 +45,7 @@
 #include <cassert>
 
 #include "arch/riscv/regs/misc.hh"
+#include "base/output.hh"
 #include "config/the_isa.hh"
 #include "cpu/activity.hh"
 #include "cpu/checker/cpu.hh"
@@ -64,6 +65,7 @@
 #include "debug/ValueCommit.hh"
 #include "enums/MemoryMode.hh"
 #include "sim/async.hh"
+#include "sim/core.hh"
 #include "sim/cur_tick.hh"
 #include "sim/full_system.hh"
 #include "sim/process.hh"
@@ -89,6 +91,8 @@ CPU::CPU(const BaseO3CPUParams &params)
       instcount(0),
 #endif
       removeInstsThisCycle(false),
+      hotCounters(name() + ".hotCounters"),
+      hotSampler(hotCounters),
       fetch(this, params),
       decode(this, params),
       rename(this, params),
@@ -123,7 +127,10 @@ CPU::CPU(const BaseO3CPUParams &params)
       system(params.system),
       lastRunningCycle(curCycle()),
       archDBer(params.arch_db),
-      perfCCT(new PerfCCT(params.arch_db && params.arch_db->dumpLifetime, params.arch_db)),
+      perfCCT(new PerfCCT(params.arch_db && params.arch_db->dumpLifetime, params.arch_db,
+                          params.lifetime_sample_period, params.lifetime_sample_burst,
+                          params.lifetime_sample_file.empty() ? params.name + ".lifetime.db"
+                                                              : params.lifetime_sample_file)),
       ipc_r("ipc", "", 1000, archDBer),
       cpi_r("cpi", "", 1000, archDBer),
       issueWidth(params.decodeWidth),
@@ -312,6 +319,44 @@ CPU::CPU(const BaseO3CPUParams &params)
         threadContexts.push_back(tc);
     }
 
+    hotIds.intRegfileReads =
+        hotCounters.bind("intRegfileReads", cpuStats.intRegfileReads);
+    hotIds.intRegfileWrites =
+        hotCounters.bind("intRegfileWrites", cpuStats.intRegfileWrites);
+    hotIds.fpRegfileReads =
+        hotCounters.bind("fpRegfileReads", cpuStats.fpRegfileReads);
+    hotIds.fpRegfileWrites =
+        hotCounters.bind("fpRegfileWrites", cpuStats.fpRegfileWrites);
+    hotIds.vecRegfileReads =
+        hotCounters.bind("vecRegfileReads", cpuStats.vecRegfileReads);
+    hotIds.vecRegfileWrites =
+        hotCounters.bind("vecRegfileWrites", cpuStats.vecRegfileWrites);
+    hotIds.vecPredRegfileReads =
+        hotCounters.bind("vecPredRegfileReads", cpuStats.vecPredRegfileReads);
+    hotIds.vecPredRegfileWrites =
+        hotCounters.bind("vecPredRegfileWrites",
+                         cpuStats.vecPredRegfileWrites);
+    hotIds.ccRegfileReads =
+        hotCounters.bind("ccRegfileReads", cpuStats.ccRegfileReads);
+    hotIds.ccRegfileWrites =
+        hotCounters.bind("ccRegfileWrites", cpuStats.ccRegfileWrites);
+    hotIds.miscRegfileReads =
+        hotCounters.bind("miscRegfileReads", cpuStats.miscRegfileReads);
+    hotIds.miscRegfileWrites =
+        hotCounters.bind("miscRegfileWrites", cpuStats.miscRegfileWrites);
+
+    hotSampler.init(params.hotCounterSamplePeriod,
+                    params.hotCounterSampleDepth,
+                    params.hotCounterSampleList);
+    if (hotSampler.enabled()) {
+        registerExitCallback([this]() {
+            auto out_handle = simout.create(name() + ".hotcounters.csv",
+                                            false, true);
+            hotSampler.dump(*out_handle->stream());
+            simout.close(out_handle);
+        });
+    }
+
     // O3CPU always requires an interrupt controller.
     if (!params.switched_out && interrupts.empty()) {
         fatal("O3CPU %s has no interrupt controller.\n"
@@ -551,7 +596,10 @@ CPU::tick()
     ++baseStats.numCycles;
     ipc_r.roll(1);
     cpi_r++;
+    if (archDBer)
+        archDBer->cpuCycle();
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
+    hotSampler.tick(curCycle());
 
 //    activity = false;
 
@@ -620,6 +668,21 @@ CPU::init()
     commit.setThreads(thread);
 }
 
+void
+CPU::preDumpStats()
+{
+    hotCounters.fold();
+    BaseCPU::preDumpStats();
+}
+
+void
+CPU::resetStats()
+{
+    BaseCPU::resetStats();
+    hotCounters.reset();
+    hotSampler.clear();
+}
+
 void
 CPU::startup()
 {
@@ -1121,7 +1184,7 @@ CPU::readMiscRegNoEffect(int misc_reg, ThreadID tid) const
 RegVal
 CPU::readMiscReg(int misc_reg, ThreadID tid)
 {
-    cpuStats.miscRegfileReads++;
+    hotCounters.inc(hotIds.miscRegfileReads);
     return isa[tid]->readMiscReg(misc_reg);
 }
 
@@ -1134,7 +1197,7 @@ CPU::setMiscRegNoEffect(int misc_reg, RegVal val, ThreadID tid)
 void
 CPU::setMiscReg(int misc_reg, RegVal val, ThreadID tid)
 {
-    cpuStats.miscRegfileWrites++;
+    hotCounters.inc(hotIds.miscRegfileWrites);
     isa[tid]->setMiscReg(misc_reg, val);
 }
 
@@ -1143,20 +1206,20 @@ CPU::getReg(PhysRegIdPtr phys_reg)
 {
     switch (phys_reg->classValue()) {
       case IntRegClass:
-        cpuStats.intRegfileReads++;
+        hotCounters.inc(hotIds.intRegfileReads);
         break;
       case FloatRegClass:
-        cpuStats.fpRegfileReads++;
+        hotCounters.inc(hotIds.fpRegfileReads);
         break;
       case CCRegClass:
-        cpuStats.ccRegfileReads++;
+        hotCounters.inc(hotIds.ccRegfileReads);
         break;
       case VecRegClass:
       case VecElemClass:
-        cpuStats.vecRegfileReads++;
+        hotCounters.inc(hotIds.vecRegfileReads);
         break;
       case VecPredRegClass:
-        cpuStats.vecPredRegfileReads++;
+        hotCounters.inc(hotIds.vecPredRegfileReads);
         break;
       default:
         break;
@@ -1169,20 +1232,20 @@ CPU::getReg(VirtRegId virt_reg)
 {
     switch (virt_reg.PhyReg()->classValue()) {
       case IntRegClass:
-        cpuStats.intRegfileReads++;
+        hotCounters.inc(hotIds.intRegfileReads);
         break;
       case FloatRegClass:
-        cpuStats.fpRegfileReads++;
+        hotCounters.inc(hotIds.fpRegfileReads);
         break;
       case CCRegClass:
-        cpuStats.ccRegfileReads++;
+        hotCounters.inc(hotIds.ccRegfileReads);
         break;
       case VecRegClass:
       case VecElemClass:
-        cpuStats.vecRegfileReads++;
+        hotCounters.inc(hotIds.vecRegfileReads);
         break;
       case VecPredRegClass:
-        cpuStats.vecPredRegfileReads++;
+        hotCounters.inc(hotIds.vecPredRegfileReads);
         break;
       default:
         break;
@@ -1195,20 +1258,20 @@ CPU::getReg(PhysRegIdPtr phys_reg, void *val)
 {
     switch (phys_reg->classValue()) {
       case IntRegClass:
-        cpuStats.intRegfileReads++;
+        hotCounters.inc(hotIds.intRegfileReads);
         break;
       case FloatRegClass:
-        cpuStats.fpRegfileReads++;
+        hotCounters.inc(hotIds.fpRegfileReads);
         break;
       case CCRegClass:
-        cpuStats.ccRegfileReads++;
+        hotCounters.inc(hotIds.ccRegfileReads);
         break;
       case VecRegClass:
       case VecElemClass:
-        cpuStats.vecRegfileReads++;
+        hotCounters.inc(hotIds.vecRegfileReads);
         break;
       case VecPredRegClass:
-        cpuStats.vecPredRegfileReads++;
+        hotCounters.inc(hotIds.vecPredRegfileReads);
         break;
       default:
         break;
@@ -1221,10 +1284,10 @@ CPU::getWritableReg(PhysRegIdPtr phys_reg)
 {
     switch (phys_reg->classValue()) {
       case VecRegClass:
-        cpuStats.vecRegfileReads++;
+        hotCounters.inc(hotIds.vecRegfileReads);
         break;
       case VecPredRegClass:
-        cpuStats.vecPredRegfileReads++;
+        hotCounters.inc(hotIds.vecPredRegfileReads);
         break;
       default:
         break;
@@ -1237,20 +1300,20 @@ CPU::setReg(PhysRegIdPtr phys_reg, RegVal val)
 {
     switch (phys_reg->classValue()) {
       case IntRegClass:
-        cpuStats.intRegfileWrites++;
+        hotCounters.inc(hotIds.intRegfileWrites);
         break;
       case FloatRegClass:
-        cpuStats.fpRegfileWrites++;
+        hotCounters.inc(hotIds.fpRegfileWrites);
         break;
       case CCRegClass:
-        cpuStats.ccRegfileWrites++;
+        hotCounters.inc(hotIds.ccRegfileWrites);
         break;
       case VecRegClass:
       case VecElemClass:
-        cpuStats.vecRegfileWrites++;
+        hotCounters.inc(hotIds.vecRegfileWrites);
         break;
       case VecPredRegClass:
-        cpuStats.vecPredRegfileWrites++;
+        hotCounters.inc(hotIds.vecPredRegfileWrites);
         break;
       default:
         break;
@@ -1263,20 +1326,20 @@ CPU::setReg(PhysRegIdPtr phys_reg, const void *val)
 {
     switch (phys_reg->classValue()) {
       case IntRegClass:
-        cpuStats.intRegfileWrites++;
+        hotCounters.inc(hotIds.intRegfileWrites);
         break;
       case FloatRegClass:
-        cpuStats.fpRegfileWrites++;
+        hotCounters.inc(hotIds.fpRegfileWrites);
         break;
       case CCRegClass:
-        cpuStats.ccRegfileWrites++;
+        hotCounters.inc(hotIds.ccRegfileWrites);
         break;
       case VecRegClass:
       case VecElemClass:
-        cpuStats.vecRegfileWrites++;
+        hotCounters.inc(hotIds.vecRegfileWrites);
         break;
       case VecPredRegClass:
-        cpuStats.vecPredRegfileWrites++;
+        hotCounters.inc(hotIds.vecPredRegfileWrites);
         break;
       default:
         break;
@@ -1356,6 +1419,8 @@ CPU::instDone(ThreadID tid, const DynInstPtr &inst)
         cpuStats.committedInsts[tid]++;
         ipc_r++;
         cpi_r.roll(1);
+        if (archDBer)
+            archDBer->commitInst(inst->pcState().instAddr());
 
         if (this->nextDumpInstCount
                 && totalInsts() == this->nextDumpInstCount) {
@@ -1728,7 +1793,7 @@ RegVal
 CPU::readArchIntReg(int reg_idx, ThreadID tid)
 {
 
-    cpuStats.intRegfileReads++;
+    hotCounters.inc(hotIds.intRegfileReads);
     PhysRegIdPtr phys_reg =
         commitRenameMap[tid].lookup(RegId(IntRegClass, reg_idx)).PhyReg();
 
@@ -1740,7 +1805,7 @@ CPU::readArchIntReg(int reg_idx, ThreadID tid)
 RegVal
 CPU::readArchFloatReg(int reg_idx, ThreadID tid)
 {
-    cpuStats.fpRegfileReads++;
+    hotCounters.inc(hotIds.fpRegfileReads);
     PhysRegIdPtr phys_reg =
         commitRenameMap[tid].lookup(RegId(FloatRegClass, reg_idx)).PhyReg();
     DPRINTF(Commit, "Get map: f%i -> p%i\n", reg_idx, phys_reg->flatIndex());
@@ -1751,7 +1816,7 @@ CPU::readArchFloatReg(int reg_idx, ThreadID tid)
 void
 CPU::readArchVecReg(int reg_idx, uint64_t *val,ThreadID tid)
 {
-    cpuStats.vecRegfileReads++;
+    hotCounters.inc(hotIds.vecRegfileReads);
     PhysRegIdPtr phys_reg =
         commitRenameMap[tid].lookup(RegId(VecRegClass, reg_idx)).PhyReg();
     DPRINTF(Commit, "Get map: v%i -> p%i\n", reg_idx, phys_reg->flatIndex());
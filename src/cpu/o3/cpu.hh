@@ -62,6 +62,7 @@
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/fetch.hh"
 #include "cpu/o3/free_list.hh"
+#include "cpu/o3/hot_counters.hh"
 #include "cpu/o3/iew.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/perfCCT.hh"
@@ -207,6 +208,11 @@ class CPU : public BaseCPU
 
     void startup() override;
 
+    /** Fold the hot counters into their stats before they are dumped. */
+    void preDumpStats() override;
+
+    void resetStats() override;
+
     /** Returns the Number of Active Threads in the CPU */
     int
     numActiveThreads()
@@ -428,6 +434,13 @@ class CPU : public BaseCPU
      */
     bool removeInstsThisCycle;
 
+    /** Plain counters for per-cycle stats, folded into the stats at dump.
+     *  Declared before the stages so that they can bind in their ctors. */
+    HotCounters hotCounters;
+
+    /** Optional time series of selected hot counters. */
+    HotCounterSampler hotSampler;
+
   protected:
     /** The fetch stage. */
     Fetch fetch;
@@ -691,6 +704,23 @@ class CPU : public BaseCPU
         statistics::Scalar lastCommitTick;
     } cpuStats;
 
+    /** Hot counter ids of the regfile access stats above. */
+    struct
+    {
+        HotCounters::Id intRegfileReads;
+        HotCounters::Id intRegfileWrites;
+        HotCounters::Id fpRegfileReads;
+        HotCounters::Id fpRegfileWrites;
+        HotCounters::Id vecRegfileReads;
+        HotCounters::Id vecRegfileWrites;
+        HotCounters::Id vecPredRegfileReads;
+        HotCounters::Id vecPredRegfileWrites;
+        HotCounters::Id ccRegfileReads;
+        HotCounters::Id ccRegfileWrites;
+        HotCounters::Id miscRegfileReads;
+        HotCounters::Id miscRegfileWrites;
+    } hotIds;
+
   public:
     // hardware transactional memory
     void htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
@@ -453,6 +453,8 @@ class DynInst : public ExecContext, public RefCounted
     IssueQue* issueQue = nullptr;
     int issueportid = -1;
     int iqtag = -1;
+    /** Slot in the issue queue's IssueMatrix, if it uses one. */
+    int iqSlot = -1;
 
   public:
     /** Records changes to result? */
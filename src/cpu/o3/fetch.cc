@@ -161,6 +161,9 @@ Fetch::Fetch(CPU *_cpu, const BaseO3CPUParams &params)
     // Get the size of an instruction.
     // stallReason size should be the same as decodeWidth,renameWidth,dispWidth
     stallReason.resize(decodeWidth, StallReason::NoStall);
+
+    hotFetchStatusDist = cpu->hotCounters.bind("fetch.fetchStatusDist",
+                                               fetchStats.fetchStatusDist);
 }
 
 std::string Fetch::name() const { return cpu->name() + ".fetch"; }
@@ -440,7 +443,7 @@ Fetch::handleMultiCacheLineFetch(Addr vaddr, ThreadID tid, Addr pc)
             tid, fetchPC, fetchSize);
 
     // Create and send first request (tail of first cache line)
-    RequestPtr first_mem_req = std::make_shared<Request>(
+    RequestPtr first_mem_req = makeRequest(
         fetchPC, fetchSize,
         Request::INST_FETCH, cpu->instRequestorId(), pc,
         cpu->thread[tid]->contextId());
@@ -467,7 +470,7 @@ Fetch::handleMultiCacheLineFetch(Addr vaddr, ThreadID tid, Addr pc)
             tid, fetchPC, fetchSize);
 
     // Create and send second request
-    RequestPtr second_mem_req = std::make_shared<Request>(
+    RequestPtr second_mem_req = makeRequest(
         fetchPC, fetchSize,
         Request::INST_FETCH, cpu->instRequestorId(), pc,
         cpu->thread[tid]->contextId());
@@ -1225,7 +1228,7 @@ Fetch::initializeTickState()
     wroteToTimeBuffer = false;
 
     // get the distribution of fetch status
-    fetchStats.fetchStatusDist[fetchStatus[0]]++;
+    cpu->hotCounters.inc(hotFetchStatusDist + fetchStatus[0]);
 
     // Check signal updates for all active threads
     while (threads != end) {
@@ -1375,6 +1378,9 @@ Fetch::updateStallReasons(unsigned insts_to_decode, ThreadID tid)
     }
 
     toDecode->fetchStallReason = stallReason;
+    if (insts_to_decode == 0) {
+        lastFullStall = stallReason[0];
+    }
 }
 
 void
@@ -1708,6 +1714,7 @@ Fetch::buildInst(ThreadID tid, StaticInstPtr staticInst,
 
     cpu->perfCCT->createMeta(instruction);
     cpu->perfCCT->updateInstPos(instruction->seqNum, PerfRecord::AtFetch);
+    cpu->perfCCT->updateInstDetail(instruction->seqNum, PerfDetail::fetchstall, lastFullStall);
 
     instruction->setTid(tid);
 
@@ -50,6 +50,7 @@
 #include "config/the_isa.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/hot_counters.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/pc_event.hh"
 #include "cpu/pred/bpred_unit.hh"
@@ -953,6 +954,9 @@ class Fetch
     /** fetch stall reasons */
     std::vector<StallReason> stallReason;
 
+    /** Reason of the last fully stalled cycle, kept until the next one */
+    StallReason lastFullStall = StallReason::NoStall;
+
     bool currentFetchTargetInLoop{false};
 
     std::pair<Addr, std::vector<branch_prediction::ftb_pred::LoopBuffer::InstDesc>> currentFtqEntryInsts;
@@ -1092,6 +1096,9 @@ class Fetch
         statistics::Formula frontendBandwidthBound;
     } fetchStats;
 
+    /** Hot counter base of fetchStatusDist. */
+    HotCounters::Id hotFetchStatusDist;
+
     SquashVersion localSquashVer;
 
 public:
@@ -46,6 +46,7 @@
 #include <array>
 #include <iostream>
 #include <queue>
+#include <vector>
 
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -183,6 +184,14 @@ class UnifiedFreeList
         freeLists[freed_reg->classValue()].addReg(freed_reg);
     }
 
+    /** Adds a set of registers back to the free lists, in order. */
+    void
+    addRegs(const std::vector<PhysRegIdPtr> &freed_regs)
+    {
+        for (auto reg : freed_regs)
+            addReg(reg);
+    }
+
     /** Checks if there are any free registers of type type. */
     bool
     hasFreeRegs(RegClassType type) const
@@ -0,0 +1,152 @@
+#include "cpu/o3/hot_counters.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+namespace o3
+{
+
+HotCounters::Id
+HotCounters::bind(const std::string &name, statistics::Scalar &stat)
+{
+    Id id = counts.size();
+    bindings.push_back({name, &stat, nullptr, 0});
+    counts.push_back(0);
+    folded.push_back(0);
+    return id;
+}
+
+HotCounters::Id
+HotCounters::bind(const std::string &name, statistics::Vector &stat)
+{
+    panic_if(stat.size() == 0,
+             "%s: vector stat %s must be initialised before binding\n",
+             _name, name);
+    Id base = counts.size();
+    for (unsigned i = 0; i < stat.size(); i++) {
+        bindings.push_back({name + "::" + std::to_string(i), nullptr,
+                            &stat, i});
+        counts.push_back(0);
+        folded.push_back(0);
+    }
+    return base;
+}
+
+void
+HotCounters::fold()
+{
+    for (Id id = 0; id < counts.size(); id++) {
+        uint64_t delta = counts[id] - folded[id];
+        if (delta == 0) {
+            continue;
+        }
+        const Binding &b = bindings[id];
+        if (b.scalar) {
+            *b.scalar += delta;
+        } else {
+            (*b.vector)[b.index] += delta;
+        }
+        folded[id] = counts[id];
+    }
+}
+
+void
+HotCounters::reset()
+{
+    std::fill(counts.begin(), counts.end(), 0);
+    std::fill(folded.begin(), folded.end(), 0);
+}
+
+bool
+HotCounters::find(const std::string &name, Id &id) const
+{
+    for (Id i = 0; i < bindings.size(); i++) {
+        if (bindings[i].name == name) {
+            id = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+HotCounterSampler::init(unsigned _period, unsigned _depth,
+                        const std::vector<std::string> &names)
+{
+    period = _period;
+    countdown = _period;
+    depth = _depth;
+    if (!period) {
+        return;
+    }
+    fatal_if(depth == 0, "%s: hot counter sample depth must be non-zero\n",
+             counters.name());
+
+    selected.clear();
+    if (names.empty()) {
+        for (HotCounters::Id id = 0; id < counters.size(); id++) {
+            selected.push_back(id);
+        }
+    } else {
+        for (const auto &name : names) {
+            HotCounters::Id id;
+            fatal_if(!counters.find(name, id),
+                     "%s: unknown hot counter '%s'\n", counters.name(), name);
+            selected.push_back(id);
+        }
+    }
+
+    ring.assign((size_t)depth * selected.size(), 0);
+    ringCycles.assign(depth, Cycles(0));
+    head = 0;
+    valid = 0;
+}
+
+void
+HotCounterSampler::sample(Cycles now)
+{
+    uint64_t *row = &ring[(size_t)head * selected.size()];
+    for (size_t i = 0; i < selected.size(); i++) {
+        row[i] = counters.value(selected[i]);
+    }
+    ringCycles[head] = now;
+    head = head + 1 == depth ? 0 : head + 1;
+    if (valid < depth) {
+        valid++;
+    }
+}
+
+void
+HotCounterSampler::dump(std::ostream &os) const
+{
+    os << "cycle";
+    for (auto id : selected) {
+        os << "," << counters.counterName(id);
+    }
+    os << "\n";
+
+    unsigned row = valid < depth ? 0 : head;
+    for (unsigned n = 0; n < valid; n++) {
+        os << (uint64_t)ringCycles[row];
+        const uint64_t *vals = &ring[(size_t)row * selected.size()];
+        for (size_t i = 0; i < selected.size(); i++) {
+            os << "," << vals[i];
+        }
+        os << "\n";
+        row = row + 1 == depth ? 0 : row + 1;
+    }
+}
+
+void
+HotCounterSampler::clear()
+{
+    head = 0;
+    valid = 0;
+    countdown = period;
+}
+
+} // namespace o3
+} // namespace gem5
@@ -0,0 +1,141 @@
+#ifndef __CPU_O3_HOT_COUNTERS_HH__
+#define __CPU_O3_HOT_COUNTERS_HH__
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+namespace o3
+{
+
+/**
+ * Per-CPU block of plain counters for stats that are bumped every cycle
+ * (or several times per cycle) by the pipeline stages. Each counter is
+ * bound to a registered gem5 stat (a Scalar or one element of a Vector)
+ * and is only folded into it when the stats are dumped, so the hot path
+ * is a single array increment.
+ *
+ * Stages bind their counters once at construction time and keep the
+ * returned Id; vector stats occupy a contiguous range of ids starting at
+ * the returned base.
+ */
+class HotCounters
+{
+  public:
+    using Id = uint32_t;
+
+    HotCounters(const std::string &name) : _name(name) {}
+
+    /** Bind a new counter to a scalar stat. */
+    Id bind(const std::string &name, statistics::Scalar &stat);
+
+    /**
+     * Bind one counter per element of an (already initialised) vector
+     * stat. @return the id of element 0.
+     */
+    Id bind(const std::string &name, statistics::Vector &stat);
+
+    void inc(Id id) { counts[id]++; }
+    void inc(Id id, uint64_t delta) { counts[id] += delta; }
+
+    /** Cumulative value since the last stats reset. */
+    uint64_t value(Id id) const { return counts[id]; }
+
+    /** Push everything counted since the last fold into the stats. */
+    void fold();
+
+    /** Called when the stats are reset. */
+    void reset();
+
+    size_t size() const { return counts.size(); }
+
+    const std::string &counterName(Id id) const { return bindings[id].name; }
+
+    /** @return true and set id if a counter with that name exists. */
+    bool find(const std::string &name, Id &id) const;
+
+    const std::string &name() const { return _name; }
+
+  private:
+    struct Binding
+    {
+        std::string name;
+        statistics::Scalar *scalar;
+        statistics::Vector *vector;
+        unsigned index;
+    };
+
+    std::string _name;
+
+    std::vector<uint64_t> counts;
+    /** Value of each counter at the last fold. */
+    std::vector<uint64_t> folded;
+    std::vector<Binding> bindings;
+};
+
+/**
+ * Snapshots a chosen subset of HotCounters every N cycles into a ring
+ * buffer, giving a cheap time series of pipeline events that can be
+ * exported at the end of the run. Once the ring is full the oldest
+ * samples are overwritten.
+ */
+class HotCounterSampler
+{
+  public:
+    HotCounterSampler(const HotCounters &counters) : counters(counters) {}
+
+    /**
+     * @param period Sample interval in cycles, 0 disables sampling.
+     * @param depth Number of samples kept in the ring.
+     * @param names Counters to sample, empty means all bound counters.
+     */
+    void init(unsigned period, unsigned depth,
+              const std::vector<std::string> &names);
+
+    bool enabled() const { return period != 0; }
+
+    /** Called once per CPU cycle. */
+    void
+    tick(Cycles now)
+    {
+        if (period && --countdown == 0) {
+            countdown = period;
+            sample(now);
+        }
+    }
+
+    /** Write the ring as CSV, oldest sample first. */
+    void dump(std::ostream &os) const;
+
+    /** Drop all samples, e.g. on stats reset. */
+    void clear();
+
+  private:
+    void sample(Cycles now);
+
+    const HotCounters &counters;
+
+    unsigned period = 0;
+    unsigned countdown = 0;
+    unsigned depth = 0;
+
+    std::vector<HotCounters::Id> selected;
+
+    /** depth rows of selected.size() values. */
+    std::vector<uint64_t> ring;
+    std::vector<Cycles> ringCycles;
+    /** Next row to write and number of valid rows. */
+    unsigned head = 0;
+    unsigned valid = 0;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_HOT_COUNTERS_HH__
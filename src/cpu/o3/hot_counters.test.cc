@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <sstream>
+
+#include "base/statistics.hh"
+#include "cpu/o3/hot_counters.hh"
+#include "sim/root.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+// Stat name lookups in statistics.cc go through the Root, which a unit test
+// does not create
+Root *Root::_root = nullptr;
+
+namespace
+{
+
+/** The stats a stage bumps, once through HotCounters, once directly. */
+struct StageStats : public statistics::Group
+{
+    statistics::Scalar hotScalar;
+    statistics::Vector hotVector;
+    statistics::Scalar refScalar;
+    statistics::Vector refVector;
+
+    StageStats()
+        : statistics::Group(nullptr),
+          ADD_STAT(hotScalar, statistics::units::Count::get(), ""),
+          ADD_STAT(hotVector, statistics::units::Count::get(), ""),
+          ADD_STAT(refScalar, statistics::units::Count::get(), ""),
+          ADD_STAT(refVector, statistics::units::Count::get(), "")
+    {
+        hotVector.init(4);
+        refVector.init(4);
+    }
+};
+
+} // anonymous namespace
+
+TEST(HotCountersTest, FoldMatchesDirectStats)
+{
+    StageStats stats;
+    HotCounters counters("cpu.hotCounters");
+    HotCounters::Id scalar = counters.bind("scalar", stats.hotScalar);
+    HotCounters::Id vector = counters.bind("vector", stats.hotVector);
+    ASSERT_EQ(counters.size(), 5);
+
+    std::mt19937 rng(1);
+    for (int fold = 0; fold < 10; fold++) {
+        for (int i = 0; i < 1000; i++) {
+            unsigned idx = rng() % 4;
+            unsigned delta = rng() % 3;
+            counters.inc(scalar);
+            stats.refScalar++;
+            counters.inc(vector + idx, delta);
+            stats.refVector[idx] += delta;
+        }
+        counters.fold();
+        // Folding again must not count anything twice
+        counters.fold();
+        EXPECT_EQ(stats.hotScalar.value(), stats.refScalar.value());
+        for (unsigned i = 0; i < 4; i++) {
+            EXPECT_EQ(stats.hotVector[i].value(), stats.refVector[i].value());
+            EXPECT_EQ(counters.value(vector + i), stats.refVector[i].value());
+        }
+    }
+
+    // A stats reset clears the stats and the counters together
+    stats.resetStats();
+    counters.reset();
+    EXPECT_EQ(counters.value(scalar), 0);
+    counters.inc(scalar, 7);
+    counters.fold();
+    EXPECT_EQ(stats.hotScalar.value(), 7);
+}
+
+TEST(HotCountersTest, FindByName)
+{
+    StageStats stats;
+    HotCounters counters("cpu.hotCounters");
+    counters.bind("scalar", stats.hotScalar);
+    HotCounters::Id vector = counters.bind("vector", stats.hotVector);
+
+    HotCounters::Id id;
+    ASSERT_TRUE(counters.find("vector::2", id));
+    EXPECT_EQ(id, vector + 2);
+    EXPECT_EQ(counters.counterName(id), "vector::2");
+    EXPECT_FALSE(counters.find("vector", id));
+}
+
+TEST(HotCountersTest, SamplerKeepsLastRows)
+{
+    StageStats stats;
+    HotCounters counters("cpu.hotCounters");
+    HotCounters::Id scalar = counters.bind("scalar", stats.hotScalar);
+    counters.bind("vector", stats.hotVector);
+
+    HotCounterSampler sampler(counters);
+    sampler.init(2, 2, {"scalar"});
+    ASSERT_TRUE(sampler.enabled());
+    for (unsigned cycle = 1; cycle <= 7; cycle++) {
+        counters.inc(scalar);
+        sampler.tick(Cycles(cycle));
+    }
+
+    // Samples at cycles 2, 4 and 6, the ring keeps the last two
+    std::ostringstream os;
+    sampler.dump(os);
+    EXPECT_EQ(os.str(), "cycle,scalar\n4,4\n6,6\n");
+
+    sampler.clear();
+    std::ostringstream empty;
+    sampler.dump(empty);
+    EXPECT_EQ(empty.str(), "cycle,scalar\n");
+}
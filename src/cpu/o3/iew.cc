@@ -120,6 +120,14 @@ IEW::IEW(CPU *_cpu, const BaseO3CPUParams &params)
 
     dispatchStalls.resize(renameWidth, StallReason::NoStall);
 
+    hotFetchStallReason = cpu->hotCounters.bind(
+        "iew.fetchStallReason", iewStats.fetchStallReason);
+    hotDecodeStallReason = cpu->hotCounters.bind(
+        "iew.decodeStallReason", iewStats.decodeStallReason);
+    hotRenameStallReason = cpu->hotCounters.bind(
+        "iew.renameStallReason", iewStats.renameStallReason);
+    hotDispatchStallReason = cpu->hotCounters.bind(
+        "iew.dispatchStallReason", iewStats.dispatchStallReason);
 }
 
 std::string
@@ -1856,15 +1864,15 @@ void
 IEW::tick()
 {
     for (int i = 0;i < fromRename->fetchStallReason.size();i++) {
-        iewStats.fetchStallReason[fromRename->fetchStallReason[i]]++;
+        cpu->hotCounters.inc(hotFetchStallReason + fromRename->fetchStallReason[i]);
     }
 
     for (int i = 0;i < fromRename->decodeStallReason.size();i++) {
-        iewStats.decodeStallReason[fromRename->decodeStallReason[i]]++;
+        cpu->hotCounters.inc(hotDecodeStallReason + fromRename->decodeStallReason[i]);
     }
 
     for (int i = 0;i < fromRename->renameStallReason.size();i++) {
-        iewStats.renameStallReason[fromRename->renameStallReason[i]]++;
+        cpu->hotCounters.inc(hotRenameStallReason + fromRename->renameStallReason[i]);
     }
 
     wbNumInst = 0;
@@ -1899,7 +1907,7 @@ IEW::tick()
         toRename->iewInfo[tid].blockReason = blockReason;
     }
     for (int i = 0;i < dispatchStalls.size();i++) {
-        iewStats.dispatchStallReason[dispatchStalls[i]]++;
+        cpu->hotCounters.inc(hotDispatchStallReason + dispatchStalls[i]);
     }
 
     if (exeStatus != Squashing) {
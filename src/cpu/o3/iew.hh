@@ -50,6 +50,7 @@
 #include "base/statistics.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/hot_counters.hh"
 #include "cpu/o3/inst_queue.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/lsq.hh"
@@ -584,6 +585,12 @@ class IEW
         statistics::Vector dispatchStallReason;
     } iewStats;
 
+    /** Hot counter bases of the per-slot stall reason vectors. */
+    HotCounters::Id hotFetchStallReason;
+    HotCounters::Id hotDecodeStallReason;
+    HotCounters::Id hotRenameStallReason;
+    HotCounters::Id hotDispatchStallReason;
+
     /** The width that can be dispatched to the scheduler per cycle. */
     std::vector<StallReason> dispatchStalls;
 
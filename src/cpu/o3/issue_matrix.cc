@@ -0,0 +1,213 @@
+#include "cpu/o3/issue_matrix.hh"
+
+#include <cassert>
+
+namespace gem5
+{
+
+namespace o3
+{
+
+void
+IssueMatrix::init(unsigned capacity, unsigned num_regs, unsigned num_groups)
+{
+    assert(capacity > 0);
+    slots.assign(capacity, Slot());
+    freeSlots.clear();
+    for (int s = capacity - 1; s >= 0; s--) {
+        freeSlots.push_back(s);
+    }
+    valid.clear();
+    valid.resize(capacity);
+    older.assign(capacity, Bits(capacity));
+    consumers.assign(num_regs, Bits(capacity));
+    ready.assign(num_groups, Bits(capacity));
+    pending.clear();
+    pending.resize(capacity);
+}
+
+void
+IssueMatrix::grow()
+{
+    size_t old_cap = slots.size();
+    size_t new_cap = old_cap * 2;
+    slots.resize(new_cap);
+    for (size_t s = new_cap - 1; s >= old_cap; s--) {
+        freeSlots.push_back(s);
+    }
+    valid.resize(new_cap);
+    for (auto &row : older) {
+        row.resize(new_cap);
+    }
+    older.resize(new_cap, Bits(new_cap));
+    for (auto &row : consumers) {
+        row.resize(new_cap);
+    }
+    for (auto &row : ready) {
+        row.resize(new_cap);
+    }
+    pending.resize(new_cap);
+}
+
+void
+IssueMatrix::insert(const DynInstPtr &inst)
+{
+    allocate(inst);
+    slots[inst->iqSlot].inList = true;
+}
+
+void
+IssueMatrix::allocate(const DynInstPtr &inst)
+{
+    if (freeSlots.empty()) {
+        grow();
+    }
+    int s = freeSlots.back();
+    freeSlots.pop_back();
+
+    Slot &slot = slots[s];
+    slot.inst = inst;
+    slot.srcs.clear();
+    slot.depRows = 0;
+    slot.readyGroup = -1;
+    slot.twin = -1;
+    slot.inList = false;
+    inst->iqSlot = s;
+
+    Bits &row = older[s];
+    row.reset();
+    for (size_t t = valid.find_first(); t != Bits::npos;
+         t = valid.find_next(t)) {
+        InstSeqNum seq = slots[t].inst->seqNum;
+        if (seq < inst->seqNum) {
+            row.set(t);
+            older[t].reset(s);
+        } else if (seq > inst->seqNum) {
+            older[t].set(s);
+        } else {
+            // Split store uops share a sequence number; their order is
+            // fixed when they become ready.
+            slot.twin = t;
+            slots[t].twin = s;
+            older[t].reset(s);
+        }
+    }
+    valid.set(s);
+}
+
+void
+IssueMatrix::remove(const DynInstPtr &inst)
+{
+    int s = inst->iqSlot;
+    assert(s >= 0 && slots[s].inList);
+    slots[s].inList = false;
+    tryFree(s);
+}
+
+void
+IssueMatrix::tryFree(int s)
+{
+    Slot &slot = slots[s];
+    if (slot.inList || slot.depRows || slot.readyGroup >= 0) {
+        return;
+    }
+    if (slot.twin >= 0) {
+        slots[slot.twin].twin = -1;
+        slot.twin = -1;
+    }
+    valid.reset(s);
+    slot.inst->iqSlot = -1;
+    slot.inst = nullptr;
+    freeSlots.push_back(s);
+}
+
+void
+IssueMatrix::addDep(const DynInstPtr &inst, RegIndex reg, uint8_t src_idx)
+{
+    int s = inst->iqSlot;
+    Slot &slot = slots[s];
+    slot.srcs.push_back({reg, src_idx});
+    if (!consumers[reg].test(s)) {
+        consumers[reg].set(s);
+        slot.depRows++;
+    }
+}
+
+void
+IssueMatrix::clearDeps(RegIndex reg)
+{
+    Bits &row = consumers[reg];
+    for (size_t s = row.find_first(); s != Bits::npos;
+         s = row.find_next(s)) {
+        assert(slots[s].depRows > 0);
+        slots[s].depRows--;
+        tryFree(s);
+    }
+    row.reset();
+}
+
+void
+IssueMatrix::clearSquashedDeps()
+{
+    for (size_t s = valid.find_first(); s != Bits::npos;
+         s = valid.find_next(s)) {
+        Slot &slot = slots[s];
+        if (!slot.depRows || !slot.inst->isSquashed()) {
+            continue;
+        }
+        for (const auto &src : slot.srcs) {
+            if (consumers[src.reg].test(s)) {
+                consumers[src.reg].reset(s);
+                slot.depRows--;
+            }
+        }
+        tryFree(s);
+    }
+}
+
+void
+IssueMatrix::pushReady(unsigned group, const DynInstPtr &inst)
+{
+    // Instructions that already left the queue can still be woken (e.g.
+    // squashed ones not yet marked); they need a slot again.
+    if (inst->iqSlot < 0) {
+        allocate(inst);
+    }
+    int s = inst->iqSlot;
+    Slot &slot = slots[s];
+    ready[group].set(s);
+    slot.readyGroup = group;
+    // A sorted ready list places the newly pushed uop ahead of an equal
+    // sequence number.
+    if (slot.twin >= 0) {
+        older[s].reset(slot.twin);
+        older[slot.twin].set(s);
+    }
+}
+
+void
+IssueMatrix::popReady(const DynInstPtr &inst)
+{
+    int s = inst->iqSlot;
+    Slot &slot = slots[s];
+    assert(slot.readyGroup >= 0);
+    ready[slot.readyGroup].reset(s);
+    slot.readyGroup = -1;
+    tryFree(s);
+}
+
+DynInstPtr
+IssueMatrix::nextSelect()
+{
+    for (size_t s = pending.find_first(); s != Bits::npos;
+         s = pending.find_next(s)) {
+        if (!older[s].intersects(pending)) {
+            pending.reset(s);
+            return slots[s].inst;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace o3
+} // namespace gem5
@@ -0,0 +1,125 @@
+#ifndef __CPU_O3_ISSUE_MATRIX_HH__
+#define __CPU_O3_ISSUE_MATRIX_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+
+#include "cpu/reg_class.hh"
+
+#ifdef UNIT_TEST
+#include "cpu/o3/test/mock_dyn_inst.hh"
+#else
+#include "cpu/o3/dyn_inst.hh"
+#include "cpu/o3/dyn_inst_ptr.hh"
+#endif
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * Bit-matrix scheduling state of one IssueQue, an alternative to the
+ * per-register consumer lists and sorted ready lists.
+ *
+ * Every instruction gets a slot when it enters the queue. It keeps the
+ * slot while the queue still refers to it: in instList, in a ready set,
+ * or as a recorded consumer of a register. So the number of slots can
+ * exceed the queue size, and the matrices grow on demand.
+ *  - consumers[reg]: slots with a source waiting on physical register reg
+ *  - older[s]: slots older than s; ties between the two uops of a split
+ *    store are resolved by ready-push order, like the sorted ready lists
+ *  - ready[group]: ready slots of each ready list
+ */
+class IssueMatrix
+{
+  public:
+    using Bits = boost::dynamic_bitset<uint64_t>;
+
+    void init(unsigned capacity, unsigned num_regs, unsigned num_groups);
+
+    /** Allocate a slot for an instruction entering the queue. */
+    void insert(const DynInstPtr &inst);
+
+    /** The instruction left the queue's instList (commit or squash). */
+    void remove(const DynInstPtr &inst);
+
+    /** Record that source src_idx of inst waits on register reg. */
+    void addDep(const DynInstPtr &inst, RegIndex reg, uint8_t src_idx);
+
+    /**
+     * Call f(src_idx, consumer) for every dependence recorded on reg, in
+     * slot order. f must not add or drop dependences.
+     */
+    template <class F>
+    void
+    forEachDep(RegIndex reg, F &&f)
+    {
+        const Bits &row = consumers[reg];
+        for (size_t s = row.find_first(); s != Bits::npos;
+             s = row.find_next(s)) {
+            const Slot &slot = slots[s];
+            for (const auto &src : slot.srcs) {
+                if (src.reg == reg) {
+                    f(src.idx, slot.inst);
+                }
+            }
+        }
+    }
+
+    /** Drop every dependence on reg, e.g. once it has been written. */
+    void clearDeps(RegIndex reg);
+
+    /** Drop the dependences of consumers marked as squashed. */
+    void clearSquashedDeps();
+
+    void pushReady(unsigned group, const DynInstPtr &inst);
+    void popReady(const DynInstPtr &inst);
+    bool anyReady(unsigned group) const { return ready[group].any(); }
+
+    /** Start walking the ready slots of group, oldest first. */
+    void beginSelect(unsigned group) { pending = ready[group]; }
+
+    /** @return the next oldest ready instruction, or nullptr when done. */
+    DynInstPtr nextSelect();
+
+  private:
+    struct Src
+    {
+        RegIndex reg;
+        uint8_t idx;
+    };
+
+    struct Slot
+    {
+        DynInstPtr inst;
+        std::vector<Src> srcs;
+        /** Number of consumer rows holding this slot. */
+        unsigned depRows = 0;
+        int readyGroup = -1;
+        /** Slot of the other uop with the same sequence number. */
+        int twin = -1;
+        bool inList = false;
+    };
+
+    void allocate(const DynInstPtr &inst);
+    void grow();
+    void tryFree(int s);
+
+    std::vector<Slot> slots;
+    std::vector<int> freeSlots;
+    Bits valid;
+    std::vector<Bits> older;
+    std::vector<Bits> consumers;
+    std::vector<Bits> ready;
+    /** Scratch copy of a ready set being selected from. */
+    Bits pending;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_ISSUE_MATRIX_HH__
@@ -0,0 +1,260 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "cpu/o3/issue_matrix.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+/**
+ * The per-register consumer lists and sorted ready lists IssueQue keeps
+ * when the matrix scheduler is off.
+ */
+struct ListScheduler
+{
+    std::vector<std::vector<std::pair<uint8_t, DynInstPtr>>> subDepGraph;
+    std::vector<std::list<DynInstPtr>> readyQs;
+
+    ListScheduler(unsigned num_regs, unsigned num_groups)
+        : subDepGraph(num_regs), readyQs(num_groups)
+    {}
+
+    void
+    pushReady(unsigned group, const DynInstPtr &inst)
+    {
+        auto &q = readyQs[group];
+        auto it = std::lower_bound(q.begin(), q.end(), inst,
+            [](const DynInstPtr &a, const DynInstPtr &b) {
+                return a->seqNum < b->seqNum;
+            });
+        q.insert(it, inst);
+    }
+
+    void
+    clearSquashedDeps()
+    {
+        for (auto &deps : subDepGraph) {
+            deps.erase(std::remove_if(deps.begin(), deps.end(),
+                [](const auto &dep) { return dep.second->isSquashed(); }),
+                deps.end());
+        }
+    }
+};
+
+using Dep = std::tuple<InstSeqNum, DynInst *, uint8_t>;
+
+std::vector<Dep>
+sorted(std::vector<Dep> deps)
+{
+    std::sort(deps.begin(), deps.end());
+    return deps;
+}
+
+} // anonymous namespace
+
+TEST(IssueMatrixTest, SelectsOldestFirst)
+{
+    IssueMatrix matrix;
+    matrix.init(2, 4, 1);
+
+    // More instructions than slots, the matrix grows
+    std::vector<DynInstPtr> insts;
+    for (InstSeqNum sn : {5, 3, 9, 1}) {
+        insts.push_back(new DynInst(sn));
+        matrix.insert(insts.back());
+    }
+    for (auto &inst : insts)
+        matrix.pushReady(0, inst);
+    ASSERT_TRUE(matrix.anyReady(0));
+
+    matrix.beginSelect(0);
+    std::vector<InstSeqNum> order;
+    for (DynInstPtr inst = matrix.nextSelect(); inst;
+         inst = matrix.nextSelect()) {
+        order.push_back(inst->seqNum);
+    }
+    EXPECT_EQ(order, std::vector<InstSeqNum>({1, 3, 5, 9}));
+
+    // A slot is only freed once the instruction left the queue and every
+    // ready set
+    matrix.remove(insts[0]);
+    EXPECT_GE(insts[0]->iqSlot, 0);
+    matrix.popReady(insts[0]);
+    EXPECT_EQ(insts[0]->iqSlot, -1);
+}
+
+TEST(IssueMatrixTest, SplitStoreTiesFollowPushOrder)
+{
+    IssueMatrix matrix;
+    matrix.init(4, 4, 1);
+    DynInstPtr sta = new DynInst(7);
+    DynInstPtr std_uop = new DynInst(7);
+    matrix.insert(sta);
+    matrix.insert(std_uop);
+
+    // Like lower_bound in a sorted ready list, the later push goes first
+    matrix.pushReady(0, sta);
+    matrix.pushReady(0, std_uop);
+    matrix.beginSelect(0);
+    EXPECT_EQ(matrix.nextSelect(), std_uop);
+    EXPECT_EQ(matrix.nextSelect(), sta);
+    EXPECT_EQ(matrix.nextSelect().get(), nullptr);
+
+    matrix.popReady(sta);
+    matrix.pushReady(0, sta);
+    matrix.beginSelect(0);
+    EXPECT_EQ(matrix.nextSelect(), sta);
+}
+
+/**
+ * Random dispatch, wakeup, select, commit and squash through the matrix and
+ * the lists it replaces: every select walk visits the same instructions in
+ * the same order, and every wakeup finds the same consumers.
+ */
+TEST(IssueMatrixTest, MatchesListScheduler)
+{
+    constexpr unsigned numRegs = 16;
+    constexpr unsigned numGroups = 3;
+    std::mt19937_64 rng(1);
+
+    for (unsigned capacity : {1, 8, 32}) {
+        IssueMatrix matrix;
+        matrix.init(capacity, numRegs, numGroups);
+        ListScheduler lists(numRegs, numGroups);
+
+        // Instructions in the queue, oldest first
+        std::list<DynInstPtr> inst_list;
+        // Ready group of each live instruction, -1 if not ready
+        std::vector<std::pair<DynInstPtr, int>> ready_of;
+        InstSeqNum seq_num = 0;
+        auto readyGroup = [&](const DynInstPtr &inst) -> int & {
+            for (auto &[i, g] : ready_of) {
+                if (i == inst)
+                    return g;
+            }
+            ready_of.emplace_back(inst, -1);
+            return ready_of.back().second;
+        };
+        auto push = [&](const DynInstPtr &inst) {
+            int &group = readyGroup(inst);
+            if (group >= 0)
+                return;
+            group = rng() % numGroups;
+            matrix.pushReady(group, inst);
+            lists.pushReady(group, inst);
+        };
+
+        for (int step = 0; step < 20000; step++) {
+            switch (rng() % 8) {
+              case 0:
+              case 1: {
+                // Dispatch; a split store's second uop shares the number
+                bool twin = !inst_list.empty() && rng() % 8 == 0 &&
+                    inst_list.back()->seqNum == seq_num &&
+                    std::count_if(inst_list.begin(), inst_list.end(),
+                        [&](const DynInstPtr &i) {
+                            return i->seqNum == seq_num;
+                        }) == 1;
+                DynInstPtr inst = new DynInst(twin ? seq_num : ++seq_num);
+                matrix.insert(inst);
+                inst_list.push_back(inst);
+                unsigned num_srcs = rng() % 4;
+                for (uint8_t i = 0; i < num_srcs; i++) {
+                    RegIndex reg = rng() % numRegs;
+                    matrix.addDep(inst, reg, i);
+                    lists.subDepGraph[reg].push_back({i, inst});
+                }
+                if (num_srcs == 0)
+                    push(inst);
+                break;
+              }
+              case 2: {
+                // Writeback of a register wakes its consumers
+                RegIndex reg = rng() % numRegs;
+                std::vector<Dep> got, expect;
+                matrix.forEachDep(reg,
+                    [&](uint8_t src_idx, const DynInstPtr &inst) {
+                        got.emplace_back(inst->seqNum, inst.get(), src_idx);
+                    });
+                for (auto &[src_idx, inst] : lists.subDepGraph[reg])
+                    expect.emplace_back(inst->seqNum, inst.get(), src_idx);
+                ASSERT_EQ(sorted(got), sorted(expect)) << "step " << step;
+
+                std::vector<DynInstPtr> woken;
+                for (auto &[src_idx, inst] : lists.subDepGraph[reg])
+                    woken.push_back(inst);
+                matrix.clearDeps(reg);
+                lists.subDepGraph[reg].clear();
+                for (auto &inst : woken)
+                    push(inst);
+                break;
+              }
+              case 3:
+              case 4: {
+                // Select: both walk the same candidates, the port takes
+                // some candidate along the way
+                unsigned group = rng() % numGroups;
+                ASSERT_EQ(matrix.anyReady(group),
+                          !lists.readyQs[group].empty());
+                std::vector<DynInstPtr> walk;
+                matrix.beginSelect(group);
+                for (DynInstPtr inst = matrix.nextSelect(); inst;
+                     inst = matrix.nextSelect()) {
+                    walk.push_back(inst);
+                }
+                auto &q = lists.readyQs[group];
+                ASSERT_EQ(walk.size(), q.size()) << "step " << step;
+                ASSERT_TRUE(std::equal(walk.begin(), walk.end(), q.begin()))
+                    << "step " << step;
+                if (walk.empty())
+                    break;
+
+                size_t pick = rng() % walk.size();
+                matrix.popReady(walk[pick]);
+                q.erase(std::next(q.begin(), pick));
+                readyGroup(walk[pick]) = -1;
+                // Canceled instructions come back later
+                if (rng() % 4 == 0)
+                    push(walk[pick]);
+                break;
+              }
+              case 5:
+                // Commit
+                if (!inst_list.empty()) {
+                    matrix.remove(inst_list.front());
+                    inst_list.pop_front();
+                }
+                break;
+              case 6: {
+                // Squash the youngest few; they may stay in ready lists
+                unsigned n = rng() % 4;
+                for (; n && !inst_list.empty(); n--) {
+                    inst_list.back()->setSquashed();
+                    matrix.remove(inst_list.back());
+                    inst_list.pop_back();
+                }
+                matrix.clearSquashedDeps();
+                lists.clearSquashedDeps();
+                break;
+              }
+              default:
+                break;
+            }
+
+            // Forget instructions neither structure refers to anymore
+            ready_of.erase(std::remove_if(ready_of.begin(), ready_of.end(),
+                [&](const auto &entry) {
+                    return entry.second < 0 && entry.first->iqSlot < 0;
+                }), ready_of.end());
+        }
+    }
+}
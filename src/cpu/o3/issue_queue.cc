@@ -36,13 +36,7 @@
         selector->deallocate(x);       \
     } while (0)
 
-#define READYQ_PUSH(x)                                                                    \
-    do {                                                                                  \
-        (x)->setInReadyQ();                                                               \
-        auto& readyQ = readyQclassify[(x)->opClass()];                                    \
-        auto it = std::lower_bound(readyQ->begin(), readyQ->end(), (x), select_policy()); \
-        readyQ->insert(it, (x));                                                          \
-    } while (0)
+#define READYQ_PUSH(x) pushReady(x)
 
 // must be consistent with FUScheduler.py
 // rfTypePortId = regfile typeid + portid
@@ -205,6 +199,9 @@ IssueQue::IssueQue(const IssueQueParams& params)
 
     readyQclassify.resize(Num_OpClasses, nullptr);
     opPipelined.resize(Num_OpClasses, false);
+    portReadyGroup.resize(outports, -1);
+    opReadyGroup.resize(Num_OpClasses, -1);
+    std::unordered_map<ReadyQue*, int> readyGroupmap;
 
     std::unordered_map<std::bitset<Num_OpClasses>, ReadyQue*> readyQmap;
     for (int i = 0; i < outports; i++) {
@@ -243,11 +240,16 @@ IssueQue::IssueQue(const IssueQueParams& params)
             t = it->second;
         }
         readyQs[i] = t;
+        if (!readyGroupmap.count(t)) {
+            readyGroupmap[t] = numReadyGroups++;
+        }
+        portReadyGroup[i] = readyGroupmap[t];
 
         bool storePipeAcc = false, loadPipeAcc = false;
         for (auto fu : oport->fu) {
             for (auto op : fu->opDescList) {
                 readyQclassify[op->opClass] = t;
+                opReadyGroup[op->opClass] = portReadyGroup[i];
                 opPipelined[op->opClass] = op->pipelined;
 
                 if (op->opClass >= MemReadOp && op->opClass <= VectorWholeRegisterLoadOp) {
@@ -276,6 +278,9 @@ void
 IssueQue::resetDepGraph(int numPhysRegs)
 {
     subDepGraph.resize(numPhysRegs);
+    if (useMatrix) {
+        matrix.init(iqsize, numPhysRegs, numReadyGroups);
+    }
 }
 
 bool
@@ -395,9 +400,17 @@ bool
 IssueQue::idle()
 {
     bool idle = false;
-    for (auto it : readyQs) {
-        if (it->size()) {
-            idle = true;
+    if (useMatrix) {
+        for (int g = 0; g < numReadyGroups; g++) {
+            if (matrix.anyReady(g)) {
+                idle = true;
+            }
+        }
+    } else {
+        for (auto it : readyQs) {
+            if (it->size()) {
+                idle = true;
+            }
         }
     }
     idle |= replayQ.size() > 0;
@@ -427,22 +440,23 @@ IssueQue::wakeUpDependents(const DynInstPtr& inst, bool speculative)
         scheduler->regCache.insert(dst->flatIndex(), {});
         DPRINTF(Schedule, "was %s woken by p%lu [sn:%llu]\n", speculative ? "spec" : "wb", dst->flatIndex(),
                 inst->seqNum);
-        auto& depgraph = subDepGraph[dst->flatIndex()];
-        for (auto& it : depgraph) {
-            int srcIdx = it.first;
-            auto& consumer = it.second;
+        forEachDep(dst->flatIndex(), [&](int srcIdx, const DynInstPtr& consumer) {
             if (consumer->readySrcIdx(srcIdx)) {
-                continue;
+                return;
             }
             consumer->markSrcRegReady(srcIdx);
 
 
             DPRINTF(Schedule, "[sn:%llu] src%d was woken\n", consumer->seqNum, srcIdx);
             addIfReady(consumer);
-        }
+        });
 
         if (!speculative) {
-            depgraph.clear();
+            if (useMatrix) {
+                matrix.clearDeps(dst->flatIndex());
+            } else {
+                subDepGraph[dst->flatIndex()].clear();
+            }
         }
     }
 }
@@ -489,51 +503,113 @@ IssueQue::cancel(const DynInstPtr& inst)
     iqstats->canceledInst++;
 }
 
+void
+IssueQue::pushReady(const DynInstPtr& inst)
+{
+    inst->setInReadyQ();
+    if (useMatrix) {
+        matrix.pushReady(opReadyGroup[inst->opClass()], inst);
+        if (!matrixCrossCheck) {
+            return;
+        }
+    }
+    auto& readyQ = readyQclassify[inst->opClass()];
+    auto it = std::lower_bound(readyQ->begin(), readyQ->end(), inst, select_policy());
+    readyQ->insert(it, inst);
+}
+
+bool
+IssueQue::portFree(int pi, const DynInstPtr& inst) const
+{
+    return !(portBusy[pi] & (1llu << scheduler->getCorrectedOpLat(inst)));
+}
+
+DynInstPtr
+IssueQue::selectFromList(int pi, bool count_busy)
+{
+    auto readyQ = readyQs[pi];
+    selector->begin(readyQ);
+    for (auto it = selector->select(readyQ->begin(), pi); it != readyQ->end(); it = selector->select(it, pi)) {
+        DynInstPtr inst = *it;
+        if (inst->canceled()) {
+            inst->clearInReadyQ();
+            it = readyQ->erase(it);
+            continue;
+        }
+
+        if (portFree(pi, inst)) {
+            readyQ->erase(it);
+            return inst;
+        }
+        if (count_busy) {
+            iqstats->portBusy[pi]++;
+        }
+
+        it++;
+    }
+    return nullptr;
+}
+
+DynInstPtr
+IssueQue::selectFromMatrix(int pi)
+{
+    // Same walk as selectFromList, over the ready bits in age order
+    matrix.beginSelect(portReadyGroup[pi]);
+    for (DynInstPtr inst = matrix.nextSelect(); inst; inst = matrix.nextSelect()) {
+        if (inst->canceled()) {
+            inst->clearInReadyQ();
+            matrix.popReady(inst);
+            continue;
+        }
+
+        if (portFree(pi, inst)) {
+            matrix.popReady(inst);
+            return inst;
+        }
+        iqstats->portBusy[pi]++;
+    }
+    return nullptr;
+}
+
 void
 IssueQue::selectInst()
 {
     selectQ.clear();
     for (int pi = 0; pi < outports; pi++) {
-        auto readyQ = readyQs[pi];
-        selector->begin(readyQ);
-        for (auto it = selector->select(readyQ->begin(), pi); it != readyQ->end(); it = selector->select(it, pi)) {
-            auto& inst = *it;
-            if (inst->canceled()) {
-                inst->clearInReadyQ();
-                it = readyQ->erase(it);
-                continue;
-            }
-
-            if (!(portBusy[pi] & (1llu << scheduler->getCorrectedOpLat(inst)))) {
-                DPRINTF(Schedule, "[sn %ld] was selected\n", inst->seqNum);
+        DynInstPtr inst = useMatrix ? selectFromMatrix(pi) : selectFromList(pi, true);
+        if (useMatrix && matrixCrossCheck) {
+            // The shadow lists got the same ready pushes, so both walks
+            // must pick the same instruction in the same cycle
+            DynInstPtr list_inst = selectFromList(pi, false);
+            panic_if(inst != list_inst,
+                     "%s port %d: matrix selected [sn:%lli], ready lists selected [sn:%lli]\n", iqname, pi,
+                     inst ? (int64_t)inst->seqNum : -1, list_inst ? (int64_t)list_inst->seqNum : -1);
+        }
+        if (!inst) {
+            continue;
+        }
 
-                // get regfile read port
-                for (int i = 0; i < inst->numSrcRegs(); i++) {
-                    auto src = inst->srcRegIdx(i);
-                    PhysRegIdPtr psrc = inst->renamedSrcIdx(i);
-                    if (psrc->isFixedMapping())
-                        continue;
-                    std::pair<int, int> rfTypePortId;
-                    // read port is point to point with srcid
-                    if (src.isIntReg() && intRfTypePortId[pi].size() > i) {
-                        rfTypePortId = intRfTypePortId[pi][i];
-                        scheduler->useRegfilePort(inst, psrc, rfTypePortId.first, rfTypePortId.second);
-                    } else if (src.isFloatReg() && fpRfTypePortId[pi].size() > i) {
-                        rfTypePortId = fpRfTypePortId[pi][i];
-                        scheduler->useRegfilePort(inst, psrc, rfTypePortId.first, rfTypePortId.second);
-                    }
-                }
+        DPRINTF(Schedule, "[sn %ld] was selected\n", inst->seqNum);
 
-                selectQ.push_back(std::make_pair(pi, inst));
-                inst->clearInReadyQ();
-                readyQ->erase(it);
-                break;
-            } else {
-                iqstats->portBusy[pi]++;
+        // get regfile read port
+        for (int i = 0; i < inst->numSrcRegs(); i++) {
+            auto src = inst->srcRegIdx(i);
+            PhysRegIdPtr psrc = inst->renamedSrcIdx(i);
+            if (psrc->isFixedMapping())
+                continue;
+            std::pair<int, int> rfTypePortId;
+            // read port is point to point with srcid
+            if (src.isIntReg() && intRfTypePortId[pi].size() > i) {
+                rfTypePortId = intRfTypePortId[pi][i];
+                scheduler->useRegfilePort(inst, psrc, rfTypePortId.first, rfTypePortId.second);
+            } else if (src.isFloatReg() && fpRfTypePortId[pi].size() > i) {
+                rfTypePortId = fpRfTypePortId[pi][i];
+                scheduler->useRegfilePort(inst, psrc, rfTypePortId.first, rfTypePortId.second);
             }
-
-            it++;
         }
+
+        selectQ.push_back(std::make_pair(pi, inst));
+        inst->clearInReadyQ();
     }
 }
 
@@ -618,6 +694,9 @@ IssueQue::insert(const DynInstPtr& inst)
     selector->allocate(inst);
     inst->issueQue = this;
     instList.emplace_back(inst);
+    if (useMatrix) {
+        matrix.insert(inst);
+    }
     bool addToDepGraph = false;
     for (int i = 0; i < inst->numSrcRegs(); i++) {
         auto src = inst->renamedSrcIdx(i);
@@ -629,7 +708,11 @@ IssueQue::insert(const DynInstPtr& inst)
                     inst->markSrcRegReady(i);
                 }
                 DPRINTF(Schedule, "[sn:%llu] src p%d add to depGraph\n", inst->seqNum, src->flatIndex());
-                subDepGraph[src->flatIndex()].push_back({i, inst});
+                if (useMatrix) {
+                    matrix.addDep(inst, src->flatIndex(), i);
+                } else {
+                    subDepGraph[src->flatIndex()].push_back({i, inst});
+                }
                 addToDepGraph = true;
             }
         }
@@ -651,6 +734,8 @@ IssueQue::insert(const DynInstPtr& inst)
     } else {
         addIfReady(inst);
     }
+    cpu->perfCCT->updateInstDetail(inst->seqNum, PerfDetail::iqwait,
+                                   addToDepGraph ? 1 : (inst->isMemRef() && !inst->memDepSolved() ? 2 : 0));
 }
 
 void
@@ -668,6 +753,9 @@ IssueQue::doCommit(const InstSeqNum seqNum)
 {
     while (!instList.empty() && instList.front()->seqNum <= seqNum) {
         assert(instList.front()->isIssued());
+        if (useMatrix) {
+            matrix.remove(instList.front());
+        }
         instList.pop_front();
     }
 }
@@ -689,6 +777,9 @@ IssueQue::doSquash(const InstSeqNum seqNum)
             (*it)->setCanCommit();
             (*it)->clearScheduled();
             (*it)->setCancel();
+            if (useMatrix) {
+                matrix.remove(*it);
+            }
             it = instList.erase(it);
             assert(instList.size() >= instNum);
         } else {
@@ -707,6 +798,9 @@ IssueQue::doSquash(const InstSeqNum seqNum)
     }
 
     // clear in depGraph
+    if (useMatrix) {
+        matrix.clearSquashedDeps();
+    }
     for (auto& entrys : subDepGraph) {
         for (auto it = entrys.begin(); it != entrys.end();) {
             if ((*it).second->isSquashed()) {
@@ -776,6 +870,10 @@ Scheduler::Scheduler(const SchedulerParams& params)
     for (int i = 0; i < issueQues.size(); i++) {
         issueQues[i]->setIQID(i);
         issueQues[i]->scheduler = this;
+        issueQues[i]->useMatrix = params.matrixScheduler;
+        issueQues[i]->matrixCrossCheck = params.matrixCrossCheck;
+        fatal_if(params.matrixScheduler && dynamic_cast<PAgeSelector*>(issueQues[i]->selector),
+                 "%s: matrixScheduler only supports the age-first selector\n", issueQues[i]->getName());
         combinedFus += issueQues[i]->outports;
         panic_if(issueQues[i]->fuDescs.size() == 0, "Empty config IssueQue: " + issueQues[i]->getName());
         for (auto fu : issueQues[i]->fuDescs) {
@@ -864,6 +962,20 @@ Scheduler::setCPU(CPU* cpu, LSQ* lsq)
     for (auto it : issueQues) {
         it->setCPU(cpu);
     }
+
+    auto &hot = cpu->hotCounters;
+    hotExecStallCycle = hot.bind("scheduler.exec_stall_cycle",
+                                 stats.exec_stall_cycle);
+    hotMemstallAnyLoad = hot.bind("scheduler.memstall_any_load",
+                                  stats.memstall_any_load);
+    hotMemstallAnyStore = hot.bind("scheduler.memstall_any_store",
+                                   stats.memstall_any_store);
+    hotMemstallL1Miss = hot.bind("scheduler.memstall_l1miss",
+                                 stats.memstall_l1miss);
+    hotMemstallL2Miss = hot.bind("scheduler.memstall_l2miss",
+                                 stats.memstall_l2miss);
+    hotMemstallL3Miss = hot.bind("scheduler.memstall_l3miss",
+                                 stats.memstall_l3miss);
 }
 
 void
@@ -909,6 +1021,7 @@ Scheduler::issueAndSelect()
     // inst arbitration
     for (auto inst : arbFailedInsts) {
         inst->setArbFailed();
+        cpu->perfCCT->updateInstDetail(inst->seqNum, PerfDetail::arbfail, 1);
     }
     arbFailedInsts.clear();
     std::fill(rfPortOccupancy.begin(), rfPortOccupancy.end(), std::make_pair(nullptr, 0));
@@ -917,16 +1030,17 @@ Scheduler::issueAndSelect()
     for (auto it : issueQues) {
         it->issueToFu();
     }
+    auto &hot = cpu->hotCounters;
     if (instsToFu.size() < intel_fewops) {
-        stats.exec_stall_cycle++;
-        if (lsq->anyStoreNotExecute()) stats.memstall_any_store++;
+        hot.inc(hotExecStallCycle);
+        if (lsq->anyStoreNotExecute()) hot.inc(hotMemstallAnyStore);
     }
     if (instsToFu.size() == 0) {
         int misslevel = lsq->anyInflightLoadsNotComplete();
-        if (misslevel != 0) stats.memstall_any_load++;
-        if ((misslevel & ((1<<1) - 1)) == ((1<<1) - 1)) stats.memstall_l1miss++;
-        if ((misslevel & ((1<<2) - 1)) == ((1<<2) - 1)) stats.memstall_l2miss++;
-        if ((misslevel & ((1<<3) - 1)) == ((1<<3) - 1)) stats.memstall_l3miss++;
+        if (misslevel != 0) hot.inc(hotMemstallAnyLoad);
+        if ((misslevel & ((1<<1) - 1)) == ((1<<1) - 1)) hot.inc(hotMemstallL1Miss);
+        if ((misslevel & ((1<<2) - 1)) == ((1<<2) - 1)) hot.inc(hotMemstallL2Miss);
+        if ((misslevel & ((1<<3) - 1)) == ((1<<3) - 1)) hot.inc(hotMemstallL3Miss);
     }
 }
 
@@ -1209,9 +1323,7 @@ Scheduler::loadCancel(const DynInstPtr& inst)
             }
             earlyScoreboard[dst->flatIndex()] = false;
             for (auto iq : issueQues) {
-                for (auto& it : iq->subDepGraph[dst->flatIndex()]) {
-                    int srcIdx = it.first;
-                    auto& depInst = it.second;
+                iq->forEachDep(dst->flatIndex(), [&](int srcIdx, const DynInstPtr& depInst) {
                     if (depInst->readySrcIdx(srcIdx)) {
                         DPRINTF(Schedule, "cancel [sn:%llu], clear src p%d ready\n", depInst->seqNum,
                                 depInst->renamedSrcIdx(srcIdx)->flatIndex());
@@ -1219,7 +1331,7 @@ Scheduler::loadCancel(const DynInstPtr& inst)
                         depInst->clearSrcRegReady(srcIdx);
                         dfs.push(depInst);
                     }
-                }
+                });
             }
         }
     }
@@ -16,6 +16,8 @@
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/dyn_inst.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/hot_counters.hh"
+#include "cpu/o3/issue_matrix.hh"
 #include "cpu/reg_class.hh"
 #include "cpu/timebuf.hh"
 #include "params/BaseSelector.hh"
@@ -156,6 +158,16 @@ class IssueQue : public SimObject
     // srcIdx : inst
     std::vector<std::vector<std::pair<uint8_t, DynInstPtr>>> subDepGraph;
 
+    /** Use the bit-matrix wakeup/select state instead of the lists. */
+    bool useMatrix = false;
+    /** Also keep the ready lists and check that both select alike. */
+    bool matrixCrossCheck = false;
+    IssueMatrix matrix;
+    /** Ready list number of each issue port and of each opClass. */
+    std::vector<int> portReadyGroup;
+    std::vector<int> opReadyGroup;
+    int numReadyGroups = 0;
+
     std::queue<DynInstPtr> replayQ;  // only for mem
 
     CPU* cpu = nullptr;
@@ -186,6 +198,25 @@ class IssueQue : public SimObject
     void scheduleInst();
     void addIfReady(const DynInstPtr& inst);
     void cancel(const DynInstPtr& inst);
+    void pushReady(const DynInstPtr& inst);
+    bool portFree(int pi, const DynInstPtr& inst) const;
+    /** Pop the oldest ready instruction that port pi can take, if any. */
+    DynInstPtr selectFromList(int pi, bool count_busy);
+    DynInstPtr selectFromMatrix(int pi);
+
+    /** Call f(srcIdx, consumer) for each recorded consumer of reg. */
+    template <class F>
+    void
+    forEachDep(RegIndex reg, F &&f)
+    {
+        if (useMatrix) {
+            matrix.forEachDep(reg, f);
+        } else {
+            for (auto& it : subDepGraph[reg]) {
+                f(it.first, it.second);
+            }
+        }
+    }
 
   public:
     inline void clearBusy(uint32_t pi) { portBusy.at(pi) = 0; }
@@ -263,6 +294,14 @@ class Scheduler : public SimObject
         statistics::Scalar memstall_l3miss;
     } stats;
 
+    /** Hot counter ids of the per-cycle stall stats above. */
+    HotCounters::Id hotExecStallCycle;
+    HotCounters::Id hotMemstallAnyLoad;
+    HotCounters::Id hotMemstallAnyStore;
+    HotCounters::Id hotMemstallL1Miss;
+    HotCounters::Id hotMemstallL2Miss;
+    HotCounters::Id hotMemstallL3Miss;
+
     struct disp_policy
     {
         OpClass disp_op;
@@ -1082,9 +1082,10 @@ LSQ::pushRequest(const DynInstPtr& inst, bool isLoad, uint8_t *data,
             inst->effAddr = request->getVaddr();
             inst->effSize = size;
             inst->effAddrValid(true);
+            thread[tid].indexMemAddr(inst, request);
 
             if (cpu->checker) {
-                inst->reqToVerify = std::make_shared<Request>(*request->req());
+                inst->reqToVerify = makeRequest(*request->req());
             }
 
             if (inst->isAtomic()) {
@@ -1164,6 +1165,8 @@ LSQ::SingleDataRequest::finish(const Fault &fault, const RequestPtr &request,
             setState(State::Fault);
         }
 
+        _port.indexMemAddr(_inst, this);
+
         LSQRequest::_inst->fault = fault;
         LSQRequest::_inst->translationCompleted(true);
         DPRINTF(LSQ, "Translation of inst %llu notified as completed\n",
@@ -1242,6 +1245,7 @@ LSQ::SplitDataRequest::finish(const Fault &fault, const RequestPtr &req,
                 _inst->fault = _fault[0];
                 setState(State::Fault);
             }
+            _port.indexMemAddr(_inst, this);
         }
 
     }
@@ -1292,7 +1296,7 @@ LSQ::SplitDataRequest::initiateTranslation()
     Addr final_addr = addrBlockAlign(_addr + _size, cacheLineSize);
     uint32_t size_so_far = 0;
 
-    _mainReq = std::make_shared<Request>(base_addr,
+    _mainReq = makeRequest(base_addr,
                 _size, _flags, _inst->requestorId(),
                 _inst->pcState().instAddr(), _inst->contextId());
     _mainReq->setByteEnable(_byteEnable);
@@ -1371,7 +1375,7 @@ LSQ::SbufferRequest::~SbufferRequest() {
 void
 LSQ::SbufferRequest::addReq(Addr blockVaddr, Addr blockPaddr, const std::vector<bool> byteEnable)
 {
-    auto req = std::make_shared<Request>(
+    auto req = makeRequest(
         blockPaddr, _port.cacheLineSize(), Request::Flags(),
         cpu->dataRequestorId());
     req->setContext(cpu->getContext(_port.lsqID)->contextId());
@@ -1447,7 +1451,7 @@ LSQ::LSQRequest::addReq(Addr addr, unsigned size,
            const std::vector<bool>& byte_enable)
 {
     if (isAnyActiveElement(byte_enable.begin(), byte_enable.end())) {
-        auto req = std::make_shared<Request>(
+        auto req = makeRequest(
                 addr, size, _flags, _inst->requestorId(),
                 _inst->pcState().instAddr(), _inst->contextId(),
                 std::move(_amo_op));
@@ -2015,6 +2019,7 @@ LSQ::UnsquashableDirectRequest::initiateTranslation()
         _inst->physEffAddr = _reqs.back()->getPaddr();
         _inst->memReqFlags = _reqs.back()->getFlags();
         _inst->savedRequest = this;
+        _port.indexMemAddr(_inst, this);
 
         flags.set(Flag::TranslationStarted);
         flags.set(Flag::TranslationFinished);
@@ -0,0 +1,188 @@
+#ifndef __CPU_O3_LSQ_ADDR_INDEX_HH__
+#define __CPU_O3_LSQ_ADDR_INDEX_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+
+namespace gem5
+{
+namespace o3
+{
+
+/**
+ * Index from address lines to the load or store queue entries whose
+ * accesses touch them, so ordering and forwarding searches only visit
+ * entries that can possibly overlap.
+ *
+ * Entries are keyed by the monotonic CircularQueue index. Every queue
+ * slot remembers the lines it is registered under, so re-registering an
+ * index (or a new instruction reusing the slot) drops the old lines.
+ * Lookups may return stale entries; callers must check the entry is
+ * still in the queue and belongs to the recorded sequence number, and
+ * then apply their own exact address test.
+ */
+class LSQAddrIndex
+{
+  public:
+    struct Entry
+    {
+        size_t idx;
+        InstSeqNum seqNum;
+
+        bool operator<(const Entry &o) const { return idx < o.idx; }
+        bool
+        operator==(const Entry &o) const
+        {
+            return idx == o.idx && seqNum == o.seqNum;
+        }
+    };
+
+    /**
+     * @param capacity Number of entries of the indexed queue.
+     * @param line_shift log2 of the indexing granularity in bytes.
+     */
+    void
+    init(size_t capacity, unsigned line_shift)
+    {
+        lineShift = line_shift;
+        slots.assign(capacity, Slot());
+        lines.clear();
+        numWild = 0;
+    }
+
+    Addr lineOf(Addr addr) const { return addr >> lineShift; }
+
+    /** Start (re-)registering queue index idx; drops its old lines. */
+    void
+    begin(size_t idx, InstSeqNum seq_num)
+    {
+        remove(idx);
+        Slot &slot = slots[idx % slots.size()];
+        slot.idx = idx;
+        slot.seqNum = seq_num;
+    }
+
+    /**
+     * Add the bytes [addr, addr + size) to the entry begun last. An empty
+     * range at address 0 wraps around in the callers' inclusive end
+     * computation and so overlaps everything; it is recorded as a wildcard.
+     */
+    void
+    addRange(size_t idx, Addr addr, Addr size)
+    {
+        Slot &slot = slots[idx % slots.size()];
+        if (size == 0 && addr == 0) {
+            if (!slot.wild) {
+                slot.wild = true;
+                numWild++;
+            }
+            return;
+        }
+        Addr first = lineOf(addr);
+        Addr last = lineOf(addr + (size ? size - 1 : 0));
+        for (Addr line = first; ; line++) {
+            if (std::find(slot.lines.begin(), slot.lines.end(), line) ==
+                    slot.lines.end()) {
+                slot.lines.push_back(line);
+                lines[line].push_back({idx, slot.seqNum});
+            }
+            if (line == last)
+                break;
+        }
+    }
+
+    /** Drop every line registered for queue index idx. */
+    void
+    remove(size_t idx)
+    {
+        Slot &slot = slots[idx % slots.size()];
+        if (slot.wild) {
+            slot.wild = false;
+            numWild--;
+        }
+        for (Addr line : slot.lines) {
+            auto it = lines.find(line);
+            if (it == lines.end())
+                continue;
+            auto &list = it->second;
+            for (size_t i = 0; i < list.size(); i++) {
+                if (list[i].idx == slot.idx) {
+                    list[i] = list.back();
+                    list.pop_back();
+                    break;
+                }
+            }
+            if (list.empty())
+                lines.erase(it);
+        }
+        slot.lines.clear();
+    }
+
+    /**
+     * Append the entries registered under any line of [addr, addr + size)
+     * to out, sorted by queue index and without duplicates.
+     */
+    void
+    lookup(Addr addr, Addr size, std::vector<Entry> &out) const
+    {
+        Addr first = lineOf(addr);
+        Addr last = lineOf(addr + (size ? size - 1 : 0));
+        for (Addr line = first; ; line++) {
+            auto it = lines.find(line);
+            if (it != lines.end())
+                out.insert(out.end(), it->second.begin(), it->second.end());
+            if (line == last)
+                break;
+        }
+    }
+
+    /** Sort and deduplicate the result of one or more lookups. */
+    static void
+    finish(std::vector<Entry> &out)
+    {
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+
+    /**
+     * Drop the results outside the queue indexes [first, last) and those
+     * whose slot has since been reused by another instruction.
+     */
+    template <class Queue>
+    static void
+    prune(std::vector<Entry> &out, Queue &queue, size_t first, size_t last)
+    {
+        auto stale = [&](const Entry &e) {
+            return e.idx < first || e.idx >= last || !queue[e.idx].valid() ||
+                queue[e.idx].instruction()->seqNum != e.seqNum;
+        };
+        out.erase(std::remove_if(out.begin(), out.end(), stale), out.end());
+    }
+
+    /** Lookups are incomplete while any wildcard entry is registered. */
+    bool hasWildcard() const { return numWild != 0; }
+
+  private:
+    struct Slot
+    {
+        size_t idx = 0;
+        InstSeqNum seqNum = 0;
+        std::vector<Addr> lines;
+        bool wild = false;
+    };
+
+    unsigned lineShift = 6;
+    unsigned numWild = 0;
+    std::vector<Slot> slots;
+    std::unordered_map<Addr, std::vector<Entry>> lines;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_LSQ_ADDR_INDEX_HH__
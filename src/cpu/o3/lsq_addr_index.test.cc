@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "cpu/o3/lsq_addr_index.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+/** The bits of a queue entry LSQAddrIndex::prune looks at. */
+struct FakeInst
+{
+    InstSeqNum seqNum = 0;
+};
+
+struct FakeEntry
+{
+    bool live = false;
+    FakeInst inst;
+    /** The ranges the entry is registered under, as (addr, size). */
+    std::vector<std::pair<Addr, Addr>> ranges;
+
+    bool valid() const { return live; }
+    const FakeInst *instruction() const { return &inst; }
+};
+
+/** A circular queue addressed by monotonic index, like CircularQueue. */
+struct FakeQueue
+{
+    std::vector<FakeEntry> entries;
+    size_t head = 0;
+    size_t tail = 0;
+
+    explicit FakeQueue(size_t capacity) : entries(capacity) {}
+
+    FakeEntry &operator[](size_t idx) { return entries[idx % entries.size()]; }
+    bool full() const { return tail - head == entries.size(); }
+    bool empty() const { return tail == head; }
+};
+
+constexpr unsigned lineShift = 6;
+
+bool
+overlaps(Addr a, Addr a_size, Addr b, Addr b_size)
+{
+    // The inclusive end computation of the LSQ's exact checks
+    Addr a_end = a + (a_size ? a_size - 1 : 0);
+    Addr b_end = b + (b_size ? b_size - 1 : 0);
+    return a <= b_end && b <= a_end;
+}
+
+bool
+linesOverlap(Addr a, Addr a_size, Addr b, Addr b_size)
+{
+    Addr a_end = a + (a_size ? a_size - 1 : 0);
+    Addr b_end = b + (b_size ? b_size - 1 : 0);
+    return (a >> lineShift) <= (b_end >> lineShift) &&
+        (b >> lineShift) <= (a_end >> lineShift);
+}
+
+void
+registerRanges(LSQAddrIndex &index, FakeQueue &queue, size_t idx,
+               std::mt19937_64 &rng)
+{
+    FakeEntry &entry = queue[idx];
+    entry.ranges.clear();
+    index.begin(idx, entry.inst.seqNum);
+    int n = 1 + rng() % 3;
+    for (int i = 0; i < n; i++) {
+        Addr addr, size;
+        if (rng() % 200 == 0) {
+            addr = size = 0;
+        } else {
+            // A few pages so that lines are shared, some accesses cross
+            // a line
+            addr = (rng() % 4) * 0x1000 + rng() % 512;
+            size = 1 << (rng() % 4);
+        }
+        index.addRange(idx, addr, size);
+        entry.ranges.emplace_back(addr, size);
+    }
+}
+
+} // anonymous namespace
+
+TEST(LSQAddrIndexTest, RangesAndWildcards)
+{
+    FakeQueue queue(4);
+    LSQAddrIndex index;
+    index.init(4, lineShift);
+
+    queue[0].live = true;
+    queue[0].inst.seqNum = 10;
+    index.begin(0, 10);
+    // Crosses from line 0 into line 1
+    index.addRange(0, 0x3c, 8);
+
+    std::vector<LSQAddrIndex::Entry> out;
+    index.lookup(0x40, 1, out);
+    index.lookup(0x00, 4, out);
+    LSQAddrIndex::finish(out);
+    ASSERT_EQ(out.size(), 1);
+    EXPECT_EQ(out[0].idx, 0);
+    EXPECT_EQ(out[0].seqNum, 10);
+
+    out.clear();
+    index.lookup(0x80, 8, out);
+    EXPECT_TRUE(out.empty());
+
+    // Re-registering drops the old lines
+    index.begin(0, 10);
+    index.addRange(0, 0x80, 8);
+    index.lookup(0x3c, 8, out);
+    EXPECT_TRUE(out.empty());
+
+    EXPECT_FALSE(index.hasWildcard());
+    index.begin(1, 11);
+    index.addRange(1, 0, 0);
+    EXPECT_TRUE(index.hasWildcard());
+    index.remove(1);
+    EXPECT_FALSE(index.hasWildcard());
+}
+
+/**
+ * After pruning, the index yields exactly the live entries of the searched
+ * window that share a line with the access, in queue order. That covers
+ * every entry the full queue walk it replaces would find overlapping.
+ */
+TEST(LSQAddrIndexTest, MatchesQueueWalk)
+{
+    std::mt19937_64 rng(1);
+    for (size_t capacity : {4, 16, 72}) {
+        FakeQueue queue(capacity);
+        LSQAddrIndex index;
+        index.init(capacity, lineShift);
+        InstSeqNum seq_num = 0;
+
+        for (int step = 0; step < 20000; step++) {
+            switch (rng() % 8) {
+              case 0:
+              case 1:
+                // Dispatch, not yet executed
+                if (!queue.full()) {
+                    FakeEntry &entry = queue[queue.tail];
+                    entry.live = true;
+                    entry.inst.seqNum = ++seq_num;
+                    entry.ranges.clear();
+                    queue.tail++;
+                }
+                break;
+              case 2:
+              case 3:
+                // Execute, or re-execute after a replay
+                if (!queue.empty()) {
+                    size_t idx = queue.head + rng() % (queue.tail - queue.head);
+                    registerRanges(index, queue, idx, rng);
+                }
+                break;
+              case 4:
+                // Commit. Leave some entries registered, lookups must
+                // prune them once the slot is reused.
+                if (!queue.empty()) {
+                    if (rng() % 4)
+                        index.remove(queue.head);
+                    queue[queue.head].live = false;
+                    queue.head++;
+                }
+                break;
+              case 5:
+                // Squash the youngest
+                if (!queue.empty()) {
+                    queue.tail--;
+                    index.remove(queue.tail);
+                    queue[queue.tail].live = false;
+                }
+                break;
+              default: {
+                // Search a window of the queue, as the ordering checks do
+                if (queue.empty() || index.hasWildcard())
+                    break;
+                Addr addr = (rng() % 4) * 0x1000 + rng() % 512;
+                Addr size = 1 << (rng() % 4);
+                size_t first = queue.head + rng() % (queue.tail - queue.head);
+                size_t last = queue.tail;
+
+                std::vector<LSQAddrIndex::Entry> out;
+                index.lookup(addr, size, out);
+                LSQAddrIndex::finish(out);
+                LSQAddrIndex::prune(out, queue, first, last);
+
+                std::vector<size_t> expect;
+                for (size_t idx = first; idx < last; idx++) {
+                    bool line_hit = false;
+                    bool byte_hit = false;
+                    for (auto [r_addr, r_size] : queue[idx].ranges) {
+                        line_hit |= linesOverlap(r_addr, r_size, addr, size);
+                        byte_hit |= overlaps(r_addr, r_size, addr, size);
+                    }
+                    ASSERT_TRUE(line_hit || !byte_hit);
+                    if (line_hit)
+                        expect.push_back(idx);
+                }
+
+                ASSERT_EQ(out.size(), expect.size()) << "step " << step;
+                for (size_t i = 0; i < out.size(); i++) {
+                    ASSERT_EQ(out[i].idx, expect[i]) << "step " << step;
+                    ASSERT_EQ(out[i].seqNum, queue[expect[i]].inst.seqNum);
+                }
+              }
+            }
+
+            // Wildcards must stay visible until their entry is dropped
+            bool wild = false;
+            for (size_t idx = queue.head; idx < queue.tail; idx++) {
+                for (auto [r_addr, r_size] : queue[idx].ranges)
+                    wild |= r_addr == 0 && r_size == 0;
+            }
+            ASSERT_TRUE(index.hasWildcard() || !wild);
+        }
+    }
+}
@@ -44,7 +44,9 @@
 #include <cassert>
 
 #include "arch/generic/debugfaults.hh"
+#include "arch/generic/decoder.hh"
 #include "arch/riscv/faults.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/str.hh"
 #include "base/trace.hh"
@@ -503,6 +505,7 @@ LSQUnit::completeDataAccess(PacketPtr pkt)
     }
 
     cpu->ppDataAccessComplete->notify(std::make_pair(inst, pkt));
+    cpu->perfCCT->updateInstDetail(inst->seqNum, PerfDetail::cachemisslevel, pkt->req->getAccessDepth());
 
     assert(!cpu->switchedOut());
     if (!inst->isSquashed()) {
@@ -633,6 +636,14 @@ LSQUnit::init(CPU *cpu_ptr, IEW *iew_ptr, const BaseO3CPUParams &params,
     checkLoads = params.LSQCheckLoads;
     needsTSO = params.needsTSO;
 
+    // Index at a granularity no finer than either the violation check or
+    // the snoop comparison, so every overlapping entry shares a line.
+    useAddrIndex = params.LSQAddrIndex;
+    unsigned index_shift =
+        std::max<unsigned>(floorLog2(cpu->cacheLineSize()), depCheckShift);
+    lqAddrIndex.init(loadQueue.capacity(), index_shift);
+    sqAddrIndex.init(storeQueue.capacity(), index_shift);
+
     // Clear RAR/RAW queues
     RARQueue.clear();
     RAWQueue.clear();
@@ -1004,7 +1015,28 @@ LSQUnit::checkSnoop(PacketPtr pkt)
 
     bool force_squash = false;
 
-    while (++iter != loadQueue.end()) {
+    // Without TSO only loads on the invalidated line are affected, so the
+    // index can stand in for the walk over all younger loads.
+    bool indexed = useAddrIndex && !needsTSO && !lqAddrIndex.hasWildcard();
+    if (indexed) {
+        addrCandidates.clear();
+        lqAddrIndex.lookup(invalidate_addr, cpu->cacheLineSize(),
+                           addrCandidates);
+        LSQAddrIndex::finish(addrCandidates);
+        LSQAddrIndex::prune(addrCandidates, loadQueue, loadQueue.head() + 1,
+                            loadQueue.tail() + 1);
+    }
+    size_t candidate = 0;
+
+    while (true) {
+        if (indexed) {
+            if (candidate == addrCandidates.size())
+                break;
+            iter = loadQueue.getIterator(addrCandidates[candidate++].idx);
+        } else if (++iter == loadQueue.end()) {
+            break;
+        }
+
         ld_inst = iter->instruction();
         assert(ld_inst);
         request = ld_inst->savedRequest;// iter->request();
@@ -1051,6 +1083,38 @@ LSQUnit::checkSnoop(PacketPtr pkt)
     return;
 }
 
+bool
+LSQUnit::findForwardCandidates(LSQRequest *request,
+                               const DynInstPtr &load_inst)
+{
+    // A load already waiting on store data is caught by the first older
+    // store checked, overlapping or not, so it needs the full walk.
+    if (!useAddrIndex || sqAddrIndex.hasWildcard() ||
+        load_inst->needSTLFReplay()) {
+        return false;
+    }
+
+    addrCandidates.clear();
+    if (request->isSplit()) {
+        for (const auto &req : request->_reqs) {
+            if (req->getSize() == 0)
+                return false;
+            sqAddrIndex.lookup(req->getPaddr(), req->getSize(),
+                               addrCandidates);
+        }
+    } else {
+        const auto &req = request->mainReq();
+        if (req->getSize() == 0)
+            return false;
+        sqAddrIndex.lookup(req->getPaddr(), req->getSize(), addrCandidates);
+    }
+    LSQAddrIndex::finish(addrCandidates);
+    // Only the stores between the write-back point and the load.
+    LSQAddrIndex::prune(addrCandidates, storeQueue, storeWBIt.idx(),
+                        load_inst->sqIt.idx());
+    return true;
+}
+
 Fault
 LSQUnit::checkViolations(typename LoadQueue::iterator& loadIt,
         const DynInstPtr& inst)
@@ -1065,7 +1129,29 @@ LSQUnit::checkViolations(typename LoadQueue::iterator& loadIt,
      */
     DPRINTF(LSQUnit, "Checking for violations for store [sn:%lli], addr: %#lx\n",
             inst->seqNum, inst->physEffAddr);
-    while (loadIt != loadQueue.end()) {
+
+    // Only loads on a line of this access can overlap it; visit them in
+    // the same oldest-first order as the full walk.
+    bool indexed = useAddrIndex && inst->effSize != 0 &&
+        !lqAddrIndex.hasWildcard();
+    if (indexed) {
+        addrCandidates.clear();
+        lqAddrIndex.lookup(inst->physEffAddr, inst->effSize, addrCandidates);
+        LSQAddrIndex::finish(addrCandidates);
+        LSQAddrIndex::prune(addrCandidates, loadQueue, loadIt.idx(),
+                            loadQueue.tail() + 1);
+    }
+    size_t candidate = 0;
+
+    while (true) {
+        if (indexed) {
+            if (candidate == addrCandidates.size())
+                break;
+            loadIt = loadQueue.getIterator(addrCandidates[candidate++].idx);
+        } else if (loadIt == loadQueue.end()) {
+            break;
+        }
+
         DynInstPtr ld_inst = loadIt->instruction();
         if (!ld_inst->effAddrValid() || ld_inst->strictlyOrdered()) {
             ++loadIt;
@@ -1145,6 +1231,32 @@ LSQUnit::checkViolations(typename LoadQueue::iterator& loadIt,
     return NoFault;
 }
 
+void
+LSQUnit::indexMemAddr(const DynInstPtr &inst, LSQRequest *request)
+{
+    if (!useAddrIndex)
+        return;
+
+    bool is_load = inst->isLoad();
+    ssize_t idx = is_load ? inst->lqIdx : inst->sqIdx;
+    if (idx < 0)
+        return;
+    LSQAddrIndex &index = is_load ? lqAddrIndex : sqAddrIndex;
+
+    // Cover every address the exact checks may later read: the effective
+    // range (with both the current and any previous effSize) and the
+    // physical address of each translated fragment.
+    index.begin(idx, inst->seqNum);
+    index.addRange(idx, inst->physEffAddr, inst->effSize);
+    if (request) {
+        index.addRange(idx, inst->physEffAddr, request->_size);
+        for (const auto &req : request->_reqs) {
+            if (req->hasPaddr())
+                index.addRange(idx, req->getPaddr(), req->getSize());
+        }
+    }
+}
+
 void
 LSQUnit::loadSetReplay(DynInstPtr inst, LSQRequest* request, bool dropReqNow)
 {
@@ -1566,7 +1678,7 @@ LSQUnit::storeDoWriteSQ(const DynInstPtr &inst)
         if (request->isMemAccessRequired() && (inst->getFault() == NoFault)) {
 
             if (cpu->checker) {
-                inst->reqToVerify = std::make_shared<Request>(*request->req());
+                inst->reqToVerify = makeRequest(*request->req());
             }
             Fault fault;
             fault = write(request, inst->memData, inst->sqIdx);
@@ -1731,7 +1843,7 @@ LSQUnit::triggerStorePFTrain(int sq_idx)
     Addr pc = inst->pcState().instAddr();
     // create request
     RequestPtr req =
-        std::make_shared<Request>(vaddr, 1, Request::STORE_PF_TRAIN, inst->requestorId(), pc, inst->contextId());
+        makeRequest(vaddr, 1, Request::STORE_PF_TRAIN, inst->requestorId(), pc, inst->contextId());
     req->setPaddr(inst->physEffAddr);
 
     // create packet
@@ -1831,6 +1943,7 @@ LSQUnit::commitLoad()
         }
     }
 
+    lqAddrIndex.remove(loadQueue.head());
     loadQueue.front().clear();
     loadQueue.pop_front();
     lastClockLQPopEntries++;
@@ -2266,6 +2379,7 @@ LSQUnit::squash(const InstSeqNum &squashed_num)
 
         // Clear the smart pointer to make sure it is decremented.
         loadQueue.back().instruction()->setSquashed();
+        lqAddrIndex.remove(loadQueue.tail());
         loadQueue.back().clear();
 
         loadQueue.pop_back();
@@ -2353,6 +2467,7 @@ LSQUnit::squash(const InstSeqNum &squashed_num)
 
         // Clear the smart pointer to make sure it is decremented.
         storeQueue.back().instruction()->setSquashed();
+        sqAddrIndex.remove(storeQueue.tail());
 
         // Must delete request now that it wasn't handed off to
         // memory.  This is quite ugly.  @todo: Figure out the proper
@@ -2588,8 +2703,15 @@ LSQUnit::completeStore(typename StoreQueue::iterator store_idx, bool from_sbuffe
         }
     }
 
+    // Drop any decoded instructions cached for the written code.
+    if (store_inst->effAddrValid()) {
+        cpu->tcBase(lsqID)->getDecoderPtr()->invalidateCodeRange(
+            store_inst->effAddr, store_inst->effSize);
+    }
+
     if (store_idx == storeQueue.begin()) {
         do {
+            sqAddrIndex.remove(storeQueue.head());
             storeQueue.front().clear();
             storeQueue.pop_front();
             lastClockSQPopEntries++;
@@ -3058,10 +3180,23 @@ LSQUnit::read(LSQRequest *request, ssize_t load_idx)
     // Check the SQ for any previous stores that might lead to forwarding
     auto store_it = load_inst->sqIt;
     assert (store_it >= storeWBIt);
+    // Either walk every older store or only those the address index
+    // reports on a line of the load, in the same youngest-first order.
+    bool indexed = !load_inst->isDataPrefetch() &&
+        findForwardCandidates(request, load_inst);
+    size_t candidate = addrCandidates.size();
     // End once we've reached the top of the LSQ
-    while (store_it != storeWBIt && !load_inst->isDataPrefetch()) {
-        // Move the index to one younger
-        store_it--;
+    while (!load_inst->isDataPrefetch()) {
+        if (indexed) {
+            if (candidate == 0)
+                break;
+            store_it = storeQueue.getIterator(addrCandidates[--candidate].idx);
+        } else {
+            if (store_it == storeWBIt)
+                break;
+            // Move the index to one younger
+            store_it--;
+        }
         assert(store_it->valid());
         assert(store_it->instruction()->seqNum < load_inst->seqNum);
         int store_size = store_it->size();
@@ -3332,6 +3467,7 @@ LSQUnit::write(LSQRequest *request, uint8_t *data, ssize_t store_idx)
     entry.setRequest(request);
     unsigned size = request->_size;
     entry.size() = size;
+    indexMemAddr(entry.instruction(), request);
     bool store_no_data =
         request->mainReq()->getFlags() & Request::STORE_NO_DATA;
         entry.isAllZeros() = store_no_data;
@@ -66,6 +66,7 @@
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/limits.hh"
 #include "cpu/o3/lsq.hh"
+#include "cpu/o3/lsq_addr_index.hh"
 #include "cpu/timebuf.hh"
 #include "debug/HtmCpu.hh"
 #include "debug/LSQUnit.hh"
@@ -390,6 +391,19 @@ class LSQUnit
      */
     void loadSetReplay(DynInstPtr inst, LSQRequest* request, bool dropReqNow);
 
+    /**
+     * Record the physical lines a load or store touches in the address
+     * index, called whenever its translation (re)completes.
+     */
+    void indexMemAddr(const DynInstPtr &inst, LSQRequest *request);
+
+    /**
+     * Collect into addrCandidates the older stores a load may forward
+     * from. @return false if the full store queue walk is required.
+     */
+    bool findForwardCandidates(LSQRequest *request,
+                               const DynInstPtr &load_inst);
+
     /** Check if an incoming invalidate hits in the lsq on a load
      * that might have issued out of order wrt another load beacuse
      * of the intermediate invalidate.
@@ -740,6 +754,14 @@ class LSQUnit
     /** Should loads be checked for dependency issues */
     bool checkLoads;
 
+    /** Find overlapping LQ/SQ entries through the address indexes. */
+    bool useAddrIndex;
+    /** Lines touched by each translated load and store. */
+    LSQAddrIndex lqAddrIndex;
+    LSQAddrIndex sqAddrIndex;
+    /** Scratch list of index lookup results. */
+    std::vector<LSQAddrIndex::Entry> addrCandidates;
+
     /** The number of store instructions in the SQ waiting to writeback. */
     int storesToWB;
 
@@ -28,8 +28,7 @@
 
 #include "cpu/o3/mem_dep_unit.hh"
 
-#include <map>
-#include <memory>
+#include <algorithm>
 #include <vector>
 
 #include "base/compiler.hh"
@@ -47,12 +46,6 @@ namespace gem5
 namespace o3
 {
 
-#ifdef DEBUG
-int MemDepUnit::MemDepEntry::memdep_count = 0;
-int MemDepUnit::MemDepEntry::memdep_insert = 0;
-int MemDepUnit::MemDepEntry::memdep_erase = 0;
-#endif
-
 MemDepUnit::MemDepUnit() : iqPtr(NULL), stats(nullptr) {}
 
 MemDepUnit::MemDepUnit(const BaseO3CPUParams &params)
@@ -65,30 +58,6 @@ MemDepUnit::MemDepUnit(const BaseO3CPUParams &params)
     DPRINTF(MemDepUnit, "Creating MemDepUnit object.\n");
 }
 
-MemDepUnit::~MemDepUnit()
-{
-    for (ThreadID tid = 0; tid < MaxThreads; tid++) {
-
-        ListIt inst_list_it = instList[tid].begin();
-
-        MemDepHashIt hash_it;
-
-        while (!instList[tid].empty()) {
-            hash_it = memDepHash.find((*inst_list_it)->seqNum);
-
-            assert(hash_it != memDepHash.end());
-
-            memDepHash.erase(hash_it);
-
-            instList[tid].erase(inst_list_it++);
-        }
-    }
-
-#ifdef DEBUG
-    assert(MemDepEntry::memdep_count == 0);
-#endif
-}
-
 void
 MemDepUnit::init(const BaseO3CPUParams &params, ThreadID tid, CPU *cpu)
 {
@@ -100,6 +69,10 @@ MemDepUnit::init(const BaseO3CPUParams &params, ThreadID tid, CPU *cpu)
     depPred.init(params.store_set_clear_period, params.store_set_clear_thres, params.SSITSize,
             params.LFSTSize, params.LFSTEntrySize);
 
+    // In-flight sequence numbers mostly span less than twice the ROB;
+    // the rest go to the overflow map.
+    entries.init(2 * params.numROBEntries);
+
     std::string stats_group_name = csprintf("MemDepUnit__%i", tid);
     cpu->addStatGroup(stats_group_name.c_str(), &stats);
     this->cpu = cpu;
@@ -123,24 +96,14 @@ MemDepUnit::MemDepUnitStats::MemDepUnitStats(statistics::Group *parent)
 bool
 MemDepUnit::isDrained() const
 {
-    bool drained = instsToReplay.empty()
-                 && memDepHash.empty()
-                 && instsToReplay.empty();
-    for (int i = 0; i < MaxThreads; ++i)
-        drained = drained && instList[i].empty();
-
-    return drained;
+    return instsToReplay.empty() && entries.size() == 0;
 }
 
 void
 MemDepUnit::drainSanityCheck() const
 {
     assert(instsToReplay.empty());
-    assert(memDepHash.empty());
-    for (int i = 0; i < MaxThreads; ++i)
-        assert(instList[i].empty());
-    assert(instsToReplay.empty());
-    assert(memDepHash.empty());
+    assert(entries.size() == 0);
 }
 
 void
@@ -158,15 +121,39 @@ MemDepUnit::setIQ(InstructionQueue *iq_ptr)
     iqPtr = iq_ptr;
 }
 
+MemDepUnit::MemDepEntry *
+MemDepUnit::allocEntry(const DynInstPtr &inst)
+{
+    MemDepEntry *entry = entries.alloc(inst->seqNum);
+    entry->inst = inst;
+    return entry;
+}
+
+void
+MemDepUnit::freeEntry(MemDepEntry *entry)
+{
+    entries.free(entry);
+}
+
+MemDepUnit::MemDepEntry *
+MemDepUnit::findEntry(InstSeqNum seq_num)
+{
+    return entries.find(seq_num);
+}
+
 void
 MemDepUnit::insertBarrierSN(const DynInstPtr &barr_inst)
 {
     InstSeqNum barr_sn = barr_inst->seqNum;
 
-    if (barr_inst->isReadBarrier() || barr_inst->isHtmCmd())
-        loadBarrierSNs.insert(barr_sn);
-    if (barr_inst->isWriteBarrier() || barr_inst->isHtmCmd())
-        storeBarrierSNs.insert(barr_sn);
+    if ((barr_inst->isReadBarrier() || barr_inst->isHtmCmd()) &&
+        std::find(loadBarrierSNs.begin(), loadBarrierSNs.end(), barr_sn) ==
+            loadBarrierSNs.end())
+        loadBarrierSNs.push_back(barr_sn);
+    if ((barr_inst->isWriteBarrier() || barr_inst->isHtmCmd()) &&
+        std::find(storeBarrierSNs.begin(), storeBarrierSNs.end(), barr_sn) ==
+            storeBarrierSNs.end())
+        storeBarrierSNs.push_back(barr_sn);
 
     if (debug::MemDepUnit) {
         const char *barrier_type = nullptr;
@@ -190,23 +177,24 @@ MemDepUnit::insertBarrierSN(const DynInstPtr &barr_inst)
     }
 }
 
+void
+MemDepUnit::eraseBarrierSN(std::vector<InstSeqNum> &barriers,
+                           InstSeqNum barr_sn)
+{
+    auto it = std::find(barriers.begin(), barriers.end(), barr_sn);
+    if (it != barriers.end()) {
+        barriers.erase(it);
+    }
+}
+
 void
 MemDepUnit::insert(const DynInstPtr &inst)
 {
     ThreadID tid = inst->threadNumber;
 
-    MemDepEntryPtr inst_entry = std::make_shared<MemDepEntry>(inst);
-
-    // Add the MemDepEntry to the hash.
-    memDepHash.insert(
-        std::pair<InstSeqNum, MemDepEntryPtr>(inst->seqNum, inst_entry));
-#ifdef DEBUG
-    MemDepEntry::memdep_insert++;
-#endif
+    MemDepEntry *inst_entry = allocEntry(inst);
 
-    instList[tid].push_back(inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    instList[tid].push_back(inst->seqNum);
 
     // Check any barriers and the dependence predictor for any
     // producing memrefs/stores.
@@ -235,16 +223,16 @@ MemDepUnit::insert(const DynInstPtr &inst)
         }
     }
 
-    std::vector<MemDepEntryPtr> store_entries;
+    std::vector<MemDepEntry *> store_entries;
 
     // If there is a producing store, try to find the entry.
     for (auto producing_store : producing_stores) {
         DPRINTF(MemDepUnit, "Searching for producer [sn:%lli]\n",
                             producing_store);
-        MemDepHashIt hash_it = memDepHash.find(producing_store);
+        MemDepEntry *store_entry = findEntry(producing_store);
 
-        if (hash_it != memDepHash.end()) {
-            store_entries.push_back((*hash_it).second);
+        if (store_entry) {
+            store_entries.push_back(store_entry);
             DPRINTF(MemDepUnit, "Producer found\n");
         }
     }
@@ -267,7 +255,7 @@ MemDepUnit::insert(const DynInstPtr &inst)
 
         // Add this instruction to the list of dependents.
         for (auto store_entry : store_entries)
-            store_entry->dependInsts.push_back(inst_entry);
+            store_entry->dependInsts.push_back(inst->seqNum);
 
         inst_entry->memDeps = store_entries.size();
 
@@ -323,19 +311,10 @@ MemDepUnit::insertBarrier(const DynInstPtr &barr_inst)
 {
     ThreadID tid = barr_inst->threadNumber;
 
-    MemDepEntryPtr inst_entry = std::make_shared<MemDepEntry>(barr_inst);
-
-    // Add the MemDepEntry to the hash.
-    memDepHash.insert(
-        std::pair<InstSeqNum, MemDepEntryPtr>(barr_inst->seqNum, inst_entry));
-#ifdef DEBUG
-    MemDepEntry::memdep_insert++;
-#endif
+    allocEntry(barr_inst);
 
     // Add the instruction to the instruction list.
-    instList[tid].push_back(barr_inst);
-
-    inst_entry->listIt = --(instList[tid].end());
+    instList[tid].push_back(barr_inst->seqNum);
 
     insertBarrierSN(barr_inst);
 }
@@ -367,7 +346,8 @@ MemDepUnit::replay()
     while (!instsToReplay.empty()) {
         temp_inst = instsToReplay.front();
 
-        MemDepEntryPtr inst_entry = findInHash(temp_inst);
+        MemDepEntry *inst_entry = findEntry(temp_inst->seqNum);
+        assert(inst_entry);
 
         DPRINTF(MemDepUnit, "Replaying mem instruction PC %s [sn:%lli].\n",
                 temp_inst->pcState(), temp_inst->seqNum);
@@ -386,19 +366,18 @@ MemDepUnit::completed(const DynInstPtr &inst)
 
     ThreadID tid = inst->threadNumber;
 
-    // Remove the instruction from the hash and the list.
-    MemDepHashIt hash_it = memDepHash.find(inst->seqNum);
-
-    assert(hash_it != memDepHash.end());
+    // Release the entry; its list slot is dropped once it reaches the
+    // front of the list.
+    MemDepEntry *inst_entry = findEntry(inst->seqNum);
 
-    instList[tid].erase((*hash_it).second->listIt);
+    assert(inst_entry);
 
-    (*hash_it).second = NULL;
+    freeEntry(inst_entry);
 
-    memDepHash.erase(hash_it);
-#ifdef DEBUG
-    MemDepEntry::memdep_erase++;
-#endif
+    auto &list = instList[tid];
+    while (!list.empty() && !findEntry(list.front())) {
+        list.pop_front();
+    }
 }
 
 void
@@ -410,11 +389,11 @@ MemDepUnit::completeInst(const DynInstPtr &inst)
 
     if (inst->isWriteBarrier() || inst->isHtmCmd()) {
         assert(hasStoreBarrier());
-        storeBarrierSNs.erase(barr_sn);
+        eraseBarrierSN(storeBarrierSNs, barr_sn);
     }
     if (inst->isReadBarrier() || inst->isHtmCmd()) {
         assert(hasLoadBarrier());
-        loadBarrierSNs.erase(barr_sn);
+        eraseBarrierSN(loadBarrierSNs, barr_sn);
     }
     if (debug::MemDepUnit) {
         const char *barrier_type = nullptr;
@@ -441,14 +420,15 @@ MemDepUnit::wakeDependents(const DynInstPtr &inst)
         return;
     }
 
-    MemDepEntryPtr inst_entry = findInHash(inst);
+    MemDepEntry *inst_entry = findEntry(inst->seqNum);
+    assert(inst_entry);
     stats.dependentLoads += inst_entry->dependInsts.size();
 
     for (int i = 0; i < inst_entry->dependInsts.size(); ++i ) {
-        MemDepEntryPtr woken_inst = inst_entry->dependInsts[i];
+        MemDepEntry *woken_inst = findEntry(inst_entry->dependInsts[i]);
 
-        if (!woken_inst->inst) {
-            // Potentially removed mem dep entries could be on this list
+        if (!woken_inst) {
+            // Squashed dependents have already released their entries
             continue;
         }
 
@@ -459,8 +439,7 @@ MemDepUnit::wakeDependents(const DynInstPtr &inst)
         assert(woken_inst->memDeps > 0);
         woken_inst->memDeps -= 1;
 
-        if ((woken_inst->memDeps == 0) &&
-            !woken_inst->squashed) {
+        if (woken_inst->memDeps == 0) {
             woken_inst->inst->issueQue->markMemDepDone(woken_inst->inst);
         }
     }
@@ -468,76 +447,41 @@ MemDepUnit::wakeDependents(const DynInstPtr &inst)
     inst_entry->dependInsts.clear();
 }
 
-MemDepUnit::MemDepEntry::MemDepEntry(const DynInstPtr &new_inst) :
-    inst(new_inst)
-{
-#ifdef DEBUG
-    ++memdep_count;
-
-    DPRINTF(MemDepUnit,
-            "Memory dependency entry created. memdep_count=%i %s\n",
-            memdep_count, inst->pcState());
-#endif
-}
-
-MemDepUnit::MemDepEntry::~MemDepEntry()
-{
-    for (int i = 0; i < dependInsts.size(); ++i) {
-        dependInsts[i] = NULL;
-    }
-#ifdef DEBUG
-    --memdep_count;
-
-    DPRINTF(MemDepUnit,
-            "Memory dependency entry deleted. memdep_count=%i %s\n",
-            memdep_count, inst->pcState());
-#endif
-}
-
 void
 MemDepUnit::squash(const InstSeqNum &squashed_num, ThreadID tid)
 {
     if (!instsToReplay.empty()) {
-        ListIt replay_it = instsToReplay.begin();
-        while (replay_it != instsToReplay.end()) {
-            if ((*replay_it)->threadNumber == tid &&
-                (*replay_it)->seqNum > squashed_num) {
-                instsToReplay.erase(replay_it++);
-            } else {
-                ++replay_it;
-            }
-        }
+        instsToReplay.erase(
+            std::remove_if(instsToReplay.begin(), instsToReplay.end(),
+                [tid, squashed_num](const DynInstPtr &inst) {
+                    return inst->threadNumber == tid &&
+                           inst->seqNum > squashed_num;
+                }),
+            instsToReplay.end());
     }
 
-    ListIt squash_it = instList[tid].end();
-    --squash_it;
-
-    MemDepHashIt hash_it;
-
-    while (!instList[tid].empty() &&
-           (*squash_it)->seqNum > squashed_num) {
+    auto &list = instList[tid];
 
-        DPRINTF(MemDepUnit, "Squashing inst [sn:%lli]\n",
-                (*squash_it)->seqNum);
+    while (!list.empty()) {
+        InstSeqNum seq_num = list.back();
+        MemDepEntry *inst_entry = findEntry(seq_num);
 
-        loadBarrierSNs.erase((*squash_it)->seqNum);
-
-        storeBarrierSNs.erase((*squash_it)->seqNum);
-
-        hash_it = memDepHash.find((*squash_it)->seqNum);
+        // Skip over instructions that have already completed.
+        if (inst_entry) {
+            if (seq_num <= squashed_num) {
+                break;
+            }
 
-        assert(hash_it != memDepHash.end());
+            DPRINTF(MemDepUnit, "Squashing inst [sn:%lli]\n", seq_num);
 
-        (*hash_it).second->squashed = true;
+            eraseBarrierSN(loadBarrierSNs, seq_num);
 
-        (*hash_it).second = NULL;
+            eraseBarrierSN(storeBarrierSNs, seq_num);
 
-        memDepHash.erase(hash_it);
-#ifdef DEBUG
-        MemDepEntry::memdep_erase++;
-#endif
+            freeEntry(inst_entry);
+        }
 
-        instList[tid].erase(squash_it--);
+        list.pop_back();
     }
 
     // Tell the dependency predictor to squash as well.
@@ -565,16 +509,6 @@ MemDepUnit::issue(const DynInstPtr &inst)
     depPred.issued(inst->pcState().instAddr(), inst->seqNum, inst->isStore());
 }
 
-MemDepUnit::MemDepEntryPtr &
-MemDepUnit::findInHash(const DynInstConstPtr &inst)
-{
-    MemDepHashIt hash_it = memDepHash.find(inst->seqNum);
-
-    assert(hash_it != memDepHash.end());
-
-    return (*hash_it).second;
-}
-
 void
 MemDepUnit::dumpLists()
 {
@@ -582,27 +516,27 @@ MemDepUnit::dumpLists()
         cprintf("Instruction list %i size: %i\n",
                 tid, instList[tid].size());
 
-        ListIt inst_list_it = instList[tid].begin();
         int num = 0;
 
-        while (inst_list_it != instList[tid].end()) {
+        for (InstSeqNum seq_num : instList[tid]) {
+            MemDepEntry *inst_entry = findEntry(seq_num);
+            if (!inst_entry) {
+                continue;
+            }
+            const DynInstPtr &inst = inst_entry->inst;
             cprintf("Instruction:%i\nPC: %s\n[sn:%llu]\n[tid:%i]\nIssued:%i\n"
                     "Squashed:%i\n\n",
-                    num, (*inst_list_it)->pcState(),
-                    (*inst_list_it)->seqNum,
-                    (*inst_list_it)->threadNumber,
-                    (*inst_list_it)->isIssued(),
-                    (*inst_list_it)->isSquashed());
-            inst_list_it++;
+                    num, inst->pcState(),
+                    inst->seqNum,
+                    inst->threadNumber,
+                    inst->isIssued(),
+                    inst->isSquashed());
             ++num;
         }
     }
 
-    cprintf("Memory dependence hash size: %i\n", memDepHash.size());
-
-#ifdef DEBUG
-    cprintf("Memory dependence entries: %i\n", MemDepEntry::memdep_count);
-#endif
+    cprintf("Memory dependence entries: %i (%i overflowed)\n", entries.size(),
+            entries.numOverflowed());
 }
 
 } // namespace o3
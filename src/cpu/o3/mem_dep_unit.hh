@@ -41,33 +41,20 @@
 #ifndef __CPU_O3_MEM_DEP_UNIT_HH__
 #define __CPU_O3_MEM_DEP_UNIT_HH__
 
-#include <list>
-#include <memory>
-#include <set>
-#include <unordered_map>
-#include <unordered_set>
+#include <deque>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/limits.hh"
+#include "cpu/o3/seq_num_ring.hh"
 #include "cpu/o3/store_set.hh"
 #include "debug/MemDepUnit.hh"
 
 namespace gem5
 {
 
-struct SNHash
-{
-    size_t
-    operator()(const InstSeqNum &seq_num) const
-    {
-        unsigned a = (unsigned)seq_num;
-        unsigned hash = (((a >> 14) ^ ((a >> 2) & 0xffff))) & 0x7FFFFFFF;
-        return hash;
-    }
-};
-
 struct BaseO3CPUParams;
 
 namespace o3
@@ -99,9 +86,6 @@ class MemDepUnit
     /** Constructs a MemDepUnit with given parameters. */
     MemDepUnit(const BaseO3CPUParams &params);
 
-    /** Frees up any memory allocated. */
-    ~MemDepUnit();
-
     /** Returns the name of the memory dependence unit. */
     std::string name() const { return _name; }
 
@@ -169,67 +153,56 @@ class MemDepUnit
     /** Wakes any dependents of a memory instruction. */
     void wakeDependents(const DynInstPtr &inst);
 
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
-
-    class MemDepEntry;
-
-    typedef std::shared_ptr<MemDepEntry> MemDepEntryPtr;
-
     /** Memory dependence entries that track memory operations, marking
      *  when the instruction is ready to execute and what instructions depend
      *  upon it.
      */
-    class MemDepEntry
+    struct MemDepEntry
     {
-      public:
-        /** Constructs a memory dependence entry. */
-        MemDepEntry(const DynInstPtr &new_inst);
-
-        /** Frees any pointers. */
-        ~MemDepEntry();
-
-        /** Returns the name of the memory dependence entry. */
-        std::string name() const { return "memdepentry"; }
-
         /** The instruction being tracked. */
         DynInstPtr inst;
 
-        /** The iterator to the instruction's location inside the list. */
-        ListIt listIt;
+        /** Sequence number of the instruction, 0 if the entry is free. */
+        InstSeqNum seqNum = 0;
 
-        /** A vector of any dependent instructions. */
-        std::vector<MemDepEntryPtr> dependInsts;
+        /** Sequence numbers of the dependent instructions. Entries are
+         *  reused, so the vector keeps its capacity across instructions.
+         */
+        std::vector<InstSeqNum> dependInsts;
 
         /** Number of memory dependencies that need to be satisfied. */
         int memDeps = 0;
-        /** If the instruction is completed. */
-        bool completed = false;
-        /** If the instruction is squashed. */
-        bool squashed = false;
-
-        /** For debugging. */
-#ifdef DEBUG
-        static int memdep_count;
-        static int memdep_insert;
-        static int memdep_erase;
-#endif
+
+        void
+        clear()
+        {
+            inst = nullptr;
+            seqNum = 0;
+            dependInsts.clear();
+            memDeps = 0;
+        }
     };
 
-    /** Finds the memory dependence entry in the hash map. */
-    MemDepEntryPtr &findInHash(const DynInstConstPtr& inst);
+    /** Allocates the entry of a newly inserted instruction. */
+    MemDepEntry *allocEntry(const DynInstPtr &inst);
 
-    typedef std::unordered_map<InstSeqNum, MemDepEntryPtr, SNHash> MemDepHash;
+    /** Releases the entry of a completed or squashed instruction. */
+    void freeEntry(MemDepEntry *entry);
 
-    typedef typename MemDepHash::iterator MemDepHashIt;
+    /** Finds the live entry of a sequence number, or nullptr. */
+    MemDepEntry *findEntry(InstSeqNum seq_num);
 
-    /** A hash map of all memory dependence entries. */
-    MemDepHash memDepHash;
+    /** The entries of all instructions in the unit. */
+    SeqNumRing<MemDepEntry> entries;
 
-    /** A list of all instructions in the memory dependence unit. */
-    std::list<DynInstPtr> instList[MaxThreads];
+    /** Sequence numbers of all instructions in the memory dependence unit,
+     *  in insertion order. Completed instructions are left behind until
+     *  they reach either end.
+     */
+    std::deque<InstSeqNum> instList[MaxThreads];
 
     /** A list of all instructions that are going to be replayed. */
-    std::list<DynInstPtr> instsToReplay;
+    std::deque<DynInstPtr> instsToReplay;
 
     /** The memory dependence predictor.  It is accessed upon new
      *  instructions being added to the IQ, and responds by telling
@@ -239,10 +212,10 @@ class MemDepUnit
     StoreSet depPred;
 
     /** Sequence numbers of outstanding load barriers. */
-    std::unordered_set<InstSeqNum> loadBarrierSNs;
+    std::vector<InstSeqNum> loadBarrierSNs;
 
     /** Sequence numbers of outstanding store barriers. */
-    std::unordered_set<InstSeqNum> storeBarrierSNs;
+    std::vector<InstSeqNum> storeBarrierSNs;
 
     /** Is there an outstanding load barrier that loads must wait on. */
     bool hasLoadBarrier() const { return !loadBarrierSNs.empty(); }
@@ -253,6 +226,10 @@ class MemDepUnit
     /** Inserts the SN of a barrier inst. to the list of tracked barriers */
     void insertBarrierSN(const DynInstPtr &barr_inst);
 
+    /** Removes a SN from a list of tracked barriers, if present. */
+    static void eraseBarrierSN(std::vector<InstSeqNum> &barriers,
+                               InstSeqNum barr_sn);
+
     /** Pointer to the IQ. */
     InstructionQueue *iqPtr;
 
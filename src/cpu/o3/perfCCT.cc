@@ -1,6 +1,8 @@
 #include "cpu/o3/perfCCT.hh"
 
+#include "base/output.hh"
 #include "cpu/o3/dyn_inst.hh"
+#include "sim/sim_exit.hh"
 
 namespace gem5
 {
@@ -13,22 +15,32 @@ InstMeta::reset(const DynInstPtr inst)
     this->sn = inst->seqNum;
     posTick.clear();
     posTick.resize((int)PerfRecord::AtCommit + 1, 0);
+    detail.fill(0);
     disasm = inst->staticInst->disassemble(inst->pcState().instAddr());
     pc = inst->pcState().instAddr();
 }
 
 
-PerfCCT::PerfCCT(bool enable, ArchDBer* db) : enableCCT(enable), archdb(db)
+PerfCCT::PerfCCT(bool enable, ArchDBer* db, unsigned sample_period, unsigned sample_burst,
+                 const std::string &sample_file)
+    : enableCCT(enable), archdb(db), samplePeriod(sample_period), sampleBurst(sample_burst)
 {
-    if (enableCCT) {
+    fatal_if(samplePeriod && (sampleBurst == 0 || sampleBurst > samplePeriod),
+             "Lifetime sample burst %u must be in [1, %u]\n", sampleBurst, samplePeriod);
+    if (enableCCT || samplePeriod) {
         metas.resize(MaxMetas);
+    }
+    if (samplePeriod) {
+        openSampleDB(sample_file);
+    }
+    if (enableCCT) {
 
         ss << "INSERT INTO LifeTimeCommitTrace(";
         ss << PerfRecordStrings[0];
         for (int i=1; i < (int)PerfRecord::Num_PerfRecord; i++) {
             ss << "," << PerfRecordStrings[i];
         }
-        ss << ") VALUES(";
+        ss << ",WindowID) VALUES(";
         sql_insert_cmd = ss.str();
         ss.str(std::string());
     }
@@ -44,7 +56,7 @@ PerfCCT::getMeta(InstSeqNum sn)
 void
 PerfCCT::createMeta(const DynInstPtr inst)
 {
-    if (!enableCCT) [[likely]] {
+    if (!enableCCT && !sampled(inst->seqNum)) [[likely]] {
         return;
     }
     auto& old = metas[inst->seqNum % MaxMetas];
@@ -54,21 +66,41 @@ PerfCCT::createMeta(const DynInstPtr inst)
 void
 PerfCCT::updateInstPos(InstSeqNum sn, const PerfRecord pos)
 {
-    if (!enableCCT) [[likely]] {
+    if (!enableCCT && !samplePeriod) [[likely]] {
         return;
     }
     auto meta = getMeta(sn);
+    // Slots of instructions that are not sampled hold older ones
+    if (meta->sn != sn) return;
     if (meta->posTick.at((int)pos)) return;
     meta->posTick.at((int)pos) = curTick();
 }
 
+void
+PerfCCT::updateInstDetail(InstSeqNum sn, const PerfDetail detail, uint64_t value)
+{
+    if (!enableCCT && !samplePeriod) [[likely]] {
+        return;
+    }
+    auto meta = getMeta(sn);
+    if (meta->sn != sn) return;
+    meta->detail[(int)detail] = value;
+}
+
 void
 PerfCCT::commitMeta(InstSeqNum sn)
 {
-    if (!enableCCT) [[likely]] {
+    if (!enableCCT && !samplePeriod) [[likely]] {
         return;
     }
     auto meta = getMeta(sn);
+    if (meta->sn != sn) return;
+    if (samplePeriod && sampled(sn)) {
+        writeSample(*meta);
+    }
+    if (!enableCCT || !archdb->recording()) {
+        return;
+    }
     ss << sql_insert_cmd;
     // dump counter first
     ss << meta->posTick[0];
@@ -82,10 +114,87 @@ PerfCCT::commitMeta(InstSeqNum sn)
     // (negtive pc = real pc - 2^64)
     // when read a negtive pc, real pc = negtive pc + 2^64
     ss << "," << int64_t(meta->pc);
+    ss << "," << archdb->windowId;
     ss << ");";
     archdb->execmd(ss.str());
     ss.str(std::string());
 }
 
+void
+PerfCCT::openSampleDB(const std::string &path)
+{
+    std::string cols = PerfRecordStrings[0];
+    std::string vals = "?";
+    std::string create = std::string("CREATE TABLE LifeTimeCommitTrace(ID INTEGER PRIMARY KEY AUTOINCREMENT,") +
+                         PerfRecordStrings[0] + " INT NOT NULL";
+    for (int i = 1; i < (int)PerfRecord::Num_PerfRecord; i++) {
+        std::string name = PerfRecordStrings[i];
+        cols += "," + name;
+        vals += ",?";
+        create += "," + name + (name == "Disasm" ? " CHAR(20)" : " INT") + " NOT NULL";
+    }
+    for (int i = 0; i < (int)PerfDetail::Num_PerfDetail; i++) {
+        std::string name = PerfDetailStrings[i];
+        cols += "," + name;
+        vals += ",?";
+        create += "," + name + " INT NOT NULL";
+    }
+    create += ");";
+
+    std::string file = simout.resolve(path);
+    unlink(file.c_str());
+    if (sqlite3_open(file.c_str(), &sampleDB) != SQLITE_OK) {
+        fatal("Can't open lifetime sample file %s: %s\n", file, sqlite3_errmsg(sampleDB));
+    }
+    std::string insert = "INSERT INTO LifeTimeCommitTrace(" + cols + ") VALUES(" + vals + ");";
+    fatal_if(sqlite3_exec(sampleDB, "PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF;", nullptr, nullptr,
+                          nullptr) != SQLITE_OK ||
+             sqlite3_exec(sampleDB, create.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK ||
+             sqlite3_prepare_v2(sampleDB, insert.c_str(), -1, &sampleInsert, nullptr) != SQLITE_OK ||
+             sqlite3_exec(sampleDB, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK,
+             "Can't set up lifetime sample file %s: %s\n", file, sqlite3_errmsg(sampleDB));
+    registerExitCallback([this]() { closeSampleDB(); });
+}
+
+void
+PerfCCT::writeSample(const InstMeta &meta)
+{
+    int col = 1;
+    for (int i = 0; i < (int)PerfRecord::Num_PerfRecord; i++) {
+        if (i == (int)PerfRecord::Disasm) {
+            sqlite3_bind_text(sampleInsert, col++, meta.disasm.c_str(), -1, SQLITE_TRANSIENT);
+        } else if (i == (int)PerfRecord::PC) {
+            // same signed encoding as the arch db
+            sqlite3_bind_int64(sampleInsert, col++, int64_t(meta.pc));
+        } else {
+            sqlite3_bind_int64(sampleInsert, col++, meta.posTick[i]);
+        }
+    }
+    for (auto value : meta.detail) {
+        sqlite3_bind_int64(sampleInsert, col++, value);
+    }
+    fatal_if(sqlite3_step(sampleInsert) != SQLITE_DONE, "Lifetime sample insert failed: %s\n",
+             sqlite3_errmsg(sampleDB));
+    sqlite3_reset(sampleInsert);
+
+    // Commit in large transactions, one per row would dominate the cost
+    if (++samplesInTransaction == 4096) {
+        sqlite3_exec(sampleDB, "COMMIT; BEGIN;", nullptr, nullptr, nullptr);
+        samplesInTransaction = 0;
+    }
+}
+
+void
+PerfCCT::closeSampleDB()
+{
+    if (!sampleDB)
+        return;
+    sqlite3_exec(sampleDB, "COMMIT;", nullptr, nullptr, nullptr);
+    sqlite3_finalize(sampleInsert);
+    sqlite3_close(sampleDB);
+    sampleInsert = nullptr;
+    sampleDB = nullptr;
+}
+
 }
 }
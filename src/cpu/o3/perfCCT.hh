@@ -1,10 +1,12 @@
 #ifndef __CPU_O3_PERFCCT_HH__
 #define __CPU_O3_PERFCCT_HH__
 
+#include <array>
 #include <string>
 
 #include "base/types.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "enums/PerfDetail.hh"
 #include "enums/PerfRecord.hh"
 #include "sim/arch_db.hh"
 
@@ -17,8 +19,9 @@ namespace o3
 class InstMeta
 {
     friend class PerfCCT;
-    InstSeqNum sn;
+    InstSeqNum sn = 0;
     std::vector<uint64_t> posTick;
+    std::array<uint64_t, (int)PerfDetail::Num_PerfDetail> detail;
     std::string disasm;
     Addr pc;
   public:
@@ -26,7 +29,22 @@ class InstMeta
     void reset(const DynInstPtr inst);
 };
 
-// performanceCounter commitTrace
+/**
+ * performanceCounter commitTrace
+ *
+ * Records the tick at which each instruction reaches every PerfRecord
+ * position into the LifeTimeCommitTrace table of the arch db. With a
+ * sample period it also records 1 in N instructions, or bursts of them,
+ * with the PerfDetail fields into a table of the same name in a separate
+ * SQLite file, readable by util/perfcct.py:
+ * - fetchstall: the StallReason of the last cycle fetch was fully stalled
+ *   before this instruction
+ * - iqwait: at issue queue insertion, 0 ready, 1 waiting for operands,
+ *   2 waiting for a memory dependence
+ * - arbfail: 1 if the instruction lost issue arbitration
+ * - cachemisslevel: cache level that answered its access, 0 for L1
+ * - ldstaddr: physical address of loads and stores
+ */
 class PerfCCT
 {
     const int MaxMetas = 1500;  // same as MaxNum of DynInst
@@ -34,6 +52,17 @@ class PerfCCT
     ArchDBer* archdb;
     std::string sql_insert_cmd;
 
+    const unsigned samplePeriod;
+    const unsigned sampleBurst;
+    sqlite3 *sampleDB = nullptr;
+    sqlite3_stmt *sampleInsert = nullptr;
+    uint64_t samplesInTransaction = 0;
+
+    bool sampled(InstSeqNum sn) const { return samplePeriod && sn % samplePeriod < sampleBurst; }
+    void openSampleDB(const std::string &path);
+    void writeSample(const InstMeta &meta);
+    void closeSampleDB();
+
     std::vector<InstMeta> metas;
 
     std::stringstream ss;
@@ -41,12 +70,15 @@ class PerfCCT
     InstMeta* getMeta(InstSeqNum sn);
 
   public:
-    PerfCCT(bool enable, ArchDBer* db);
+    PerfCCT(bool enable, ArchDBer* db, unsigned sample_period = 0, unsigned sample_burst = 1,
+            const std::string &sample_file = "");
 
     void createMeta(const DynInstPtr inst);
 
     void updateInstPos(InstSeqNum sn, const PerfRecord pos);
 
+    void updateInstDetail(InstSeqNum sn, const PerfDetail detail, uint64_t value);
+
     // void updateInstMeta
 
     void commitMeta(InstSeqNum sn);
@@ -41,6 +41,7 @@
 
 #include "cpu/o3/rename.hh"
 
+#include <algorithm>
 #include <list>
 
 #include "cpu/o3/cpu.hh"
@@ -67,6 +68,7 @@ Rename::Rename(CPU *_cpu, const BaseO3CPUParams &params)
       renameWidth(params.renameWidth),
       releaseWidth(params.phyregReleaseWidth),
       numThreads(params.numThreads),
+      numCheckpoints(params.numRenameCheckpoints),
       stats(_cpu)
 {
     if (renameWidth > MaxWidth)
@@ -87,6 +89,7 @@ Rename::Rename(CPU *_cpu, const BaseO3CPUParams &params)
         stalls[tid] = {false, false};
         serializeInst[tid] = nullptr;
         serializeOnNextInst[tid] = false;
+        checkpoints.emplace_back(numCheckpoints);
     }
 
     renameStalls.resize(renameWidth, StallReason::NoStall);
@@ -142,6 +145,10 @@ Rename::RenameStats::RenameStats(statistics::Group *parent)
                "Number of HB maps that are committed"),
       ADD_STAT(undoneMaps, statistics::units::Count::get(),
                "Number of HB maps that are undone due to squashing"),
+      ADD_STAT(checkpointRestores, statistics::units::Count::get(),
+               "Number of squashes that restored a rename map checkpoint"),
+      ADD_STAT(checkpointsFull, statistics::units::Count::get(),
+               "Number of branches renamed without a free checkpoint"),
       ADD_STAT(serializing, statistics::units::Count::get(),
                "count of serializing insts renamed"),
       ADD_STAT(tempSerializing, statistics::units::Count::get(),
@@ -180,6 +187,8 @@ Rename::RenameStats::RenameStats(statistics::Group *parent)
 
     committedMaps.prereq(committedMaps);
     undoneMaps.prereq(undoneMaps);
+    checkpointRestores.prereq(checkpointRestores);
+    checkpointsFull.prereq(checkpointsFull);
     serializing.flags(statistics::total);
     tempSerializing.flags(statistics::total);
     skidInsts.flags(statistics::total);
@@ -297,6 +306,9 @@ Rename::resetStage()
         storesInProgress[tid] = 0;
 
         serializeOnNextInst[tid] = false;
+
+        while (!checkpoints[tid].empty())
+            dropOldestCheckpoint(tid);
     }
 }
 
@@ -310,8 +322,10 @@ Rename::setActiveThreads(std::list<ThreadID> *at_ptr)
 void
 Rename::setRenameMap(UnifiedRenameMap rm_ptr[MaxThreads])
 {
-    for (ThreadID tid = 0; tid < numThreads; tid++)
+    for (ThreadID tid = 0; tid < numThreads; tid++) {
         renameMap[tid] = &rm_ptr[tid];
+        renameMap[tid]->initCheckpoints(numCheckpoints);
+    }
 }
 
 void
@@ -868,6 +882,10 @@ Rename::renameInsts(ThreadID tid)
 
         renameDestRegs(inst, inst->threadNumber);
 
+        if (numCheckpoints && inst->isControl()) {
+            takeCheckpoint(inst, tid);
+        }
+
         cpu->perfCCT->updateInstPos(inst->seqNum, PerfRecord::AtRename);
 
         if (inst->isAtomic() || inst->isStore()) {
@@ -1102,22 +1120,73 @@ Rename::tryFreePReg(PhysRegIdPtr preg)
 void
 Rename::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
 {
-    auto hb_it = historyBuffer[tid].begin();
+    auto &history = historyBuffer[tid];
+    auto &cps = checkpoints[tid];
+
+    // Drop the checkpoints of squashed branches. If the squash returns to
+    // a checkpointed branch, the map is restored in one step instead of
+    // walking the history buffer.
+    while (!cps.empty() && cps.back().instSeqNum > squashed_seq_num) {
+        dropYoungestCheckpoint(tid);
+    }
+    if (!cps.empty() && cps.back().instSeqNum == squashed_seq_num &&
+        !history.empty() && history.front().instSeqNum > squashed_seq_num) {
+        renameMap[tid]->restore(cps.back().map);
+        ++stats.checkpointRestores;
+
+        // The map is back at the branch already, so the squashed renames
+        // only drop their references, and the registers that become free
+        // go back to the free list as one set, youngest first like the
+        // walk below.
+        auto squashed_end = std::partition_point(
+            history.begin(), history.end(),
+            [squashed_seq_num](const RenameHistory &hb_entry) {
+                return hb_entry.instSeqNum > squashed_seq_num;
+            });
+        squashedRegs.clear();
+        for (auto it = history.begin(); it != squashed_end; ++it) {
+            PhysRegIdPtr preg = it->newPhysReg.PhyReg();
+            if (it->newPhysReg == it->prevPhysReg ||
+                preg == it->prevPhysReg.PhyReg() || preg->getRef() == 0 ||
+                preg->classValue() == InvalidRegClass) {
+                continue;
+            }
+            preg->decRef();
+            if (preg->getRef() == 0)
+                squashedRegs.push_back(preg);
+        }
+        freeList->addRegs(squashedRegs);
+
+        if (ppSquashInRename->hasListeners()) {
+            for (auto it = history.begin(); it != squashed_end; ++it) {
+                ppSquashInRename->notify(std::make_pair(
+                    it->instSeqNum, it->newPhysReg.PhyReg()));
+            }
+        }
+
+        DPRINTF(Rename, "[tid:%i] Restored rename map checkpoint of "
+                "[sn:%llu], %i renames undone, %i registers freed.\n",
+                tid, squashed_seq_num, squashed_end - history.begin(),
+                squashedRegs.size());
+        stats.undoneMaps += squashed_end - history.begin();
+        history.erase(history.begin(), squashed_end);
+        return;
+    }
 
     // After a syscall squashes everything, the history buffer may be empty
     // but the ROB may still be squashing instructions.
     // Go through the most recent instructions, undoing the mappings
     // they did and freeing up the registers.
-    while (!historyBuffer[tid].empty() &&
-           hb_it->instSeqNum > squashed_seq_num) {
-        assert(hb_it != historyBuffer[tid].end());
+    while (!history.empty() &&
+           history.front().instSeqNum > squashed_seq_num) {
+        const RenameHistory &hb_entry = history.front();
 
         DPRINTF(Rename,
                 "[tid:%i] Removing history entry with sequence "
                 "number %i (archReg: %d, newPhysReg: %s, prevPhysReg: %s).\n",
-                tid, hb_it->instSeqNum, hb_it->archReg.index(),
-                hb_it->newPhysReg.toString(),
-                hb_it->prevPhysReg.toString());
+                tid, hb_entry.instSeqNum, hb_entry.archReg.index(),
+                hb_entry.newPhysReg.toString(),
+                hb_entry.prevPhysReg.toString());
 
         // Undo the rename mapping only if it was really a change.
         // Special regs that are not really renamed (like misc regs
@@ -1125,22 +1194,22 @@ Rename::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
         // is the same as the old one.  While it would be merely a
         // waste of time to update the rename table, we definitely
         // don't want to put these on the free list.
-        if (hb_it->newPhysReg != hb_it->prevPhysReg) {
+        if (hb_entry.newPhysReg != hb_entry.prevPhysReg) {
             // Tell the rename map to set the architected register to the
             // previous physical register that it was renamed to.
-            renameMap[tid]->setEntry(hb_it->archReg, hb_it->prevPhysReg);
-            if (hb_it->newPhysReg.PhyReg() != hb_it->prevPhysReg.PhyReg()) {
-                tryFreePReg(hb_it->newPhysReg.PhyReg());
+            renameMap[tid]->setEntry(hb_entry.archReg, hb_entry.prevPhysReg);
+            if (hb_entry.newPhysReg.PhyReg() !=
+                hb_entry.prevPhysReg.PhyReg()) {
+                tryFreePReg(hb_entry.newPhysReg.PhyReg());
             }
         }
 
         // Notify potential listeners that the register mapping needs to be
-        // removed because the instruction it was mapped to got squashed. Note
-        // that this is done before hb_it is incremented.
-        ppSquashInRename->notify(std::make_pair(hb_it->instSeqNum,
-                                                hb_it->newPhysReg.PhyReg()));
+        // removed because the instruction it was mapped to got squashed.
+        ppSquashInRename->notify(std::make_pair(hb_entry.instSeqNum,
+                                                hb_entry.newPhysReg.PhyReg()));
 
-        historyBuffer[tid].erase(hb_it++);
+        history.pop_front();
 
         ++stats.undoneMaps;
     }
@@ -1149,18 +1218,22 @@ Rename::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
 void
 Rename::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
 {
+    auto &history = historyBuffer[tid];
+
     DPRINTF(Rename, "[tid:%i] Removing a committed instruction from the "
             "history buffer %u (size=%i), until [sn:%llu].\n",
-            tid, tid, historyBuffer[tid].size(), inst_seq_num);
-
-    auto hb_it = historyBuffer[tid].end();
+            tid, tid, history.size(), inst_seq_num);
 
-    --hb_it;
+    // Committed branches can no longer be squashed to.
+    auto &cps = checkpoints[tid];
+    while (!cps.empty() && cps.front().instSeqNum <= inst_seq_num) {
+        dropOldestCheckpoint(tid);
+    }
 
-    if (historyBuffer[tid].empty()) {
+    if (history.empty()) {
         DPRINTF(Rename, "[tid:%i] History buffer is empty.\n", tid);
         return;
-    } else if (hb_it->instSeqNum > inst_seq_num) {
+    } else if (history.back().instSeqNum > inst_seq_num) {
         DPRINTF(Rename, "[tid:%i] [sn:%llu] "
                 "Old sequence number encountered. "
                 "Ensure that a syscall happened recently.\n",
@@ -1172,29 +1245,56 @@ Rename::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
     // number. Some or even all of the committed instructions may not have
     // rename histories if they did not have destination registers that were
     // renamed.
-    while (!historyBuffer[tid].empty() &&
-           hb_it != historyBuffer[tid].end() &&
-           hb_it->instSeqNum <= inst_seq_num) {
+    while (!history.empty() &&
+           history.back().instSeqNum <= inst_seq_num) {
+        const RenameHistory &hb_entry = history.back();
 
         DPRINTF(Rename,
                 "[tid:%i] try to free up older rename of reg %s (%s), "
                 "[sn:%llu].\n",
-                tid, hb_it->prevPhysReg.toString(),
-                hb_it->prevPhysReg.PhyReg()->className(),
-                hb_it->instSeqNum);
+                tid, hb_entry.prevPhysReg.toString(),
+                hb_entry.prevPhysReg.PhyReg()->className(),
+                hb_entry.instSeqNum);
 
 
         // Don't free special phys regs like misc and zero regs, which
         // can be recognized because the new mapping is the same as
         // the old one.
-        if (hb_it->newPhysReg.PhyReg() != hb_it->prevPhysReg.PhyReg()) {
-            tryFreePReg(hb_it->prevPhysReg.PhyReg());
+        if (hb_entry.newPhysReg.PhyReg() != hb_entry.prevPhysReg.PhyReg()) {
+            tryFreePReg(hb_entry.prevPhysReg.PhyReg());
         }
 
         ++stats.committedMaps;
 
-        historyBuffer[tid].erase(hb_it--);
+        history.pop_back();
+    }
+}
+
+void
+Rename::takeCheckpoint(const DynInstPtr &inst, ThreadID tid)
+{
+    auto &cps = checkpoints[tid];
+    if (cps.size() >= numCheckpoints) {
+        ++stats.checkpointsFull;
+        return;
     }
+    cps.advance_tail();
+    cps.back().instSeqNum = inst->seqNum;
+    renameMap[tid]->checkpoint(cps.back().map);
+}
+
+void
+Rename::dropYoungestCheckpoint(ThreadID tid)
+{
+    renameMap[tid]->release(checkpoints[tid].back().map);
+    checkpoints[tid].pop_back();
+}
+
+void
+Rename::dropOldestCheckpoint(ThreadID tid)
+{
+    renameMap[tid]->release(checkpoints[tid].front().map);
+    checkpoints[tid].pop_front();
 }
 
 void
@@ -1340,7 +1440,7 @@ Rename::renameDestRegs(const DynInstPtr &inst, ThreadID tid)
 
         DPRINTF(Rename, "[tid:%i] [sn:%llu] "
                 "Adding instruction to history buffer (size=%i).\n",
-                tid,(*historyBuffer[tid].begin()).instSeqNum,
+                tid, historyBuffer[tid].front().instSeqNum,
                 historyBuffer[tid].size());
 
         // Tell the instruction to rename the appropriate destination
@@ -1641,11 +1741,9 @@ Rename::incrFullStat(const FullSource &source)
 void
 Rename::dumpHistory()
 {
-    std::list<RenameHistory>::iterator buf_it;
-
     for (ThreadID tid = 0; tid < numThreads; tid++) {
 
-        buf_it = historyBuffer[tid].begin();
+        auto buf_it = historyBuffer[tid].begin();
 
         while (buf_it != historyBuffer[tid].end()) {
             cprintf("Seq num: %i\nArch reg[%s]: %i New phys reg:"
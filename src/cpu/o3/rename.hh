@@ -42,9 +42,12 @@
 #ifndef __CPU_O3_RENAME_HH__
 #define __CPU_O3_RENAME_HH__
 
+#include <deque>
 #include <list>
 #include <utility>
+#include <vector>
 
+#include "base/circular_queue.hh"
 #include "base/statistics.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/commit.hh"
@@ -52,6 +55,7 @@
 #include "cpu/o3/free_list.hh"
 #include "cpu/o3/iew.hh"
 #include "cpu/o3/limits.hh"
+#include "cpu/o3/rename_map.hh"
 #include "cpu/timebuf.hh"
 #include "sim/probe/probe.hh"
 
@@ -332,9 +336,37 @@ class Rename
     };
 
     /** A per-thread list of all destination register renames, used to either
-     * undo rename mappings or free old physical registers.
+     * undo rename mappings or free old physical registers. The youngest
+     * rename is at the front.
      */
-    std::list<RenameHistory> historyBuffer[MaxThreads];
+    std::deque<RenameHistory> historyBuffer[MaxThreads];
+
+    /** A snapshot of the rename map taken right after renaming a branch. */
+    struct RenameCheckpoint
+    {
+        InstSeqNum instSeqNum;
+        UnifiedRenameMap::Checkpoint map;
+    };
+
+    /** Per-thread checkpoints of in-flight branches, oldest first. The
+     * slots and their snapshot storage are allocated once and reused. */
+    std::vector<CircularQueue<RenameCheckpoint>> checkpoints;
+
+    /** Maximum number of checkpoints per thread, 0 to always walk the
+     * history buffer on a squash. */
+    const unsigned numCheckpoints;
+
+    /** Checkpoint the rename map of tid after renaming branch inst. */
+    void takeCheckpoint(const DynInstPtr &inst, ThreadID tid);
+
+    /** Drop the youngest checkpoint of tid. */
+    void dropYoungestCheckpoint(ThreadID tid);
+
+    /** Drop the oldest checkpoint of tid. */
+    void dropOldestCheckpoint(ThreadID tid);
+
+    /** Registers freed by a squash restored from a checkpoint, reused. */
+    std::vector<PhysRegIdPtr> squashedRegs;
 
     InstSeqNum finalCommitSeq = 0;
 
@@ -549,6 +581,11 @@ class Rename
         /** Stat for total number of mappings that were undone due to a
          *  squash. */
         statistics::Scalar undoneMaps;
+        /** Stat for number of squashes that restored the rename map from
+         *  a checkpoint. */
+        statistics::Scalar checkpointRestores;
+        /** Stat for number of branches renamed without a free checkpoint. */
+        statistics::Scalar checkpointsFull;
         /** Number of serialize instructions handled. */
         statistics::Scalar serializing;
         /** Number of instructions marked as temporarily serializing. */
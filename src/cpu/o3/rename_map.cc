@@ -41,9 +41,11 @@
 
 #include "cpu/o3/rename_map.hh"
 
+#include <algorithm>
 #include <vector>
 
 #include "arch/vecregs.hh"
+#include "base/logging.hh"
 #include "cpu/o3/dyn_inst.hh"
 #include "cpu/reg_class.hh"
 #include "debug/Rename.hh"
@@ -66,9 +68,71 @@ SimpleRenameMap::init(const RegClass &reg_class, SimpleFreeList *_freeList)
     assert(map.empty());
 
     map.resize(reg_class.numRegs());
+    cleanChunks.assign((map.size() + ChunkSize - 1) / ChunkSize, NoChunk);
     freeList = _freeList;
 }
 
+void
+SimpleRenameMap::initCheckpoints(unsigned num_checkpoints)
+{
+    // Each live checkpoint holds at most one chunk per map chunk, and the
+    // map itself may still hold the chunks of a dropped checkpoint
+    size_t num_chunks = cleanChunks.size() * (num_checkpoints + 1);
+    chunkPool.resize(num_chunks);
+    chunkRefs.assign(num_chunks, 0);
+    freeChunks.resize(num_chunks);
+    for (size_t i = 0; i < num_chunks; i++)
+        freeChunks[i] = num_chunks - 1 - i;
+}
+
+void
+SimpleRenameMap::checkpoint(Checkpoint &cp)
+{
+    assert(cp.empty());
+    cp.resize(cleanChunks.size());
+    for (size_t c = 0; c < cleanChunks.size(); c++) {
+        if (cleanChunks[c] == NoChunk) {
+            panic_if(freeChunks.empty(), "Rename map checkpoint pool is "
+                     "exhausted\n");
+            ChunkIdx chunk = freeChunks.back();
+            freeChunks.pop_back();
+            size_t base = c * ChunkSize;
+            size_t n = std::min<size_t>(ChunkSize, map.size() - base);
+            std::copy_n(map.begin() + base, n, chunkPool[chunk].begin());
+            chunkRefs[chunk] = 1;
+            cleanChunks[c] = chunk;
+        }
+        cp[c] = cleanChunks[c];
+        chunkRefs[cp[c]]++;
+    }
+}
+
+void
+SimpleRenameMap::restore(const Checkpoint &cp)
+{
+    assert(cp.size() == cleanChunks.size());
+    for (size_t c = 0; c < cleanChunks.size(); c++) {
+        if (cleanChunks[c] == cp[c])
+            continue;
+        size_t base = c * ChunkSize;
+        size_t n = std::min<size_t>(ChunkSize, map.size() - base);
+        std::copy_n(chunkPool[cp[c]].begin(), n, map.begin() + base);
+        if (cleanChunks[c] != NoChunk)
+            releaseChunk(cleanChunks[c]);
+        cleanChunks[c] = cp[c];
+        chunkRefs[cp[c]]++;
+    }
+}
+
+void
+SimpleRenameMap::release(Checkpoint &cp)
+{
+    for (ChunkIdx chunk : cp)
+        releaseChunk(chunk);
+    // Keep the capacity, the slot is reused for a later checkpoint
+    cp.clear();
+}
+
 SimpleRenameMap::RenameInfo
 SimpleRenameMap::rename(const RegId &arch_reg, const VirtRegId& bypass_reg)
 {
@@ -87,6 +151,7 @@ SimpleRenameMap::rename(const RegId &arch_reg, const VirtRegId& bypass_reg)
 
         // New mapping
         map[arch_reg.index()] = renamed_reg;
+        markDirty(arch_reg.index());
 
         if (prev_reg.PhyReg() != bypass_reg.PhyReg()) {
             // A new archReg map to the same physReg
@@ -110,6 +175,7 @@ SimpleRenameMap::rename(const RegId &arch_reg, const VirtRegId& bypass_reg)
         renamed_reg.setPhyReg(freeList->getReg());
         DPRINTF(Rename, "Get free reg p%i\n", renamed_reg.PhyReg()->flatIndex());
         map[arch_reg.index()] = renamed_reg;
+        markDirty(arch_reg.index());
         renamed_reg.PhyReg()->setNumPinnedWrites(arch_reg.getNumPinnedWrites());
         renamed_reg.PhyReg()->setNumPinnedWritesToComplete(
             arch_reg.getNumPinnedWrites() + 1);
@@ -77,7 +77,46 @@ class SimpleRenameMap
   public:
     using iterator = Arch2PhysMap::iterator;
     using const_iterator = Arch2PhysMap::const_iterator;
+
+    /** Number of map entries per copy-on-write checkpoint chunk. */
+    static constexpr unsigned ChunkSize = 8;
+    using Chunk = std::array<VirtRegId, ChunkSize>;
+    /** Index of a chunk in the checkpoint pool. */
+    using ChunkIdx = uint32_t;
+    static constexpr ChunkIdx NoChunk = std::numeric_limits<ChunkIdx>::max();
+    /** A checkpoint of the map, as one pooled chunk per ChunkSize regs. */
+    using Checkpoint = std::vector<ChunkIdx>;
+
   private:
+    /** Chunk storage of all the checkpoints, allocated once. */
+    std::vector<Chunk> chunkPool;
+    /** Number of checkpoints and clean map chunks using each chunk. */
+    std::vector<unsigned> chunkRefs;
+    std::vector<ChunkIdx> freeChunks;
+
+    /**
+     * For every chunk of the map, the pooled chunk it is known to be
+     * equal to, or NoChunk if it was written since. Checkpoints share the
+     * chunks that did not change in between.
+     */
+    std::vector<ChunkIdx> cleanChunks;
+
+    void
+    releaseChunk(ChunkIdx chunk)
+    {
+        if (--chunkRefs[chunk] == 0)
+            freeChunks.push_back(chunk);
+    }
+
+    void
+    markDirty(RegIndex idx)
+    {
+        auto &chunk = cleanChunks[idx / ChunkSize];
+        if (chunk != NoChunk) {
+            releaseChunk(chunk);
+            chunk = NoChunk;
+        }
+    }
 
     /**
      * Pointer to the free list from which new physical registers
@@ -136,8 +175,22 @@ class SimpleRenameMap
     {
         assert(arch_reg.index() <= map.size());
         map[arch_reg.index()] = phys_reg;
+        markDirty(arch_reg.index());
     }
 
+    /** Allocate the chunks for up to num_checkpoints live checkpoints. */
+    void initCheckpoints(unsigned num_checkpoints);
+
+    /** Take a checkpoint of the map, copying only the chunks written since
+     * the previous one. cp must be empty. */
+    void checkpoint(Checkpoint &cp);
+
+    /** Restore the map to a checkpoint taken earlier. */
+    void restore(const Checkpoint &cp);
+
+    /** Return the chunks of a dropped checkpoint to the pool. */
+    void release(Checkpoint &cp);
+
     /** Return the number of free entries on the associated free list. */
     unsigned numFreeEntries() const { return freeList->numFreeRegs(); }
 
@@ -182,6 +235,10 @@ class UnifiedRenameMap
 
     typedef SimpleRenameMap::RenameInfo RenameInfo;
 
+    /** Copy-on-write snapshot of all the renameable register classes. */
+    using Checkpoint =
+        std::array<SimpleRenameMap::Checkpoint, RMiscRegClass + 1>;
+
     /** Default constructor.  init() must be called prior to use. */
     UnifiedRenameMap() : regFile(nullptr) {};
 
@@ -260,6 +317,42 @@ class UnifiedRenameMap
         return renameMaps[arch_reg.classValue()].setEntry(arch_reg, virt_reg);
     }
 
+    /** Allocate the snapshot storage of num_checkpoints checkpoints. */
+    void
+    initCheckpoints(unsigned num_checkpoints)
+    {
+        for (auto &map : renameMaps)
+            map.initCheckpoints(num_checkpoints);
+    }
+
+    /** Snapshot the whole map, e.g. at a branch. */
+    void
+    checkpoint(Checkpoint &cp)
+    {
+        for (int i = 0; i < renameMaps.size(); i++)
+            renameMaps[i].checkpoint(cp[i]);
+    }
+
+    /**
+     * Restore the whole map to a snapshot in one step. This is equivalent
+     * to undoing every history entry younger than the snapshot; the
+     * caller still owns freeing their physical registers.
+     */
+    void
+    restore(const Checkpoint &cp)
+    {
+        for (int i = 0; i < renameMaps.size(); i++)
+            renameMaps[i].restore(cp[i]);
+    }
+
+    /** Drop a snapshot, its storage goes back to the pool. */
+    void
+    release(Checkpoint &cp)
+    {
+        for (int i = 0; i < renameMaps.size(); i++)
+            renameMaps[i].release(cp[i]);
+    }
+
     /**
      * Return the minimum number of free entries across all of the
      * register classes.  The minimum is used so we guarantee that
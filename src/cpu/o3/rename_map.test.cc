@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "base/debug.hh"
+#include "cpu/o3/rename_map.hh"
+#include "cpu/reg_class.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+debug::SimpleFlag testFlag("RenameMapTest", "");
+
+/** Not a multiple of the chunk size, the last chunk is partial. */
+constexpr size_t numArchRegs = 37;
+constexpr unsigned numCheckpoints = 4;
+
+const RegClass testRegClass(IntRegClass, numArchRegs, testFlag, 8);
+
+/** Undo information of one rename, as Rename's history buffer keeps it. */
+struct History
+{
+    InstSeqNum seqNum;
+    RegIndex archReg;
+    VirtRegId prevReg;
+};
+
+struct BranchCheckpoint
+{
+    InstSeqNum seqNum;
+    SimpleRenameMap::Checkpoint map;
+};
+
+void
+expectSameMap(const SimpleRenameMap &map, const std::vector<VirtRegId> &ref,
+              int step)
+{
+    for (RegIndex i = 0; i < numArchRegs; i++) {
+        ASSERT_EQ(map.lookup(RegId(IntRegClass, i)), ref[i])
+            << "reg " << i << " step " << step;
+    }
+}
+
+} // anonymous namespace
+
+TEST(RenameMapTest, RestoreUndoesLaterWrites)
+{
+    std::vector<PhysRegId> pregs(4);
+    SimpleRenameMap map;
+    map.init(testRegClass, nullptr);
+    map.initCheckpoints(2);
+
+    RegId r3(IntRegClass, 3);
+    RegId r36(IntRegClass, 36);
+    map.setEntry(r3, VirtRegId(&pregs[0]));
+    SimpleRenameMap::Checkpoint first, second;
+    map.checkpoint(first);
+    map.setEntry(r3, VirtRegId(&pregs[1]));
+    map.setEntry(r36, VirtRegId(&pregs[2]));
+    map.checkpoint(second);
+    map.setEntry(r36, VirtRegId(&pregs[3]));
+
+    map.restore(second);
+    EXPECT_EQ(map.lookup(r3), VirtRegId(&pregs[1]));
+    EXPECT_EQ(map.lookup(r36), VirtRegId(&pregs[2]));
+    map.restore(first);
+    EXPECT_EQ(map.lookup(r3), VirtRegId(&pregs[0]));
+    EXPECT_EQ(map.lookup(r36), VirtRegId());
+
+    // Released checkpoints go back to the pool, which fits two live ones
+    for (int i = 0; i < 10; i++) {
+        map.release(first);
+        map.release(second);
+        map.setEntry(r3, VirtRegId(&pregs[i % 4]));
+        map.checkpoint(first);
+        map.setEntry(r36, VirtRegId(&pregs[i % 4]));
+        map.checkpoint(second);
+    }
+    map.restore(first);
+    EXPECT_EQ(map.lookup(r3), VirtRegId(&pregs[9 % 4]));
+    EXPECT_EQ(map.lookup(r36), VirtRegId(&pregs[8 % 4]));
+}
+
+/**
+ * Renames, branches, commits and squashes as Rename drives them. A squash
+ * to a checkpointed branch restores the checkpoint, the map must then
+ * equal a copy that walked the history buffer back entry by entry, which
+ * is what the checkpoints replace. Squashes to other points walk the real
+ * map too, mixing the two. The pool, sized for numCheckpoints live
+ * checkpoints, must never run out.
+ */
+TEST(RenameMapTest, CheckpointsMatchHistoryWalk)
+{
+    std::vector<PhysRegId> pregs(64);
+    std::mt19937_64 rng(1);
+
+    SimpleRenameMap map;
+    map.init(testRegClass, nullptr);
+    map.initCheckpoints(numCheckpoints);
+    std::vector<VirtRegId> ref(numArchRegs);
+
+    // Youngest first, like the history buffer
+    std::deque<History> history;
+    // Oldest first
+    std::deque<BranchCheckpoint> cps;
+    InstSeqNum seq_num = 0;
+
+    auto undo = [&](InstSeqNum squashed_seq_num, bool walk_map) {
+        while (!history.empty() &&
+               history.front().seqNum > squashed_seq_num) {
+            RegId reg(IntRegClass, history.front().archReg);
+            ref[reg.index()] = history.front().prevReg;
+            if (walk_map)
+                map.setEntry(reg, history.front().prevReg);
+            history.pop_front();
+        }
+    };
+
+    for (int step = 0; step < 50000; step++) {
+        switch (rng() % 8) {
+          case 0:
+          case 1:
+          case 2: {
+            // Rename a destination
+            RegIndex idx = rng() % numArchRegs;
+            RegId reg(IntRegClass, idx);
+            VirtRegId preg(&pregs[rng() % pregs.size()]);
+            history.push_front({++seq_num, idx, map.lookup(reg)});
+            map.setEntry(reg, preg);
+            ref[idx] = preg;
+            break;
+          }
+          case 3:
+            // A branch takes a checkpoint if one is free
+            ++seq_num;
+            if (cps.size() < numCheckpoints) {
+                cps.push_back({seq_num, {}});
+                map.checkpoint(cps.back().map);
+            }
+            break;
+          case 4: {
+            // Commit up to some instruction
+            if (history.empty())
+                break;
+            InstSeqNum done = history.back().seqNum + rng() % 8;
+            while (!cps.empty() && cps.front().seqNum <= done) {
+                map.release(cps.front().map);
+                cps.pop_front();
+            }
+            while (!history.empty() && history.back().seqNum <= done)
+                history.pop_back();
+            break;
+          }
+          case 5: {
+            // Squash to a checkpointed branch
+            if (cps.empty())
+                break;
+            size_t keep = rng() % cps.size();
+            while (cps.size() > keep + 1) {
+                map.release(cps.back().map);
+                cps.pop_back();
+            }
+            map.restore(cps.back().map);
+            undo(cps.back().seqNum, false);
+            break;
+          }
+          case 6: {
+            // Squash to an instruction without a checkpoint
+            if (history.empty())
+                break;
+            InstSeqNum squashed = history.front().seqNum - rng() % 8;
+            while (!cps.empty() && cps.back().seqNum > squashed) {
+                map.release(cps.back().map);
+                cps.pop_back();
+            }
+            undo(squashed, true);
+            break;
+          }
+          default:
+            break;
+        }
+        expectSameMap(map, ref, step);
+    }
+}
@@ -0,0 +1,111 @@
+#ifndef __CPU_O3_SEQ_NUM_RING_HH__
+#define __CPU_O3_SEQ_NUM_RING_HH__
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "cpu/inst_seq.hh"
+
+namespace gem5
+{
+
+struct SNHash
+{
+    size_t
+    operator()(const InstSeqNum &seq_num) const
+    {
+        unsigned a = (unsigned)seq_num;
+        unsigned hash = (((a >> 14) ^ ((a >> 2) & 0xffff))) & 0x7FFFFFFF;
+        return hash;
+    }
+};
+
+namespace o3
+{
+
+/**
+ * Per-instruction entries keyed by sequence number. Entries live in a ring
+ * indexed by sequence number modulo its size; a sequence number whose ring
+ * slot is still taken goes to a small overflow map.
+ *
+ * Entry needs a seqNum member, 0 while the entry is free (sequence numbers
+ * start at 1), and a clear() that makes a ring slot reusable.
+ */
+template <class Entry>
+class SeqNumRing
+{
+  public:
+    /** Size the ring to hold at least min_size consecutive numbers. */
+    void
+    init(size_t min_size)
+    {
+        ring.clear();
+        ring.resize(1ULL << ceilLog2(min_size));
+        mask = ring.size() - 1;
+        overflow.clear();
+        numEntries = 0;
+    }
+
+    /** Allocates the entry of a newly inserted instruction. */
+    Entry *
+    alloc(InstSeqNum seq_num)
+    {
+        Entry *entry = &ring[seq_num & mask];
+        if (entry->seqNum != 0) {
+            entry = &overflow[seq_num];
+        }
+        entry->seqNum = seq_num;
+        numEntries++;
+        return entry;
+    }
+
+    /** Releases the entry of a completed or squashed instruction. */
+    void
+    free(Entry *entry)
+    {
+        numEntries--;
+        if (entry == &ring[entry->seqNum & mask]) {
+            entry->clear();
+        } else {
+            overflow.erase(entry->seqNum);
+        }
+    }
+
+    /** Finds the live entry of a sequence number, or nullptr. */
+    Entry *
+    find(InstSeqNum seq_num)
+    {
+        Entry &slot = ring[seq_num & mask];
+        if (slot.seqNum == seq_num) {
+            return &slot;
+        }
+        if (overflow.empty()) {
+            return nullptr;
+        }
+        auto it = overflow.find(seq_num);
+        return it == overflow.end() ? nullptr : &it->second;
+    }
+
+    /** Number of live entries. */
+    size_t size() const { return numEntries; }
+
+    /** Number of live entries that did not fit in the ring. */
+    size_t numOverflowed() const { return overflow.size(); }
+
+  private:
+    std::vector<Entry> ring;
+
+    /** Mask to obtain the ring slot of a sequence number. */
+    InstSeqNum mask = 0;
+
+    std::unordered_map<InstSeqNum, Entry, SNHash> overflow;
+
+    size_t numEntries = 0;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_SEQ_NUM_RING_HH__
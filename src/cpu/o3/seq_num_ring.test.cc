@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "cpu/o3/seq_num_ring.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+struct Entry
+{
+    InstSeqNum seqNum = 0;
+    std::vector<InstSeqNum> payload;
+
+    void
+    clear()
+    {
+        seqNum = 0;
+        payload.clear();
+    }
+};
+
+} // anonymous namespace
+
+TEST(SeqNumRingTest, OverflowWhenSlotTaken)
+{
+    SeqNumRing<Entry> ring;
+    ring.init(3);
+
+    // Rounded up to four slots, 1 and 5 share one
+    Entry *first = ring.alloc(1);
+    first->payload.push_back(10);
+    Entry *second = ring.alloc(5);
+    second->payload.push_back(50);
+    EXPECT_EQ(ring.size(), 2);
+    EXPECT_EQ(ring.numOverflowed(), 1);
+    EXPECT_EQ(ring.find(1), first);
+    EXPECT_EQ(ring.find(5), second);
+    EXPECT_EQ(ring.find(9), nullptr);
+
+    ring.free(first);
+    EXPECT_EQ(ring.find(1), nullptr);
+    EXPECT_EQ(ring.find(5)->payload, std::vector<InstSeqNum>({50}));
+
+    // A freed slot comes back empty
+    Entry *third = ring.alloc(9);
+    EXPECT_EQ(third, first);
+    EXPECT_TRUE(third->payload.empty());
+    ring.free(ring.find(5));
+    ring.free(third);
+    EXPECT_EQ(ring.size(), 0);
+    EXPECT_EQ(ring.numOverflowed(), 0);
+}
+
+/**
+ * Instructions enter in order, complete out of order and get squashed from
+ * the young end, as in MemDepUnit. Some linger far longer than the ring
+ * spans. Lookups must match the hash map of entries the ring replaces.
+ */
+TEST(SeqNumRingTest, MatchesHashMap)
+{
+    std::mt19937_64 rng(1);
+    for (size_t size : {4, 16, 192}) {
+        SeqNumRing<Entry> ring;
+        ring.init(size);
+        std::unordered_map<InstSeqNum, std::vector<InstSeqNum>> ref;
+        std::deque<InstSeqNum> in_flight;
+        InstSeqNum seq_num = 0;
+
+        for (int step = 0; step < 50000; step++) {
+            switch (rng() % 6) {
+              case 0:
+              case 1: {
+                // Insert, sequence numbers of other instructions in between
+                seq_num += 1 + rng() % 3;
+                Entry *entry = ring.alloc(seq_num);
+                ASSERT_EQ(entry->seqNum, seq_num);
+                ASSERT_TRUE(entry->payload.empty());
+                entry->payload.push_back(seq_num);
+                ref[seq_num] = {seq_num};
+                in_flight.push_back(seq_num);
+                break;
+              }
+              case 2: {
+                // A dependent of some live instruction
+                if (in_flight.empty())
+                    break;
+                InstSeqNum sn = in_flight[rng() % in_flight.size()];
+                InstSeqNum dep = rng();
+                ring.find(sn)->payload.push_back(dep);
+                ref[sn].push_back(dep);
+                break;
+              }
+              case 3: {
+                // Complete, mostly among the oldest
+                if (in_flight.empty())
+                    break;
+                size_t i = rng() % std::min<size_t>(in_flight.size(), 8);
+                if (rng() % 16 == 0)
+                    i = rng() % in_flight.size();
+                InstSeqNum sn = in_flight[i];
+                ring.free(ring.find(sn));
+                ref.erase(sn);
+                in_flight.erase(in_flight.begin() + i);
+                break;
+              }
+              case 4:
+                // Squash the youngest
+                for (int n = rng() % 4; n && !in_flight.empty(); n--) {
+                    ring.free(ring.find(in_flight.back()));
+                    ref.erase(in_flight.back());
+                    in_flight.pop_back();
+                }
+                break;
+              default: {
+                // Look up anything recent, live or not
+                InstSeqNum sn = seq_num - rng() % (4 * size);
+                if (sn == 0 || sn > seq_num)
+                    break;
+                Entry *entry = ring.find(sn);
+                auto it = ref.find(sn);
+                ASSERT_EQ(entry != nullptr, it != ref.end())
+                    << "sn " << sn << " step " << step;
+                if (entry) {
+                    ASSERT_EQ(entry->payload, it->second);
+                }
+              }
+            }
+            ASSERT_EQ(ring.size(), ref.size());
+        }
+
+        for (InstSeqNum sn : in_flight) {
+            Entry *entry = ring.find(sn);
+            ASSERT_NE(entry, nullptr);
+            EXPECT_EQ(entry->payload, ref[sn]);
+        }
+    }
+}
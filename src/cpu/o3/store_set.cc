@@ -28,6 +28,8 @@
 
 #include "cpu/o3/store_set.hh"
 
+#include <algorithm>
+
 #include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -51,37 +53,30 @@ StoreSet::StoreSet(uint64_t clear_period, int _SSIT_size, int _LFST_size,int _st
         fatal("Invalid SSIT size!\n");
     }
 
-    SSIT.resize(SSITSize);
-
-    validSSIT.resize(SSITSize);
-
-    for (int i = 0; i < SSITSize; ++i)
-        validSSIT[i] = false;
-
     if (!isPowerOf2(LFSTSize)) {
         fatal("Invalid LFST size!\n");
     }
 
-    //LFST.resize(LFSTSize);
-    LFSTLarge.resize(LFSTSize);
-    LFSTLargePC.resize(LFSTSize);
-    validLFSTLarge.resize(LFSTSize);
-    //validLFST.resize(LFSTSize);
-    VictimEntryID.resize(LFSTSize);
-
-    for (int i = 0; i < LFSTSize; ++i) {
-        // validLFST[i] = false;
-        // LFST[i] = 0;
-        LFSTLarge[i].resize(LFSTEntrySize);
-        LFSTLargePC[i].resize(LFSTEntrySize);
-        validLFSTLarge[i].resize(LFSTEntrySize);
-        VictimEntryID[i]=0;
-        for (int j=0;j<LFSTEntrySize;++j) {
-            validLFSTLarge[i][j] = 0;
-            LFSTLarge[i][j] = 0;
-            LFSTLargePC[i][j] = 0;
-        }
-    }
+    resize();
+}
+
+StoreSet::~StoreSet()
+{
+}
+
+void
+StoreSet::resize()
+{
+    SSITBits = floorLog2(SSITSize);
+    LFSTBits = floorLog2(LFSTSize);
+
+    SSIT.assign(SSITSize, 0);
+    validSSIT.assign(SSITSize, false);
+    SSITStrict.assign(SSITSize, false);
+
+    LFST.assign(LFSTSize * LFSTEntrySize, LFSTEntry());
+    VictimEntryID.assign(LFSTSize, 0);
+    youngestLFSTStore = 0;
 
     indexMask = SSITSize - 1;
 
@@ -90,10 +85,6 @@ StoreSet::StoreSet(uint64_t clear_period, int _SSIT_size, int _LFST_size,int _st
     memOpsPred = 0;
 }
 
-StoreSet::~StoreSet()
-{
-}
-
 void
 StoreSet::init(uint64_t clear_period, int clear_period_thres, int _SSIT_size, int _LFST_size, int _LFST_entry_size)
 {
@@ -107,45 +98,7 @@ StoreSet::init(uint64_t clear_period, int clear_period_thres, int _SSIT_size, in
     DPRINTF(StoreSet, "StoreSet: SSIT size: %i, LFST size: %i.\n",
             SSITSize, LFSTSize);
 
-    SSIT.resize(SSITSize);
-
-    validSSIT.resize(SSITSize);
-
-    SSITStrict.resize(SSITSize);
-    for (int i = 0; i < SSITSize; ++i) {
-        validSSIT[i] = false;
-        SSITStrict[i] = false;
-    }
-    LFSTLarge.resize(LFSTSize);
-    LFSTLargePC.resize(LFSTSize);
-    validLFSTLarge.resize(LFSTSize);
-    VictimEntryID.resize(LFSTSize);
-
-
-    // LFST.resize(LFSTSize);
-
-    // validLFST.resize(LFSTSize);
-
-
-    for (int i = 0; i < LFSTSize; ++i) {
-        // validLFST[i] = false;
-        // LFST[i] = 0;
-        LFSTLarge[i].resize(LFSTEntrySize);
-        LFSTLargePC[i].resize(LFSTEntrySize);
-        validLFSTLarge[i].resize(LFSTEntrySize);
-        VictimEntryID[i]=0;
-        for (int j=0;j<LFSTEntrySize;++j) {
-            validLFSTLarge[i][j] = false;
-            LFSTLarge[i][j] = 0;
-            LFSTLargePC[i][j] = 0;
-        }
-    }
-
-    indexMask = SSITSize - 1;
-
-    offsetBits = 2;
-
-    memOpsPred = 0;
+    resize();
 
     lastClearPeriodCycle = 0;
 }
@@ -277,13 +230,11 @@ StoreSet::insertStore(Addr store_PC, InstSeqNum store_seq_num, ThreadID tid, Cyc
         // Update the last store that was fetched with the current one.
         // LFST[store_SSID] = store_seq_num;
         victim_inst = findVictimInLFSTEntry(store_SSID);
-        LFSTLarge[store_SSID][victim_inst] = store_seq_num;
-
-        // validLFST[store_SSID] = 1;
-        LFSTLargePC[store_SSID][victim_inst] = store_PC;
-
-        // storeList[store_seq_num] = store_SSID;
-        validLFSTLarge[store_SSID][victim_inst] = 1;
+        LFSTEntry &slot = lfstSet(store_SSID)[victim_inst];
+        slot.seqNum = store_seq_num;
+        slot.pc = store_PC;
+        slot.valid = true;
+        youngestLFSTStore = std::max(youngestLFSTStore, store_seq_num);
 
         DPRINTF(StoreSet, "Store %#x sn:%lu updated the LFST[SSID=%i][%i]\n",
                 store_PC, store_seq_num, store_SSID, victim_inst);
@@ -339,9 +290,10 @@ StoreSet::checkInst(Addr PC)
 
         //     return LFST[inst_SSID];
         // }
+        const LFSTEntry *set = lfstSet(inst_SSID);
         for (int j = 0; j < LFSTEntrySize; ++j) {
-            if (validLFSTLarge[inst_SSID][j]) {
-                vec.push_back(LFSTLarge[inst_SSID][j]);
+            if (set[j].valid) {
+                vec.push_back(set[j].seqNum);
             }
         }
         DPRINTF(StoreSet, "Inst %#x with index=%i, ssid=%i, had %lu valid producer\n",
@@ -386,11 +338,10 @@ StoreSet::issued(Addr issued_PC, InstSeqNum issued_seq_num, bool is_store)
     //     validLFST[store_SSID] = false;
     // }
 
+    LFSTEntry *set = lfstSet(store_SSID);
     for (int j=0;j<LFSTEntrySize;++j) {
-        if (validLFSTLarge[store_SSID][j] && LFSTLarge[store_SSID][j] == issued_seq_num) {
-            validLFSTLarge[store_SSID][j] = false;
-            LFSTLarge[store_SSID][j] = 0;
-            LFSTLargePC[store_SSID][j] = 0;
+        if (set[j].valid && set[j].seqNum == issued_seq_num) {
+            set[j] = LFSTEntry();
         }
     }
 }
@@ -398,19 +349,17 @@ StoreSet::issued(Addr issued_PC, InstSeqNum issued_seq_num, bool is_store)
 void
 StoreSet::squash(InstSeqNum squashed_num, ThreadID tid)
 {
-    for (int i=0;i<LFSTSize;++i) {
-        for (int j=0; j<LFSTEntrySize; ++j) {
-            if (validLFSTLarge[i][j] && LFSTLarge[i][j] > squashed_num) {
-                LFSTLarge[i][j] =0;
-                LFSTLargePC[i][j] = 0;
-                validLFSTLarge[i][j] = false;
-            }
-            else if (!validLFSTLarge[i][j]) {
-                LFSTLarge[i][j] = 0;
-                LFSTLargePC[i][j] = 0;
-            }
+    // Nothing younger than the squash point was inserted since the last
+    // squash or clear.
+    if (youngestLFSTStore <= squashed_num) {
+        return;
+    }
+    for (auto &slot : LFST) {
+        if (slot.valid && slot.seqNum > squashed_num) {
+            slot = LFSTEntry();
         }
     }
+    youngestLFSTStore = squashed_num;
 }
 
 void
@@ -420,11 +369,10 @@ StoreSet::clear()
         validSSIT[i] = false;
     }
 
-    for (int i = 0; i < LFSTSize; ++i) {
-        for (int j=0;j<LFSTEntrySize;++j) {
-            validLFSTLarge[i][j] = false;
-        }
+    for (auto &slot : LFST) {
+        slot.valid = false;
     }
+    youngestLFSTStore = 0;
 
 }
 
@@ -447,8 +395,9 @@ StoreSet::dump()
 int
 StoreSet::findVictimInLFSTEntry(int store_SSID)
 {
+    const LFSTEntry *set = lfstSet(store_SSID);
     for (int j=0;j<LFSTEntrySize;++j) {
-        if (!validLFSTLarge[store_SSID][j]) {
+        if (!set[j].valid) {
             return j;
         }
     }
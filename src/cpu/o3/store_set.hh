@@ -125,26 +125,42 @@ class StoreSet
     // inline int calcIndex(Addr PC)
     // { return (PC >> offsetBits) & indexMask; }
     inline int calcIndexSSIT(Addr pc)
-    { return XORFold(pc,log2(SSITSize)); }
+    { return XORFold(pc, SSITBits); }
 
     /** Calculates a Store Set ID based on the PC. */
     // inline SSID calcSSID(Addr PC)
     // { return ((PC ^ (PC >> 10)) % LFSTSize); }
     inline SSID calcSSID(Addr pc)
-    { return XORFold(XORFold(pc,log2(SSITSize)),log2(LFSTSize)); }
+    { return XORFold(XORFold(pc, SSITBits), LFSTBits); }
+
+    /** Sizes the tables and invalidates every entry. */
+    void resize();
 
     /** The Store Set ID Table. */
     std::vector<SSID> SSIT;
 
-    /** Bit vector to tell if the SSIT has a valid entry. */
-    std::vector<bool> validSSIT,SSITStrict;
+    /** Tell if the SSIT has a valid entry, and if it is strict. */
+    std::vector<uint8_t> validSSIT, SSITStrict;
+
+    /** One store slot of the Last Fetched Store Table. */
+    struct LFSTEntry
+    {
+        InstSeqNum seqNum = 0;
+        Addr pc = 0;
+        bool valid = false;
+    };
 
-    /** Last Fetched Store Table. */
-    std::vector<std::vector<InstSeqNum>> LFSTLarge,LFSTLargePC;
+    /** Last Fetched Store Table, LFSTEntrySize slots per store set. */
+    std::vector<LFSTEntry> LFST;
     std::vector<InstSeqNum> VictimEntryID;
 
-    /** Bit vector to tell if the LFST has a valid entry. */
-    std::vector<std::vector<bool>> validLFSTLarge;
+    /** The slots of a store set. */
+    LFSTEntry *lfstSet(SSID ssid) { return &LFST[ssid * LFSTEntrySize]; }
+
+    /** Upper bound of the sequence numbers valid in the LFST, so squashes
+     * that cannot hit any store skip the table scan.
+     */
+    InstSeqNum youngestLFSTStore = 0;
 
     /** Map of stores that have been inserted into the store set, but
      * not yet issued or squashed.
@@ -164,6 +180,10 @@ class StoreSet
     /** Last Fetched Store Table size, in entries. */
     int LFSTSize;
 
+    /** log2 of the SSIT and LFST sizes, the widths of the folded PC. */
+    unsigned SSITBits;
+    unsigned LFSTBits;
+
     int LFSTEntrySize;
     uint64_t clearPeriodThreshold;
 
@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "cpu/o3/store_set.hh"
+
+using namespace gem5;
+using namespace gem5::o3;
+
+namespace
+{
+
+/**
+ * The store set predictor as it was before its LFST became one flat array:
+ * per store set vectors of sequence numbers, PCs and valid bits, and a
+ * squash that always scans the whole table.
+ */
+class NestedStoreSet
+{
+  public:
+    NestedStoreSet(uint64_t clear_thres, int ssit_size, int lfst_size,
+                   int entry_size)
+        : clearPeriodThreshold(clear_thres), SSITSize(ssit_size),
+          LFSTSize(lfst_size), LFSTEntrySize(entry_size),
+          SSIT(ssit_size), validSSIT(ssit_size), SSITStrict(ssit_size),
+          LFSTLarge(lfst_size, std::vector<InstSeqNum>(entry_size)),
+          LFSTLargePC(lfst_size, std::vector<InstSeqNum>(entry_size)),
+          validLFSTLarge(lfst_size, std::vector<bool>(entry_size)),
+          VictimEntryID(lfst_size)
+    {}
+
+    void
+    violation(Addr store_pc, Addr load_pc)
+    {
+        int load_index = calcIndexSSIT(load_pc);
+        int store_index = calcIndexSSIT(store_pc);
+        bool valid_load = validSSIT[load_index];
+        bool valid_store = validSSIT[store_index];
+        if (!valid_load || !valid_store) {
+            if (!valid_load) {
+                validSSIT[load_index] = true;
+                SSIT[load_index] = calcSSID(load_pc);
+            }
+            if (!valid_store) {
+                validSSIT[store_index] = true;
+                SSIT[store_index] = calcSSID(store_pc);
+            }
+        } else {
+            unsigned load_ssid = SSIT[load_index];
+            unsigned store_ssid = SSIT[store_index];
+            if (store_ssid > load_ssid) {
+                SSIT[store_index] = load_ssid;
+            } else {
+                SSIT[load_index] = store_ssid;
+                if (store_ssid == load_ssid)
+                    SSITStrict[load_index] = true;
+            }
+        }
+    }
+
+    void
+    checkClear(Cycles cur_cycle)
+    {
+        if ((uint64_t)cur_cycle - lastClearPeriodCycle >
+                clearPeriodThreshold) {
+            clear();
+            lastClearPeriodCycle = (uint64_t)cur_cycle;
+        }
+    }
+
+    void
+    insertStore(Addr store_pc, InstSeqNum seq_num, Cycles cur_cycle)
+    {
+        int index = calcIndexSSIT(store_pc);
+        checkClear(cur_cycle);
+        if (!validSSIT[index])
+            return;
+        int ssid = SSIT[index];
+        int victim = findVictimInLFSTEntry(ssid);
+        LFSTLarge[ssid][victim] = seq_num;
+        LFSTLargePC[ssid][victim] = store_pc;
+        validLFSTLarge[ssid][victim] = true;
+    }
+
+    std::vector<InstSeqNum>
+    checkInst(Addr pc)
+    {
+        int index = calcIndexSSIT(pc);
+        std::vector<InstSeqNum> vec;
+        if (!validSSIT[index])
+            return vec;
+        int ssid = SSIT[index];
+        for (int j = 0; j < LFSTEntrySize; ++j) {
+            if (validLFSTLarge[ssid][j])
+                vec.push_back(LFSTLarge[ssid][j]);
+        }
+        return vec;
+    }
+
+    bool
+    checkInstStrict(Addr pc)
+    {
+        int index = calcIndexSSIT(pc);
+        return validSSIT[index] && SSITStrict[index];
+    }
+
+    void
+    issued(Addr pc, InstSeqNum seq_num)
+    {
+        int index = calcIndexSSIT(pc);
+        if (!validSSIT[index])
+            return;
+        int ssid = SSIT[index];
+        for (int j = 0; j < LFSTEntrySize; ++j) {
+            if (validLFSTLarge[ssid][j] && LFSTLarge[ssid][j] == seq_num) {
+                validLFSTLarge[ssid][j] = false;
+                LFSTLarge[ssid][j] = 0;
+                LFSTLargePC[ssid][j] = 0;
+            }
+        }
+    }
+
+    void
+    squash(InstSeqNum squashed_num)
+    {
+        for (int i = 0; i < LFSTSize; ++i) {
+            for (int j = 0; j < LFSTEntrySize; ++j) {
+                if (validLFSTLarge[i][j] && LFSTLarge[i][j] > squashed_num) {
+                    LFSTLarge[i][j] = 0;
+                    LFSTLargePC[i][j] = 0;
+                    validLFSTLarge[i][j] = false;
+                } else if (!validLFSTLarge[i][j]) {
+                    LFSTLarge[i][j] = 0;
+                    LFSTLargePC[i][j] = 0;
+                }
+            }
+        }
+    }
+
+    void
+    clear()
+    {
+        for (int i = 0; i < SSITSize; ++i)
+            validSSIT[i] = false;
+        for (int i = 0; i < LFSTSize; ++i) {
+            for (int j = 0; j < LFSTEntrySize; ++j)
+                validLFSTLarge[i][j] = false;
+        }
+    }
+
+  private:
+    int
+    findVictimInLFSTEntry(int ssid)
+    {
+        for (int j = 0; j < LFSTEntrySize; ++j) {
+            if (!validLFSTLarge[ssid][j])
+                return j;
+        }
+        VictimEntryID[ssid]++;
+        if (VictimEntryID[ssid] >= LFSTEntrySize)
+            VictimEntryID[ssid] %= LFSTEntrySize;
+        return VictimEntryID[ssid];
+    }
+
+    static Addr
+    XORFold(Addr pc, uint64_t reset_width)
+    {
+        uint64_t fold_range = (64 + reset_width - 1) / reset_width;
+        uint64_t xored = 0;
+        do {
+            xored ^= pc & ((1 << reset_width) - 1);
+            pc >>= reset_width;
+            fold_range--;
+        } while (fold_range != 0);
+        return xored;
+    }
+
+    int calcIndexSSIT(Addr pc) { return XORFold(pc, log2(SSITSize)); }
+
+    unsigned
+    calcSSID(Addr pc)
+    {
+        return XORFold(XORFold(pc, log2(SSITSize)), log2(LFSTSize));
+    }
+
+    uint64_t clearPeriodThreshold;
+    uint64_t lastClearPeriodCycle = 0;
+    int SSITSize;
+    int LFSTSize;
+    int LFSTEntrySize;
+    std::vector<unsigned> SSIT;
+    std::vector<bool> validSSIT, SSITStrict;
+    std::vector<std::vector<InstSeqNum>> LFSTLarge, LFSTLargePC;
+    std::vector<std::vector<bool>> validLFSTLarge;
+    std::vector<InstSeqNum> VictimEntryID;
+};
+
+} // anonymous namespace
+
+/**
+ * Violations, stores entering and issuing, squashes and periodic clears:
+ * every load and store PC must predict the same producers and strictness
+ * as with the nested tables. Few PCs and small tables keep store sets full
+ * so victims get replaced.
+ */
+TEST(StoreSetTest, FlatLFSTMatchesNested)
+{
+    constexpr uint64_t clearThres = 5000;
+    std::mt19937_64 rng(1);
+
+    for (int entry_size : {1, 4}) {
+        StoreSet flat(0, 64, 16, clearThres, entry_size);
+        NestedStoreSet nested(clearThres, 64, 16, entry_size);
+        std::vector<Addr> pcs;
+        for (int i = 0; i < 48; i++)
+            pcs.push_back(0x80000000 + (rng() % 4096) * 2);
+
+        // In-flight stores, oldest first
+        std::vector<std::pair<Addr, InstSeqNum>> stores;
+        InstSeqNum seq_num = 0;
+        Cycles cycle(0);
+
+        for (int step = 0; step < 50000; step++) {
+            cycle += Cycles(rng() % 2);
+            Addr pc = pcs[rng() % pcs.size()];
+            switch (rng() % 8) {
+              case 0: {
+                Addr load_pc = pcs[rng() % pcs.size()];
+                flat.violation(pc, load_pc);
+                nested.violation(pc, load_pc);
+                break;
+              }
+              case 1:
+              case 2:
+                flat.insertStore(pc, ++seq_num, 0, cycle);
+                nested.insertStore(pc, seq_num, cycle);
+                stores.emplace_back(pc, seq_num);
+                break;
+              case 3:
+                flat.insertLoad(pc, ++seq_num, cycle);
+                nested.checkClear(cycle);
+                break;
+              case 4: {
+                if (stores.empty())
+                    break;
+                size_t i = rng() % stores.size();
+                flat.issued(stores[i].first, stores[i].second, true);
+                nested.issued(stores[i].first, stores[i].second);
+                // Loads never touch the LFST
+                flat.issued(stores[i].first, stores[i].second, false);
+                stores.erase(stores.begin() + i);
+                break;
+              }
+              case 5: {
+                // Squash some of the youngest, at times nothing at all
+                InstSeqNum squashed = seq_num - rng() % 6;
+                flat.squash(squashed, 0);
+                nested.squash(squashed);
+                while (!stores.empty() && stores.back().second > squashed)
+                    stores.pop_back();
+                break;
+              }
+              case 6:
+                if (rng() % 64 == 0) {
+                    flat.clear();
+                    nested.clear();
+                }
+                break;
+              default:
+                break;
+            }
+
+            for (Addr check_pc : pcs) {
+                ASSERT_EQ(flat.checkInst(check_pc), nested.checkInst(check_pc))
+                    << "step " << step;
+                ASSERT_EQ(flat.checkInstStrict(check_pc),
+                          nested.checkInstStrict(check_pc));
+            }
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef __CPU_O3_TEST_MOCK_DYN_INST_HH__
+#define __CPU_O3_TEST_MOCK_DYN_INST_HH__
+
+#include "base/refcnt.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/o3/dyn_inst_ptr.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+/**
+ * @brief Mock DynInst for testing, only the state the issue queue's
+ * scheduling structures look at
+ */
+class DynInst : public RefCounted
+{
+  public:
+    DynInst(InstSeqNum seq_num) : seqNum(seq_num) {}
+
+    InstSeqNum seqNum;
+
+    /** Slot in the issue queue's IssueMatrix, -1 if none. */
+    int iqSlot = -1;
+
+    bool isSquashed() const { return squashed; }
+    void setSquashed() { squashed = true; }
+
+  private:
+    bool squashed = false;
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_TEST_MOCK_DYN_INST_HH__
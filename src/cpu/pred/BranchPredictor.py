@@ -1151,6 +1151,9 @@ class DecoupledBPUWithBTB(BranchPredictor):
     ras = Param.BTBRAS(BTBRAS(), "RAS")
 
     bpDBSwitches = VectorParam.String([], "Enable which traces in the form of database")
+    branchTraceFile = Param.String("", "Record committed control "
+        "instructions to this file in the output directory for offline "
+        "replay (.gz to compress)")
     enableLoopBuffer = Param.Bool(False, "Enable loop buffer to supply inst for loops")
     enableLoopPredictor = Param.Bool(False, "Use loop predictor to predict loop exit")
     enableJumpAheadPredictor = Param.Bool(False, "Use jump ahead predictor to skip no-need-to-predict blocks")
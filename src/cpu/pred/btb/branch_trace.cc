@@ -0,0 +1,95 @@
+#include "cpu/pred/btb/branch_trace.hh"
+
+#include <cstring>
+
+#include "base/logging.hh"
+#include "sim/byteswap.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+namespace btb_pred
+{
+
+namespace
+{
+
+/** pc, target, instDelta, size, flags */
+constexpr size_t RecordBytes = 8 + 8 + 4 + 1 + 1;
+
+template <class T>
+char *
+put(char *p, T v)
+{
+    v = htole(v);
+    std::memcpy(p, &v, sizeof(v));
+    return p + sizeof(v);
+}
+
+template <class T>
+const char *
+get(const char *p, T &v)
+{
+    std::memcpy(&v, p, sizeof(v));
+    v = letoh(v);
+    return p + sizeof(v);
+}
+
+} // anonymous namespace
+
+BranchTraceWriter::BranchTraceWriter(std::ostream &_os)
+    : os(_os)
+{
+    os.write(Magic, sizeof(Magic));
+}
+
+void
+BranchTraceWriter::append(const BranchTraceRecord &rec)
+{
+    char buf[RecordBytes];
+    char *p = buf;
+    p = put(p, uint64_t(rec.pc));
+    p = put(p, uint64_t(rec.target));
+    p = put(p, rec.instDelta);
+    p = put(p, rec.size);
+    put(p, rec.flags);
+    os.write(buf, sizeof(buf));
+    written++;
+}
+
+BranchTraceReader::BranchTraceReader(std::istream &_is)
+    : is(_is)
+{
+    char magic[sizeof(BranchTraceWriter::Magic)];
+    is.read(magic, sizeof(magic));
+    fatal_if(!is || std::memcmp(magic, BranchTraceWriter::Magic,
+                                sizeof(magic)) != 0,
+             "Not a branch trace.\n");
+}
+
+bool
+BranchTraceReader::next(BranchTraceRecord &rec)
+{
+    char buf[RecordBytes];
+    if (!is.read(buf, sizeof(buf))) {
+        fatal_if(is.gcount() != 0, "Truncated branch trace.\n");
+        return false;
+    }
+    uint64_t pc, target;
+    const char *p = buf;
+    p = get(p, pc);
+    p = get(p, target);
+    p = get(p, rec.instDelta);
+    p = get(p, rec.size);
+    get(p, rec.flags);
+    rec.pc = pc;
+    rec.target = target;
+    return true;
+}
+
+} // namespace btb_pred
+} // namespace branch_prediction
+} // namespace gem5
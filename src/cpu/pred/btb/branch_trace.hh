@@ -0,0 +1,82 @@
+#ifndef __CPU_PRED_BTB_BRANCH_TRACE_HH__
+#define __CPU_PRED_BTB_BRANCH_TRACE_HH__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+namespace btb_pred
+{
+
+/** One committed control instruction. */
+struct BranchTraceRecord
+{
+    enum Flag : uint8_t
+    {
+        Cond = 1 << 0,
+        Indirect = 1 << 1,
+        Call = 1 << 2,
+        Return = 1 << 3,
+        Taken = 1 << 4,
+    };
+
+    Addr pc = 0;
+    /** Target if taken, the fall-through pc otherwise. */
+    Addr target = 0;
+    /** Instructions committed since the previous record, this one included. */
+    uint32_t instDelta = 0;
+    uint8_t size = 0;
+    uint8_t flags = 0;
+
+    bool is(Flag f) const { return flags & f; }
+    bool taken() const { return is(Taken); }
+};
+
+/**
+ * Writes BranchTraceRecords as fixed-size little-endian rows after the
+ * 8-byte Magic. Compression is left to the stream, e.g. a .gz file from
+ * simout.
+ */
+class BranchTraceWriter
+{
+  public:
+    static constexpr char Magic[8] = {'X', 'S', 'B', 'R', 'T', 'R', 'C', '1'};
+
+    explicit BranchTraceWriter(std::ostream &os);
+
+    void append(const BranchTraceRecord &rec);
+
+    uint64_t numRecords() const { return written; }
+
+  private:
+    std::ostream &os;
+    uint64_t written = 0;
+};
+
+/** Reads back the records of a BranchTraceWriter, in order. */
+class BranchTraceReader
+{
+  public:
+    /** Fails with fatal() if the stream is not a branch trace. */
+    explicit BranchTraceReader(std::istream &is);
+
+    /** @return false at the end of the trace. */
+    bool next(BranchTraceRecord &rec);
+
+  private:
+    std::istream &is;
+};
+
+} // namespace btb_pred
+} // namespace branch_prediction
+} // namespace gem5
+
+#endif // __CPU_PRED_BTB_BRANCH_TRACE_HH__
@@ -4,14 +4,18 @@
 #include <cmath>
 #include <ctime>
 
-#include "base/debug_helper.hh"
 #include "base/intmath.hh"
+#include "base/logging.hh"
+
+#ifndef UNIT_TEST
+#include "base/debug_helper.hh"
 #include "base/trace.hh"
 #include "cpu/o3/dyn_inst.hh"
 #include "debug/DecoupleBP.hh"
 #include "debug/DecoupleBPVerbose.hh"
 #include "debug/DecoupleBPUseful.hh"
 #include "debug/ITTAGE.hh"
+#endif
 
 namespace gem5 {
 
@@ -485,10 +489,12 @@ BTBITTAGE::checkFoldedHist(const boost::dynamic_bitset<> &hist, const char * whe
     }
 }
 
+#ifndef UNIT_TEST
 void
 BTBITTAGE::commitBranch(const FetchStream &stream, const DynInstPtr &inst)
 {
 }
+#endif
 
 } // namespace btb_pred
 
@@ -6,17 +6,25 @@
 #include <vector>
 #include <utility>
 
-#include "base/statistics.hh"
 #include "base/types.hh"
 #include "base/sat_counter.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/pred/btb/folded_hist.hh"
 #include "cpu/pred/btb/stream_struct.hh"
+
+#ifdef UNIT_TEST
+#include "cpu/pred/btb/test/test_dprintf.hh"
+#include "cpu/pred/btb/test/timed_base_pred.hh"
+
+#else
+#include "base/statistics.hh"
 #include "cpu/pred/btb/timed_base_pred.hh"
-#include "params/BTBITTAGE.hh"
 #include "debug/DecoupleBP.hh"
+#include "params/BTBITTAGE.hh"
 #include "sim/sim_object.hh"
 
+#endif
+
 namespace gem5
 {
 
@@ -26,12 +34,32 @@ namespace branch_prediction
 namespace btb_pred
 {
 
+#ifdef UNIT_TEST
+using TimedBaseBTBPredictor = test::TimedBaseBTBPredictor;
+#endif
+
 class BTBITTAGE : public TimedBaseBTBPredictor
 {
     using defer = std::shared_ptr<void>;
     using bitset = boost::dynamic_bitset<>;
   public:
+#ifdef UNIT_TEST
+    /** The BTBITTAGE parameters of BranchPredictor.py and their defaults. */
+    struct Params
+    {
+        unsigned numPredictors = 5;
+        std::vector<unsigned> tableSizes{256, 256, 512, 512, 512};
+        std::vector<unsigned> TTagBitSizes = std::vector<unsigned>(5, 9);
+        std::vector<unsigned> TTagPcShifts = std::vector<unsigned>(5, 1);
+        std::vector<unsigned> histLengths{4, 8, 13, 16, 32};
+        unsigned maxHistLen = 970;
+        unsigned numTablesToAlloc = 1;
+        unsigned numDelay = 2;
+        unsigned blockSize = 32;
+    };
+#else
     typedef BTBITTAGEParams Params;
+#endif
 
     struct TageEntry
     {
@@ -106,7 +134,9 @@ class BTBITTAGE : public TimedBaseBTBPredictor
 
     void update(const FetchStream &entry) override;
 
+#ifndef UNIT_TEST
     void commitBranch(const FetchStream &stream, const DynInstPtr &inst) override;
+#endif
 
     // check folded hists after speculative update and recover
     void checkFoldedHist(const bitset &history, const char *when);
@@ -4,11 +4,15 @@
 #include <cmath>
 #include <ctime>
 
-#include "base/debug_helper.hh"
 #include "base/intmath.hh"
+#include "base/logging.hh"
+
+#ifndef UNIT_TEST
+#include "base/debug_helper.hh"
 #include "base/trace.hh"
 #include "cpu/o3/dyn_inst.hh"
 #include "debug/MGSC.hh"
+#endif
 
 namespace gem5 {
 
@@ -55,110 +59,62 @@ mgscStats(this)
 {
     DPRINTF(MGSC, "BTBMGSC constructor\n");
     this->needMoreHistories = p.needMoreHistories;
-    bwTable.resize(bwTableNum);
+
+    bwLane = 0;
+    lLane = bwLane + bwTableNum;
+    iLane = lLane + lTableNum;
+    gLane = iLane + iTableNum;
+    pLane = gLane + gTableNum;
+    biasLane = pLane + pTableNum;
+    fatal_if(biasLane + biasTableNum > MaxScTables,
+             "MGSC supports at most %u tables in total.\n", MaxScTables);
+
+    bwTable.init(bwTableNum, 1 << bwTableIdxWidth, numWays);
     for (unsigned int i = 0; i < bwTableNum; ++i) {
-        assert(bwTable.size() >= bwTableNum);
-        bwTable[i].resize(std::pow(2,bwTableIdxWidth));
-        for (unsigned int j = 0; j < (std::pow(2,bwTableIdxWidth)); ++j) {
-            bwTable[i][j].resize(numWays);
-        }
         indexBwFoldedHist.push_back(FoldedHist(bwHistLen[i], bwTableIdxWidth, 16, HistoryType::GLOBALBW));
     }
-    bwIndex.resize(bwTableNum);
 
-    lTable.resize(lTableNum);
+    lTable.init(lTableNum, 1 << lTableIdxWidth, numWays);
     indexLFoldedHist.resize(numEntriesFirstLocalHistories);
     for (unsigned int i = 0; i < lTableNum; ++i) {
-        assert(lTable.size() >= lTableNum);
-        lTable[i].resize(std::pow(2,lTableIdxWidth));
-        for (unsigned int j = 0; j < (std::pow(2,lTableIdxWidth)); ++j) {
-            lTable[i][j].resize(numWays);
-        }
         for (unsigned int k = 0; k < numEntriesFirstLocalHistories; ++k) {
             indexLFoldedHist[k].push_back(FoldedHist(lHistLen[i], lTableIdxWidth, 16, HistoryType::LOCAL));
         }
     }
-    lIndex.resize(lTableNum);
 
-    iTable.resize(iTableNum);
+    iTable.init(iTableNum, 1 << iTableIdxWidth, numWays);
     for (unsigned int i = 0; i < iTableNum; ++i) {
-        assert(iTable.size() >= iTableNum);
-        iTable[i].resize(std::pow(2,iTableIdxWidth));
-        for (unsigned int j = 0; j < (std::pow(2,iTableIdxWidth)); ++j) {
-            iTable[i][j].resize(numWays);
-        }
         indexIFoldedHist.push_back(FoldedHist(iHistLen[i], iTableIdxWidth, 16, HistoryType::IMLI));
     }
-    iIndex.resize(iTableNum);
 
-    gTable.resize(gTableNum);
+    gTable.init(gTableNum, 1 << gTableIdxWidth, numWays);
     for (unsigned int i = 0; i < gTableNum; ++i) {
-        assert(gTable.size() >= gTableNum);
-        gTable[i].resize(std::pow(2,gTableIdxWidth));
-        for (unsigned int j = 0; j < (std::pow(2,gTableIdxWidth)); ++j) {
-            gTable[i][j].resize(numWays);
-        }
         indexGFoldedHist.push_back(FoldedHist(gHistLen[i], gTableIdxWidth, 16, HistoryType::GLOBAL));
     }
-    gIndex.resize(gTableNum);
 
-    pTable.resize(pTableNum);
+    pTable.init(pTableNum, 1 << pTableIdxWidth, numWays);
     for (unsigned int i = 0; i < pTableNum; ++i) {
-        assert(pTable.size() >= pTableNum);
-        pTable[i].resize(std::pow(2,pTableIdxWidth));
-        for (unsigned int j = 0; j < (std::pow(2,pTableIdxWidth)); ++j) {
-            pTable[i][j].resize(numWays);
-        }
         indexPFoldedHist.push_back(FoldedHist(pHistLen[i], pTableIdxWidth, 2, HistoryType::PATH));
     }
-    pIndex.resize(pTableNum);
-
-    biasTable.resize(biasTableNum);
-    for (unsigned int i = 0; i < biasTableNum; ++i) {
-        assert(biasTable.size() >= biasTableNum);
-        biasTable[i].resize(std::pow(2,biasTableIdxWidth));
-        for (unsigned int j = 0; j < (std::pow(2,biasTableIdxWidth)); ++j) {
-            biasTable[i][j].resize(numWays);
-        }
-    }
-    biasIndex.resize(biasTableNum);
-
-    bwWeightTable.resize(std::pow(2,weightTableIdxWidth));
-    for (unsigned int j = 0; j < (std::pow(2,weightTableIdxWidth)); ++j) {
-        bwWeightTable[j].resize(numWays);
-    }
-
-    lWeightTable.resize(std::pow(2,weightTableIdxWidth));
-    for (unsigned int j = 0; j < (std::pow(2,weightTableIdxWidth)); ++j) {
-        lWeightTable[j].resize(numWays);
-    }
 
-    iWeightTable.resize(std::pow(2,weightTableIdxWidth));
-    for (unsigned int j = 0; j < (std::pow(2,weightTableIdxWidth)); ++j) {
-        iWeightTable[j].resize(numWays);
-    }
+    biasTable.init(biasTableNum, 1 << biasTableIdxWidth, numWays);
 
-    gWeightTable.resize(std::pow(2,weightTableIdxWidth));
-    for (unsigned int j = 0; j < (std::pow(2,weightTableIdxWidth)); ++j) {
-        gWeightTable[j].resize(numWays);
-    }
+    bwWeightTable.init(1, 1 << weightTableIdxWidth, numWays);
+    lWeightTable.init(1, 1 << weightTableIdxWidth, numWays);
+    iWeightTable.init(1, 1 << weightTableIdxWidth, numWays);
+    gWeightTable.init(1, 1 << weightTableIdxWidth, numWays);
+    pWeightTable.init(1, 1 << weightTableIdxWidth, numWays);
+    biasWeightTable.init(1, 1 << weightTableIdxWidth, numWays);
 
-    pWeightTable.resize(std::pow(2,weightTableIdxWidth));
-    for (unsigned int j = 0; j < (std::pow(2,weightTableIdxWidth)); ++j) {
-        pWeightTable[j].resize(numWays);
-    }
+    pUpdateThreshold.init(1, 1 << thresholdTablelogSize, numWays);
+    updateThreshold.init(1, 1, numWays);
 
-    biasWeightTable.resize(std::pow(2,weightTableIdxWidth));
-    for (unsigned int j = 0; j < (std::pow(2,weightTableIdxWidth)); ++j) {
-        biasWeightTable[j].resize(numWays);
-    }
-
-    pUpdateThreshold.resize(std::pow(2,thresholdTablelogSize));
-    for (unsigned int j = 0; j < (std::pow(2,thresholdTablelogSize)); ++j) {
-        pUpdateThreshold[j].resize(numWays);
-    }
-
-    updateThreshold.resize(numWays);
+    bwHistBase = 0;
+    lHistBase = bwHistBase + bwTableNum;
+    iHistBase = lHistBase + numEntriesFirstLocalHistories * lTableNum;
+    gHistBase = iHistBase + iTableNum;
+    pHistBase = gHistBase + gTableNum;
+    numFoldedHists = pHistBase + pTableNum;
 
 }
 
@@ -166,11 +122,13 @@ BTBMGSC::~BTBMGSC()
 {
 }
 
+#ifndef UNIT_TEST
 // Set up tracing for debugging
 void
 BTBMGSC::setTrace()
 {
 }
+#endif
 
 void
 BTBMGSC::tick() {}
@@ -178,36 +136,29 @@ BTBMGSC::tick() {}
 void
 BTBMGSC::tickStart() {}
 
-bool
-BTBMGSC::tagMatch(Addr pc_a, Addr pc_b, unsigned matchBits) {
-    // Use bitwise operations directly to avoid overhead of creating bitset objects
-    // Create mask: when matchBits=5, mask=0x1F (binary 11111)
-    Addr mask = (1ULL << matchBits) - 1;
-    return ((pc_a >> instShiftAmt) & mask) == ((pc_b >> instShiftAmt) & mask);
-}
-
 /**
  * Calculate perceptron sum from a table for a given PC
- * perceptron sum is the sum of the (2*counter + 1) of the matching entries
+ * perceptron sum is the sum of the (2*counter + 1) of the matching entries.
+ * At most one way of a set matches, so the ways are summed without
+ * branching and the loop vectorizes.
  * @param table The table to search in
  * @param tableIndices Indices to use for each table component
  * @param numTables Number of tables to search
- * @param pc PC to match against
+ * @param tag pcTag() to match against
  * @return Calculated percsum value
  */
 int
-BTBMGSC::calculatePercsum(const std::vector<std::vector<std::vector<MgscEntry>>> &table,
-                         const std::vector<Addr> &tableIndices,
+BTBMGSC::calculatePercsum(const FlatTable<short> &table,
+                         const uint32_t *tableIndices,
                          unsigned numTables,
-                         Addr pc) {
+                         uint8_t tag) {
     int percsum = 0;
     for (unsigned int i = 0; i < numTables; ++i) {
+        size_t base = table.setBase(i, tableIndices[i]);
+        const uint8_t *tags = &table.tags[base];
+        const short *counters = &table.counters[base];
         for (unsigned way = 0; way < numWays; way++) {
-            auto &entry = table[i][tableIndices[i]][way];
-            if (tagMatch(pc, entry.pc, 5) && entry.valid) {
-                percsum += (2 * entry.counter + 1); // 2*counter + 1 is always >= 0
-                break;
-            }
+            percsum += tags[way] == tag ? 2 * counters[way] + 1 : 0; // 2*counter + 1 is always >= 0
         }
     }
     return percsum;
@@ -217,20 +168,16 @@ BTBMGSC::calculatePercsum(const std::vector<std::vector<std::vector<MgscEntry>>>
  * Find weight in a weight table for a given PC
  * @param weightTable The weight table to search
  * @param tableIndex Index to use for the table
- * @param pc PC to match against
+ * @param tag pcTag() to match against
  * @return Found weight or 0 if not found
  */
 int
-BTBMGSC::findWeight(const std::vector<std::vector<MgscWeightEntry>> &weightTable,
+BTBMGSC::findWeight(const FlatTable<short> &weightTable,
                    Addr tableIndex,
-                   Addr pc) {
-    for (unsigned way = 0; way < numWays; way++) {
-        auto &entry = weightTable[tableIndex][way];
-        if (tagMatch(pc, entry.pc, 5) && entry.valid) {
-            return entry.counter;
-        }
-    }
-    return 0;
+                   uint8_t tag) {
+    size_t base = weightTable.setBase(0, tableIndex);
+    int way = weightTable.find(base, tag);
+    return way < 0 ? 0 : weightTable.counters[base + way];
 }
 
 /**
@@ -249,22 +196,18 @@ BTBMGSC::calculateScaledPercsum(int weight, int percsum) {
  * Find threshold in a threshold table for a given PC
  * @param thresholdTable The threshold table to search
  * @param tableIndex Index to use for the table
- * @param pc PC to match against
+ * @param tag pcTag() to match against
  * @param defaultValue Default value to return if not found
  * @return Found threshold or default value if not found
  */
 int
-BTBMGSC::findThreshold(const std::vector<std::vector<MgscThresEntry>> &thresholdTable,
+BTBMGSC::findThreshold(const FlatTable<unsigned> &thresholdTable,
                       Addr tableIndex,
-                      Addr pc,
+                      uint8_t tag,
                       int defaultValue) {
-    for (unsigned way = 0; way < numWays; way++) {
-        auto &entry = thresholdTable[tableIndex][way];
-        if (tagMatch(pc, entry.pc, 5) && entry.valid) {
-            return entry.counter;
-        }
-    }
-    return defaultValue;
+    size_t base = thresholdTable.setBase(0, tableIndex);
+    int way = thresholdTable.find(base, tag);
+    return way < 0 ? defaultValue : thresholdTable.counters[base + way];
 }
 
 /**
@@ -283,71 +226,93 @@ BTBMGSC::calculateWeightScaleDiff(int total_sum, int scale_percsum, int percsum)
 }
 
 /**
- * @brief Generate prediction for a single BTB entry by searching MGSC tables
+ * @brief Compute the table indices of a stream
  *
- * @param btb_entry The BTB entry to generate prediction for
- * @param startPC The starting PC address for calculating indices and tags
- * @return TagePrediction containing main and alternative predictions
+ * The folded histories do not change while a stream is predicted, so the
+ * history indexed lanes are computed once here and shared by all its
+ * branches; only the two low bits of the bias index are per branch.
+ *
+ * @param startPC The starting PC address of the stream
  */
-BTBMGSC::MgscPrediction
-BTBMGSC::generateSinglePrediction(const BTBEntry &btb_entry,
-                                 const Addr &startPC,
-                                 const TageInfoForMGSC &tage_info) {
-    DPRINTF(MGSC, "generateSinglePrediction for btbEntry: %#lx, always taken %d\n",
-        btb_entry.pc, btb_entry.alwaysTaken);
-
-    // Calculate indices for all tables
+void
+BTBMGSC::computeLookupIndices(Addr startPC)
+{
     for (unsigned int i = 0; i < bwTableNum; ++i) {
-        bwIndex[i] = getHistIndex(startPC, bwTableIdxWidth, indexBwFoldedHist[i].get());
+        lookupLanes[bwLane + i] = getHistIndex(startPC, bwTableIdxWidth, indexBwFoldedHist[i].get());
     }
 
+    auto &local_hist = indexLFoldedHist[getPcIndex(startPC, log2(numEntriesFirstLocalHistories))];
     for (unsigned int i = 0; i < lTableNum; ++i) {
-        lIndex[i] = getHistIndex(startPC, lTableIdxWidth,
-                  indexLFoldedHist[getPcIndex(startPC, log2(numEntriesFirstLocalHistories))][i].get());
+        lookupLanes[lLane + i] = getHistIndex(startPC, lTableIdxWidth, local_hist[i].get());
     }
 
     for (unsigned int i = 0; i < iTableNum; ++i) {
-        iIndex[i] = getHistIndex(startPC, iTableIdxWidth, indexIFoldedHist[i].get());
+        lookupLanes[iLane + i] = getHistIndex(startPC, iTableIdxWidth, indexIFoldedHist[i].get());
     }
 
     for (unsigned int i = 0; i < gTableNum; ++i) {
-        gIndex[i] = getHistIndex(startPC, gTableIdxWidth, indexGFoldedHist[i].get());
+        lookupLanes[gLane + i] = getHistIndex(startPC, gTableIdxWidth, indexGFoldedHist[i].get());
     }
 
     for (unsigned int i = 0; i < pTableNum; ++i) {
-        pIndex[i] = getHistIndex(startPC, pTableIdxWidth, indexPFoldedHist[i].get());
+        lookupLanes[pLane + i] = getHistIndex(startPC, pTableIdxWidth, indexPFoldedHist[i].get());
     }
 
+    lookupBiasBase = getBiasIndex(startPC, biasTableIdxWidth, false, false);
+    lookupWeightIdx = getPcIndex(startPC, weightTableIdxWidth);
+    lookupThresIdx = getPcIndex(startPC, thresholdTablelogSize);
+}
+
+/**
+ * @brief Generate prediction for a single BTB entry by searching MGSC tables
+ *
+ * Uses the indices computeLookupIndices() prepared for the stream.
+ *
+ * @param btb_entry The BTB entry to generate prediction for
+ * @param startPC The starting PC address for calculating indices and tags
+ * @return TagePrediction containing main and alternative predictions
+ */
+BTBMGSC::MgscPrediction
+BTBMGSC::generateSinglePrediction(const BTBEntry &btb_entry,
+                                 const Addr &startPC,
+                                 const TageInfoForMGSC &tage_info) {
+    DPRINTF(MGSC, "generateSinglePrediction for btbEntry: %#lx, always taken %d\n",
+        btb_entry.pc, btb_entry.alwaysTaken);
+
+    // Only the bias indices depend on the tage prediction
+    IndexLanes indices = lookupLanes;
     for (unsigned int i = 0; i < biasTableNum; ++i) {
-        biasIndex[i] = getBiasIndex(startPC, biasTableIdxWidth, tage_info.tage_pred_taken,
-                    tage_info.tage_pred_conf_low && tage_info.tage_pred_alt_diff);
+        indices[biasLane + i] = lookupBiasBase +
+            ((tage_info.tage_pred_conf_low && tage_info.tage_pred_alt_diff) << 1) +
+            tage_info.tage_pred_taken;
     }
 
     // Calculate percsums and weights for all tables
-    Addr tableIndex = getPcIndex(startPC, weightTableIdxWidth);
+    Addr tableIndex = lookupWeightIdx;
+    uint8_t tag = pcTag(btb_entry.pc);
 
-    int bw_percsum = calculatePercsum(bwTable, bwIndex, bwTableNum, btb_entry.pc);
-    int bw_weight = findWeight(bwWeightTable, tableIndex, btb_entry.pc);
+    int bw_percsum = calculatePercsum(bwTable, &indices[bwLane], bwTableNum, tag);
+    int bw_weight = findWeight(bwWeightTable, tableIndex, tag);
     int bw_scale_percsum = calculateScaledPercsum(bw_weight, bw_percsum);
 
-    int l_percsum = calculatePercsum(lTable, lIndex, lTableNum, btb_entry.pc);
-    int l_weight = findWeight(lWeightTable, tableIndex, btb_entry.pc);
+    int l_percsum = calculatePercsum(lTable, &indices[lLane], lTableNum, tag);
+    int l_weight = findWeight(lWeightTable, tableIndex, tag);
     int l_scale_percsum = calculateScaledPercsum(l_weight, l_percsum);
 
-    int i_percsum = calculatePercsum(iTable, iIndex, iTableNum, btb_entry.pc);
-    int i_weight = findWeight(iWeightTable, tableIndex, btb_entry.pc);
+    int i_percsum = calculatePercsum(iTable, &indices[iLane], iTableNum, tag);
+    int i_weight = findWeight(iWeightTable, tableIndex, tag);
     int i_scale_percsum = calculateScaledPercsum(i_weight, i_percsum);
 
-    int g_percsum = calculatePercsum(gTable, gIndex, gTableNum, btb_entry.pc);
-    int g_weight = findWeight(gWeightTable, tableIndex, btb_entry.pc);
+    int g_percsum = calculatePercsum(gTable, &indices[gLane], gTableNum, tag);
+    int g_weight = findWeight(gWeightTable, tableIndex, tag);
     int g_scale_percsum = calculateScaledPercsum(g_weight, g_percsum);
 
-    int p_percsum = calculatePercsum(pTable, pIndex, pTableNum, btb_entry.pc);
-    int p_weight = findWeight(pWeightTable, tableIndex, btb_entry.pc);
+    int p_percsum = calculatePercsum(pTable, &indices[pLane], pTableNum, tag);
+    int p_weight = findWeight(pWeightTable, tableIndex, tag);
     int p_scale_percsum = calculateScaledPercsum(p_weight, p_percsum);
 
-    int bias_percsum = calculatePercsum(biasTable, biasIndex, biasTableNum, btb_entry.pc);
-    int bias_weight = findWeight(biasWeightTable, tableIndex, btb_entry.pc);
+    int bias_percsum = calculatePercsum(biasTable, &indices[biasLane], biasTableNum, tag);
+    int bias_weight = findWeight(biasWeightTable, tableIndex, tag);
     int bias_scale_percsum = calculateScaledPercsum(bias_weight, bias_percsum);
 
     // Calculate total sum of all weighted percsums
@@ -356,20 +321,11 @@ BTBMGSC::generateSinglePrediction(const BTBEntry &btb_entry,
 
     // Find thresholds
     // pc-indexed threshold table, default value = initialUpdateThresholdValue = 0
-    int p_update_thres = findThreshold(pUpdateThreshold,
-                                     getPcIndex(startPC, thresholdTablelogSize),
-                                     btb_entry.pc,
+    int p_update_thres = findThreshold(pUpdateThreshold, lookupThresIdx, tag,
                                      initialUpdateThresholdValue);
 
     // global threshold table
-    int update_thres = 35 << 3;     // default value = 35 << 3 ?
-    for (unsigned way = 0; way < numWays; way++) {
-        auto &entry = updateThreshold[way];
-        if (tagMatch(btb_entry.pc, entry.pc, 5) && entry.valid) {
-            update_thres = entry.counter;
-            break;
-        }
-    }
+    int update_thres = findThreshold(updateThreshold, 0, tag, 35 << 3);     // default value = 35 << 3 ?
 
     int total_thres = (update_thres >> 3) + p_update_thres;  // total_thres = global_thres + pc_thres
 
@@ -404,7 +360,7 @@ BTBMGSC::generateSinglePrediction(const BTBEntry &btb_entry,
 
     return MgscPrediction(btb_entry.pc, total_sum, use_sc_pred, taken,
                         tage_info.tage_pred_taken, total_thres,
-                        bwIndex, lIndex, iIndex, gIndex, pIndex, biasIndex,
+                        packTageInfo(tage_info), indices,
                         bw_weight_scale_diff, l_weight_scale_diff, i_weight_scale_diff,
                         g_weight_scale_diff, p_weight_scale_diff, bias_weight_scale_diff,
                         bw_percsum, l_percsum, i_percsum, g_percsum, p_percsum, bias_percsum);
@@ -429,9 +385,15 @@ BTBMGSC::lookupHelper(const Addr &startPC, const std::vector<BTBEntry> &btbEntri
         if (btb_entry.isCond && btb_entry.valid) {
             auto tage_info = tageInfoForMgscs.find(btb_entry.pc);
             if(tage_info != tageInfoForMgscs.end()){
-                auto pred = generateSinglePrediction(btb_entry, startPC, tage_info->second);
-                meta->preds[btb_entry.pc] = pred;
-                results.push_back({btb_entry.pc, pred.taken || btb_entry.alwaysTaken});
+                // Stages usually see the same branch with the same tage
+                // info, reuse the prediction made for an earlier stage
+                auto it = meta->preds.find(btb_entry.pc);
+                if (it == meta->preds.end() ||
+                    it->second.tage_info_bits != packTageInfo(tage_info->second)) {
+                    it = meta->preds.insert_or_assign(btb_entry.pc,
+                        generateSinglePrediction(btb_entry, startPC, tage_info->second)).first;
+                }
+                results.push_back({btb_entry.pc, it->second.taken || btb_entry.alwaysTaken});
             } else {
                 assert(false);
             }
@@ -461,14 +423,29 @@ BTBMGSC::putPCHistory(Addr stream_start, const bitset &history, std::vector<Full
 
     // Clear old prediction metadata and save current history state
     meta = std::make_shared<MgscMeta>();
-    meta->indexBwFoldedHist = indexBwFoldedHist;
-    meta->indexLFoldedHist = indexLFoldedHist;
-    meta->indexIFoldedHist = indexIFoldedHist;
-    meta->indexGFoldedHist = indexGFoldedHist;
-    meta->indexPFoldedHist = indexPFoldedHist;
+    auto &folded = meta->foldedHist;
+    folded.reserve(numFoldedHists);
+    for (auto &hist : indexBwFoldedHist) {
+        folded.push_back(hist.get());
+    }
+    for (auto &local_hists : indexLFoldedHist) {
+        for (auto &hist : local_hists) {
+            folded.push_back(hist.get());
+        }
+    }
+    for (auto &hist : indexIFoldedHist) {
+        folded.push_back(hist.get());
+    }
+    for (auto &hist : indexGFoldedHist) {
+        folded.push_back(hist.get());
+    }
+    for (auto &hist : indexPFoldedHist) {
+        folded.push_back(hist.get());
+    }
+
+    computeLookupIndices(stream_start);
 
     for (int s = getDelay(); s < stagePreds.size(); s++) {
-        // TODO: only lookup once for one btb entry in different stages
         auto &stage_pred = stagePreds[s];
         stage_pred.condTakens.clear();
         lookupHelper(stream_start, stage_pred.btbEntries, stage_pred.tageInfoForMgscs, stage_pred.condTakens);
@@ -523,31 +500,24 @@ BTBMGSC::prepareUpdateEntries(const FetchStream &stream) {
  * @param actual_taken Actual branch outcome (true=taken, false=not taken)
  */
 void
-BTBMGSC::updateAndAllocatePredTable(std::vector<std::vector<std::vector<MgscEntry>>> &table,
-                                  const std::vector<Addr> &tableIndices,
+BTBMGSC::updateAndAllocatePredTable(FlatTable<short> &table,
+                                  const uint32_t *tableIndices,
                                   unsigned numTables,
                                   Addr pc,
                                   bool actual_taken) {
+    uint8_t tag = pcTag(pc);
     for (unsigned int i = 0; i < numTables; ++i) {
-        bool found_entry = false;
-        // Search all ways in the set for a matching entry
-        for (unsigned way = 0; way < numWays; way++) {
-            auto &entry = table[i][tableIndices[i]][way];
-            if (tagMatch(pc, entry.pc, 5) && entry.valid) {
-                // Entry found - update its counter based on branch outcome
-                updateCounter(actual_taken, scCountersWidth, entry.counter);
-                found_entry = true;
-                updateLRU(table[i], tableIndices[i], way);
-                break;
-            }
-        }
-        // Allocate if not found - use LRU replacement policy
-        if (!found_entry) {
-            unsigned alloc_way = getLRUVictim(table[i], tableIndices[i]);
-            auto &entry_to_alloc = table[i][tableIndices[i]][alloc_way];
+        size_t base = table.setBase(i, tableIndices[i]);
+        int way = table.find(base, tag);
+        if (way >= 0) {
+            // Entry found - update its counter based on branch outcome
+            updateCounter(actual_taken, scCountersWidth, table.counters[base + way]);
+            table.touch(base, way);
+        } else {
+            // Allocate if not found - use LRU replacement policy
             // Initialize counter based on branch outcome
             short newCounter = actual_taken ? 0 : -1;
-            entry_to_alloc = MgscEntry(true, newCounter, pc, 0);
+            table.fill(base, table.victim(base), tag, newCounter);
         }
     }
 }
@@ -570,33 +540,25 @@ BTBMGSC::updateAndAllocatePredTable(std::vector<std::vector<std::vector<MgscEntr
  * @param percsum_matches_actual Whether the raw percsum correctly predicted the outcome
  */
 void
-BTBMGSC::updateAndAllocateWeightTable(std::vector<std::vector<MgscWeightEntry>> &weightTable,
+BTBMGSC::updateAndAllocateWeightTable(FlatTable<short> &weightTable,
                                     Addr tableIndex,
                                     Addr pc,
                                     bool weight_scale_diff,
                                     bool percsum_matches_actual) {
-    bool found_entry = false;
-    // Search all ways in the set for a matching entry
-    for (unsigned way = 0; way < numWays; way++) {
-        auto &entry = weightTable[tableIndex][way];
-        if (tagMatch(pc, entry.pc, 5) && entry.valid) {
-            // Only update if weight scale could affect prediction
-            if (weight_scale_diff) {
-                // Increase weight if percsum was correct, decrease if incorrect
-                updateCounter(percsum_matches_actual, extraWeightsWidth, entry.counter);
-            }
-            found_entry = true;
-            updateLRU(weightTable, tableIndex, way);
-            break;
+    uint8_t tag = pcTag(pc);
+    size_t base = weightTable.setBase(0, tableIndex);
+    int way = weightTable.find(base, tag);
+    if (way >= 0) {
+        // Only update if weight scale could affect prediction
+        if (weight_scale_diff) {
+            // Increase weight if percsum was correct, decrease if incorrect
+            updateCounter(percsum_matches_actual, extraWeightsWidth, weightTable.counters[base + way]);
         }
-    }
-
-    // Allocate if not found - use LRU replacement policy
-    if (!found_entry) {
-        unsigned alloc_way = getLRUVictim(weightTable, tableIndex);
-        auto &entry_to_alloc = weightTable[tableIndex][alloc_way];
+        weightTable.touch(base, way);
+    } else {
+        // Allocate if not found - use LRU replacement policy
         // Initialize weight to neutral value (0)
-        entry_to_alloc = MgscWeightEntry(true, pc, 0, 0);
+        weightTable.fill(base, weightTable.victim(base), tag, 0);
     }
 }
 
@@ -621,28 +583,20 @@ BTBMGSC::updatePCThresholdTable(Addr tableIndex,
                                 Addr pc,
                                 bool update_condition,
                                 bool update_direction) {
-    bool found_entry = false;
-    // Search all ways in the set for a matching entry
-    for (unsigned way = 0; way < numWays; way++) {
-        auto &entry = pUpdateThreshold[tableIndex][way];
-        if (tagMatch(pc, entry.pc, 5) && entry.valid) {
-            // Only update if the update condition is met (TAGE and SC disagree)
-            if (update_condition) {
-                // Adjust threshold based on which prediction was correct
-                updateCounter(update_direction, pUpdateThresholdWidth, entry.counter);
-            }
-            found_entry = true;
-            updateLRU(pUpdateThreshold, tableIndex, way);
-            break;
+    uint8_t tag = pcTag(pc);
+    size_t base = pUpdateThreshold.setBase(0, tableIndex);
+    int way = pUpdateThreshold.find(base, tag);
+    if (way >= 0) {
+        // Only update if the update condition is met (TAGE and SC disagree)
+        if (update_condition) {
+            // Adjust threshold based on which prediction was correct
+            updateCounter(update_direction, pUpdateThresholdWidth, pUpdateThreshold.counters[base + way]);
         }
-    }
-
-    // Allocate if not found - use LRU replacement policy
-    if (!found_entry) {
-        unsigned alloc_way = getLRUVictim(pUpdateThreshold, tableIndex);
-        auto &entry_to_alloc = pUpdateThreshold[tableIndex][alloc_way];
+        pUpdateThreshold.touch(base, way);
+    } else {
+        // Allocate if not found - use LRU replacement policy
         // Initialize with default value from class member
-        entry_to_alloc = MgscThresEntry(true, pc, initialUpdateThresholdValue, 0);
+        pUpdateThreshold.fill(base, pUpdateThreshold.victim(base), tag, initialUpdateThresholdValue);
     }
 }
 
@@ -663,27 +617,18 @@ void
 BTBMGSC::updateGlobalThreshold(Addr pc,
                              bool update_condition,
                              bool update_direction) {
-    bool found_entry = false;
-    // Search all ways for a matching entry
-    for (unsigned way = 0; way < numWays; way++) {
-        auto &entry = updateThreshold[way];
-        if (tagMatch(pc, entry.pc, 5) && entry.valid) {
-            // Only update if the update condition is met
-            if (update_condition) {
-                updateCounter(update_direction, updateThresholdWidth, entry.counter);
-            }
-            found_entry = true;
-            updateLRU(updateThreshold, way);
-            break;
+    uint8_t tag = pcTag(pc);
+    int way = updateThreshold.find(0, tag);
+    if (way >= 0) {
+        // Only update if the update condition is met
+        if (update_condition) {
+            updateCounter(update_direction, updateThresholdWidth, updateThreshold.counters[way]);
         }
-    }
-
-    // Allocate if not found - use LRU replacement policy
-    if (!found_entry) {
-        unsigned alloc_way = getLRUVictim(updateThreshold);
-        auto &entry_to_alloc = updateThreshold[alloc_way];
+        updateThreshold.touch(0, way);
+    } else {
+        // Allocate if not found - use LRU replacement policy
         // Initialize with default hard-coded value (35 << 3)
-        entry_to_alloc = MgscThresEntry(true, pc, 35 << 3, 0);
+        updateThreshold.fill(0, updateThreshold.victim(0), tag, 35 << 3);
     }
 }
 
@@ -732,42 +677,42 @@ BTBMGSC::updateAndAllocateSinglePredictor(const BTBEntry &entry,
         Addr weightTableIdx = getPcIndex(stream.startPC, weightTableIdxWidth);
 
         // Update BW tables
-        updateAndAllocatePredTable(bwTable, pred.bwIndex, bwTableNum, entry.pc, actual_taken);
+        updateAndAllocatePredTable(bwTable, &pred.indices[bwLane], bwTableNum, entry.pc, actual_taken);
         updateAndAllocateWeightTable(
             bwWeightTable, weightTableIdx, entry.pc, pred.bw_weight_scale_diff,
             (pred.bw_percsum >= 0) == actual_taken);
 
         // Update L tables
         updateAndAllocatePredTable(
-            lTable, pred.lIndex, lTableNum, entry.pc, actual_taken);
+            lTable, &pred.indices[lLane], lTableNum, entry.pc, actual_taken);
         updateAndAllocateWeightTable(
             lWeightTable, weightTableIdx, entry.pc, pred.l_weight_scale_diff,
             (pred.l_percsum >= 0) == actual_taken);
 
         // Update I tables
         updateAndAllocatePredTable(
-            iTable, pred.iIndex, iTableNum, entry.pc, actual_taken);
+            iTable, &pred.indices[iLane], iTableNum, entry.pc, actual_taken);
         updateAndAllocateWeightTable(
             iWeightTable, weightTableIdx, entry.pc, pred.i_weight_scale_diff,
             (pred.i_percsum >= 0) == actual_taken);
 
         // Update G tables
         updateAndAllocatePredTable(
-            gTable, pred.gIndex, gTableNum, entry.pc, actual_taken);
+            gTable, &pred.indices[gLane], gTableNum, entry.pc, actual_taken);
         updateAndAllocateWeightTable(
             gWeightTable, weightTableIdx, entry.pc, pred.g_weight_scale_diff,
             (pred.g_percsum >= 0) == actual_taken);
 
         // Update P tables
         updateAndAllocatePredTable(
-            pTable, pred.pIndex, pTableNum, entry.pc, actual_taken);
+            pTable, &pred.indices[pLane], pTableNum, entry.pc, actual_taken);
         updateAndAllocateWeightTable(
             pWeightTable, weightTableIdx, entry.pc, pred.p_weight_scale_diff,
             (pred.p_percsum >= 0) == actual_taken);
 
         // Update bias tables
         updateAndAllocatePredTable(
-            biasTable, pred.biasIndex, biasTableNum, entry.pc, actual_taken);
+            biasTable, &pred.indices[biasLane], biasTableNum, entry.pc, actual_taken);
         updateAndAllocateWeightTable(
             biasWeightTable, weightTableIdx, entry.pc, pred.bias_weight_scale_diff,
             (pred.bias_percsum >= 0) == actual_taken);
@@ -1066,7 +1011,7 @@ BTBMGSC::recoverHist(const boost::dynamic_bitset<> &history,
 {
     std::shared_ptr<MgscMeta> predMeta = std::static_pointer_cast<MgscMeta>(entry.predMetas[getComponentIdx()]);
     for (int i = 0; i < gTableNum; i++) {
-        indexGFoldedHist[i].recover(predMeta->indexGFoldedHist[i]);
+        indexGFoldedHist[i].recover(predMeta->foldedHist[gHistBase + i]);
     }
     doUpdateHist(history, shamt, cond_taken, indexGFoldedHist);
 }
@@ -1090,7 +1035,7 @@ BTBMGSC::recoverPHist(const boost::dynamic_bitset<> &history,
 {
     std::shared_ptr<MgscMeta> predMeta = std::static_pointer_cast<MgscMeta>(entry.predMetas[getComponentIdx()]);
     for (int i = 0; i < pTableNum; i++) {
-        indexPFoldedHist[i].recover(predMeta->indexPFoldedHist[i]);
+        indexPFoldedHist[i].recover(predMeta->foldedHist[pHistBase + i]);
     }
     doUpdateHist(history, 1, cond_taken, indexPFoldedHist, entry.getControlPC());
 }
@@ -1114,7 +1059,7 @@ BTBMGSC::recoverBwHist(const boost::dynamic_bitset<> &history,
 {
     std::shared_ptr<MgscMeta> predMeta = std::static_pointer_cast<MgscMeta>(entry.predMetas[getComponentIdx()]);
     for (int i = 0; i < bwTableNum; i++) {
-        indexBwFoldedHist[i].recover(predMeta->indexBwFoldedHist[i]);
+        indexBwFoldedHist[i].recover(predMeta->foldedHist[bwHistBase + i]);
     }
     doUpdateHist(history, shamt, cond_taken, indexBwFoldedHist);
 }
@@ -1138,7 +1083,7 @@ BTBMGSC::recoverIHist(const boost::dynamic_bitset<> &history,
 {
     std::shared_ptr<MgscMeta> predMeta = std::static_pointer_cast<MgscMeta>(entry.predMetas[getComponentIdx()]);
     for (int i = 0; i < iTableNum; i++) {
-        indexIFoldedHist[i].recover(predMeta->indexIFoldedHist[i]);
+        indexIFoldedHist[i].recover(predMeta->foldedHist[iHistBase + i]);
     }
     doUpdateHist(history, shamt, cond_taken, indexIFoldedHist);
 }
@@ -1163,13 +1108,14 @@ BTBMGSC::recoverLHist(const std::vector<boost::dynamic_bitset<>> &history,
     std::shared_ptr<MgscMeta> predMeta = std::static_pointer_cast<MgscMeta>(entry.predMetas[getComponentIdx()]);
     for (unsigned int k = 0; k < numEntriesFirstLocalHistories; ++k) {
         for (int i = 0; i < lTableNum; i++) {
-            indexLFoldedHist[k][i].recover(predMeta->indexLFoldedHist[k][i]);
+            indexLFoldedHist[k][i].recover(predMeta->foldedHist[lHistBase + k * lTableNum + i]);
         }
     }
     doUpdateHist(history[getPcIndex(entry.startPC, log2(numEntriesFirstLocalHistories))], shamt, cond_taken,
                 indexLFoldedHist[getPcIndex(entry.startPC, log2(numEntriesFirstLocalHistories))]);
 }
 
+#ifndef UNIT_TEST
 // Constructor for TAGE statistics
 BTBMGSC::MgscStats::MgscStats(statistics::Group* parent):
     statistics::Group(parent),
@@ -1182,80 +1128,11 @@ BTBMGSC::MgscStats::MgscStats(statistics::Group* parent):
 {
 }
 
-// Update LRU counters for a set
-template <typename T>
-void
-BTBMGSC::updateLRU(std::vector<std::vector<T>> &table, Addr index, unsigned way)
-{
-    // Increment LRU counters for all entries in the set
-    for (unsigned i = 0; i < numWays; i++) {
-        if (i != way && table[index][i].valid) {
-            table[index][i].lruCounter++;
-        }
-    }
-    // Reset LRU counter for the accessed entry
-    table[index][way].lruCounter = 0;
-}
-
-template <typename T>
-void
-BTBMGSC::updateLRU(std::vector<T> &table, unsigned way)
-{
-    // Increment LRU counters for all entries in the set
-    for (unsigned i = 0; i < numWays; i++) {
-        if (i != way && table[i].valid) {
-            table[i].lruCounter++;
-        }
-    }
-    // Reset LRU counter for the accessed entry
-    table[way].lruCounter = 0;
-}
-
-// Find the LRU victim in a set
-template <typename T>
-unsigned
-BTBMGSC::getLRUVictim(std::vector<std::vector<T>> &table, Addr index)
-{
-    unsigned victim = 0;
-    unsigned maxLRU = 0;
-
-    // Find the entry with the highest LRU counter
-    for (unsigned i = 0; i < numWays; i++) {
-        if (!table[index][i].valid) {
-            return i; // Use invalid entry if available
-        }
-        if (table[index][i].lruCounter > maxLRU) {
-            maxLRU = table[index][i].lruCounter;
-            victim = i;
-        }
-    }
-    return victim;
-}
-
-template <typename T>
-unsigned
-BTBMGSC::getLRUVictim(std::vector<T> &table)
-{
-    unsigned victim = 0;
-    unsigned maxLRU = 0;
-
-    // Find the entry with the highest LRU counter
-    for (unsigned i = 0; i < numWays; i++) {
-        if (!table[i].valid) {
-            return i; // Use invalid entry if available
-        }
-        if (table[i].lruCounter > maxLRU) {
-            maxLRU = table[i].lruCounter;
-            victim = i;
-        }
-    }
-    return victim;
-}
-
 void
 BTBMGSC::commitBranch(const FetchStream &stream, const DynInstPtr &inst)
 {
 }
+#endif
 
 } // namespace btb_pred
 
@@ -1,6 +1,8 @@
 #ifndef __CPU_PRED_BTB_MGSC_HH__
 #define __CPU_PRED_BTB_MGSC_HH__
 
+#include <array>
+#include <cstdint>
 #include <deque>
 #include <map>
 #include <vector>
@@ -11,11 +13,19 @@
 #include "cpu/inst_seq.hh"
 #include "cpu/pred/btb/folded_hist.hh"
 #include "cpu/pred/btb/stream_struct.hh"
+
+#ifdef UNIT_TEST
+#include "cpu/pred/btb/test/test_dprintf.hh"
+#include "cpu/pred/btb/test/timed_base_pred.hh"
+
+#else
 #include "cpu/pred/btb/timed_base_pred.hh"
 #include "debug/DecoupleBP.hh"
 #include "params/BTBMGSC.hh"
 #include "sim/sim_object.hh"
 
+#endif
+
 namespace gem5
 {
 
@@ -25,58 +35,148 @@ namespace branch_prediction
 namespace btb_pred
 {
 
+#ifdef UNIT_TEST
+using TimedBaseBTBPredictor = test::TimedBaseBTBPredictor;
+#endif
+
 class BTBMGSC : public TimedBaseBTBPredictor
 {
     using defer = std::shared_ptr<void>;
     using bitset = boost::dynamic_bitset<>;
   public:
-    typedef BTBMGSCParams Params;
-
-    // Represents a single entry in the MGSC prediction table
-    struct MgscEntry
+#ifdef UNIT_TEST
+    /** The BTBMGSC parameters of BranchPredictor.py and their defaults. */
+    struct Params
     {
-        public:
-            bool valid;
-            short counter;  // Prediction counter (-32 to 31), 6bits
-            Addr pc;        // branch pc, like branch position, for btb entry pc check
-            unsigned lruCounter;
-
-            MgscEntry() : valid(false), counter(0), pc(0), lruCounter(0) {}
-
-            MgscEntry(bool valid, short counter, Addr pc, unsigned lruCounter) :
-            valid(valid), counter(counter), pc(pc), lruCounter(lruCounter) {}
-            bool taken() const {
-                return counter >= 0;
-            }
+        bool enableMGSC = true;
+        bool needMoreHistories = true;
+        unsigned bwTableNum = 2;
+        std::vector<int> bwHistLen{4, 8};
+        unsigned bwTableIdxWidth = 11;
+        int bwWeightInitValue = 7;
+        unsigned numEntriesFirstLocalHistories = 32;
+        unsigned lTableNum = 2;
+        std::vector<int> lHistLen{4, 8};
+        unsigned lTableIdxWidth = 11;
+        int lWeightInitValue = 7;
+        unsigned iTableNum = 1;
+        std::vector<int> iHistLen{8};
+        unsigned iTableIdxWidth = 11;
+        int iWeightInitValue = 7;
+        unsigned gTableNum = 2;
+        std::vector<int> gHistLen{8, 16};
+        unsigned gTableIdxWidth = 11;
+        int gWeightInitValue = 7;
+        unsigned pTableNum = 2;
+        std::vector<int> pHistLen{8, 16};
+        unsigned pTableIdxWidth = 11;
+        int pWeightInitValue = 7;
+        unsigned biasTableNum = 1;
+        unsigned biasTableIdxWidth = 11;
+        unsigned thresholdTablelogSize = 6;
+        unsigned updateThresholdWidth = 12;
+        unsigned pUpdateThresholdWidth = 8;
+        unsigned extraWeightsWidth = 6;
+        unsigned scCountersWidth = 6;
+        int initialUpdateThresholdValue = 0;
+        unsigned weightTableIdxWidth = 5;
+        unsigned numWays = 8;
+        unsigned numDelay = 3;
+        unsigned blockSize = 32;
     };
+#else
+    typedef BTBMGSCParams Params;
+#endif
+
+    /** Upper bound on the SC tables of all components together. */
+    static constexpr unsigned MaxScTables = 16;
 
-    // Represents a single entry in the MGSC weight table
-    struct MgscWeightEntry
+    /**
+     * Set index of every SC table for one prediction, laid out bw, l, i,
+     * g, p and bias, see the *Lane members for where each one starts.
+     */
+    using IndexLanes = std::array<uint32_t, MaxScTables>;
+
+    /**
+     * A group of set-associative tables stored flat as (table x set x way),
+     * one array per field. A way keeps the 5 pc bits it is tagged with plus
+     * a valid bit, 0 meaning invalid, so a set is matched with plain byte
+     * compares the compiler can vectorize. A tag is only allocated when no
+     * valid way of the set matches it, hence at most one way ever hits.
+     */
+    template <typename Counter>
+    struct FlatTable
     {
-        public:
-            bool valid;
-            Addr pc;           // btb entry pc, same as mgsc entry pc
-            short counter;  // weight counter (-32 to 31), 6bits
-            unsigned lruCounter;
+        unsigned numSets = 0;
+        unsigned numWays = 0;
+        std::vector<uint8_t> tags;
+        std::vector<Counter> counters;
+        std::vector<unsigned> lru;
+
+        void
+        init(unsigned num_tables, unsigned num_sets, unsigned num_ways)
+        {
+            numSets = num_sets;
+            numWays = num_ways;
+            size_t size = (size_t)num_tables * num_sets * num_ways;
+            tags.assign(size, 0);
+            counters.assign(size, 0);
+            lru.assign(size, 0);
+        }
 
-            MgscWeightEntry() : valid(false), pc(0), counter(0), lruCounter(0) {}
+        /** @return The offset of the first way of a set. */
+        size_t
+        setBase(unsigned table, Addr set) const
+        {
+            return ((size_t)table * numSets + set) * numWays;
+        }
 
-            MgscWeightEntry(bool valid, Addr pc, short counter, unsigned lruCounter) :
-                            valid(valid), pc(pc), counter(counter), lruCounter(lruCounter) {}
-    };
+        /** @return The hitting way, or -1. */
+        int
+        find(size_t base, uint8_t tag) const
+        {
+            int hit = -1;
+            for (unsigned way = 0; way < numWays; way++) {
+                hit = tags[base + way] == tag ? (int)way : hit;
+            }
+            return hit;
+        }
 
-    struct MgscThresEntry
-    {
-        public:
-            bool valid;
-            Addr pc;           // btb entry pc, same as mgsc entry pc
-            unsigned counter;         // thres counter (0 to 255), 6bits
-            unsigned lruCounter;
+        /** Age the other valid ways of the set, make way the youngest. */
+        void
+        touch(size_t base, unsigned way)
+        {
+            for (unsigned i = 0; i < numWays; i++) {
+                lru[base + i] += (i != way && tags[base + i]);
+            }
+            lru[base + way] = 0;
+        }
 
-            MgscThresEntry() : valid(false), pc(0), counter(0), lruCounter(0) {}
+        /** @return The first invalid way, else the oldest one. */
+        unsigned
+        victim(size_t base) const
+        {
+            unsigned victim = 0;
+            unsigned max_lru = 0;
+            for (unsigned i = 0; i < numWays; i++) {
+                if (!tags[base + i]) {
+                    return i;
+                }
+                if (lru[base + i] > max_lru) {
+                    max_lru = lru[base + i];
+                    victim = i;
+                }
+            }
+            return victim;
+        }
 
-            MgscThresEntry(bool valid, Addr pc, unsigned counter, unsigned lruCounter) :
-                            valid(valid), pc(pc), counter(counter), lruCounter(lruCounter) {}
+        void
+        fill(size_t base, unsigned way, uint8_t tag, Counter counter)
+        {
+            tags[base + way] = tag;
+            counters[base + way] = counter;
+            lru[base + way] = 0;
+        }
     };
 
     // Contains the complete prediction result
@@ -88,12 +188,8 @@ class BTBMGSC : public TimedBaseBTBPredictor
         bool taken;                     // Final prediction = (use sc pred) ? (total_sum >= 0) : tage prediction
         bool taken_before_sc;           // Tage prediction (before SC)
         unsigned total_thres;           // Combined threshold
-        std::vector<Addr> bwIndex;      // BW table indices
-        std::vector<Addr> lIndex;       // L table indices
-        std::vector<Addr> iIndex;       // I table indices
-        std::vector<Addr> gIndex;       // G table indices
-        std::vector<Addr> pIndex;       // P table indices
-        std::vector<Addr> biasIndex;    // Bias table indices
+        uint8_t tage_info_bits;         // Packed tage info the prediction was made with
+        IndexLanes indices;             // Table indices of all components
         // Weight scale difference flags and percsum values
             bool bw_weight_scale_diff;
             bool l_weight_scale_diff;
@@ -109,26 +205,23 @@ class BTBMGSC : public TimedBaseBTBPredictor
             int bias_percsum;
 
             MgscPrediction() : btb_pc(0), total_sum(0), use_mgsc(false), taken(false),
-                               taken_before_sc(false), total_thres(0), bwIndex(0),
-                               lIndex(0), iIndex(0), gIndex(0), pIndex(0), biasIndex(0), bw_weight_scale_diff(false),
+                               taken_before_sc(false), total_thres(0), tage_info_bits(0),
+                               indices{}, bw_weight_scale_diff(false),
                                l_weight_scale_diff(false), i_weight_scale_diff(false),
                                g_weight_scale_diff(false), p_weight_scale_diff(false), bias_weight_scale_diff(false),
                                bw_percsum(0), l_percsum(0), i_percsum(0), g_percsum(0), p_percsum(0), bias_percsum(0){}
 
             MgscPrediction(Addr btb_pc, int total_sum, bool use_mgsc, bool taken,
                            bool taken_before_sc, unsigned total_thres,
-                           std::vector<Addr> bwIndex, std::vector<Addr> lIndex,
-                           std::vector<Addr> iIndex, std::vector<Addr> gIndex,
-                           std::vector<Addr> pIndex, std::vector<Addr> biasIndex,
+                           uint8_t tage_info_bits, const IndexLanes &indices,
                            bool bw_weight_scale_diff, bool l_weight_scale_diff, bool i_weight_scale_diff,
                            bool g_weight_scale_diff, bool p_weight_scale_diff,
                            bool bias_weight_scale_diff, int bw_percsum,
                            int l_percsum, int i_percsum, int g_percsum, int p_percsum, int bias_percsum) :
                             btb_pc(btb_pc), total_sum(total_sum), use_mgsc(use_mgsc),
                             taken(taken), taken_before_sc(taken_before_sc),
-                            total_thres(total_thres), bwIndex(bwIndex),
-                            lIndex(lIndex), iIndex(iIndex), gIndex(gIndex), pIndex(pIndex),
-                            biasIndex(biasIndex), bw_weight_scale_diff(bw_weight_scale_diff),
+                            total_thres(total_thres), tage_info_bits(tage_info_bits),
+                            indices(indices), bw_weight_scale_diff(bw_weight_scale_diff),
                             l_weight_scale_diff(l_weight_scale_diff), i_weight_scale_diff(i_weight_scale_diff),
                             g_weight_scale_diff(g_weight_scale_diff), p_weight_scale_diff(p_weight_scale_diff),
                             bias_weight_scale_diff(bias_weight_scale_diff),
@@ -167,9 +260,11 @@ class BTBMGSC : public TimedBaseBTBPredictor
     // Update predictor state based on actual branch outcomes
     void update(const FetchStream &entry) override;
 
+#ifndef UNIT_TEST
     void commitBranch(const FetchStream &stream, const DynInstPtr &inst) override;
 
     void setTrace() override;
+#endif
 
     // check folded hists after speculative update and recover
     void checkFoldedHist(const bitset &history, const char *when);
@@ -181,17 +276,17 @@ class BTBMGSC : public TimedBaseBTBPredictor
     /**
      * Calculate percsum from a table for a given PC
      */
-    int calculatePercsum(const std::vector<std::vector<std::vector<MgscEntry>>> &table,
-                         const std::vector<Addr> &tableIndices,
+    int calculatePercsum(const FlatTable<short> &table,
+                         const uint32_t *tableIndices,
                          unsigned numTables,
-                         Addr pc);
+                         uint8_t tag);
 
     /**
      * Find weight in a weight table for a given PC
      */
-    int findWeight(const std::vector<std::vector<MgscWeightEntry>> &weightTable,
+    int findWeight(const FlatTable<short> &weightTable,
                    Addr tableIndex,
-                   Addr pc);
+                   uint8_t tag);
 
     /**
      * Calculate scaled percsum using weight
@@ -201,9 +296,9 @@ class BTBMGSC : public TimedBaseBTBPredictor
     /**
      * Find threshold in a threshold table for a given PC
      */
-    int findThreshold(const std::vector<std::vector<MgscThresEntry>> &thresholdTable,
+    int findThreshold(const FlatTable<unsigned> &thresholdTable,
                       Addr tableIndex,
-                      Addr pc,
+                      uint8_t tag,
                       int defaultValue);
 
     /**
@@ -214,8 +309,8 @@ class BTBMGSC : public TimedBaseBTBPredictor
     /**
      * Update a prediction table and allocate new entry if needed
      */
-    void updateAndAllocatePredTable(std::vector<std::vector<std::vector<MgscEntry>>> &table,
-                                   const std::vector<Addr> &tableIndices,
+    void updateAndAllocatePredTable(FlatTable<short> &table,
+                                   const uint32_t *tableIndices,
                                    unsigned numTables,
                                    Addr pc,
                                    bool actual_taken);
@@ -223,7 +318,7 @@ class BTBMGSC : public TimedBaseBTBPredictor
     /**
      * Update a weight table and allocate new entry if needed
      */
-    void updateAndAllocateWeightTable(std::vector<std::vector<MgscWeightEntry>> &weightTable,
+    void updateAndAllocateWeightTable(FlatTable<short> &weightTable,
                                     Addr tableIndex,
                                     Addr pc,
                                     bool weight_scale_diff,
@@ -337,39 +432,45 @@ class BTBMGSC : public TimedBaseBTBPredictor
     std::vector<FoldedHist> indexGFoldedHist;
     std::vector<FoldedHist> indexPFoldedHist;
 
-    // The actual MGSC prediction tables (table x index x way)
-    std::vector<std::vector<std::vector<MgscEntry>>> bwTable;
-    // The actual MGSC prediction tables (index x way)
-    std::vector<std::vector<MgscWeightEntry>> bwWeightTable;
+    // The actual MGSC prediction tables (table x index x way) and their
+    // weight tables (index x way)
+    FlatTable<short> bwTable;
+    FlatTable<short> bwWeightTable;
 
-    // The actual MGSC prediction tables (table x index x way)
-    std::vector<std::vector<std::vector<MgscEntry>>> lTable;
-    // The actual MGSC prediction tables (index x way)
-    std::vector<std::vector<MgscWeightEntry>> lWeightTable;
+    FlatTable<short> lTable;
+    FlatTable<short> lWeightTable;
 
-    // The actual MGSC prediction tables (table x index x way)
-    std::vector<std::vector<std::vector<MgscEntry>>> iTable;
-    // The actual MGSC prediction tables (index x way)
-    std::vector<std::vector<MgscWeightEntry>> iWeightTable;
+    FlatTable<short> iTable;
+    FlatTable<short> iWeightTable;
 
-    // The actual MGSC prediction tables (table x index x way)
-    std::vector<std::vector<std::vector<MgscEntry>>> gTable;
-    // The actual MGSC prediction tables (index x way)
-    std::vector<std::vector<MgscWeightEntry>> gWeightTable;
+    FlatTable<short> gTable;
+    FlatTable<short> gWeightTable;
 
-    // The actual MGSC prediction tables (table x index x way)
-    std::vector<std::vector<std::vector<MgscEntry>>> pTable;
-    // The actual MGSC prediction tables (index x way)
-    std::vector<std::vector<MgscWeightEntry>> pWeightTable;
+    FlatTable<short> pTable;
+    FlatTable<short> pWeightTable;
 
-    // The actual MGSC prediction tables (table x index x way)
-    std::vector<std::vector<std::vector<MgscEntry>>> biasTable;
-    // The actual MGSC prediction tables (index x way)
-    std::vector<std::vector<MgscWeightEntry>> biasWeightTable;
+    FlatTable<short> biasTable;
+    FlatTable<short> biasWeightTable;
 
     // thres table
-    std::vector<std::vector<MgscThresEntry>> pUpdateThreshold;  // pc-indexed threshold table
-    std::vector<MgscThresEntry> updateThreshold;  // global threshold table
+    FlatTable<unsigned> pUpdateThreshold;  // pc-indexed threshold table
+    FlatTable<unsigned> updateThreshold;  // global threshold table, a single set
+
+    // Where each component starts in IndexLanes
+    unsigned bwLane;
+    unsigned lLane;
+    unsigned iLane;
+    unsigned gLane;
+    unsigned pLane;
+    unsigned biasLane;
+
+    // Where each component starts in MgscMeta::foldedHist
+    unsigned bwHistBase;
+    unsigned lHistBase;
+    unsigned iHistBase;
+    unsigned gHistBase;
+    unsigned pHistBase;
+    unsigned numFoldedHists;
 
 
     // Debug flag
@@ -392,15 +493,26 @@ class BTBMGSC : public TimedBaseBTBPredictor
     bool satDecrement(int min, short &counter);
     bool satDecrement(int min, unsigned &counter);
 
-    // Cache for MGSC indices
-    std::vector<Addr> bwIndex;
-    std::vector<Addr> lIndex;
-    std::vector<Addr> iIndex;
-    std::vector<Addr> gIndex;
-    std::vector<Addr> pIndex;
-    std::vector<Addr> biasIndex;
+    // Indices of the stream being predicted, computed once per
+    // putPCHistory; only the bias lanes differ between its branches
+    IndexLanes lookupLanes;
+    Addr lookupWeightIdx;
+    Addr lookupThresIdx;
+    Addr lookupBiasBase;
 
     // Statistics for MGSC predictor
+#ifdef UNIT_TEST
+    struct MgscStats {
+        uint64_t scCorrectTageWrong = 0;
+        uint64_t scWrongTageCorrect = 0;
+        uint64_t scCorrectTageCorrect = 0;
+        uint64_t scWrongTageWrong = 0;
+        uint64_t scUsed = 0;
+        uint64_t scNotUsed = 0;
+
+        MgscStats(TimedBaseBTBPredictor *parent) {}
+    } ;
+#else
     struct MgscStats : public statistics::Group {
         statistics::Scalar scCorrectTageWrong;
         statistics::Scalar scWrongTageCorrect;
@@ -411,10 +523,13 @@ class BTBMGSC : public TimedBaseBTBPredictor
 
         MgscStats(statistics::Group* parent);
     } ;
+#endif
 
     MgscStats mgscStats;
 
+#ifndef UNIT_TEST
     TraceManager *mgscMissTrace;
+#endif
 
 public:
 
@@ -430,30 +545,26 @@ private:
     // Metadata for MGSC predictions
     typedef struct MgscMeta {
         std::unordered_map<Addr, MgscPrediction> preds;
-        std::vector<FoldedHist> indexBwFoldedHist;
-        std::vector<std::vector<FoldedHist>> indexLFoldedHist;
-        std::vector<FoldedHist> indexIFoldedHist;
-        std::vector<FoldedHist> indexGFoldedHist;
-        std::vector<FoldedHist> indexPFoldedHist;
-        MgscMeta(std::unordered_map<Addr, MgscPrediction> preds, std::vector<FoldedHist> indexBwFoldedHist,
-                 std::vector<std::vector<FoldedHist>> indexLFoldedHist, std::vector<FoldedHist> indexIFoldedHist,
-                 std::vector<FoldedHist> indexGFoldedHist, std::vector<FoldedHist> indexPFoldedHist) :
-            preds(preds), indexBwFoldedHist(indexBwFoldedHist), indexLFoldedHist(indexLFoldedHist),
-            indexIFoldedHist(indexIFoldedHist), indexGFoldedHist(indexGFoldedHist), indexPFoldedHist(indexPFoldedHist) {}
-        MgscMeta() {}
-        MgscMeta(const MgscMeta &other) {
-            preds = other.preds;
-            indexBwFoldedHist = other.indexBwFoldedHist;
-            indexLFoldedHist = other.indexLFoldedHist;
-            indexIFoldedHist = other.indexIFoldedHist;
-            indexGFoldedHist = other.indexGFoldedHist;
-            indexPFoldedHist = other.indexPFoldedHist;
-        }
+        // Folded history bits at prediction time, see the *HistBase members
+        std::vector<uint64_t> foldedHist;
     } MgscMeta;
 
 private:
+    // Tag a branch is kept under: 5 pc bits plus the valid bit
+    uint8_t pcTag(Addr pc) const {
+        return 0x20 | ((pc >> instShiftAmt) & 0x1f);
+    }
+
+    static uint8_t packTageInfo(const TageInfoForMGSC &tage_info) {
+        return tage_info.tage_pred_taken | tage_info.tage_pred_conf_high << 1 |
+               tage_info.tage_pred_conf_mid << 2 | tage_info.tage_pred_conf_low << 3 |
+               tage_info.tage_pred_alt_diff << 4;
+    }
+
+    // Compute the lookup* indices of a stream from the current histories
+    void computeLookupIndices(Addr startPC);
+
     // Helper method to generate prediction for a single BTB entry
-    bool tagMatch(Addr pc_a, Addr pc_b, unsigned matchBits);
     MgscPrediction generateSinglePrediction(const BTBEntry &btb_entry,
                                            const Addr &startPC,
                                            const TageInfoForMGSC &tage_info);
@@ -465,18 +576,6 @@ private:
                                           bool actual_taken,
                                           const MgscPrediction &pred,
                                           const FetchStream &stream);
-    template <typename T>
-    void updateLRU(std::vector<std::vector<T>> &table, Addr index, unsigned way);
-
-    template <typename T>
-    void updateLRU(std::vector<T> &table, unsigned way);
-
-    template <typename T>
-    unsigned getLRUVictim(std::vector<std::vector<T>> &table, Addr index);
-
-    template <typename T>
-    unsigned getLRUVictim(std::vector<T> &table);
-
     std::shared_ptr<MgscMeta> meta;
 };
 }
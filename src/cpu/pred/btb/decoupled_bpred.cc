@@ -118,6 +118,16 @@ DecoupledBPUWithBTB::DecoupledBPUWithBTB(const DecoupledBPUWithBTBParams &p)
     registerExitCallback([this]() {
         this->dumpStats();
     });
+
+    if (!p.branchTraceFile.empty()) {
+        branchTraceStream = simout.create(p.branchTraceFile, true);
+        branchTraceWriter = std::make_unique<BranchTraceWriter>(
+            *branchTraceStream->stream());
+        registerExitCallback([this]() {
+            branchTraceWriter.reset();
+            simout.close(branchTraceStream);
+        });
+    }
 }
 
 void
@@ -1322,6 +1332,22 @@ DecoupledBPUWithBTB::commitBranch(const DynInstPtr &inst, bool mispred)
     BranchInfo info(branchAddr, targetAddr, inst->staticInst, fallThruPC-branchAddr);
     bool taken = rv_pc.branching() || inst->isUncondCtrl();
 
+    if (branchTraceWriter) {
+        BranchTraceRecord rec;
+        rec.pc = branchAddr;
+        rec.target = targetAddr;
+        // Called before notifyInstCommit counts this instruction
+        rec.instDelta = numInstCommitted + 1 - lastTracedInstNum;
+        lastTracedInstNum = numInstCommitted + 1;
+        rec.size = info.size;
+        rec.flags = (info.isCond ? BranchTraceRecord::Cond : 0) |
+            (info.isIndirect ? BranchTraceRecord::Indirect : 0) |
+            (info.isCall ? BranchTraceRecord::Call : 0) |
+            (info.isReturn ? BranchTraceRecord::Return : 0) |
+            (taken ? BranchTraceRecord::Taken : 0);
+        branchTraceWriter->append(rec);
+    }
+
     // ---------- Process misprediction and update statistics ----------
     processMisprediction(entry, branchAddr, info, taken, mispred);
 
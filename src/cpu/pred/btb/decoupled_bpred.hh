@@ -2,6 +2,7 @@
 #define __CPU_PRED_BTB_DECOUPLED_BPRED_HH__
 
 #include <array>
+#include <memory>
 #include <queue>
 #include <stack>
 #include <utility>
@@ -12,6 +13,7 @@
 #include "cpu/o3/cpu_def.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/pred/bpred_unit.hh"
+#include "cpu/pred/btb/branch_trace.hh"
 #include "cpu/pred/btb/btb.hh"
 #include "cpu/pred/btb/btb_ittage.hh"
 #include "cpu/pred/btb/btb_tage.hh"
@@ -44,6 +46,8 @@
 namespace gem5
 {
 
+class OutputStream;
+
 namespace branch_prediction
 {
 
@@ -128,6 +132,11 @@ class DecoupledBPUWithBTB : public BPredUnit
     }
     DataBase bpdb;
     TraceManager *bptrace;
+    /** Committed control-flow trace for offline replay, if enabled. */
+    OutputStream *branchTraceStream{nullptr};
+    std::unique_ptr<BranchTraceWriter> branchTraceWriter;
+    /** Value of numInstCommitted at the last recorded branch. */
+    int lastTracedInstNum{0};
     TraceManager *predTraceManager;  // Trace manager for prediction-time events
     TraceManager *ftqTraceManager;   // Trace manager for fetch target queue entries
     TraceManager *lptrace;
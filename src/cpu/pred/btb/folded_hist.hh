@@ -85,6 +85,12 @@ class FoldedHist
      */
     void recover(FoldedHist &other);
 
+    /**
+     * Recover the folded history from bits saved with get()
+     * @param saved The folded history bits
+     */
+    void recover(uint64_t saved) { folded = saved; }
+
     /**
      * Verify that the folded history is consistent with the global history
      * @param ghr Global history register to check against
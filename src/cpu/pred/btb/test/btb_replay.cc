@@ -0,0 +1,536 @@
+/**
+ * Replays a branch trace recorded by DecoupledBPUWithBTB (branchTraceFile)
+ * through the CPU-free uBTB, BTB, TAGE, ITTAGE and MGSC models of this
+ * directory plus a return stack, and reports MPKI overall and per branch.
+ *
+ * Prediction follows the fetch-stream flow of DecoupledBPUWithBTB: every
+ * component fills the stage predictions of one fetch block, the last stage
+ * with BTB entries wins, and earlier stages that disagree cost override
+ * bubbles. The global, path, backward, IMLI and local histories are kept
+ * and recovered as updateHistoryForPrediction() and
+ * recoverHistoryForSquash() do. Unlike the timing model, each stream
+ * updates the predictors as soon as it is resolved, and no wrong-path
+ * blocks are predicted.
+ *
+ * Usage: btb_replay [options] <trace[.gz]>
+ */
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "cpu/pred/btb/branch_trace.hh"
+#include "cpu/pred/btb/btb_ittage.hh"
+#include "cpu/pred/btb/btb_mgsc.hh"
+#include "cpu/pred/btb/stream_struct.hh"
+#include "cpu/pred/btb/test/btb_tage.hh"
+#include "cpu/pred/btb/test/mockbtb.hh"
+#include "zfstream.h"
+
+using namespace gem5;
+using namespace gem5::branch_prediction::btb_pred;
+
+namespace
+{
+
+struct Config
+{
+    unsigned ubtbEntries = 32;
+    unsigned ubtbWays = 32;
+    unsigned btbEntries = 2048;
+    unsigned btbWays = 8;
+    unsigned btbTagBits = 20;
+    unsigned tageTables = 4;
+    unsigned tageWays = 2;
+    unsigned tageTableSize = 1024;
+    BTBITTAGE::Params ittage;
+    BTBMGSC::Params mgsc;
+    /** MGSC predicts from stage 3, as in DecoupledBPUWithBTB. */
+    unsigned numStages = 4;
+    /** Fixed by the 32-byte half-aligned blocks of the BTB models. */
+    unsigned predictWidth = 64;
+    unsigned historyBits = 128;
+    unsigned rasDepth = 32;
+    unsigned top = 20;
+    uint64_t maxInsts = 0;
+};
+
+struct BranchStats
+{
+    uint8_t flags = 0;
+    uint64_t execs = 0;
+    uint64_t mispreds = 0;
+};
+
+class Replayer
+{
+  public:
+    explicit Replayer(const Config &cfg);
+
+    void run(BranchTraceReader &reader);
+    void report(std::ostream &os) const;
+
+  private:
+    /** Make sure at least n records are buffered. */
+    bool fill(size_t n);
+
+    void predict(Addr start_pc);
+    void resolveStream(Addr start_pc);
+    void recoverHist(FetchStream &stream, Addr squash_pc, bool is_cond,
+                     bool taken, Addr redirect_pc);
+
+    void
+    histShiftIn(int shamt, bool taken, boost::dynamic_bitset<> &hist)
+    {
+        if (shamt == 0)
+            return;
+        hist <<= shamt;
+        hist[0] = taken;
+    }
+
+    /** Same as DecoupledBPUWithBTB::pHistShiftIn(). */
+    void
+    pHistShiftIn(bool taken, boost::dynamic_bitset<> &hist, Addr pc)
+    {
+        if (!taken)
+            return;
+        hist <<= 2;
+        hist[0] = ((pc >> 1) ^ (pc >> 3) ^ (pc >> 5) ^ (pc >> 7)) & 1;
+        hist[1] = (((pc >> 1) ^ (pc >> 3) ^ (pc >> 5) ^ (pc >> 7)) & 2) >> 1;
+    }
+
+    boost::dynamic_bitset<> &
+    localHist(Addr start_pc)
+    {
+        return lhistory[mgsc->getPcIndex(start_pc,
+            log2(mgsc->getNumEntriesFirstLocalHistories()))];
+    }
+
+    const Config cfg;
+    BranchTraceReader *reader = nullptr;
+    std::deque<BranchTraceRecord> pending;
+
+    std::unique_ptr<test::DefaultBTB> ubtb;
+    std::unique_ptr<test::DefaultBTB> btb;
+    std::unique_ptr<test::BTBTAGE> tage;
+    std::unique_ptr<BTBITTAGE> ittage;
+    std::unique_ptr<BTBMGSC> mgsc;
+    std::vector<test::TimedBaseBTBPredictor *> components;
+
+    std::vector<FullBTBPrediction> stagePreds;
+    FullBTBPrediction finalPred;
+    boost::dynamic_bitset<> history;
+    boost::dynamic_bitset<> phistory;
+    boost::dynamic_bitset<> bwhistory;
+    boost::dynamic_bitset<> ihistory;
+    std::vector<boost::dynamic_bitset<>> lhistory;
+    std::vector<Addr> ras;
+
+    uint64_t insts = 0;
+    uint64_t streams = 0;
+    uint64_t mispreds = 0;
+    uint64_t falseHits = 0;
+    uint64_t resyncs = 0;
+    uint64_t overrideBubbles = 0;
+    std::unordered_map<Addr, BranchStats> branches;
+};
+
+Replayer::Replayer(const Config &_cfg)
+    : cfg(_cfg),
+      ubtb(new test::DefaultBTB(cfg.ubtbEntries, 38, cfg.ubtbWays, 0, true)),
+      btb(new test::DefaultBTB(cfg.btbEntries, cfg.btbTagBits, cfg.btbWays,
+                               1, true)),
+      tage(new test::BTBTAGE(cfg.tageTables, cfg.tageWays,
+                             cfg.tageTableSize)),
+      ittage(new BTBITTAGE(cfg.ittage)),
+      mgsc(new BTBMGSC(cfg.mgsc)),
+      components{ubtb.get(), btb.get(), tage.get(), ittage.get(),
+                 mgsc.get()},
+      stagePreds(cfg.numStages),
+      history(cfg.historyBits, 0),
+      phistory(cfg.historyBits, 0),
+      bwhistory(cfg.historyBits, 0),
+      ihistory(cfg.historyBits, 0),
+      lhistory(mgsc->getNumEntriesFirstLocalHistories(),
+               boost::dynamic_bitset<>(cfg.historyBits, 0))
+{
+    for (size_t i = 0; i < components.size(); i++)
+        components[i]->setComponentIdx(i);
+}
+
+bool
+Replayer::fill(size_t n)
+{
+    BranchTraceRecord rec;
+    while (pending.size() < n && reader->next(rec))
+        pending.push_back(rec);
+    return pending.size() >= n;
+}
+
+void
+Replayer::predict(Addr start_pc)
+{
+    for (unsigned s = 0; s < cfg.numStages; s++) {
+        stagePreds[s] = FullBTBPrediction();
+        stagePreds[s].bbStart = start_pc;
+        stagePreds[s].predSource = s;
+        stagePreds[s].returnTarget = ras.empty() ? 0 : ras.back();
+    }
+    for (auto *c : components)
+        c->putPCHistory(start_pc, history, stagePreds);
+
+    // Same choice as generateFinalPredAndCreateBubbles()
+    unsigned chosen = 0;
+    for (int s = cfg.numStages - 1; s >= 0; s--) {
+        if (!stagePreds[s].btbEntries.empty()) {
+            chosen = s;
+            break;
+        }
+    }
+    finalPred = stagePreds[chosen];
+    unsigned first_hit = 0;
+    while (first_hit < cfg.numStages - 1 &&
+           !stagePreds[first_hit].match(finalPred, cfg.predictWidth).first)
+        first_hit++;
+    overrideBubbles += first_hit;
+    finalPred.predSource = first_hit;
+}
+
+void
+Replayer::recoverHist(FetchStream &stream, Addr squash_pc, bool is_cond,
+                      bool taken, Addr redirect_pc)
+{
+    history = stream.history;
+    phistory = stream.phistory;
+    bwhistory = stream.bwhistory;
+    ihistory = stream.ihistory;
+    lhistory = stream.lhistory;
+    auto [shamt, cond_taken] =
+        stream.getHistInfoDuringSquash(squash_pc, is_cond, taken);
+    auto [bw_shamt, bw_taken] = stream.getBwHistInfoDuringSquash(
+        squash_pc, is_cond, taken, redirect_pc);
+    for (auto *c : components) {
+        c->recoverHist(history, stream, shamt, cond_taken);
+        if (c->needMoreHistories) {
+            c->recoverPHist(phistory, stream, shamt, cond_taken);
+            c->recoverBwHist(bwhistory, stream, bw_shamt, bw_taken);
+            c->recoverIHist(ihistory, stream, bw_shamt, bw_taken);
+            c->recoverLHist(lhistory, stream, shamt, cond_taken);
+        }
+    }
+    histShiftIn(shamt, cond_taken, history);
+    pHistShiftIn(cond_taken, phistory, squash_pc);
+    histShiftIn(bw_shamt, bw_taken, bwhistory);
+    histShiftIn(bw_shamt, bw_taken, ihistory);
+    histShiftIn(shamt, cond_taken, localHist(stream.startPC));
+}
+
+void
+Replayer::resolveStream(Addr start_pc)
+{
+    FetchStream stream;
+    stream.startPC = start_pc;
+    stream.history = history;
+    stream.phistory = phistory;
+    stream.bwhistory = bwhistory;
+    stream.ihistory = ihistory;
+    stream.lhistory = lhistory;
+    stream.isHit = !finalPred.btbEntries.empty();
+    stream.predBTBEntries = finalPred.btbEntries;
+    stream.predTaken = finalPred.isTaken();
+    stream.predEndPC = finalPred.getFallThrough(cfg.predictWidth);
+    if (stream.predTaken) {
+        stream.predBranchInfo = finalPred.getTakenEntry().getBranchInfo();
+        stream.predBranchInfo.target = finalPred.getTarget(cfg.predictWidth);
+    }
+    for (size_t i = 0; i < components.size(); i++)
+        stream.predMetas[i] = components[i]->getPredictionMeta();
+    stream.setDefaultResolve();
+    stream.resolved = true;
+
+    for (auto *c : components) {
+        c->specUpdateHist(history, finalPred);
+        if (c->needMoreHistories) {
+            c->specUpdatePHist(phistory, finalPred);
+            c->specUpdateBwHist(bwhistory, finalPred);
+            c->specUpdateIHist(ihistory, finalPred);
+            c->specUpdateLHist(lhistory, finalPred);
+        }
+    }
+    auto [shamt, taken] = finalPred.getHistInfo();
+    auto [bw_shamt, bw_taken] = finalPred.getBwHistInfo();
+    Addr p_pc = finalPred.getPHistInfo().first;
+    histShiftIn(shamt, taken, history);
+    pHistShiftIn(taken, phistory, p_pc);
+    histShiftIn(bw_shamt, bw_taken, bwhistory);
+    histShiftIn(bw_shamt, bw_taken, ihistory);
+    histShiftIn(shamt, taken, localHist(finalPred.bbStart));
+
+    const Addr pred_pc = stream.predBranchInfo.pc;
+    const Addr fall_thru = stream.predEndPC;
+    Addr next_pc = fall_thru;
+    bool ended = false;
+
+    while (!ended && fill(1)) {
+        const BranchTraceRecord rec = pending.front();
+        if (rec.pc < start_pc) {
+            // Control flow left without a committed branch, e.g. a trap
+            resyncs++;
+            next_pc = rec.pc;
+            stream.exeTaken = false;
+            stream.exeBranchInfo = BranchInfo();
+            break;
+        }
+        if (stream.predTaken && pred_pc < std::min<Addr>(rec.pc, fall_thru)) {
+            // Predicted a taken branch where none was committed
+            falseHits++;
+            mispreds++;
+            stream.squashType = SQUASH_OTHER;
+            stream.squashPC = pred_pc;
+            stream.exeTaken = false;
+            stream.exeBranchInfo = BranchInfo();
+            next_pc = pred_pc + stream.predBranchInfo.size;
+            recoverHist(stream, pred_pc, false, false, next_pc);
+            break;
+        }
+        if (rec.pc >= fall_thru) {
+            stream.exeTaken = false;
+            stream.exeBranchInfo = BranchInfo();
+            break;
+        }
+
+        pending.pop_front();
+        insts += rec.instDelta;
+
+        BranchInfo info;
+        info.pc = rec.pc;
+        info.target = rec.target;
+        info.size = rec.size;
+        info.isCond = rec.is(BranchTraceRecord::Cond);
+        info.isIndirect = rec.is(BranchTraceRecord::Indirect);
+        info.isCall = rec.is(BranchTraceRecord::Call);
+        info.isReturn = rec.is(BranchTraceRecord::Return);
+
+        bool pred_taken = stream.predTaken && pred_pc == rec.pc;
+        bool mispred = pred_taken != rec.taken() ||
+            (rec.taken() &&
+             stream.predBranchInfo.target != rec.target);
+
+        auto &bs = branches[rec.pc];
+        bs.flags = rec.flags;
+        bs.execs++;
+
+        if (info.isCall)
+            ras.push_back(rec.pc + rec.size);
+        else if (info.isReturn && !ras.empty())
+            ras.pop_back();
+        if (ras.size() > cfg.rasDepth)
+            ras.erase(ras.begin());
+
+        if (mispred) {
+            bs.mispreds++;
+            mispreds++;
+            stream.squashType = SQUASH_CTRL;
+            stream.squashPC = rec.pc;
+            stream.exeTaken = rec.taken();
+            stream.exeBranchInfo = info;
+            next_pc = rec.taken() ? rec.target : rec.pc + rec.size;
+            recoverHist(stream, rec.pc, info.isCond, rec.taken(), next_pc);
+            ended = true;
+        } else if (rec.taken()) {
+            stream.exeTaken = true;
+            stream.exeBranchInfo = info;
+            next_pc = rec.target;
+            ended = true;
+        }
+    }
+
+    if (stream.isHit || stream.exeTaken) {
+        stream.setUpdateInstEndPC(cfg.predictWidth);
+        stream.setUpdateBTBEntries();
+        btb->getAndSetNewBTBEntry(stream);
+        for (auto *c : components)
+            c->update(stream);
+    }
+    streams++;
+
+    if (fill(1))
+        predict(next_pc);
+}
+
+void
+Replayer::run(BranchTraceReader &_reader)
+{
+    reader = &_reader;
+    if (!fill(1))
+        return;
+    // The trace holds no block starts; begin at the first branch.
+    Addr start_pc = pending.front().pc;
+    predict(start_pc);
+    while (!pending.empty()) {
+        resolveStream(start_pc);
+        start_pc = finalPred.bbStart;
+        if (cfg.maxInsts && insts >= cfg.maxInsts)
+            break;
+    }
+}
+
+void
+Replayer::report(std::ostream &os) const
+{
+    auto mpki = [this](uint64_t n) {
+        return insts ? 1000.0 * n / insts : 0.0;
+    };
+    ccprintf(os, "insts %d\nstreams %d\nmispredicts %d\nMPKI %.4f\n",
+             insts, streams, mispreds, mpki(mispreds));
+    ccprintf(os, "falseHits %d\nresyncs %d\noverrideBubbles %d\n",
+             falseHits, resyncs, overrideBubbles);
+
+    std::vector<std::pair<Addr, BranchStats>> sorted(branches.begin(),
+                                                      branches.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+        return a.second.mispreds != b.second.mispreds ?
+            a.second.mispreds > b.second.mispreds : a.first < b.first;
+    });
+    if (sorted.size() > cfg.top)
+        sorted.resize(cfg.top);
+
+    ccprintf(os, "\n%-18s %-6s %12s %12s %10s\n", "pc", "type", "execs",
+             "mispreds", "MPKI");
+    for (const auto &[pc, bs] : sorted) {
+        const char *type = bs.flags & BranchTraceRecord::Cond ? "cond" :
+            bs.flags & BranchTraceRecord::Return ? "ret" :
+            bs.flags & BranchTraceRecord::Call ? "call" :
+            bs.flags & BranchTraceRecord::Indirect ? "ind" : "jump";
+        ccprintf(os, "%#-18x %-6s %12d %12d %10.4f\n", pc, type, bs.execs,
+                 bs.mispreds, mpki(bs.mispreds));
+    }
+}
+
+void
+usage(const char *prog)
+{
+    ccprintf(std::cerr,
+        "Usage: %s [options] <trace[.gz]>\n"
+        "  --ubtb-entries N    uBTB entries (32)\n"
+        "  --ubtb-ways N       uBTB ways (32)\n"
+        "  --btb-entries N     main BTB entries (2048)\n"
+        "  --btb-ways N        main BTB ways (8)\n"
+        "  --btb-tag-bits N    main BTB tag bits (20)\n"
+        "  --tage-tables N     TAGE tables, at most 4 (4)\n"
+        "  --tage-ways N       TAGE ways (2)\n"
+        "  --tage-size N       entries per TAGE table (1024)\n"
+        "  --ittage-tables N   ITTAGE tables, at most 5 (5)\n"
+        "  --ittage-size N     entries per ITTAGE table (256, 256, 512...)\n"
+        "  --no-mgsc           keep the TAGE direction, as enableMGSC=False\n"
+        "  --mgsc-idx-width N  log2 sets of each MGSC table (11)\n"
+        "  --mgsc-ways N       MGSC ways (8)\n"
+        "  --mgsc-local N      MGSC local histories, a power of 2 (32)\n"
+        "  --stages N          prediction stages, at least 4 (4)\n"
+        "  --ras-depth N       return stack depth (32)\n"
+        "  --max-insts N       stop after N instructions\n"
+        "  --top N             branches listed (20)\n", prog);
+    std::exit(1);
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char *argv[])
+{
+    static const option opts[] = {
+        {"ubtb-entries", required_argument, nullptr, 'u'},
+        {"ubtb-ways", required_argument, nullptr, 'U'},
+        {"btb-entries", required_argument, nullptr, 'b'},
+        {"btb-ways", required_argument, nullptr, 'B'},
+        {"btb-tag-bits", required_argument, nullptr, 'g'},
+        {"tage-tables", required_argument, nullptr, 't'},
+        {"tage-ways", required_argument, nullptr, 'T'},
+        {"tage-size", required_argument, nullptr, 's'},
+        {"ittage-tables", required_argument, nullptr, 'i'},
+        {"ittage-size", required_argument, nullptr, 'I'},
+        {"no-mgsc", no_argument, nullptr, 'M'},
+        {"mgsc-idx-width", required_argument, nullptr, 'x'},
+        {"mgsc-ways", required_argument, nullptr, 'w'},
+        {"mgsc-local", required_argument, nullptr, 'l'},
+        {"stages", required_argument, nullptr, 'S'},
+        {"ras-depth", required_argument, nullptr, 'r'},
+        {"max-insts", required_argument, nullptr, 'm'},
+        {"top", required_argument, nullptr, 'n'},
+        {nullptr, 0, nullptr, 0},
+    };
+
+    Config cfg;
+    int c;
+    while ((c = getopt_long(argc, argv, "", opts, nullptr)) != -1) {
+        unsigned long v = optarg ? std::strtoul(optarg, nullptr, 0) : 0;
+        switch (c) {
+          case 'u': cfg.ubtbEntries = v; break;
+          case 'U': cfg.ubtbWays = v; break;
+          case 'b': cfg.btbEntries = v; break;
+          case 'B': cfg.btbWays = v; break;
+          case 'g': cfg.btbTagBits = v; break;
+          case 't': cfg.tageTables = v; break;
+          case 'T': cfg.tageWays = v; break;
+          case 's': cfg.tageTableSize = v; break;
+          case 'i': cfg.ittage.numPredictors = v; break;
+          case 'I':
+            cfg.ittage.tableSizes.assign(cfg.ittage.tableSizes.size(), v);
+            break;
+          case 'M': cfg.mgsc.enableMGSC = false; break;
+          case 'x':
+            cfg.mgsc.bwTableIdxWidth = cfg.mgsc.lTableIdxWidth =
+                cfg.mgsc.iTableIdxWidth = cfg.mgsc.gTableIdxWidth =
+                cfg.mgsc.pTableIdxWidth = cfg.mgsc.biasTableIdxWidth = v;
+            break;
+          case 'w': cfg.mgsc.numWays = v; break;
+          case 'l': cfg.mgsc.numEntriesFirstLocalHistories = v; break;
+          case 'S': cfg.numStages = v; break;
+          case 'r': cfg.rasDepth = v; break;
+          case 'm': cfg.maxInsts = v; break;
+          case 'n': cfg.top = v; break;
+          default: usage(argv[0]);
+        }
+    }
+    if (optind + 1 != argc)
+        usage(argv[0]);
+
+    fatal_if(cfg.tageTables == 0 || cfg.tageTables > 4,
+             "The TAGE model has history lengths for 1 to 4 tables.\n");
+    fatal_if(cfg.ittage.numPredictors == 0 ||
+             cfg.ittage.numPredictors > cfg.ittage.histLengths.size(),
+             "The ITTAGE model has history lengths for 1 to %d tables.\n",
+             cfg.ittage.histLengths.size());
+    fatal_if(cfg.mgsc.numWays == 0, "MGSC needs at least one way.\n");
+    fatal_if((int)cfg.mgsc.iTableIdxWidth < cfg.mgsc.iHistLen[0],
+             "The MGSC IMLI table needs at least %d index bits.\n",
+             cfg.mgsc.iHistLen[0]);
+    fatal_if(cfg.mgsc.numEntriesFirstLocalHistories == 0 ||
+             !isPowerOf2(cfg.mgsc.numEntriesFirstLocalHistories),
+             "MGSC local histories must be a power of 2.\n");
+    fatal_if(cfg.numStages < 4,
+             "MGSC predicts at stage 3, need at least 4 stages.\n");
+
+    // gzifstream also reads uncompressed files.
+    gzifstream in(argv[optind]);
+    fatal_if(!in.is_open(), "Cannot open %s.\n", argv[optind]);
+    BranchTraceReader reader(in);
+
+    Replayer replayer(cfg);
+    replayer.run(reader);
+    replayer.report(std::cout);
+    return 0;
+}
@@ -186,7 +186,7 @@ BTBTAGE::generateSinglePrediction(const BTBEntry &btb_entry,
     DPRINTF(TAGE, "tage use_alt %d ? (alt_provided %d ? alt_taken %d : base_taken %d) : main_taken %d\n",
         use_alt, alt_provided, alt_taken, base_taken, main_taken);
 
-    return TagePrediction(btb_entry.pc, main_info, alt_info, use_alt, taken);
+    return TagePrediction(btb_entry.pc, main_info, alt_info, use_alt, taken, alt_pred);
 }
 
 /**
@@ -246,7 +246,19 @@ BTBTAGE::putPCHistory(Addr stream_start, const bitset &history, std::vector<Full
         // TODO: only lookup once for one btb entry in different stages
         auto &stage_pred = stagePreds[s];
         auto cond_takens = lookupHelper(stream_start, stage_pred.btbEntries);
-        stage_pred.condTakens = cond_takens;
+        stage_pred.condTakens.assign(cond_takens.begin(), cond_takens.end());
+        // confidence of each prediction, consumed by MGSC
+        for (auto &[pc, pred] : meta.preds) {
+            auto &info = stage_pred.tageInfoForMgscs[pc];
+            int ctr = pred.mainInfo.entry.counter * 2 + 1;
+            info.tage_pred_taken = pred.taken;
+            info.tage_pred_conf_high = pred.mainInfo.found && abs(ctr) == 7;
+            info.tage_pred_conf_mid = pred.mainInfo.found &&
+                                      abs(ctr) < 7 && abs(ctr) > 1;
+            info.tage_pred_conf_low = !pred.mainInfo.found || abs(ctr) <= 1;
+            info.tage_pred_alt_diff = pred.mainInfo.found &&
+                                      pred.mainInfo.taken() != pred.altPred;
+        }
     }
 
 }
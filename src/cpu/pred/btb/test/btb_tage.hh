@@ -87,13 +87,14 @@ class BTBTAGE : public TimedBaseBTBPredictor
             TageTableInfo altInfo;  // Alternative prediction info
             bool useAlt;           // Whether to use alternative prediction, true if main is weak or no main prediction
             bool taken;            // Final prediction (taken/not taken) = use_alt ? alt_provided ? alt_taken : base_taken : main_taken
+            bool altPred;          // Alternative prediction = alt_provided ? alt_taken : base_taken;
 
-            TagePrediction() : btb_pc(0), useAlt(false), taken(false) {}
+            TagePrediction() : btb_pc(0), useAlt(false), taken(false), altPred(false) {}
 
             TagePrediction(Addr btb_pc, TageTableInfo mainInfo, TageTableInfo altInfo,
-                            bool useAlt, bool taken) :
+                            bool useAlt, bool taken, bool altPred) :
                             btb_pc(btb_pc), mainInfo(mainInfo), altInfo(altInfo),
-                            useAlt(useAlt), taken(taken) {}
+                            useAlt(useAlt), taken(taken), altPred(altPred) {}
     };
 
     // Structure to hold allocation results
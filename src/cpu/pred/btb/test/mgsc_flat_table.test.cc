@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "cpu/pred/btb/btb_mgsc.hh"
+
+using namespace gem5;
+using namespace gem5::branch_prediction::btb_pred;
+
+namespace
+{
+
+using FlatTable = BTBMGSC::FlatTable<short>;
+
+/** Tag of a pc in a flat table: 5 pc bits above bit 0, plus a valid bit. */
+uint8_t
+pcTag(Addr pc)
+{
+    return 0x20 | ((pc >> 1) & 0x1f);
+}
+
+void
+updateCounter(bool taken, short &counter)
+{
+    // The default 6-bit scCountersWidth
+    if (taken && counter < 31)
+        counter++;
+    else if (!taken && counter > -32)
+        counter--;
+}
+
+/**
+ * MGSC prediction tables as they were before being flattened: a vector of
+ * entry structs per set, matched with tagMatch() on 5 pc bits and the
+ * valid bit, replaced by LRU counter.
+ */
+struct NestedTable
+{
+    struct Entry
+    {
+        bool valid = false;
+        short counter = 0;
+        Addr pc = 0;
+        unsigned lruCounter = 0;
+    };
+
+    unsigned numWays;
+    std::vector<std::vector<std::vector<Entry>>> table;
+
+    NestedTable(unsigned num_tables, unsigned num_sets, unsigned num_ways)
+        : numWays(num_ways),
+          table(num_tables, std::vector<std::vector<Entry>>(num_sets,
+                std::vector<Entry>(num_ways)))
+    {}
+
+    static bool
+    tagMatch(Addr pc_a, Addr pc_b, unsigned match_bits)
+    {
+        Addr mask = (1ULL << match_bits) - 1;
+        return ((pc_a >> 1) & mask) == ((pc_b >> 1) & mask);
+    }
+
+    int
+    percsum(const std::vector<Addr> &indices, Addr pc) const
+    {
+        int sum = 0;
+        for (unsigned i = 0; i < table.size(); ++i) {
+            for (unsigned way = 0; way < numWays; way++) {
+                auto &entry = table[i][indices[i]][way];
+                if (tagMatch(pc, entry.pc, 5) && entry.valid) {
+                    sum += 2 * entry.counter + 1;
+                    break;
+                }
+            }
+        }
+        return sum;
+    }
+
+    void
+    updateLRU(std::vector<std::vector<Entry>> &sets, Addr index,
+              unsigned way)
+    {
+        for (unsigned i = 0; i < numWays; i++) {
+            if (i != way && sets[index][i].valid)
+                sets[index][i].lruCounter++;
+        }
+        sets[index][way].lruCounter = 0;
+    }
+
+    unsigned
+    getLRUVictim(std::vector<std::vector<Entry>> &sets, Addr index)
+    {
+        unsigned victim = 0;
+        unsigned max_lru = 0;
+        for (unsigned i = 0; i < numWays; i++) {
+            if (!sets[index][i].valid)
+                return i;
+            if (sets[index][i].lruCounter > max_lru) {
+                max_lru = sets[index][i].lruCounter;
+                victim = i;
+            }
+        }
+        return victim;
+    }
+
+    void
+    update(const std::vector<Addr> &indices, Addr pc, bool taken)
+    {
+        for (unsigned i = 0; i < table.size(); ++i) {
+            bool found = false;
+            for (unsigned way = 0; way < numWays; way++) {
+                auto &entry = table[i][indices[i]][way];
+                if (tagMatch(pc, entry.pc, 5) && entry.valid) {
+                    updateCounter(taken, entry.counter);
+                    found = true;
+                    updateLRU(table[i], indices[i], way);
+                    break;
+                }
+            }
+            if (!found) {
+                unsigned way = getLRUVictim(table[i], indices[i]);
+                table[i][indices[i]][way] = {true, short(taken ? 0 : -1),
+                                             pc, 0};
+            }
+        }
+    }
+};
+
+void
+expectSameState(const FlatTable &flat, const NestedTable &nested, int step)
+{
+    for (unsigned t = 0; t < nested.table.size(); t++) {
+        for (unsigned s = 0; s < flat.numSets; s++) {
+            size_t base = flat.setBase(t, s);
+            for (unsigned w = 0; w < flat.numWays; w++) {
+                auto &entry = nested.table[t][s][w];
+                ASSERT_EQ(flat.tags[base + w] != 0, entry.valid)
+                    << "step " << step;
+                if (!entry.valid)
+                    continue;
+                ASSERT_EQ(flat.tags[base + w], pcTag(entry.pc));
+                ASSERT_EQ(flat.counters[base + w], entry.counter);
+                ASSERT_EQ(flat.lru[base + w], entry.lruCounter);
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
+TEST(MgscFlatTableTest, FindTouchVictim)
+{
+    FlatTable table;
+    table.init(1, 2, 4);
+    size_t base = table.setBase(0, 1);
+    EXPECT_EQ(base, 4);
+    EXPECT_EQ(table.find(base, pcTag(0x2)), -1);
+    EXPECT_EQ(table.victim(base), 0);
+
+    for (unsigned way = 0; way < 4; way++) {
+        table.fill(base, table.victim(base), pcTag(way * 2), way);
+        table.touch(base, way);
+    }
+    EXPECT_EQ(table.find(base, pcTag(0x4)), 2);
+    // Pcs 64 bytes apart share a tag
+    EXPECT_EQ(table.find(base, pcTag(0x44)), 2);
+
+    // Way 0 was filled first and never touched since
+    EXPECT_EQ(table.victim(base), 0);
+    table.touch(base, 0);
+    EXPECT_EQ(table.victim(base), 1);
+}
+
+/**
+ * Random lookups and updates over a few sets, pcs colliding in their 5 tag
+ * bits: BTBMGSC's percsum and update of the flat tables must give the same
+ * percsums and leave the same valid ways, tags, counters and LRU ages as
+ * the per-way scan.
+ */
+TEST(MgscFlatTableTest, MatchesTagMatchAndLRU)
+{
+    std::mt19937_64 rng(1);
+    for (unsigned num_ways : {1, 2, 8}) {
+        constexpr unsigned numTables = 3;
+        constexpr unsigned numSets = 4;
+        BTBMGSC::Params params;
+        params.numWays = num_ways;
+        BTBMGSC mgsc(params);
+        FlatTable flat;
+        flat.init(numTables, numSets, num_ways);
+        NestedTable nested(numTables, numSets, num_ways);
+
+        std::vector<Addr> pcs;
+        for (int i = 0; i < 24; i++)
+            pcs.push_back(0x80000000 + (rng() % 256) * 2);
+
+        for (int step = 0; step < 20000; step++) {
+            Addr pc = pcs[rng() % pcs.size()];
+            std::vector<Addr> indices;
+            std::vector<uint32_t> flat_indices;
+            for (unsigned t = 0; t < numTables; t++) {
+                indices.push_back(rng() % numSets);
+                flat_indices.push_back(indices.back());
+            }
+
+            ASSERT_EQ(mgsc.calculatePercsum(flat, flat_indices.data(),
+                                            numTables, pcTag(pc)),
+                      nested.percsum(indices, pc)) << "step " << step;
+            if (rng() % 2) {
+                bool taken = rng() % 3;
+                mgsc.updateAndAllocatePredTable(flat, flat_indices.data(),
+                                                numTables, pc, taken);
+                nested.update(indices, pc, taken);
+            }
+            if (step % 100 == 0)
+                expectSameState(flat, nested, step);
+        }
+        expectSameState(flat, nested, -1);
+    }
+}
@@ -160,6 +160,8 @@ DefaultBTB::fillStagePredictions(const std::vector<TickedBTBEntry>& entries,
         
         // Copy BTB entries to stage prediction
         stagePreds[s].btbEntries.clear();
+        stagePreds[s].condTakens.clear();
+        stagePreds[s].indirectTargets.clear();
         for (auto e: entries) {
             stagePreds[s].btbEntries.push_back(BTBEntry(e));
         }
@@ -173,13 +175,13 @@ DefaultBTB::fillStagePredictions(const std::vector<TickedBTBEntry>& entries,
                 // TODO: a performance bug here, mbtb should not update condTakens!
                 // if (isL0()) {  // only L0 BTB has saturating counter
                     // use saturating counter of L0 BTB
-                    stagePreds[s].condTakens[e.pc] = e.alwaysTaken || (e.ctr >= 0);
+                    stagePreds[s].condTakens.push_back({e.pc, e.alwaysTaken || (e.ctr >= 0)});
                 // } else {  // L1 BTB condTakens depends on the TAGE predictor
                 // }
             } else if (e.isIndirect) {
                 // Set predicted target for indirect branches
                 DPRINTF(BTB, "setting indirect target for pc %#lx to %#lx\n", e.pc, e.target);
-                stagePreds[s].indirectTargets[e.pc] = e.target;
+                stagePreds[s].indirectTargets.push_back({e.pc, e.target});
             }
         }
 
@@ -17,9 +17,6 @@
  */ 
 
 // #include "base/logging.hh"
-#include <gmock/gmock.h>
-#include <gtest/gtest.h>
-
 #include <cstdint>
 #include <queue>
 
@@ -28,8 +28,17 @@ class TimedBaseBTBPredictor
 
     TimedBaseBTBPredictor();
 
-    // virtual void tickStart() {}
-    // virtual void tick() {}
+    /** Take blockSize and numDelay from the Params of a predictor. */
+    template <class Params>
+    TimedBaseBTBPredictor(const Params &p)
+        : TimedBaseBTBPredictor()
+    {
+        blockSize = p.blockSize;
+        numDelay = p.numDelay;
+    }
+
+    virtual void tickStart() {}
+    virtual void tick() {}
     // make predictions, record in stage preds
     virtual void putPCHistory(Addr startAddr,
                               const boost::dynamic_bitset<> &history,
@@ -38,12 +47,23 @@ class TimedBaseBTBPredictor
     virtual std::shared_ptr<void> getPredictionMeta() { return nullptr; }
 
     virtual void specUpdateHist(const boost::dynamic_bitset<> &history, FullBTBPrediction &pred) {}
+    virtual void specUpdatePHist(const boost::dynamic_bitset<> &history, FullBTBPrediction &pred) {}
+    virtual void specUpdateBwHist(const boost::dynamic_bitset<> &history, FullBTBPrediction &pred) {}
+    virtual void specUpdateIHist(const boost::dynamic_bitset<> &history, FullBTBPrediction &pred) {}
+    virtual void specUpdateLHist(const std::vector<boost::dynamic_bitset<>> &history, FullBTBPrediction &pred) {}
     virtual void recoverHist(const boost::dynamic_bitset<> &history, const FetchStream &entry, int shamt, bool cond_taken) {}
+    virtual void recoverPHist(const boost::dynamic_bitset<> &history, const FetchStream &entry, int shamt, bool cond_taken) {}
+    virtual void recoverBwHist(const boost::dynamic_bitset<> &history, const FetchStream &entry, int shamt, bool cond_taken) {}
+    virtual void recoverIHist(const boost::dynamic_bitset<> &history, const FetchStream &entry, int shamt, bool cond_taken) {}
+    virtual void recoverLHist(const std::vector<boost::dynamic_bitset<>> &history, const FetchStream &entry, int shamt, bool cond_taken) {}
     virtual void update(const FetchStream &entry) {}
     virtual unsigned getDelay() {return numDelay;}
     // do some statistics on a per-branch and per-predictor basis
     // virtual void commitBranch(const FetchStream &entry, const DynInstPtr &inst) {}
 
+    // whether path, backward, imli and local histories are needed
+    bool needMoreHistories{false};
+
     int componentIdx = 0;
     unsigned aheadPipelinedStages{0};
     int getComponentIdx() { return componentIdx; }
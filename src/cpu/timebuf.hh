@@ -31,11 +31,27 @@
 
 #include <cassert>
 #include <cstring>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace gem5
 {
 
+/**
+ * Slot types with a reset() member are recycled in place when the buffer
+ * advances instead of being destroyed and re-constructed. reset() must
+ * leave the slot equal to a freshly constructed one, but may keep any
+ * storage it owns (e.g. vector capacity).
+ */
+template <class T, class = void>
+struct TimeBufferSlotReset : std::false_type {};
+
+template <class T>
+struct TimeBufferSlotReset<
+    T, std::void_t<decltype(std::declval<T &>().reset())>>
+    : std::true_type {};
+
 template <class T>
 class TimeBuffer
 {
@@ -184,9 +200,13 @@ class TimeBuffer
         int ptr = base + future;
         if (ptr >= (int)size)
             ptr -= size;
-        (reinterpret_cast<T *>(index[ptr]))->~T();
-        std::memset(index[ptr], 0, sizeof(T));
-        new (index[ptr]) T;
+        if constexpr (TimeBufferSlotReset<T>::value) {
+            (reinterpret_cast<T *>(index[ptr]))->reset();
+        } else {
+            (reinterpret_cast<T *>(index[ptr]))->~T();
+            std::memset(index[ptr], 0, sizeof(T));
+            new (index[ptr]) T;
+        }
     }
 
   protected:
@@ -148,6 +148,12 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MiB', "Maximum capacity of snoop filter")
 
+    # Optional set-associative directory model. Lines evicted from it are
+    # counted as back-invalidations; the filter itself stays precise.
+    dir_entries = Param.Unsigned(0, "Entries of the modelled directory "
+                                 "(0 to disable the model)")
+    dir_assoc = Param.Unsigned(8, "Associativity of the modelled directory")
+
 # We use a coherent crossbar to connect multiple requestors to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
@@ -154,6 +154,13 @@ class BaseCache(ClockedObject):
 
     cache_level = Param.Unsigned(0, "Cache level (L1 is 1, L2 is 2, etc.)")
 
+    warm_trace_out = Param.String("",
+        "File in the output directory that records the cache contents at "
+        "the end of warmup, i.e. the first stats reset (empty to disable)")
+    warm_trace_in = Param.String("",
+        "Warm trace whose lines are fetched into the cache at startup "
+        "(empty to disable)")
+
     tag_load_read_ports = Param.Unsigned(3, "Total tag read ports for load/prefetcher(in L1 Cache)")
     slice_num = Param.Int(-1, "slice number (-1 is disable)")
 
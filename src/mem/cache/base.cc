@@ -45,6 +45,9 @@
 
 #include "mem/cache/base.hh"
 
+#include <algorithm>
+#include <fstream>
+
 #include "base/compiler.hh"
 #include "base/logging.hh"
 #include "base/output.hh"
@@ -66,6 +69,7 @@
 #include "mem/cache/queue_entry.hh"
 #include "mem/cache/tags/compressed_tags.hh"
 #include "mem/cache/tags/super_blk.hh"
+#include "mem/cache/warm_trace.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 #include "params/BaseCache.hh"
@@ -78,6 +82,14 @@
 namespace gem5
 {
 
+namespace
+{
+
+/** Deepest cache level that the warm trace replay orders. */
+constexpr unsigned WarmReplayMaxLevel = 8;
+
+} // anonymous namespace
+
 BaseCache::SendTimingRespEvent::SendTimingRespEvent(BaseCache* cache, PacketPtr pkt)
     : Event(Delayed_Writeback_Pri, AutoDelete),
       cache(cache),
@@ -175,6 +187,11 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
       stats(*this),
       cacheLevel(p.cache_level),
       forceHit(p.force_hit),
+      warmTraceOut(p.warm_trace_out),
+      warmTraceIn(p.warm_trace_in),
+      warmReplayEvent([this]{ replayWarmTrace(); }, name() + ".warmReplay",
+                      false, Event::Minimum_Pri + int(WarmReplayMaxLevel -
+                      std::min<unsigned>(p.cache_level, WarmReplayMaxLevel))),
       doFastWriteline(p.do_fast_writeline)
 {
     // the MSHR queue has no reserve entries as we check the MSHR
@@ -237,6 +254,15 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
         });
     }
 
+    if (!warmTraceIn.empty())
+        warmRequestorId = system->getRequestorId(this, "warm_replay");
+
+    if (!warmTraceOut.empty()) {
+        // The first reset after startup ends the warmup, runs without
+        // one record the contents at exit
+        statistics::registerResetCallback([this]() { recordWarmTrace(); });
+        registerExitCallback([this]() { recordWarmTrace(); });
+    }
 }
 
 BaseCache::~BaseCache()
@@ -300,6 +326,95 @@ BaseCache::init()
     forwardSnoops = cpuSidePort.isSnooping();
 }
 
+void
+BaseCache::startup()
+{
+    // simulate() resets the stats once more right after startup
+    warmTraceStartTick = curTick();
+    if (!warmTraceIn.empty())
+        schedule(warmReplayEvent, curTick());
+}
+
+void
+BaseCache::recordWarmTrace()
+{
+    if (warmTraceRecorded || curTick() <= warmTraceStartTick)
+        return;
+    warmTraceRecorded = true;
+
+    struct Line
+    {
+        uint64_t age;
+        WarmRecord rec;
+    };
+    std::vector<Line> lines;
+    tags->forEachBlk([&](CacheBlk &blk) {
+        if (!blk.isValid())
+            return;
+        WarmRecord rec;
+        rec.addr = regenerateBlkAddr(&blk);
+        if (blk.isSecure())
+            rec.flags |= WarmRecord::Secure;
+        if (blk.isSet(CacheBlk::WritableBit))
+            rec.flags |= WarmRecord::Writable;
+        if (blk.isSet(CacheBlk::DirtyBit))
+            rec.flags |= WarmRecord::Dirty;
+        lines.push_back({tags->replacementAge(&blk), rec});
+    });
+
+    // Oldest first. Ties keep the way order, which is also how LRU picks
+    // between lines touched in the same tick.
+    std::stable_sort(lines.begin(), lines.end(),
+                     [](const Line &a, const Line &b) {
+                         return a.age > b.age;
+                     });
+
+    OutputStream *out = simout.create(warmTraceOut, true);
+    WarmTraceWriter writer(*out->stream());
+    for (const auto &line : lines)
+        writer.append(line.rec);
+    simout.close(out);
+
+    inform("%s: recorded %llu lines in warm trace %s at tick %llu\n",
+           name(), writer.numRecords(), warmTraceOut, curTick());
+}
+
+void
+BaseCache::replayWarmTrace()
+{
+    std::ifstream is(warmTraceIn, std::ios::binary);
+    fatal_if(!is, "%s: Cannot open warm trace %s.\n", name(), warmTraceIn);
+    WarmTraceReader reader(is);
+
+    uint64_t num_lines = 0;
+    uint64_t num_dirty = 0;
+    WarmRecord rec;
+    while (reader.next(rec)) {
+        const bool is_secure = rec.is(WarmRecord::Secure);
+        RequestPtr req = std::make_shared<Request>(
+            rec.addr, blkSize, is_secure ? Request::SECURE : 0,
+            warmRequestorId);
+        // A plain read lets the fill come back exclusive when no other
+        // cache holds the line, as it would for the recorded run
+        Packet pkt(req, MemCmd::ReadReq);
+        pkt.allocate();
+        recvAtomic(&pkt);
+        num_lines++;
+
+        // The data matches memory, marking the line dirty only restores
+        // the writeback it would cause on eviction
+        CacheBlk *blk = tags->findBlock(rec.addr, is_secure);
+        if (blk && rec.is(WarmRecord::Dirty) &&
+            blk->isSet(CacheBlk::WritableBit)) {
+            blk->setCoherenceBits(CacheBlk::DirtyBit);
+            num_dirty++;
+        }
+    }
+
+    inform("%s: replayed %llu lines (%llu dirty) from warm trace %s\n",
+           name(), num_lines, num_dirty, warmTraceIn);
+}
+
 Port &
 BaseCache::getPort(const std::string &if_name, PortID idx)
 {
@@ -348,7 +463,7 @@ BaseCache::handleTimingReqHit(PacketPtr pkt, CacheBlk *blk, Tick request_time, b
             // Basically we need to get the MSHR in the same state as if
             // we had missed and just received the response.
             // Request *req2 = new Request(*(pkt->req));
-            RequestPtr req2 = std::make_shared<Request>(*(pkt->req));
+            RequestPtr req2 = makeRequest(*(pkt->req));
             PacketPtr pkt2 = new Packet(req2, pkt->cmd);
             MSHR *mshr = allocateMissBuffer(pkt2, curTick(), true);
             // Mark the MSHR "in service" (even though it's not) to prevent
@@ -708,6 +823,7 @@ BaseCache::recvTimingReq(PacketPtr pkt)
         // TODO: for now there are some bugs in vaddrs
         if (archDBer && pkt->req->hasPC() &&
             (pkt->isRead() || pkt->isWrite())){
+            archDBer->cacheMiss(cacheLevel);
             Addr pc = pkt->req->getPC();
             Addr vaddr = pkt->req->hasVaddr() ? pkt->req->getVaddr() : 0;
             Addr paddr = pkt->req->getPaddr();
@@ -1380,9 +1496,8 @@ BaseCache::updateCompressionData(CacheBlk *&blk, const uint64_t* data,
     // metadata can be updated.
     Cycles compression_lat = Cycles(0);
     Cycles decompression_lat = Cycles(0);
-    const auto comp_data =
-        compressor->compress(data, compression_lat, decompression_lat);
-    std::size_t compression_size = comp_data->getSizeBits();
+    std::size_t compression_size = compressor->compressedSizeBits(data,
+        compression_lat, decompression_lat);
 
     // Get previous compressed size
     CompressionBlk* compression_blk = static_cast<CompressionBlk*>(blk);
@@ -2112,9 +2227,8 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
     // calculate the amount of extra cycles needed to read or write compressed
     // blocks.
     if (compressor && pkt->hasData()) {
-        const auto comp_data = compressor->compress(
+        blk_size_bits = compressor->compressedSizeBits(
             pkt->getConstPtr<uint64_t>(), compression_lat, decompression_lat);
-        blk_size_bits = comp_data->getSizeBits();
     }
 
     // Find replacement victim
@@ -2202,7 +2316,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 
     stats.writebacks[Request::wbRequestorId]++;
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure())
@@ -2246,7 +2360,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 PacketPtr
 BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
 {
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = makeRequest(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure()) {
@@ -2321,7 +2435,7 @@ BaseCache::writebackVisitor(CacheBlk &blk)
     if (blk.isSet(CacheBlk::DirtyBit)) {
         assert(blk.isValid());
 
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = makeRequest(
             regenerateBlkAddr(&blk), blkSize, 0, Request::funcRequestorId);
 
         request->taskId(blk.getTaskId());
@@ -1307,6 +1307,7 @@ class BaseCache : public ClockedObject, CacheAccessor
     ~BaseCache();
 
     void init() override;
+    void startup() override;
 
     Port &getPort(const std::string &if_name,
                   PortID idx=InvalidPortID) override;
@@ -1571,6 +1572,40 @@ class BaseCache : public ClockedObject, CacheAccessor
 
     const bool forceHit;
 
+    /** File in the output directory that gets the warm trace, or empty. */
+    const std::string warmTraceOut;
+
+    /** Warm trace replayed at startup, or empty. */
+    const std::string warmTraceIn;
+
+    /** Stats resets up to this tick happen before the warmup. */
+    Tick warmTraceStartTick = MaxTick;
+
+    bool warmTraceRecorded = false;
+
+    RequestorID warmRequestorId = Request::invldRequestorId;
+
+    /**
+     * Replays the warm trace before the first simulated cycle. Its
+     * priority puts lower levels first, so the accesses of the upper
+     * levels mostly hit and leave the replacement order below intact.
+     */
+    EventFunctionWrapper warmReplayEvent;
+
+    /**
+     * Write the valid lines to warmTraceOut, the lines that would be
+     * evicted first at the front. Only the first call after startup
+     * writes the trace.
+     */
+    void recordWarmTrace();
+
+    /**
+     * Fetch the lines of warmTraceIn with atomic accesses through this
+     * cache, in file order, so the fills go through the coherence
+     * protocol and the snoop filters see them.
+     */
+    void replayWarmTrace();
+
 public:
     /**
      * This cache should allocate a block on a line-sized write miss.
@@ -53,6 +53,11 @@ class BaseCacheCompressor(SimObject):
     decomp_extra_latency = Param.Cycles(1, "Number of extra cycles required "
         "to finish decompression (e.g., due to shifting and packaging).")
 
+    size_fast_path = Param.Bool(True, "Use the size-only compression path, "
+        "when available, to update the tags")
+    validate_size_fast_path = Param.Bool(False, "Cross-check every "
+        "size-only compression against the full encoding")
+
 class BaseDictionaryCompressor(BaseCacheCompressor):
     type = 'BaseDictionaryCompressor'
     abstract = True
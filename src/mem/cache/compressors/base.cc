@@ -89,6 +89,8 @@ Base::Base(const Params &p)
     compExtraLatency(p.comp_extra_latency),
     decompChunksPerCycle(p.decomp_chunks_per_cycle),
     decompExtraLatency(p.decomp_extra_latency),
+    useSizeFastPath(p.size_fast_path),
+    validateSizeFastPath(p.validate_size_fast_path),
     cache(nullptr), stats(*this)
 {
     fatal_if(64 % chunkSizeBits,
@@ -167,12 +169,56 @@ Base::compress(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat)
              "Decompressed line does not match original line.");
     #endif
 
-    // Get compression size. If compressed size is greater than the size
-    // threshold, the compression is seen as unsuccessful
-    std::size_t comp_size_bits = comp_data->getSizeBits();
-    if (comp_size_bits > sizeThreshold * CHAR_BIT) {
+    comp_data->setSizeBits(recordCompression(comp_data->getSizeBits(),
+                                             comp_lat, decomp_lat));
+
+    return comp_data;
+}
+
+std::size_t
+Base::compressedSizeBits(const uint64_t* data, Cycles& comp_lat,
+                         Cycles& decomp_lat)
+{
+    std::size_t size_bits;
+    if (!useSizeFastPath ||
+        !compressSize(data, size_bits, comp_lat, decomp_lat)) {
+        return compress(data, comp_lat, decomp_lat)->getSizeBits();
+    }
+
+    if (validateSizeFastPath) {
+        Cycles full_comp_lat;
+        Cycles full_decomp_lat;
+        suppressStats(true);
+        const std::unique_ptr<CompressionData> comp_data =
+            compress(toChunks(data), full_comp_lat, full_decomp_lat);
+        suppressStats(false);
+        panic_if((comp_data->getSizeBits() != size_bits) ||
+                 (full_comp_lat != comp_lat) ||
+                 (full_decomp_lat != decomp_lat),
+                 "%s: size fast path mismatch: %d bits (%d/%d cycles) vs "
+                 "%d bits (%d/%d cycles) from the full encoding\n", name(),
+                 size_bits, comp_lat, decomp_lat, comp_data->getSizeBits(),
+                 full_comp_lat, full_decomp_lat);
+    }
+
+    return recordCompression(size_bits, comp_lat, decomp_lat);
+}
+
+std::size_t
+Base::recordCompression(std::size_t comp_size_bits, Cycles comp_lat,
+                        Cycles decomp_lat)
+{
+    // If compressed size is greater than the size threshold, the
+    // compression is seen as unsuccessful
+    const bool failed = comp_size_bits > sizeThreshold * CHAR_BIT;
+    if (failed) {
         comp_size_bits = blkSize * CHAR_BIT;
-        comp_data->setSizeBits(comp_size_bits);
+    }
+    if (statsSuppressed) {
+        return comp_size_bits;
+    }
+
+    if (failed) {
         stats.failedCompressions++;
     }
 
@@ -190,7 +236,7 @@ Base::compress(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat)
             "Compression latency: %llu, decompression latency: %llu\n",
             blkSize*8, comp_size_bits, comp_lat, decomp_lat);
 
-    return comp_data;
+    return comp_size_bits;
 }
 
 Cycles
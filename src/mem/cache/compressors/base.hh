@@ -36,8 +36,10 @@
 #ifndef __MEM_CACHE_COMPRESSORS_BASE_HH__
 #define __MEM_CACHE_COMPRESSORS_BASE_HH__
 
+#include <climits>
 #include <cstdint>
 
+#include "base/bitfield.hh"
 #include "base/compiler.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
@@ -126,6 +128,24 @@ class Base : public SimObject
      */
     const Cycles decompExtraLatency;
 
+    /**
+     * Whether compressedSizeBits() may use the compressor's size-only fast
+     * path instead of building the full encoding.
+     */
+    const bool useSizeFastPath;
+
+    /**
+     * Cross-check every fast path result against the full encoding. Only
+     * meant for validation, since the full encoding is still built.
+     */
+    const bool validateSizeFastPath;
+
+    /**
+     * Set while validateSizeFastPath re-runs the full encoding, so that the
+     * stats of a line are only counted once.
+     */
+    bool statsSuppressed = false;
+
     /** Pointer to the parent cache. */
     BaseCache* cache;
 
@@ -165,6 +185,31 @@ class Base : public SimObject
      */
     std::vector<Chunk> toChunks(const uint64_t* data) const;
 
+    /** Number of chunks in an uncompressed cache line. */
+    std::size_t
+    numChunks() const
+    {
+        return (blkSize * CHAR_BIT) / chunkSizeBits;
+    }
+
+    /**
+     * Extract a single chunk from the raw data, without building the whole
+     * chunk vector. Equivalent to toChunks(data)[index].
+     *
+     * @param data The raw pointer to the data being compressed.
+     * @param index The index of the chunk.
+     * @return The chunk.
+     */
+    Chunk
+    getChunk(const uint64_t* data, std::size_t index) const
+    {
+        const unsigned num_chunks_per_64 =
+            (sizeof(uint64_t) * CHAR_BIT) / chunkSizeBits;
+        const unsigned start = index % num_chunks_per_64;
+        return bits(data[index / num_chunks_per_64],
+            (start + 1) * chunkSizeBits - 1, start * chunkSizeBits);
+    }
+
     /**
      * This function re-joins the chunks to recreate the original data.
      *
@@ -198,6 +243,36 @@ class Base : public SimObject
     virtual void decompress(const CompressionData* comp_data,
                               uint64_t* cache_line) = 0;
 
+    /**
+     * Size-only counterpart of the chunk-based compress(). It must produce
+     * exactly the same size, latencies and per-compressor stats as the full
+     * encoding, but does not build the compressed data, so that the tags
+     * can be updated without any allocation.
+     *
+     * @param data The cache line to be compressed.
+     * @param size_bits Compressed size, in bits, before the size threshold
+     *        is applied.
+     * @param comp_lat Compression latency in number of cycles.
+     * @param decomp_lat Decompression latency in number of cycles.
+     * @return Whether the compressor implements a fast path.
+     */
+    virtual bool
+    compressSize(const uint64_t* data, std::size_t& size_bits,
+                 Cycles& comp_lat, Cycles& decomp_lat)
+    {
+        return false;
+    }
+
+    /**
+     * Apply the size threshold to a compression result and update the
+     * compression stats.
+     *
+     * @param size_bits Compressed size, in bits.
+     * @return The size after applying the threshold.
+     */
+    std::size_t recordCompression(std::size_t size_bits, Cycles comp_lat,
+                                  Cycles decomp_lat);
+
   public:
     typedef BaseCacheCompressorParams Params;
     Base(const Params &p);
@@ -206,6 +281,12 @@ class Base : public SimObject
     /** The cache can only be set once. */
     virtual void setCache(BaseCache *_cache);
 
+    /**
+     * Make compress() leave the stats untouched, or update them again.
+     * Compressors built on others forward it to them.
+     */
+    virtual void suppressStats(bool suppress) { statsSuppressed = suppress; }
+
     /**
      * Apply the compression process to the cache line. Ignores compression
      * cycles.
@@ -218,6 +299,19 @@ class Base : public SimObject
     std::unique_ptr<CompressionData>
     compress(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat);
 
+    /**
+     * Get the compressed size of the cache line, in bits. Uses the size-only
+     * fast path when the compressor has one, and falls back to the full
+     * encoding otherwise. Updates the same stats as compress().
+     *
+     * @param data The cache line to be compressed.
+     * @param comp_lat Compression latency in number of cycles.
+     * @param decomp_lat Decompression latency in number of cycles.
+     * @return Compressed size, in bits.
+     */
+    std::size_t compressedSizeBits(const uint64_t* data, Cycles& comp_lat,
+                                   Cycles& decomp_lat);
+
     /**
      * Get the decompression latency if the block is compressed. Latency is 0
      * otherwise.
@@ -37,6 +37,8 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "base/bitfield.hh"
 #include "mem/cache/compressors/dictionary_compressor.hh"
@@ -125,6 +127,25 @@ class BaseDelta : public DictionaryCompressor<BaseType>
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
 
+    /**
+     * Check whether a value can be encoded as a delta of the given base.
+     * Same condition as PatternM, without the dictionary entries.
+     */
+    static bool
+    isValidDelta(const BaseType value, const BaseType base)
+    {
+        const typename std::make_signed<BaseType>::type limit =
+            DeltaSizeBits ? mask(DeltaSizeBits - 1) : 0;
+        const typename std::make_signed<BaseType>::type delta = value - base;
+        return (delta >= -limit) && (delta <= limit);
+    }
+
+    /** Bases found by the size-only path; the zero base is the first. */
+    std::vector<BaseType> fastBases;
+
+    bool compressSize(const uint64_t* data, std::size_t& size_bits,
+        Cycles& comp_lat, Cycles& decomp_lat) override;
+
   public:
     typedef BaseDictionaryCompressorParams Params;
     BaseDelta(const Params &p);
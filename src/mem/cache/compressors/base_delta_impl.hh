@@ -48,6 +48,7 @@ template <class BaseType, std::size_t DeltaSizeBits>
 BaseDelta<BaseType, DeltaSizeBits>::BaseDelta(const Params &p)
     : DictionaryCompressor<BaseType>(p)
 {
+    fastBases.resize(this->numChunks() + 1);
 }
 
 template <class BaseType, std::size_t DeltaSizeBits>
@@ -98,6 +99,55 @@ BaseDelta<BaseType, DeltaSizeBits>::compress(
     return comp_data;
 }
 
+template <class BaseType, std::size_t DeltaSizeBits>
+bool
+BaseDelta<BaseType, DeltaSizeBits>::compressSize(const uint64_t* data,
+    std::size_t& size_bits, Cycles& comp_lat, Cycles& decomp_lat)
+{
+    // The parsed values only match the full encoding's when each chunk
+    // holds exactly one base-sized value
+    if (this->chunkSizeBits != 8 * sizeof(BaseType)) {
+        return false;
+    }
+
+    // Replay the dictionary insertions on a flat array of bases: every
+    // value that is not a valid delta of any base becomes a new base
+    const std::size_t num_chunks = this->numChunks();
+    BaseType* const bases = fastBases.data();
+    bases[0] = 0;
+    std::size_t num_bases = 1;
+    for (std::size_t i = 0; i < num_chunks; i++) {
+        const BaseType value = this->getChunk(data, i);
+        bool match = false;
+        for (std::size_t b = 0; b < num_bases; b++) {
+            match |= isValidDelta(value, bases[b]);
+        }
+        if (!match) {
+            bases[num_bases++] = value;
+        }
+    }
+
+    const std::size_t num_uncompressed = num_bases - 1;
+    this->dictionaryStats.patterns[X] += num_uncompressed;
+    this->dictionaryStats.patterns[M] += num_chunks - num_uncompressed;
+
+    this->setLatencies(num_chunks, comp_lat, decomp_lat);
+
+    // Both patterns carry the base bitmask and the delta; uncompressed
+    // values also carry the new base
+    const std::size_t delta_size_bits =
+        std::ceil(std::log2(DEFAULT_MAX_NUM_BASES)) + DeltaSizeBits;
+    const int diff = DEFAULT_MAX_NUM_BASES - num_bases;
+    if (diff < 0) {
+        size_bits = this->blkSize * 8;
+    } else {
+        size_bits = num_chunks * delta_size_bits +
+            8 * sizeof(BaseType) * (num_uncompressed + diff);
+    }
+
+    return true;
+}
+
 } // namespace compression
 } // namespace gem5
 
@@ -252,6 +252,17 @@ class DictionaryCompressor : public BaseDictionaryCompressor
 
     using BaseDictionaryCompressor::compress;
 
+    /**
+     * Set latencies based on the degree of parallelization, and any extra
+     * latencies due to shifting or packaging.
+     *
+     * @param num_chunks Number of chunks being (de)compressed.
+     * @param comp_lat Compression latency in number of cycles.
+     * @param decomp_lat Decompression latency in number of cycles.
+     */
+    void setLatencies(std::size_t num_chunks, Cycles& comp_lat,
+        Cycles& decomp_lat) const;
+
     void decompress(const CompressionData* comp_data, uint64_t* data) override;
 
     /**
@@ -116,7 +116,9 @@ DictionaryCompressor<T>::compressValue(const T data)
     }
 
     // Update stats
-    dictionaryStats.patterns[pattern->getPatternNumber()]++;
+    if (!this->statsSuppressed) {
+        dictionaryStats.patterns[pattern->getPatternNumber()]++;
+    }
 
     // Push into dictionary
     if (pattern->shouldAllocate()) {
@@ -153,15 +155,22 @@ template <class T>
 std::unique_ptr<Base::CompressionData>
 DictionaryCompressor<T>::compress(const std::vector<Chunk>& chunks,
     Cycles& comp_lat, Cycles& decomp_lat)
+{
+    setLatencies(chunks.size(), comp_lat, decomp_lat);
+
+    return compress(chunks);
+}
+
+template <class T>
+void
+DictionaryCompressor<T>::setLatencies(std::size_t num_chunks,
+    Cycles& comp_lat, Cycles& decomp_lat) const
 {
     // Set latencies based on the degree of parallelization, and any extra
     // latencies due to shifting or packaging
-    comp_lat = Cycles(compExtraLatency +
-        (chunks.size() / compChunksPerCycle));
+    comp_lat = Cycles(compExtraLatency + (num_chunks / compChunksPerCycle));
     decomp_lat = Cycles(decompExtraLatency +
-        (chunks.size() / decompChunksPerCycle));
-
-    return compress(chunks);
+        (num_chunks / decompChunksPerCycle));
 }
 
 template <class T>
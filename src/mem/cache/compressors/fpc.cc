@@ -81,6 +81,22 @@ FPC::FPCCompData::addEntry(std::unique_ptr<Pattern> pattern)
 FPC::FPC(const Params &p)
   : DictionaryCompressor<uint32_t>(p), zeroRunSizeBits(p.zero_run_bits)
 {
+    const DictionaryEntry bytes = toDictionaryEntry(0);
+    ZeroRun zero_run(bytes, -1);
+    zero_run.setRealSize(zeroRunSizeBits);
+    patternSizeBits[ZERO_RUN] = zero_run.getSizeBits();
+    patternSizeBits[SIGN_EXTENDED_4_BITS] =
+        SignExtended4Bits(bytes, -1).getSizeBits();
+    patternSizeBits[SIGN_EXTENDED_1_BYTE] =
+        SignExtended1Byte(bytes, -1).getSizeBits();
+    patternSizeBits[SIGN_EXTENDED_HALFWORD] =
+        SignExtendedHalfword(bytes, -1).getSizeBits();
+    patternSizeBits[ZERO_PADDED_HALFWORD] =
+        ZeroPaddedHalfword(bytes, -1).getSizeBits();
+    patternSizeBits[SIGN_EXTENDED_TWO_HALFWORDS] =
+        SignExtendedTwoHalfwords(bytes, -1).getSizeBits();
+    patternSizeBits[REP_BYTES] = RepBytes(bytes, -1).getSizeBits();
+    patternSizeBits[UNCOMPRESSED] = Uncompressed(bytes, -1).getSizeBits();
 }
 
 void
@@ -99,5 +115,62 @@ FPC::instantiateDictionaryCompData() const
         new FPCCompData(zeroRunSizeBits));
 }
 
+FPC::PatternNumber
+FPC::matchPattern(const uint32_t value)
+{
+    // FPC has no dictionary, so patterns are always matched against an
+    // empty entry, with an invalid match location
+    const DictionaryEntry bytes = toDictionaryEntry(value);
+    const DictionaryEntry dict_bytes = toDictionaryEntry(0);
+    if (ZeroRun::isPattern(bytes, dict_bytes, -1)) {
+        return ZERO_RUN;
+    } else if (SignExtended4Bits::isPattern(bytes, dict_bytes, -1)) {
+        return SIGN_EXTENDED_4_BITS;
+    } else if (SignExtended1Byte::isPattern(bytes, dict_bytes, -1)) {
+        return SIGN_EXTENDED_1_BYTE;
+    } else if (SignExtendedHalfword::isPattern(bytes, dict_bytes, -1)) {
+        return SIGN_EXTENDED_HALFWORD;
+    } else if (ZeroPaddedHalfword::isPattern(bytes, dict_bytes, -1)) {
+        return ZERO_PADDED_HALFWORD;
+    } else if (SignExtendedTwoHalfwords::isPattern(bytes, dict_bytes, -1)) {
+        return SIGN_EXTENDED_TWO_HALFWORDS;
+    } else if (RepBytes::isPattern(bytes, dict_bytes, -1)) {
+        return REP_BYTES;
+    }
+    return UNCOMPRESSED;
+}
+
+bool
+FPC::compressSize(const uint64_t* data, std::size_t& size_bits,
+    Cycles& comp_lat, Cycles& decomp_lat)
+{
+    const std::size_t num_chunks = numChunks();
+    setLatencies(num_chunks, comp_lat, decomp_lat);
+
+    // Mirrors FPCCompData::addEntry: only the first zero of a run, or of
+    // a new run after the maximum run length is reached, has a size.
+    // A negative run length means the previous entry was not a zero run
+    const int max_run_length = mask(zeroRunSizeBits);
+    int run_length = -1;
+    size_bits = 0;
+    for (std::size_t i = 0; i < num_chunks; i++) {
+        const PatternNumber pattern = matchPattern(getChunk(data, i));
+        dictionaryStats.patterns[pattern]++;
+        if (pattern == ZERO_RUN) {
+            if ((run_length < 0) || (run_length == max_run_length)) {
+                size_bits += patternSizeBits[ZERO_RUN];
+                run_length = 0;
+            } else {
+                run_length++;
+            }
+        } else {
+            size_bits += patternSizeBits[pattern];
+            run_length = -1;
+        }
+    }
+
+    return true;
+}
+
 } // namespace compression
 } // namespace gem5
@@ -35,6 +35,7 @@
 #ifndef __MEM_CACHE_COMPRESSORS_FPC_HH__
 #define __MEM_CACHE_COMPRESSORS_FPC_HH__
 
+#include <array>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -94,6 +95,12 @@ class FPC : public DictionaryCompressor<uint32_t>
      */
     const int zeroRunSizeBits;
 
+    /**
+     * Size, in bits, of each pattern. The zero run entry holds the size of
+     * the first entry of a run.
+     */
+    std::array<std::size_t, NUM_PATTERNS> patternSizeBits;
+
     uint64_t getNumPatterns() const override { return NUM_PATTERNS; }
 
     std::string
@@ -129,6 +136,15 @@ class FPC : public DictionaryCompressor<uint32_t>
     std::unique_ptr<DictionaryCompressor::CompData>
     instantiateDictionaryCompData() const override;
 
+    /**
+     * Find the pattern number of a value, checking the patterns in the same
+     * order as the pattern factory, without instantiating them.
+     */
+    static PatternNumber matchPattern(const uint32_t value);
+
+    bool compressSize(const uint64_t* data, std::size_t& size_bits,
+        Cycles& comp_lat, Cycles& decomp_lat) override;
+
   public:
     typedef FPCParams Params;
     FPC(const Params &p);
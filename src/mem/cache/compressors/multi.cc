@@ -33,6 +33,7 @@
 
 #include "mem/cache/compressors/multi.hh"
 
+#include <algorithm>
 #include <cmath>
 #include <queue>
 
@@ -69,6 +70,7 @@ Multi::Multi(const Params &p)
     multiStats(stats, *this)
 {
     fatal_if(compressors.size() == 0, "There must be at least one compressor");
+    sizeResults.reserve(compressors.size());
 }
 
 Multi::~Multi()
@@ -87,6 +89,15 @@ Multi::setCache(BaseCache *_cache)
     }
 }
 
+void
+Multi::suppressStats(bool suppress)
+{
+    Base::suppressStats(suppress);
+    for (auto& compressor : compressors) {
+        compressor->suppressStats(suppress);
+    }
+}
+
 std::unique_ptr<Base::CompressionData>
 Multi::compress(const std::vector<Chunk>& chunks, Cycles& comp_lat,
     Cycles& decomp_lat)
@@ -102,21 +113,10 @@ Multi::compress(const std::vector<Chunk>& chunks, Cycles& comp_lat,
             std::unique_ptr<Base::CompressionData> comp_data,
             Cycles decomp_lat, std::size_t blk_size)
             : index(index), compData(std::move(comp_data)),
-              decompLat(decomp_lat)
+              decompLat(decomp_lat),
+              compressionFactor(Multi::compressionFactor(compData->getSize(),
+                  blk_size))
         {
-            const std::size_t size = compData->getSize();
-            // If the compressed size is worse than the uncompressed size,
-            // we assume the size is the uncompressed size, and thus the
-            // compression factor is 1.
-            //
-            // Some compressors (notably the zero compressor) may rely on
-            // extra information being stored in the tags, or added in
-            // another compression layer. Their size can be 0, so it is
-            // assigned the highest possible compression factor (the original
-            // block's size).
-            compressionFactor = (size > blk_size) ? 1 :
-                ((size == 0) ? blk_size :
-                alignToPowerOfTwo(std::floor(blk_size / (double) size)));
         }
     };
     struct ResultsComparator
@@ -125,15 +125,8 @@ Multi::compress(const std::vector<Chunk>& chunks, Cycles& comp_lat,
         operator()(const std::shared_ptr<Results>& lhs,
             const std::shared_ptr<Results>& rhs) const
         {
-            const std::size_t lhs_cf = lhs->compressionFactor;
-            const std::size_t rhs_cf = rhs->compressionFactor;
-
-            if (lhs_cf == rhs_cf) {
-                // When they have similar compressed sizes, give the one
-                // with fastest decompression privilege
-                return lhs->decompLat > rhs->decompLat;
-            }
-            return lhs_cf < rhs_cf;
+            return worseResult(lhs->compressionFactor, lhs->decompLat,
+                rhs->compressionFactor, rhs->decompLat);
         }
     };
 
@@ -167,9 +160,11 @@ Multi::compress(const std::vector<Chunk>& chunks, Cycles& comp_lat,
     decomp_lat = results.top()->decompLat + decompExtraLatency;
 
     // Update compressor ranking stats
-    for (int rank = 0; rank < compressors.size(); rank++) {
-        multiStats.ranks[results.top()->index][rank]++;
-        results.pop();
+    if (!statsSuppressed) {
+        for (int rank = 0; rank < compressors.size(); rank++) {
+            multiStats.ranks[results.top()->index][rank]++;
+            results.pop();
+        }
     }
 
     // Set compression latency (compression latency of the slowest compressor
@@ -179,6 +174,65 @@ Multi::compress(const std::vector<Chunk>& chunks, Cycles& comp_lat,
     return multi_comp_data;
 }
 
+bool
+Multi::compressSize(const uint64_t* data, std::size_t& size_bits,
+    Cycles& comp_lat, Cycles& decomp_lat)
+{
+    // Same ranking as compress(), on a reusable heap of plain results.
+    // std::priority_queue is defined in terms of push_heap and pop_heap,
+    // so ties are broken identically
+    const auto comparator = [](const SizeResult& lhs, const SizeResult& rhs)
+    {
+        return worseResult(lhs.compressionFactor, lhs.decompLat,
+            rhs.compressionFactor, rhs.decompLat);
+    };
+
+    sizeResults.clear();
+    Cycles max_comp_lat;
+    for (unsigned i = 0; i < compressors.size(); i++) {
+        Cycles temp_decomp_lat;
+        const std::size_t temp_size_bits = compressors[i]->compressedSizeBits(
+            data, comp_lat, temp_decomp_lat) + numEncodingBits;
+        // The compressed size in bytes is truncated, as in
+        // CompressionData::getSize()
+        sizeResults.push_back({i, temp_size_bits, temp_decomp_lat,
+            compressionFactor(temp_size_bits / 8, blkSize)});
+        std::push_heap(sizeResults.begin(), sizeResults.end(), comparator);
+        max_comp_lat = std::max(max_comp_lat, comp_lat);
+    }
+
+    const SizeResult& best = sizeResults.front();
+    DPRINTF(CacheComp, "Best compressor: %d\n", best.index);
+    size_bits = best.sizeBits;
+    decomp_lat = best.decompLat + decompExtraLatency;
+
+    // Update compressor ranking stats
+    for (int rank = 0; rank < compressors.size(); rank++) {
+        multiStats.ranks[sizeResults.front().index][rank]++;
+        std::pop_heap(sizeResults.begin(), sizeResults.end(), comparator);
+        sizeResults.pop_back();
+    }
+
+    comp_lat = Cycles(max_comp_lat + compExtraLatency);
+
+    return true;
+}
+
+uint8_t
+Multi::compressionFactor(std::size_t size, std::size_t blk_size)
+{
+    // If the compressed size is worse than the uncompressed size, we
+    // assume the size is the uncompressed size, and thus the compression
+    // factor is 1.
+    //
+    // Some compressors (notably the zero compressor) may rely on extra
+    // information being stored in the tags, or added in another compression
+    // layer. Their size can be 0, so it is assigned the highest possible
+    // compression factor (the original block's size).
+    return (size > blk_size) ? 1 : ((size == 0) ? blk_size :
+        alignToPowerOfTwo(std::floor(blk_size / (double) size)));
+}
+
 void
 Multi::decompress(const CompressionData* comp_data,
     uint64_t* cache_line)
@@ -101,6 +101,45 @@ class Multi : public Base
         statistics::Vector2d ranks;
     } multiStats;
 
+    /**
+     * Get the compression factor of a compressed size. If the compressed
+     * size is worse than the uncompressed size, the compression factor is 1.
+     *
+     * @param size Compressed size, in bytes.
+     * @param blk_size Uncompressed size, in bytes.
+     */
+    static uint8_t compressionFactor(std::size_t size, std::size_t blk_size);
+
+    /**
+     * Ranking of the sub-compressor results: a result is worse than
+     * another if its compression factor is lower or, for the same factor,
+     * if it decompresses slower.
+     */
+    static bool
+    worseResult(uint8_t lhs_cf, Cycles lhs_lat, uint8_t rhs_cf,
+        Cycles rhs_lat)
+    {
+        if (lhs_cf == rhs_cf) {
+            return lhs_lat > rhs_lat;
+        }
+        return lhs_cf < rhs_cf;
+    }
+
+    /** Size-only result of a sub-compressor. */
+    struct SizeResult
+    {
+        unsigned index;
+        std::size_t sizeBits;
+        Cycles decompLat;
+        uint8_t compressionFactor;
+    };
+
+    /** Heap of size-only results, kept to avoid per-line allocations. */
+    std::vector<SizeResult> sizeResults;
+
+    bool compressSize(const uint64_t* data, std::size_t& size_bits,
+        Cycles& comp_lat, Cycles& decomp_lat) override;
+
   public:
     typedef MultiCompressorParams Params;
     Multi(const Params &p);
@@ -108,6 +147,8 @@ class Multi : public Base
 
     void setCache(BaseCache *_cache) override;
 
+    void suppressStats(bool suppress) override;
+
     std::unique_ptr<Base::CompressionData> compress(
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
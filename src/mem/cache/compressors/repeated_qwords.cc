@@ -82,5 +82,27 @@ RepeatedQwords::compress(const std::vector<Chunk>& chunks,
     return comp_data;
 }
 
+bool
+RepeatedQwords::compressSize(const uint64_t* data, std::size_t& size_bits,
+    Cycles& comp_lat, Cycles& decomp_lat)
+{
+    // The first chunk is always stored uncompressed, and any chunk that
+    // differs from it becomes a new dictionary entry
+    const std::size_t num_chunks = numChunks();
+    const Chunk first = getChunk(data, 0);
+    std::size_t num_matches = 0;
+    for (std::size_t i = 1; i < num_chunks; i++) {
+        num_matches += (getChunk(data, i) == first);
+    }
+    dictionaryStats.patterns[M] += num_matches;
+    dictionaryStats.patterns[X] += num_chunks - num_matches;
+
+    size_bits = (num_matches == num_chunks - 1) ? sizeof(uint64_t) * 8 :
+        blkSize * 8;
+    comp_lat = Cycles(1);
+    decomp_lat = Cycles(1);
+    return true;
+}
+
 } // namespace compression
 } // namespace gem5
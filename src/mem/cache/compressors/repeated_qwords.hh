@@ -101,6 +101,9 @@ class RepeatedQwords : public DictionaryCompressor<uint64_t>
         const std::vector<Base::Chunk>& chunks,
         Cycles& comp_lat, Cycles& decomp_lat) override;
 
+    bool compressSize(const uint64_t* data, std::size_t& size_bits,
+        Cycles& comp_lat, Cycles& decomp_lat) override;
+
   public:
     typedef RepeatedQwordsCompressorParams Params;
     RepeatedQwords(const Params &p);
@@ -80,5 +80,25 @@ Zero::compress(const std::vector<Chunk>& chunks, Cycles& comp_lat,
     return comp_data;
 }
 
+bool
+Zero::compressSize(const uint64_t* data, std::size_t& size_bits,
+    Cycles& comp_lat, Cycles& decomp_lat)
+{
+    // Every non-zero chunk would be added to the dictionary as an
+    // uncompressed pattern, so only the number of zero chunks matters
+    const std::size_t num_chunks = numChunks();
+    std::size_t num_zeros = 0;
+    for (std::size_t i = 0; i < num_chunks; i++) {
+        num_zeros += (getChunk(data, i) == 0);
+    }
+    dictionaryStats.patterns[Z] += num_zeros;
+    dictionaryStats.patterns[X] += num_chunks - num_zeros;
+
+    size_bits = (num_zeros == num_chunks) ? 0 : blkSize * 8;
+    comp_lat = Cycles(1);
+    decomp_lat = Cycles(1);
+    return true;
+}
+
 } // namespace compression
 } // namespace gem5
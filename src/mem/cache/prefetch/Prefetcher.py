@@ -87,6 +87,9 @@ class BasePrefetcher(ClockedObject):
             "Size of pages for virtual addresses")
 
     is_sub_prefetcher = Param.Bool(False, "Is this a sub-prefetcher")
+    train_trace = Param.String("",
+        "File in the output directory that records every training access and "
+        "fill (empty to disable)")
 
 
     def __init__(self, **kwargs):
@@ -1174,3 +1177,14 @@ class L3CompositeWithWorkerPrefetcher(CompositeWithWorkerPrefetcher):
     cxx_header = "mem/cache/prefetch/l3_composite_with_worker.hh"
 
     bop = Param.BasePrefetcher(FallenBOPPrefetcher(is_sub_prefetcher=True), "")
+
+class PrefetchTraceReplayer(SimObject):
+    type = 'PrefetchTraceReplayer'
+    cxx_class = 'gem5::prefetch::TraceReplayer'
+    cxx_header = "mem/cache/prefetch/trace_replayer.hh"
+
+    trace = Param.String("Training trace written by train_trace")
+    prefetcher = Param.QueuedPrefetcher("Prefetcher to replay the trace on")
+    block_size = Param.Int(Parent.cache_line_size, "Block size in bytes")
+    window_lines = Param.Unsigned(4096,
+        "Prefetched lines remembered when measuring coverage and accuracy")
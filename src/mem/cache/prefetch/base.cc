@@ -48,6 +48,7 @@
 #include <cassert>
 
 #include "base/intmath.hh"
+#include "base/output.hh"
 #include "debug/HWPrefetch.hh"
 #include "mem/cache/base.hh"
 #include "params/BasePrefetcher.hh"
@@ -112,12 +113,26 @@ Base::PrefetchInfo::PrefetchInfo(PrefetchInfo const &pfi, Addr addr)
 {
 }
 
+Base::PrefetchInfo::PrefetchInfo(const TrainRecord &rec)
+  : address(rec.addr), pc(rec.pc), requestorId(rec.requestorId),
+    validPC(rec.is(TrainRecord::ValidPC)),
+    secure(rec.is(TrainRecord::Secure)), size(rec.size),
+    write(rec.is(TrainRecord::Write)), paddress(rec.paddr),
+    cacheMiss(rec.is(TrainRecord::Miss)), data(nullptr),
+    xsMetadata(PrefetchSourceType(rec.pfSource)),
+    pfFirstHit(rec.is(TrainRecord::PfFirstHit)),
+    pfHit(rec.is(TrainRecord::PfHit)), data_ptr(nullptr)
+{
+}
+
 void
 Base::PrefetchListener::notify(const PacketPtr &pkt)
 {
     if (coreDirectNotify) {
         parent.coreDirectAddrNotify(pkt);
     } else if (isFill) {
+        if (parent.trainTrace)
+            parent.recordFill(pkt);
         parent.notifyFill(pkt);
     } else {
         parent.probeNotify(pkt, miss);
@@ -138,6 +153,58 @@ Base::Base(const BasePrefetcherParams &p)
       prefetchStats(this), issuedPrefetches(0),
       usefulPrefetches(0), streamlatenum(0),tlb(nullptr)
 {
+    if (!p.train_trace.empty()) {
+        trainTraceStream = simout.create(p.train_trace, true, true);
+        trainTrace.reset(new TrainTraceWriter(*trainTraceStream->stream()));
+        registerExitCallback([this]() {
+            trainTrace.reset();
+            simout.close(trainTraceStream);
+        });
+    }
+}
+
+void
+Base::recordTraining(const PacketPtr &pkt, const PrefetchInfo &pfi)
+{
+    TrainRecord rec;
+    rec.tick = curTick();
+    rec.pc = pfi.hasPC() ? pfi.getPC() : 0;
+    rec.addr = pfi.getAddr();
+    rec.paddr = pfi.getPaddr();
+    rec.size = pfi.getSize();
+    rec.requestorId = pfi.getRequestorId();
+    rec.pfSource = pfi.getXsMetadata().prefetchSource;
+    rec.flags = (pfi.isCacheMiss() ? TrainRecord::Miss : 0) |
+        (pfi.isWrite() ? TrainRecord::Write : 0) |
+        (pfi.isSecure() ? TrainRecord::Secure : 0) |
+        (pfi.hasPC() ? TrainRecord::ValidPC : 0) |
+        (pfi.isPfHit() ? TrainRecord::PfHit : 0) |
+        (pfi.isPfFirstHit() ? TrainRecord::PfFirstHit : 0) |
+        (pkt->missOnLatePf ? TrainRecord::Late : 0) |
+        (pkt->coalescingMSHR ? TrainRecord::MissRepeat : 0);
+    trainTrace->append(rec);
+}
+
+void
+Base::recordFill(const PacketPtr &pkt)
+{
+    // No prefetcher learns from instruction fills
+    if (pkt->req->isInstFetch())
+        return;
+
+    TrainRecord rec;
+    rec.tick = curTick();
+    rec.pc = pkt->req->hasPC() ? pkt->req->getPC() : 0;
+    rec.addr = pkt->req->hasVaddr() ? pkt->req->getVaddr() : pkt->getAddr();
+    rec.paddr = pkt->getAddr();
+    rec.size = pkt->getSize();
+    rec.requestorId = pkt->req->requestorId();
+    rec.pfSource = pkt->req->getXsMetadata().prefetchSource;
+    rec.flags = TrainRecord::Fill |
+        (pkt->isSecure() ? TrainRecord::Secure : 0) |
+        (pkt->req->hasPC() ? TrainRecord::ValidPC : 0) |
+        (pkt->req->isPrefetch() ? TrainRecord::Prefetch : 0);
+    trainTrace->append(rec);
 }
 
 void
@@ -391,6 +458,8 @@ Base::probeNotify(const PacketPtr &pkt, bool miss)
             pfi.setPfFirstHit(!miss && hasBeenPrefetched(pkt->getAddr(), pkt->isSecure()));
             pfi.setPfHit(!miss && hasEverBeenPrefetched(pkt->getAddr(), pkt->isSecure()));
             squashMark = false;
+            if (trainTrace)
+                recordTraining(pkt, pfi);
             notify(pkt, pfi);
         } else {
             DPRINTF(HWPrefetch, "Skip req addr %x, has vaddr: %i\n",
@@ -47,12 +47,14 @@
 #define __MEM_CACHE_PREFETCH_BASE_HH__
 
 #include <cstdint>
+#include <memory>
 
 #include "arch/generic/tlb.hh"
 #include "base/compiler.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/cache/cache_probe_arg.hh"
+#include "mem/cache/prefetch/train_trace.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 #include "sim/arch_db.hh"
@@ -63,6 +65,7 @@
 namespace gem5
 {
 
+class OutputStream;
 struct BasePrefetcherParams;
 
 GEM5_DEPRECATED_NAMESPACE(Prefetcher, prefetch);
@@ -326,6 +329,9 @@ class Base : public ClockedObject
          */
         PrefetchInfo(PrefetchInfo const &pfi, Addr addr);
 
+        /** Constructs a PrefetchInfo from a recorded training access. */
+        PrefetchInfo(const TrainRecord &rec);
+
         ~PrefetchInfo()
         {
             delete[] data;
@@ -566,6 +572,13 @@ class Base : public ClockedObject
 
     bool functionalTLB{false};
 
+    /** Records every training access and fill when train_trace is set. */
+    std::unique_ptr<TrainTraceWriter> trainTrace;
+    OutputStream *trainTraceStream{nullptr};
+
+    void recordTraining(const PacketPtr &pkt, const PrefetchInfo &pfi);
+    void recordFill(const PacketPtr &pkt);
+
   public:
     virtual void addHintDownStream(Base* down_stream)
     {
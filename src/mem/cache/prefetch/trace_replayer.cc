@@ -0,0 +1,229 @@
+#include "mem/cache/prefetch/trace_replayer.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/cache/prefetch/berti.hh"
+#include "mem/cache/prefetch/bop.hh"
+#include "mem/cache/prefetch/cdp.hh"
+#include "mem/cache/prefetch/xs_stride.hh"
+#include "mem/packet.hh"
+#include "sim/sim_exit.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+TraceReplayer::TraceReplayer(const Params &p)
+    : SimObject(p), traceFile(p.trace), prefetcher(p.prefetcher),
+      lineShift(floorLog2(p.block_size)), windowLines(p.window_lines),
+      replayEvent([this]{ replay(); }, name()),
+      stats(this)
+{
+    fatal_if(dynamic_cast<CDP *>(prefetcher), "%s: CDP prefetches from the "
+             "data of filled lines and cannot replay a training trace.\n",
+             name());
+    fatal_if(!isPowerOf2(p.block_size), "%s: block size must be a power "
+             "of 2.\n", name());
+    fatal_if(windowLines == 0, "%s: window_lines must be positive.\n",
+             name());
+}
+
+TraceReplayer::LineKey
+TraceReplayer::key(Addr addr, bool virt) const
+{
+    return ((addr >> lineShift) << 1) | (virt ? 1 : 0);
+}
+
+void
+TraceReplayer::insertPrefetch(LineKey line)
+{
+    auto it = window.find(line);
+    if (it != window.end()) {
+        // Already requested and still in the window
+        lru.splice(lru.begin(), lru, it->second);
+        return;
+    }
+    stats.pfIssued++;
+    if (window.size() == windowLines) {
+        window.erase(lru.back().line);
+        lru.pop_back();
+    }
+    lru.push_front({line, false});
+    window[line] = lru.begin();
+}
+
+bool
+TraceReplayer::usePrefetch(LineKey line)
+{
+    auto it = window.find(line);
+    if (it == window.end() || it->second->used)
+        return false;
+    it->second->used = true;
+    stats.pfUseful++;
+    return true;
+}
+
+void
+TraceReplayer::startup()
+{
+    traceStream.open(traceFile, std::ios::binary);
+    fatal_if(!traceStream, "%s: cannot open %s.\n", name(), traceFile);
+    reader.reset(new TrainTraceReader(traceStream));
+
+    if (!reader->next(nextRecord)) {
+        exitSimLoop("prefetcher training trace replayed");
+        return;
+    }
+    firstRecordTick = nextRecord.tick;
+    startTick = curTick();
+    schedule(replayEvent, startTick);
+}
+
+void
+TraceReplayer::replay()
+{
+    std::vector<Queued::AddrPriority> addresses;
+    Tick when;
+    do {
+        if (nextRecord.is(TrainRecord::Fill))
+            fill(nextRecord);
+        else
+            train(nextRecord, addresses);
+        if (!reader->next(nextRecord)) {
+            inform("%s: replayed %llu training accesses from %s\n", name(),
+                   (unsigned long long)stats.accesses.value(), traceFile);
+            exitSimLoop("prefetcher training trace replayed");
+            return;
+        }
+        // Records of several caches may interleave slightly out of order
+        when = startTick + nextRecord.tick - std::min(nextRecord.tick,
+                                                      firstRecordTick);
+    } while (when <= curTick());
+    schedule(replayEvent, when);
+}
+
+void
+TraceReplayer::train(const TrainRecord &rec,
+                     std::vector<Queued::AddrPriority> &addresses)
+{
+    Base::PrefetchInfo pfi(rec);
+    bool miss = rec.is(TrainRecord::Miss);
+    stats.accesses++;
+    if (miss)
+        stats.misses++;
+
+    // The training address may be virtual; try both views of the line
+    bool virt = rec.addr != rec.paddr;
+    bool covered = usePrefetch(key(rec.paddr, false));
+    if (virt)
+        covered = usePrefetch(key(rec.addr, true)) || covered;
+    if (miss && covered)
+        stats.coveredMisses++;
+
+    bool late = miss && rec.is(TrainRecord::Late);
+    auto pf_source = PrefetchSourceType(rec.pfSource);
+    bool miss_repeat = rec.is(TrainRecord::MissRepeat);
+    // XSCompositePrefetcher trains these on load misses and first hits
+    // on prefetched lines only
+    bool first_access = miss || rec.is(TrainRecord::PfFirstHit);
+    bool load = !rec.is(TrainRecord::Write);
+
+    if (miss && !miss_repeat) {
+        pendingMisses[key(rec.paddr, false)] =
+            makeRequest(rec, Request::Flags());
+    }
+
+    addresses.clear();
+    if (auto *stride = dynamic_cast<XSStridePrefetcher *>(prefetcher)) {
+        if (load && first_access) {
+            // Without the composite's region table, repeated misses go
+            // to the redundant stride table
+            Addr pf_addr = 0;
+            int64_t learned_bop_offset = 0;
+            stride->calculatePrefetch(pfi, addresses, late, pf_source,
+                                      miss_repeat, false, !miss_repeat,
+                                      pf_addr, learned_bop_offset);
+        }
+    } else if (auto *berti = dynamic_cast<BertiPrefetcher *>(prefetcher)) {
+        if (load && first_access) {
+            Addr local_delta_pf_addr = 0;
+            berti->calculatePrefetch(pfi, addresses, late, pf_source,
+                                     miss_repeat, local_delta_pf_addr);
+        }
+    } else if (auto *bop = dynamic_cast<BOP *>(prefetcher)) {
+        if (first_access && !miss_repeat) {
+            bop->calculatePrefetch(pfi, addresses,
+                                   late && pf_source ==
+                                   PrefetchSourceType::HWP_BOP);
+        }
+    } else {
+        prefetcher->calculatePrefetch(pfi, addresses, late, pf_source,
+                                      miss_repeat);
+    }
+    for (const auto &pf : addresses)
+        insertPrefetch(key(pf.addr, pf.isVA && virt));
+}
+
+void
+TraceReplayer::fill(const TrainRecord &rec)
+{
+    RequestPtr req;
+    auto it = pendingMisses.find(key(rec.paddr, false));
+    if (it != pendingMisses.end()) {
+        if (!rec.is(TrainRecord::Prefetch))
+            req = it->second;
+        pendingMisses.erase(it);
+    }
+    if (!req) {
+        req = makeRequest(rec, rec.is(TrainRecord::Prefetch) ?
+                          Request::PREFETCH : Request::Flags());
+    }
+
+    Packet pkt(req, MemCmd::ReadResp);
+    prefetcher->notifyFill(&pkt);
+}
+
+RequestPtr
+TraceReplayer::makeRequest(const TrainRecord &rec, Request::Flags flags) const
+{
+    if (rec.is(TrainRecord::Secure))
+        flags.set(Request::SECURE);
+    RequestPtr req;
+    if (rec.is(TrainRecord::ValidPC)) {
+        req = std::make_shared<Request>(rec.addr, rec.size, flags,
+                                        rec.requestorId, rec.pc, 0);
+        req->setPaddr(rec.paddr);
+    } else {
+        req = std::make_shared<Request>(rec.paddr, rec.size, flags,
+                                        rec.requestorId);
+    }
+    return req;
+}
+
+TraceReplayer::ReplayStats::ReplayStats(statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(accesses, statistics::units::Count::get(),
+               "Training accesses replayed"),
+      ADD_STAT(misses, statistics::units::Count::get(),
+               "Replayed accesses that missed in the recorded run"),
+      ADD_STAT(coveredMisses, statistics::units::Count::get(),
+               "Misses to a line prefetched earlier in the replay"),
+      ADD_STAT(pfIssued, statistics::units::Count::get(),
+               "Distinct prefetches generated"),
+      ADD_STAT(pfUseful, statistics::units::Count::get(),
+               "Prefetches accessed while in the window"),
+      ADD_STAT(coverage, statistics::units::Ratio::get(),
+               "Fraction of misses covered by prefetches",
+               coveredMisses / misses),
+      ADD_STAT(accuracy, statistics::units::Ratio::get(),
+               "Fraction of prefetches that were used",
+               pfUseful / pfIssued)
+{
+}
+
+} // namespace prefetch
+} // namespace gem5
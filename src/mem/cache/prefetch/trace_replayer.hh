@@ -0,0 +1,119 @@
+#ifndef __MEM_CACHE_PREFETCH_TRACE_REPLAYER_HH__
+#define __MEM_CACHE_PREFETCH_TRACE_REPLAYER_HH__
+
+#include <fstream>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/request.hh"
+#include "mem/cache/prefetch/train_trace.hh"
+#include "params/PrefetchTraceReplayer.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+/**
+ * Feeds a training trace recorded with BasePrefetcher.train_trace to a
+ * queued prefetcher, without any CPU or cache, and measures the coverage
+ * and accuracy of the prefetches it generates. Records are replayed at
+ * their recorded distance from the first one, so prefetchers with timed
+ * internal events see the same spacing, and the simulation exits once
+ * the trace is done.
+ *
+ * Recorded fills are passed to notifyFill with a request made when the
+ * matching miss was replayed, so fill latencies are kept too.
+ *
+ * XSStridePrefetcher, BertiPrefetcher and BOPPrefetcher are trained
+ * through the entry points XSCompositePrefetcher uses for them, other
+ * prefetchers through the generic Queued entry point. CDP prefetches
+ * from the data of filled lines, which a training trace does not hold,
+ * so it is rejected.
+ *
+ * Generated prefetches are kept in an LRU window of window_lines lines.
+ * A prefetch is useful if a later access touches its line while it is in
+ * the window; a trace miss is covered if it touches such a line.
+ */
+class TraceReplayer : public SimObject
+{
+  public:
+    PARAMS(PrefetchTraceReplayer);
+    TraceReplayer(const Params &p);
+
+    void startup() override;
+
+  private:
+    /** Line address with the lowest bit set for virtual addresses. */
+    typedef Addr LineKey;
+
+    LineKey key(Addr addr, bool virt) const;
+
+    /** Replay the due records and schedule the next one. */
+    void replay();
+    /** Train the prefetcher on one access record. */
+    void train(const TrainRecord &rec,
+               std::vector<Queued::AddrPriority> &addresses);
+    /** Notify the prefetcher of one fill record. */
+    void fill(const TrainRecord &rec);
+    /** A request for rec, timestamped now. */
+    RequestPtr makeRequest(const TrainRecord &rec,
+                           Request::Flags flags) const;
+
+    void insertPrefetch(LineKey line);
+    /** @return whether line was an unused prefetch in the window. */
+    bool usePrefetch(LineKey line);
+
+    const std::string traceFile;
+    Queued *prefetcher;
+    const unsigned lineShift;
+    const unsigned windowLines;
+
+    std::ifstream traceStream;
+    std::unique_ptr<TrainTraceReader> reader;
+    TrainRecord nextRecord;
+    /** Recorded tick of the first record and the tick it replays at */
+    Tick firstRecordTick = 0;
+    Tick startTick = 0;
+    EventFunctionWrapper replayEvent;
+
+    struct WindowEntry
+    {
+        LineKey line;
+        bool used;
+    };
+    std::list<WindowEntry> lru;
+    std::unordered_map<LineKey, std::list<WindowEntry>::iterator> window;
+
+    /**
+     * Requests of the replayed demand misses by physical line, so their
+     * fills report the latency since the miss
+     */
+    std::unordered_map<LineKey, RequestPtr> pendingMisses;
+
+    struct ReplayStats : public statistics::Group
+    {
+        ReplayStats(statistics::Group *parent);
+
+        statistics::Scalar accesses;
+        statistics::Scalar misses;
+        statistics::Scalar coveredMisses;
+        statistics::Scalar pfIssued;
+        statistics::Scalar pfUseful;
+        statistics::Formula coverage;
+        statistics::Formula accuracy;
+    } stats;
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_TRACE_REPLAYER_HH__
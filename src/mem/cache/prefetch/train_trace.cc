@@ -0,0 +1,110 @@
+#include "mem/cache/prefetch/train_trace.hh"
+
+#include <cstring>
+
+#include "base/logging.hh"
+#include "sim/byteswap.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+namespace
+{
+
+template <class T>
+void
+writeColumn(std::ostream &os, std::vector<T> &col)
+{
+    for (auto &v : col)
+        v = htole(v);
+    os.write(reinterpret_cast<const char *>(col.data()),
+             col.size() * sizeof(T));
+    col.clear();
+}
+
+template <class T>
+bool
+readColumn(std::istream &is, std::vector<T> &col, uint32_t count)
+{
+    col.resize(count);
+    is.read(reinterpret_cast<char *>(col.data()), count * sizeof(T));
+    for (auto &v : col)
+        v = letoh(v);
+    return bool(is);
+}
+
+} // anonymous namespace
+
+TrainTraceWriter::TrainTraceWriter(std::ostream &_os)
+    : os(_os)
+{
+    os.write(Magic, sizeof(Magic));
+}
+
+void
+TrainTraceWriter::flush()
+{
+    if (ticks.empty())
+        return;
+    uint32_t count = htole(uint32_t(ticks.size()));
+    os.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    written += ticks.size();
+    writeColumn(os, ticks);
+    writeColumn(os, pcs);
+    writeColumn(os, addrs);
+    writeColumn(os, paddrs);
+    writeColumn(os, sizes);
+    writeColumn(os, requestors);
+    writeColumn(os, flagWords);
+    writeColumn(os, sources);
+    os.flush();
+}
+
+TrainTraceReader::TrainTraceReader(std::istream &_is)
+    : is(_is)
+{
+    char magic[sizeof(TrainTraceWriter::Magic)];
+    is.read(magic, sizeof(magic));
+    fatal_if(!is || std::memcmp(magic, TrainTraceWriter::Magic,
+                                sizeof(magic)) != 0,
+             "Not a prefetcher training trace.\n");
+}
+
+bool
+TrainTraceReader::readBlock()
+{
+    uint32_t count;
+    if (!is.read(reinterpret_cast<char *>(&count), sizeof(count)))
+        return false;
+    count = letoh(count);
+    bool ok = readColumn(is, ticks, count) && readColumn(is, pcs, count) &&
+        readColumn(is, addrs, count) && readColumn(is, paddrs, count) &&
+        readColumn(is, sizes, count) && readColumn(is, requestors, count) &&
+        readColumn(is, flagWords, count) && readColumn(is, sources, count);
+    fatal_if(!ok, "Truncated prefetcher training trace.\n");
+    pos = 0;
+    return count > 0;
+}
+
+bool
+TrainTraceReader::next(TrainRecord &rec)
+{
+    if (pos == ticks.size() && !readBlock())
+        return false;
+    rec.tick = ticks[pos];
+    rec.pc = pcs[pos];
+    rec.addr = addrs[pos];
+    rec.paddr = paddrs[pos];
+    rec.size = sizes[pos];
+    rec.requestorId = requestors[pos];
+    rec.flags = flagWords[pos];
+    rec.pfSource = sources[pos];
+    pos++;
+    return true;
+}
+
+} // namespace prefetch
+} // namespace gem5
@@ -0,0 +1,131 @@
+#ifndef __MEM_CACHE_PREFETCH_TRAIN_TRACE_HH__
+#define __MEM_CACHE_PREFETCH_TRAIN_TRACE_HH__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+/** One training access or cache fill seen by a prefetcher. */
+struct TrainRecord
+{
+    enum Flag : uint16_t
+    {
+        Miss = 1 << 0,
+        Write = 1 << 1,
+        Secure = 1 << 2,
+        ValidPC = 1 << 3,
+        PfHit = 1 << 4,
+        PfFirstHit = 1 << 5,
+        /** The miss hit a prefetch still in flight. */
+        Late = 1 << 6,
+        /** The miss coalesced into an existing MSHR. */
+        MissRepeat = 1 << 7,
+        /** A line filled into the cache rather than a training access. */
+        Fill = 1 << 8,
+        /** The fill was for a prefetch. */
+        Prefetch = 1 << 9,
+    };
+
+    Tick tick = 0;
+    Addr pc = 0;
+    /** Training address, virtual if the prefetcher uses them. */
+    Addr addr = 0;
+    Addr paddr = 0;
+    uint16_t size = 0;
+    uint16_t requestorId = 0;
+    uint16_t flags = 0;
+    /** PrefetchSourceType of the block or of the late prefetch. */
+    uint8_t pfSource = 0;
+
+    bool is(Flag f) const { return flags & f; }
+};
+
+/**
+ * Writes TrainRecords in blocks of BlockRecords. Within a block every
+ * field is stored as its own little-endian array (tick, pc, addr, paddr,
+ * size, requestorId, flags, pfSource), so tools can load single columns
+ * straight into arrays.
+ *
+ * File layout: the 8-byte Magic, then blocks of a 32-bit record count
+ * followed by the columns.
+ */
+class TrainTraceWriter
+{
+  public:
+    static constexpr char Magic[8] = {'X', 'S', 'P', 'F', 'T', 'R', 'C', '2'};
+    static constexpr uint32_t BlockRecords = 4096;
+
+    explicit TrainTraceWriter(std::ostream &os);
+    ~TrainTraceWriter() { flush(); }
+
+    void
+    append(const TrainRecord &rec)
+    {
+        ticks.push_back(rec.tick);
+        pcs.push_back(rec.pc);
+        addrs.push_back(rec.addr);
+        paddrs.push_back(rec.paddr);
+        sizes.push_back(rec.size);
+        requestors.push_back(rec.requestorId);
+        flagWords.push_back(rec.flags);
+        sources.push_back(rec.pfSource);
+        if (ticks.size() == BlockRecords)
+            flush();
+    }
+
+    /** Write out the records buffered so far as one block. */
+    void flush();
+
+    uint64_t numRecords() const { return written + ticks.size(); }
+
+  private:
+    std::ostream &os;
+    uint64_t written = 0;
+    std::vector<uint64_t> ticks;
+    std::vector<uint64_t> pcs;
+    std::vector<uint64_t> addrs;
+    std::vector<uint64_t> paddrs;
+    std::vector<uint16_t> sizes;
+    std::vector<uint16_t> requestors;
+    std::vector<uint16_t> flagWords;
+    std::vector<uint8_t> sources;
+};
+
+/** Reads back the records of a TrainTraceWriter, in order. */
+class TrainTraceReader
+{
+  public:
+    /** Fails with fatal() if the stream is not a training trace. */
+    explicit TrainTraceReader(std::istream &is);
+
+    /** @return false at the end of the trace. */
+    bool next(TrainRecord &rec);
+
+  private:
+    bool readBlock();
+
+    std::istream &is;
+    size_t pos = 0;
+    std::vector<uint64_t> ticks;
+    std::vector<uint64_t> pcs;
+    std::vector<uint64_t> addrs;
+    std::vector<uint64_t> paddrs;
+    std::vector<uint16_t> sizes;
+    std::vector<uint16_t> requestors;
+    std::vector<uint16_t> flagWords;
+    std::vector<uint8_t> sources;
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_TRAIN_TRACE_HH__
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+#include "mem/cache/prefetch/train_trace.hh"
+
+using namespace gem5;
+using namespace gem5::prefetch;
+
+namespace
+{
+
+TrainRecord
+makeRecord(uint64_t i)
+{
+    TrainRecord rec;
+    rec.tick = i * 500;
+    rec.pc = 0x80000000 + i * 4;
+    rec.addr = 0x10000 + i * 64;
+    rec.paddr = 0x90000000 + i * 64;
+    rec.size = 8;
+    rec.requestorId = i % 3;
+    rec.flags = i & 0x3ff;
+    rec.pfSource = i % 7;
+    return rec;
+}
+
+} // anonymous namespace
+
+/** Records survive a round trip, across several blocks. */
+TEST(TrainTraceTest, RoundTrip)
+{
+    const uint64_t n = TrainTraceWriter::BlockRecords * 2 + 10;
+    std::stringstream ss;
+    {
+        TrainTraceWriter writer(ss);
+        for (uint64_t i = 0; i < n; i++)
+            writer.append(makeRecord(i));
+        EXPECT_EQ(writer.numRecords(), n);
+    }
+
+    TrainTraceReader reader(ss);
+    TrainRecord rec;
+    for (uint64_t i = 0; i < n; i++) {
+        ASSERT_TRUE(reader.next(rec));
+        TrainRecord ref = makeRecord(i);
+        EXPECT_EQ(rec.tick, ref.tick);
+        EXPECT_EQ(rec.pc, ref.pc);
+        EXPECT_EQ(rec.addr, ref.addr);
+        EXPECT_EQ(rec.paddr, ref.paddr);
+        EXPECT_EQ(rec.size, ref.size);
+        EXPECT_EQ(rec.requestorId, ref.requestorId);
+        EXPECT_EQ(rec.flags, ref.flags);
+        EXPECT_EQ(rec.pfSource, ref.pfSource);
+    }
+    EXPECT_FALSE(reader.next(rec));
+}
+
+TEST(TrainTraceTest, Empty)
+{
+    std::stringstream ss;
+    { TrainTraceWriter writer(ss); }
+    TrainTraceReader reader(ss);
+    TrainRecord rec;
+    EXPECT_FALSE(reader.next(rec));
+}
@@ -104,6 +104,20 @@ class Base : public SimObject
     virtual ReplaceableEntry* getVictim(
                            const ReplacementCandidates& candidates) const = 0;
 
+    /**
+     * Rank an entry against the other entries of its set, used to replay
+     * cache contents in replacement order. Entries that would be evicted
+     * sooner have larger ages; policies without an order return 0.
+     *
+     * @param replacement_data Replacement data of the entry.
+     * @return The age of the entry.
+     */
+    virtual uint64_t
+    age(const std::shared_ptr<ReplacementData>& replacement_data) const
+    {
+        return 0;
+    }
+
     /**
      * Instantiate a replacement data entry.
      *
@@ -142,6 +142,12 @@ BRRIP::getVictim(const ReplacementCandidates& candidates) const
     return victim;
 }
 
+uint64_t
+BRRIP::age(const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    return std::static_pointer_cast<BRRIPReplData>(replacement_data)->rrpv;
+}
+
 std::shared_ptr<ReplacementData>
 BRRIP::instantiateEntry()
 {
@@ -152,6 +152,15 @@ class BRRIP : public Base
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
 
+    /**
+     * The RRPV of the entry.
+     *
+     * @param replacement_data Replacement data of the entry.
+     * @return The age of the entry.
+     */
+    uint64_t age(const std::shared_ptr<ReplacementData>& replacement_data)
+                                                               const override;
+
     /**
      * Instantiate a replacement data entry.
      *
@@ -173,6 +173,13 @@ Dueling::getVictim(const ReplacementCandidates& candidates) const
     return victim;
 }
 
+uint64_t
+Dueling::age(const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    return replPolicyA->age(std::static_pointer_cast<DuelerReplData>(
+        replacement_data)->replDataA);
+}
+
 std::shared_ptr<ReplacementData>
 Dueling::instantiateEntry()
 {
@@ -110,6 +110,8 @@ class Dueling : public Base
                                                                      override;
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
+    uint64_t age(const std::shared_ptr<ReplacementData>& replacement_data)
+                                                               const override;
     std::shared_ptr<ReplacementData> instantiateEntry() override;
 };
 
@@ -91,6 +91,13 @@ LRU::getVictim(const ReplacementCandidates& candidates) const
     return victim;
 }
 
+uint64_t
+LRU::age(const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    return curTick() - std::static_pointer_cast<LRUReplData>(
+        replacement_data)->lastTouchTick;
+}
+
 std::shared_ptr<ReplacementData>
 LRU::instantiateEntry()
 {
@@ -102,6 +102,15 @@ class LRU : public Base
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
 
+    /**
+     * Ticks since the entry was last touched.
+     *
+     * @param replacement_data Replacement data of the entry.
+     * @return The age of the entry.
+     */
+    uint64_t age(const std::shared_ptr<ReplacementData>& replacement_data)
+                                                               const override;
+
     /**
      * Instantiate a replacement data entry.
      *
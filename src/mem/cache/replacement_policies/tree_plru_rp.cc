@@ -196,6 +196,16 @@ TreePLRU::getVictim(const ReplacementCandidates& candidates) const
     return candidates[tree_index - (numLeaves - 1)];
 }
 
+uint64_t
+TreePLRU::age(const std::shared_ptr<ReplacementData>& replacement_data)
+const
+{
+    std::shared_ptr<TreePLRUReplData> treePLRU_replacement_data =
+        std::static_pointer_cast<TreePLRUReplData>(replacement_data);
+    return treeAge(*treePLRU_replacement_data->tree,
+                   treePLRU_replacement_data->index);
+}
+
 std::shared_ptr<ReplacementData>
 TreePLRU::instantiateEntry()
 {
@@ -197,6 +197,43 @@ class TreePLRU : public Base
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
 
+    /**
+     * Number formed by the tree bits on the path from the root to the
+     * entry, each set when it points toward the entry. The victim has all
+     * of them set.
+     *
+     * @param replacement_data Replacement data of the entry.
+     * @return The age of the entry.
+     */
+    uint64_t age(const std::shared_ptr<ReplacementData>& replacement_data)
+                                                               const override;
+
+    /**
+     * Age of a leaf of a tree, as computed by age().
+     *
+     * @param tree The tree bits.
+     * @param index Index of the leaf in the tree.
+     * @return The age of the leaf.
+     */
+    static uint64_t
+    treeAge(const PLRUTree& tree, uint64_t index)
+    {
+        // Walk up from the leaf, the bits closer to the root weigh more
+        uint64_t age = 0;
+        unsigned depth = 0;
+        do {
+            // Right subtrees have even indices
+            const bool right = index % 2 == 0;
+            index = (index - 1) / 2;
+            if (tree[index] == right) {
+                age |= uint64_t(1) << depth;
+            }
+            depth++;
+        } while (index != 0);
+
+        return age;
+    }
+
     /**
      * Instantiate a replacement data entry. Consecutive calls to this
      * function use the same tree up to numLeaves. When numLeaves replacement
@@ -345,6 +345,15 @@ class BaseTags : public ClockedObject
      */
     virtual Addr regenerateBlkAddr(const CacheBlk* blk) const = 0;
 
+    /**
+     * Rank a block against the other blocks of its set. Blocks that would
+     * be evicted sooner have larger ages.
+     *
+     * @param blk The block.
+     * @return The replacement age of the block, 0 if the tags keep no order.
+     */
+    virtual uint64_t replacementAge(const CacheBlk *blk) const { return 0; }
+
     /**
      * Visit each block in the tags and apply a visitor
      *
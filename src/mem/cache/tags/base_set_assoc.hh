@@ -237,6 +237,11 @@ class BaseSetAssoc : public BaseTags
         return indexingPolicy->regenerateAddr(blk->getTag(), blk);
     }
 
+    uint64_t replacementAge(const CacheBlk *blk) const override
+    {
+        return replacementPolicy->age(blk->replacementData);
+    }
+
     void forEachBlk(std::function<void(CacheBlk &)> visitor) override {
         for (CacheBlk& blk : blks) {
             visitor(blk);
@@ -0,0 +1,51 @@
+#include "mem/cache/warm_trace.hh"
+
+#include <cstring>
+
+#include "base/logging.hh"
+#include "sim/byteswap.hh"
+
+namespace gem5
+{
+
+WarmTraceWriter::WarmTraceWriter(std::ostream &_os)
+    : os(_os)
+{
+    os.write(Magic, sizeof(Magic));
+}
+
+void
+WarmTraceWriter::append(const WarmRecord &rec)
+{
+    panic_if(rec.addr & WarmRecord::FlagMask,
+             "Warm trace address %#x is not block aligned.\n", rec.addr);
+    uint64_t word = htole(uint64_t(rec.addr | rec.flags));
+    os.write(reinterpret_cast<const char *>(&word), sizeof(word));
+    written++;
+}
+
+WarmTraceReader::WarmTraceReader(std::istream &_is)
+    : is(_is)
+{
+    char magic[sizeof(WarmTraceWriter::Magic)];
+    is.read(magic, sizeof(magic));
+    fatal_if(!is || std::memcmp(magic, WarmTraceWriter::Magic,
+                                sizeof(magic)) != 0,
+             "Not a warm cache trace.\n");
+}
+
+bool
+WarmTraceReader::next(WarmRecord &rec)
+{
+    uint64_t word;
+    if (!is.read(reinterpret_cast<char *>(&word), sizeof(word))) {
+        fatal_if(is.gcount() != 0, "Truncated warm cache trace.\n");
+        return false;
+    }
+    word = letoh(word);
+    rec.addr = word & ~WarmRecord::FlagMask;
+    rec.flags = word & WarmRecord::FlagMask;
+    return true;
+}
+
+} // namespace gem5
@@ -0,0 +1,70 @@
+#ifndef __MEM_CACHE_WARM_TRACE_HH__
+#define __MEM_CACHE_WARM_TRACE_HH__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/** One line held by a cache when its contents were recorded. */
+struct WarmRecord
+{
+    enum Flag : uint8_t
+    {
+        Secure = 1 << 0,
+        Writable = 1 << 1,
+        Dirty = 1 << 2,
+    };
+
+    /** Mask of the address bits that carry the flags in the file. */
+    static constexpr Addr FlagMask = 0x7;
+
+    Addr addr = 0;
+    uint8_t flags = 0;
+
+    bool is(Flag f) const { return flags & f; }
+};
+
+/**
+ * Writes the lines of a cache as 64-bit little-endian words after the
+ * 8-byte Magic. Lines are block aligned, so the flags are kept in the low
+ * address bits. Records are replayed in file order, so writers put the
+ * lines that should be evicted first at the front.
+ */
+class WarmTraceWriter
+{
+  public:
+    static constexpr char Magic[8] = {'X', 'S', 'W', 'A', 'R', 'M', 'C', '1'};
+
+    explicit WarmTraceWriter(std::ostream &os);
+
+    void append(const WarmRecord &rec);
+
+    uint64_t numRecords() const { return written; }
+
+  private:
+    std::ostream &os;
+    uint64_t written = 0;
+};
+
+/** Reads back the records of a WarmTraceWriter, in order. */
+class WarmTraceReader
+{
+  public:
+    /** Fails with fatal() if the stream is not a warm cache trace. */
+    explicit WarmTraceReader(std::istream &is);
+
+    /** @return false at the end of the trace. */
+    bool next(WarmRecord &rec);
+
+  private:
+    std::istream &is;
+};
+
+} // namespace gem5
+
+#endif // __MEM_CACHE_WARM_TRACE_HH__
@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "mem/cache/replacement_policies/tree_plru_rp.hh"
+#include "mem/cache/warm_trace.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+/** Tree PLRU bits of one set, indexed as in TreePLRU. */
+struct PLRUSet
+{
+    std::vector<bool> tree;
+    unsigned numWays;
+
+    explicit PLRUSet(unsigned num_ways)
+        : tree(num_ways - 1, false), numWays(num_ways)
+    {}
+
+    uint64_t leaf(unsigned way) const { return way + numWays - 1; }
+
+    /** Makes every bit on the path point away from the way. */
+    void
+    touch(unsigned way)
+    {
+        uint64_t index = leaf(way);
+        do {
+            const bool right = index % 2 == 0;
+            index = (index - 1) / 2;
+            tree[index] = !right;
+        } while (index != 0);
+    }
+
+    unsigned
+    victim() const
+    {
+        uint64_t index = 0;
+        while (index < tree.size())
+            index = tree[index] ? 2 * index + 2 : 2 * index + 1;
+        return index - (numWays - 1);
+    }
+
+    uint64_t
+    age(unsigned way) const
+    {
+        return replacement_policy::TreePLRU::treeAge(tree, leaf(way));
+    }
+};
+
+/** Line address of a way, distinct per set and way. */
+Addr
+lineAddr(unsigned set, unsigned way)
+{
+    return 0x80000000 + (Addr(way) << 20) + Addr(set) * 64;
+}
+
+} // anonymous namespace
+
+TEST(WarmTraceTest, RoundTrip)
+{
+    std::vector<WarmRecord> recs;
+    for (uint8_t flags = 0; flags <= WarmRecord::FlagMask; flags++) {
+        recs.push_back({Addr(flags) << 6, flags});
+        recs.push_back({0xfffffffffffffff8ULL - (Addr(flags) << 12), flags});
+    }
+
+    std::stringstream ss;
+    WarmTraceWriter writer(ss);
+    for (const auto &rec : recs)
+        writer.append(rec);
+    EXPECT_EQ(writer.numRecords(), recs.size());
+    EXPECT_EQ(ss.str().size(), 8 * (recs.size() + 1));
+
+    WarmTraceReader reader(ss);
+    WarmRecord rec;
+    for (const auto &expected : recs) {
+        ASSERT_TRUE(reader.next(rec));
+        EXPECT_EQ(rec.addr, expected.addr);
+        EXPECT_EQ(rec.flags, expected.flags);
+    }
+    EXPECT_FALSE(reader.next(rec));
+
+    // Flags read back individually
+    rec.flags = WarmRecord::Secure | WarmRecord::Dirty;
+    EXPECT_TRUE(rec.is(WarmRecord::Secure));
+    EXPECT_FALSE(rec.is(WarmRecord::Writable));
+    EXPECT_TRUE(rec.is(WarmRecord::Dirty));
+}
+
+TEST(WarmTraceTest, EmptyTrace)
+{
+    std::stringstream ss;
+    WarmTraceWriter writer(ss);
+    EXPECT_EQ(writer.numRecords(), 0);
+
+    WarmTraceReader reader(ss);
+    WarmRecord rec;
+    EXPECT_FALSE(reader.next(rec));
+}
+
+TEST(WarmTraceTest, RejectsBadTraces)
+{
+    std::stringstream not_a_trace("XSWARMC0");
+    ASSERT_ANY_THROW(WarmTraceReader reader(not_a_trace));
+
+    std::stringstream short_magic("XSW");
+    ASSERT_ANY_THROW(WarmTraceReader reader(short_magic));
+
+    std::stringstream ss;
+    WarmTraceWriter writer(ss);
+    writer.append({0x1000, WarmRecord::Writable});
+    std::stringstream truncated(ss.str().substr(0, ss.str().size() - 3));
+    WarmTraceReader reader(truncated);
+    WarmRecord rec;
+    ASSERT_ANY_THROW(reader.next(rec));
+
+    ASSERT_ANY_THROW(writer.append({0x1004, 0}));
+}
+
+/**
+ * Sets of a tree PLRU cache after random touches, recorded as BaseCache
+ * does: lines sorted by decreasing tree PLRU age. Reading the trace back
+ * must give the recorded lines, the first one of each set being its
+ * victim, and touching them in trace order must rebuild the same tree.
+ */
+TEST(WarmTraceTest, TreePLRUAgeOrder)
+{
+    constexpr unsigned numSets = 16;
+    std::mt19937_64 rng(1);
+
+    for (unsigned num_ways : {2, 4, 8, 16}) {
+        struct Line
+        {
+            uint64_t age;
+            WarmRecord rec;
+        };
+
+        std::vector<PLRUSet> sets(numSets, PLRUSet(num_ways));
+        std::stringstream ss;
+        WarmTraceWriter writer(ss);
+        for (unsigned s = 0; s < numSets; s++) {
+            for (int i = 0; i < 64; i++)
+                sets[s].touch(rng() % num_ways);
+
+            std::vector<Line> lines;
+            for (unsigned way = 0; way < num_ways; way++) {
+                lines.push_back({sets[s].age(way),
+                                 {lineAddr(s, way), uint8_t(rng() % 8)}});
+            }
+            std::stable_sort(lines.begin(), lines.end(),
+                             [](const Line &a, const Line &b) {
+                                 return a.age > b.age;
+                             });
+
+            // Ages rank the ways, the victim has all its path bits set
+            for (unsigned i = 1; i < num_ways; i++)
+                ASSERT_GT(lines[i - 1].age, lines[i].age);
+            ASSERT_EQ(lines[0].age, num_ways - 1);
+
+            for (const auto &line : lines)
+                writer.append(line.rec);
+        }
+
+        std::vector<PLRUSet> replayed(numSets, PLRUSet(num_ways));
+        WarmTraceReader reader(ss);
+        WarmRecord rec;
+        for (unsigned s = 0; s < numSets; s++) {
+            for (unsigned i = 0; i < num_ways; i++) {
+                ASSERT_TRUE(reader.next(rec));
+                ASSERT_EQ((rec.addr & 0xfffff) / 64, s);
+                const unsigned way = (rec.addr - 0x80000000) >> 20;
+                if (i == 0) {
+                    ASSERT_EQ(way, sets[s].victim());
+                }
+                replayed[s].touch(way);
+            }
+            EXPECT_EQ(replayed[s].tree, sets[s].tree) << "set " << s;
+        }
+        EXPECT_FALSE(reader.next(rec));
+    }
+}
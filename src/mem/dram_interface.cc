@@ -59,116 +59,105 @@ namespace memory
 std::pair<MemPacketQueue::iterator, Tick>
 DRAMInterface::chooseNextFRFCFS(MemPacketQueue& queue, Tick min_col_at) const
 {
-    std::vector<uint32_t> earliest_banks(ranksPerChannel, 0);
+    // This takes the decision of a first-come first-served scan over the
+    // queue, but from the per-bank indexes of the queue:
+    //  - the oldest row hit that can issue seamlessly wins outright;
+    //  - else the oldest packet to one of the earliest banks found by
+    //    minBankPrep, if its bank preparation can be hidden or there is
+    //    no row hit;
+    //  - else the oldest row hit.
+    // Packets of ranks that are refreshing are never selected.
+    MemPacket *seamless_pkt = nullptr;
+    Tick seamless_col_at = MaxTick;
+    MemPacket *prepped_pkt = nullptr;
+    Tick prepped_col_at = MaxTick;
+    bool found_miss = false;
+
+    for (const auto &[key, bank_queue] : queue.banks()) {
+        if (bank_queue.pkts.empty())
+            continue;
+        MemPacket *first = bank_queue.pkts.front();
+        if (first->pseudoChannel != pseudoChannel || !burstReady(first))
+            continue;
 
-    // Has minBankPrep been called to populate earliest_banks?
-    bool filled_earliest_banks = false;
-    // can the PRE/ACT sequence be done without impacting utlization?
-    bool hidden_bank_prep = false;
+        const Bank& bank = ranks[first->rank]->banks[first->bank];
+        auto hits = bank.openRow == Bank::NO_ROW ? bank_queue.rows.end() :
+            bank_queue.rows.find(bank.openRow);
+        if (hits == bank_queue.rows.end() ||
+            hits->second.size() < bank_queue.pkts.size()) {
+            found_miss = true;
+        }
+        if (hits == bank_queue.rows.end())
+            continue;
 
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
-    // Will select closed rows first to enable more open row possibilies
-    // in future selections
-    bool found_hidden_bank = false;
-
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
-
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
-
-    Tick selected_col_at = MaxTick;
-    auto selected_pkt_it = queue.end();
-
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        MemPacket* pkt = *i;
-
-        // select optimal DRAM packet in Q
-        if (pkt->isDram() && (pkt->pseudoChannel == pseudoChannel)) {
-            const Bank& bank = ranks[pkt->rank]->banks[pkt->bank];
-            const Tick col_allowed_at = pkt->isRead() ? bank.rdAllowedAt :
-                                                        bank.wrAllowedAt;
-
-            DPRINTF(DRAM, "%s checking DRAM packet in bank %d, row %d\n",
-                    __func__, pkt->bank, pkt->row);
-
-            // check if rank is not doing a refresh and thus is available,
-            // if not, jump to the next packet
-            if (burstReady(pkt)) {
-
-                DPRINTF(DRAM,
-                        "%s bank %d - Rank %d available\n", __func__,
-                        pkt->bank, pkt->rank);
-
-                // check if it is a row hit
-                if (bank.openRow == pkt->row) {
-                    // no additional rank-to-rank or same bank-group
-                    // delays, or we switched read/write and might as well
-                    // go for the row hit
-                    if (col_allowed_at <= min_col_at) {
-                        // FCFS within the hits, giving priority to
-                        // commands that can issue seamlessly, without
-                        // additional delay, such as same rank accesses
-                        // and/or different bank-group accesses
-                        DPRINTF(DRAM, "%s Seamless buffer hit\n", __func__);
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        // no need to look through the remaining queue entries
-                        break;
-                    } else if (!found_hidden_bank && !found_prepped_pkt) {
-                        // if we did not find a packet to a closed row that can
-                        // issue the bank commands without incurring delay, and
-                        // did not yet find a packet to a prepped row, remember
-                        // the current one
-                        selected_pkt_it = i;
-                        selected_col_at = col_allowed_at;
-                        found_prepped_pkt = true;
-                        DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
-                    }
-                } else if (!found_earliest_pkt) {
-                    // if we have not initialised the bank status, do it
-                    // now, and only once per scheduling decisions
-                    if (!filled_earliest_banks) {
-                        // determine entries with earliest bank delay
-                        std::tie(earliest_banks, hidden_bank_prep) =
-                            minBankPrep(queue, min_col_at);
-                        filled_earliest_banks = true;
-                    }
+        MemPacket *pkt = hits->second.front();
+        const Tick col_allowed_at = pkt->isRead() ? bank.rdAllowedAt :
+                                                    bank.wrAllowedAt;
+        if (col_allowed_at <= min_col_at) {
+            if (!seamless_pkt || pkt->queueSeq < seamless_pkt->queueSeq) {
+                seamless_pkt = pkt;
+                seamless_col_at = col_allowed_at;
+            }
+        } else if (!prepped_pkt || pkt->queueSeq < prepped_pkt->queueSeq) {
+            prepped_pkt = pkt;
+            prepped_col_at = col_allowed_at;
+        }
+    }
 
-                    // bank is amongst first available banks
-                    // minBankPrep will give priority to packets that can
-                    // issue seamlessly
-                    if (bits(earliest_banks[pkt->rank],
-                             pkt->bank, pkt->bank)) {
-                        found_earliest_pkt = true;
-                        found_hidden_bank = hidden_bank_prep;
-
-                        // give priority to packets that can issue
-                        // bank commands 'behind the scenes'
-                        // any additional delay if any will be due to
-                        // col-to-col command requirements
-                        if (hidden_bank_prep || !found_prepped_pkt) {
-                            selected_pkt_it = i;
-                            selected_col_at = col_allowed_at;
-                        }
-                    }
+    if (seamless_pkt) {
+        DPRINTF(DRAM, "%s Seamless buffer hit in bank %d, row %d\n",
+                __func__, seamless_pkt->bank, seamless_pkt->row);
+        return std::make_pair(queue.find(seamless_pkt), seamless_col_at);
+    }
+
+    // the oldest packet to a closed row among the earliest banks
+    MemPacket *earliest_pkt = nullptr;
+    Tick earliest_col_at = MaxTick;
+    bool hidden_bank_prep = false;
+    if (found_miss) {
+        std::vector<uint32_t> earliest_banks;
+        std::tie(earliest_banks, hidden_bank_prep) =
+            minBankPrep(queue, min_col_at);
+
+        for (const auto &[key, bank_queue] : queue.banks()) {
+            if (bank_queue.pkts.empty())
+                continue;
+            MemPacket *first = bank_queue.pkts.front();
+            if (first->pseudoChannel != pseudoChannel ||
+                !burstReady(first) ||
+                !bits(earliest_banks[first->rank], first->bank, first->bank))
+                continue;
+
+            const Bank& bank = ranks[first->rank]->banks[first->bank];
+            for (MemPacket *pkt : bank_queue.pkts) {
+                if (bank.openRow == pkt->row)
+                    continue;
+                if (!earliest_pkt || pkt->queueSeq < earliest_pkt->queueSeq) {
+                    earliest_pkt = pkt;
+                    earliest_col_at = pkt->isRead() ? bank.rdAllowedAt :
+                                                      bank.wrAllowedAt;
                 }
-            } else {
-                DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
-                        pkt->bank, pkt->rank);
+                break;
             }
         }
     }
 
-    if (selected_pkt_it == queue.end()) {
-        DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+    // give priority to packets that can issue bank commands 'behind the
+    // scenes', any additional delay if any will be due to col-to-col
+    // command requirements
+    if (earliest_pkt && (hidden_bank_prep || !prepped_pkt)) {
+        DPRINTF(DRAM, "%s Earliest bank %d, row %d\n", __func__,
+                earliest_pkt->bank, earliest_pkt->row);
+        return std::make_pair(queue.find(earliest_pkt), earliest_col_at);
+    }
+    if (prepped_pkt) {
+        DPRINTF(DRAM, "%s Prepped row buffer hit in bank %d, row %d\n",
+                __func__, prepped_pkt->bank, prepped_pkt->row);
+        return std::make_pair(queue.find(prepped_pkt), prepped_col_at);
     }
 
-    return std::make_pair(selected_pkt_it, selected_col_at);
+    DPRINTF(DRAM, "%s no available DRAM ranks found\n", __func__);
+    return std::make_pair(queue.end(), MaxTick);
 }
 
 void
@@ -1041,10 +1030,13 @@ DRAMInterface::minBankPrep(const MemPacketQueue& queue,
     // determine if we have queued transactions targetting the
     // bank in question
     std::vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
+    for (const auto &[key, bank_queue] : queue.banks()) {
+        if (bank_queue.pkts.empty())
+            continue;
+        const MemPacket *p = bank_queue.pkts.front();
         if (p->pseudoChannel != pseudoChannel)
             continue;
-        if (p->isDram() && ranks[p->rank]->inRefIdleState())
+        if (ranks[p->rank]->inRefIdleState())
             got_waiting[p->bankId] = true;
     }
 
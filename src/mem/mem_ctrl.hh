@@ -46,12 +46,15 @@
 #ifndef __MEM_CTRL_HH__
 #define __MEM_CTRL_HH__
 
+#include <algorithm>
 #include <deque>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "base/block_pool.hh"
 #include "base/callback.hh"
 #include "base/statistics.hh"
 #include "enums/MemSched.hh"
@@ -213,11 +216,109 @@ class MemPacket
           burstHelper(NULL), _qosValue(_pkt->qosValue())
     { }
 
+    /** Arrival order in the MemPacketQueue holding the packet. */
+    uint64_t queueSeq = 0;
+
+    /** One MemPacket per burst is created, so recycle them. */
+    static void *
+    operator new(size_t size)
+    {
+        assert(size == sizeof(MemPacket));
+        return BlockPool<sizeof(MemPacket)>::alloc();
+    }
+
+    static void
+    operator delete(void *p)
+    {
+        BlockPool<sizeof(MemPacket)>::free(p);
+    }
 };
 
-// The memory packets are store in a multiple dequeue structure,
-// based on their QoS priority
-typedef std::deque<MemPacket*> MemPacketQueue;
+/**
+ * The memory packets of one QoS priority, in arrival order. The DRAM
+ * packets are also indexed by bank and by row, so the scheduler can find
+ * the oldest row hit of each bank without scanning the whole queue.
+ */
+class MemPacketQueue
+{
+  public:
+    typedef std::deque<MemPacket*>::iterator iterator;
+    typedef std::deque<MemPacket*>::const_iterator const_iterator;
+
+    /** The DRAM packets of one bank, oldest first. */
+    struct BankQueue
+    {
+        std::vector<MemPacket*> pkts;
+        std::unordered_map<uint32_t, std::vector<MemPacket*>> rows;
+    };
+    /** Banks by bankKey(); a bank stays once it has been used. */
+    typedef std::unordered_map<uint32_t, BankQueue> BankMap;
+
+    static uint32_t
+    bankKey(const MemPacket *pkt)
+    {
+        return (uint32_t(pkt->pseudoChannel) << 16) | pkt->bankId;
+    }
+
+    iterator begin() { return pkts.begin(); }
+    iterator end() { return pkts.end(); }
+    const_iterator begin() const { return pkts.begin(); }
+    const_iterator end() const { return pkts.end(); }
+    size_t size() const { return pkts.size(); }
+    bool empty() const { return pkts.empty(); }
+    MemPacket *front() const { return pkts.front(); }
+
+    void
+    push_back(MemPacket *pkt)
+    {
+        pkt->queueSeq = nextSeq++;
+        pkts.push_back(pkt);
+        if (pkt->isDram()) {
+            BankQueue &bank = banksByKey[bankKey(pkt)];
+            bank.pkts.push_back(pkt);
+            bank.rows[pkt->row].push_back(pkt);
+        }
+    }
+
+    iterator
+    erase(iterator it)
+    {
+        MemPacket *pkt = *it;
+        if (pkt->isDram()) {
+            BankQueue &bank = banksByKey[bankKey(pkt)];
+            removeFrom(bank.pkts, pkt);
+            auto row = bank.rows.find(pkt->row);
+            removeFrom(row->second, pkt);
+            if (row->second.empty())
+                bank.rows.erase(row);
+        }
+        return pkts.erase(it);
+    }
+
+    /** @return the position of pkt, which must be queued. */
+    iterator
+    find(const MemPacket *pkt)
+    {
+        auto it = std::find(pkts.begin(), pkts.end(), pkt);
+        assert(it != pkts.end());
+        return it;
+    }
+
+    const BankMap &banks() const { return banksByKey; }
+
+  private:
+    static void
+    removeFrom(std::vector<MemPacket*> &list, const MemPacket *pkt)
+    {
+        auto it = std::find(list.begin(), list.end(), pkt);
+        assert(it != list.end());
+        list.erase(it);
+    }
+
+    std::deque<MemPacket*> pkts;
+    BankMap banksByKey;
+    uint64_t nextSeq = 0;
+};
 
 
 /**
@@ -297,14 +398,14 @@ class MemCtrl : public qos::MemCtrl
      * in these methods
      */
     virtual void processNextReqEvent(MemInterface* mem_intr,
-                          MemPacketQueue& resp_queue,
+                          std::deque<MemPacket*>& resp_queue,
                           EventFunctionWrapper& resp_event,
                           EventFunctionWrapper& next_req_event,
                           bool& retry_wr_req);
     EventFunctionWrapper nextReqEvent;
 
     virtual void processRespondEvent(MemInterface* mem_intr,
-                        MemPacketQueue& queue,
+                        std::deque<MemPacket*>& queue,
                         EventFunctionWrapper& resp_event,
                         bool& retry_rd_req);
     EventFunctionWrapper respondEvent;
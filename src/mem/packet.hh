@@ -53,6 +53,7 @@
 #include <list>
 
 #include "base/addr_range.hh"
+#include "base/block_pool.hh"
 #include "base/cast.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
@@ -353,6 +354,9 @@ class Packet : public Printable
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The dynamic data came from the per-thread pool of
+        /// PoolDataBytes buffers rather than new [].
+        POOLED_DATA            = 0x00004000,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -1098,6 +1102,28 @@ class Packet : public Printable
         deleteData();
     }
 
+    /**
+     * Packets are recycled through a per-thread pool, so the many
+     * short-lived packets of misses, prefetches and snoops do not each
+     * go through the heap.
+     */
+    static void *
+    operator new(size_t size)
+    {
+        if (size == sizeof(Packet))
+            return BlockPool<sizeof(Packet)>::alloc();
+        return ::operator new(size);
+    }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        if (size == sizeof(Packet))
+            BlockPool<sizeof(Packet)>::free(p);
+        else
+            ::operator delete(p);
+    }
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -1405,13 +1431,18 @@ class Packet : public Printable
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(POOLED_DATA))
+            BlockPool<PoolDataBytes>::free(data);
+        else if (flags.isSet(DYNAMIC_DATA))
             delete [] data;
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|POOLED_DATA);
         data = NULL;
     }
 
+    /** Payloads up to this size are allocated from a per-thread pool. */
+    static constexpr unsigned PoolDataBytes = 64;
+
     /** Allocate memory for the packet. */
     void
     allocate()
@@ -1421,7 +1452,13 @@ class Packet : public Printable
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
             flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            if (getSize() <= PoolDataBytes) {
+                flags.set(POOLED_DATA);
+                data = static_cast<uint8_t *>(
+                    BlockPool<PoolDataBytes>::alloc());
+            } else {
+                data = new uint8_t[getSize()];
+            }
         }
     }
 
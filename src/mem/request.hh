@@ -57,6 +57,7 @@
 #include <vector>
 
 #include "base/amo.hh"
+#include "base/block_pool.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
 #include "base/types.hh"
@@ -1333,6 +1334,20 @@ class Request
     void setFirstReqAfterSquash() { firstReqAfterSquash = true; }
 };
 
+/**
+ * Create a Request like std::make_shared, but with the request and its
+ * reference count in one block from a per-thread pool. Meant for the
+ * requests the memory system creates on its own for every miss,
+ * prefetch and writeback.
+ */
+template <typename... Args>
+RequestPtr
+makeRequest(Args&&... args)
+{
+    return std::allocate_shared<Request>(PoolAllocator<Request>(),
+                                         std::forward<Args>(args)...);
+}
+
 } // namespace gem5
 
 #endif // __MEM_REQUEST_HH__
@@ -0,0 +1,186 @@
+#ifndef __MEM_RUBY_COMMON_FLATADDRMAP_HH__
+#define __MEM_RUBY_COMMON_FLATADDRMAP_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "mem/ruby/common/Address.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+// Hash map from addresses to values kept in one array with linear probing,
+// so lookups touch a single cache line in the common case and insertions
+// do not allocate once the table has grown to its working size. Erasing
+// shifts the following entries back instead of leaving tombstones.
+//
+// Iteration order depends on the hash. Users that need a deterministic
+// order, e.g. to replay messages, should walk sortedKeys().
+//
+// Pointers and references to values are invalidated by inserting a new
+// key and by erase().
+template<typename V>
+class FlatAddrMap
+{
+  public:
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_t count(Addr addr) const { return findSlot(addr) >= 0 ? 1 : 0; }
+
+    V *
+    find(Addr addr)
+    {
+        int slot = findSlot(addr);
+        return slot >= 0 ? &m_slots[slot].value : nullptr;
+    }
+
+    const V *
+    find(Addr addr) const
+    {
+        int slot = findSlot(addr);
+        return slot >= 0 ? &m_slots[slot].value : nullptr;
+    }
+
+    // Returns the value of addr, default constructed if it was not present
+    V &
+    operator[](Addr addr)
+    {
+        if ((m_size + 1) * 2 > m_slots.size())
+            grow();
+        size_t slot = home(addr);
+        while (m_slots[slot].used) {
+            if (m_slots[slot].addr == addr)
+                return m_slots[slot].value;
+            slot = (slot + 1) & m_mask;
+        }
+        m_slots[slot].used = true;
+        m_slots[slot].addr = addr;
+        ++m_size;
+        return m_slots[slot].value;
+    }
+
+    // Returns the number of removed entries
+    size_t
+    erase(Addr addr)
+    {
+        int found = findSlot(addr);
+        if (found < 0)
+            return 0;
+
+        size_t hole = found;
+        size_t next = hole;
+        while (true) {
+            next = (next + 1) & m_mask;
+            if (!m_slots[next].used)
+                break;
+            // Move the entry back if the hole lies between its home slot
+            // and its current slot, cyclically
+            size_t h = home(m_slots[next].addr);
+            if (((next - h) & m_mask) >= ((next - hole) & m_mask)) {
+                m_slots[hole] = std::move(m_slots[next]);
+                hole = next;
+            }
+        }
+        m_slots[hole] = Slot();
+        --m_size;
+        return 1;
+    }
+
+    void
+    clear()
+    {
+        for (auto &slot : m_slots) {
+            if (slot.used)
+                slot = Slot();
+        }
+        m_size = 0;
+    }
+
+    // Calls f(addr, value) for every entry, in hash order
+    template<typename F>
+    void
+    forEach(F f)
+    {
+        for (auto &slot : m_slots) {
+            if (slot.used)
+                f(slot.addr, slot.value);
+        }
+    }
+
+    std::vector<Addr>
+    sortedKeys() const
+    {
+        std::vector<Addr> keys;
+        keys.reserve(m_size);
+        for (const auto &slot : m_slots) {
+            if (slot.used)
+                keys.push_back(slot.addr);
+        }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+  private:
+    struct Slot
+    {
+        Addr addr = 0;
+        bool used = false;
+        V value = V();
+    };
+
+    size_t
+    home(Addr addr) const
+    {
+        // Fibonacci hashing spreads line-aligned addresses over the table
+        return (addr * 0x9E3779B97F4A7C15ULL) >> m_shift;
+    }
+
+    int
+    findSlot(Addr addr) const
+    {
+        if (m_size == 0)
+            return -1;
+        size_t slot = home(addr);
+        while (m_slots[slot].used) {
+            if (m_slots[slot].addr == addr)
+                return slot;
+            slot = (slot + 1) & m_mask;
+        }
+        return -1;
+    }
+
+    void
+    grow()
+    {
+        std::vector<Slot> old(std::max<size_t>(m_slots.size() * 2,
+                                               InitialSlots));
+        old.swap(m_slots);
+        m_mask = m_slots.size() - 1;
+        m_shift = 64;
+        for (size_t n = m_slots.size(); n > 1; n >>= 1)
+            --m_shift;
+        m_size = 0;
+        for (auto &slot : old) {
+            if (slot.used)
+                (*this)[slot.addr] = std::move(slot.value);
+        }
+    }
+
+    static constexpr size_t InitialSlots = 16;
+
+    std::vector<Slot> m_slots;
+    size_t m_mask = 0;
+    unsigned m_shift = 64;
+    size_t m_size = 0;
+};
+
+} // namespace ruby
+} // namespace gem5
+
+#endif // __MEM_RUBY_COMMON_FLATADDRMAP_HH__
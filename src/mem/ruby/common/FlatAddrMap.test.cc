@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "mem/ruby/common/FlatAddrMap.hh"
+
+using namespace gem5;
+using namespace gem5::ruby;
+
+namespace
+{
+
+/** Home slot of addr in a table of 2^bits slots, as FlatAddrMap hashes. */
+size_t
+homeSlot(Addr addr, unsigned bits)
+{
+    return (addr * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+}
+
+/** @return n line addresses whose home is slot in a 16-slot table. */
+std::vector<Addr>
+keysAtHome(size_t slot, int n)
+{
+    std::vector<Addr> keys;
+    for (Addr addr = 0; keys.size() < n; addr += 64) {
+        if (homeSlot(addr, 4) == slot)
+            keys.push_back(addr);
+    }
+    return keys;
+}
+
+void
+expectSame(const FlatAddrMap<int> &map, const std::map<Addr, int> &ref)
+{
+    ASSERT_EQ(map.size(), ref.size());
+    std::vector<Addr> keys;
+    for (const auto &[addr, value] : ref) {
+        keys.push_back(addr);
+        const int *found = map.find(addr);
+        ASSERT_NE(found, nullptr) << std::hex << addr;
+        EXPECT_EQ(*found, value) << std::hex << addr;
+    }
+    EXPECT_EQ(map.sortedKeys(), keys);
+}
+
+} // anonymous namespace
+
+TEST(FlatAddrMapTest, InsertFindErase)
+{
+    FlatAddrMap<int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(0x40), nullptr);
+
+    map[0x40] = 1;
+    map[0x80] = 2;
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.count(0x40), 1);
+    EXPECT_EQ(*map.find(0x80), 2);
+    EXPECT_EQ(map.count(0xc0), 0);
+
+    EXPECT_EQ(map.erase(0x40), 1);
+    EXPECT_EQ(map.erase(0x40), 0);
+    EXPECT_EQ(map.find(0x40), nullptr);
+    EXPECT_EQ(*map.find(0x80), 2);
+
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.find(0x80), nullptr);
+}
+
+/**
+ * Keys sharing the last slot as home wrap around to slot 0 and on. Erasing
+ * any of them must shift the rest back over the end of the table, without
+ * moving an entry in front of its home.
+ */
+TEST(FlatAddrMapTest, CollisionsAcrossWrap)
+{
+    std::vector<Addr> last = keysAtHome(15, 4);
+    std::vector<Addr> first = keysAtHome(0, 2);
+    // Home-0 keys behind wrapped home-15 keys, and home-0 keys that must
+    // stay put while a later home-15 key moves over them
+    std::vector<std::vector<Addr>> orders = {
+        {last[0], last[1], first[0], last[2], first[1], last[3]},
+        {last[0], first[0], first[1], last[1], last[2], last[3]},
+    };
+
+    for (const auto &order : orders) {
+        for (int victim = 0; victim < 6; victim++) {
+            FlatAddrMap<int> map;
+            std::map<Addr, int> ref;
+            int value = 0;
+            for (Addr addr : order)
+                map[addr] = ref[addr] = ++value;
+            expectSame(map, ref);
+
+            Addr addr = victim < 4 ? last[victim] : first[victim - 4];
+            EXPECT_EQ(map.erase(addr), 1);
+            ref.erase(addr);
+            expectSame(map, ref);
+
+            // Refilling the hole must not duplicate a key
+            map[addr] = ref[addr] = 100;
+            expectSame(map, ref);
+        }
+    }
+}
+
+TEST(FlatAddrMapTest, RandomAgainstStdMap)
+{
+    std::mt19937_64 rng(1);
+    for (unsigned universe : {8, 64, 1024}) {
+        FlatAddrMap<int> map;
+        std::map<Addr, int> ref;
+        // Few distinct line addresses give long probe chains, the table
+        // grows and shrinks its load as keys come and go
+        std::uniform_int_distribution<unsigned> key(0, universe - 1);
+        for (int step = 0; step < 20000; step++) {
+            Addr addr = Addr(key(rng)) * 64;
+            switch (rng() % 4) {
+              case 0:
+              case 1:
+                map[addr] = ref[addr] = step;
+                break;
+              case 2:
+                ASSERT_EQ(map.erase(addr), ref.erase(addr));
+                break;
+              default: {
+                const int *found = map.find(addr);
+                auto it = ref.find(addr);
+                ASSERT_EQ(found != nullptr, it != ref.end());
+                if (found) {
+                    ASSERT_EQ(*found, it->second);
+                }
+              }
+            }
+            ASSERT_EQ(map.size(), ref.size());
+            if (step % 1000 == 0)
+                expectSame(map, ref);
+        }
+        expectSame(map, ref);
+
+        int visited = 0;
+        map.forEach([&](Addr addr, int &value) {
+            EXPECT_EQ(ref.at(addr), value);
+            visited++;
+        });
+        EXPECT_EQ(visited, ref.size());
+    }
+}
@@ -98,6 +98,9 @@ MessageBuffer::MessageBuffer(const Params &p)
     m_input_link_id = 0;
     m_vnet_id = 0;
 
+    m_cross_partition = false;
+    m_cross_partition_occupancy = 0;
+
     m_buf_msgs = 0;
     m_stall_time = 0;
 
@@ -161,7 +164,12 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
     unsigned int current_size = 0;
     unsigned int current_stall_size = 0;
 
-    if (m_time_last_time_pop < current_time) {
+    if (m_cross_partition) {
+        // the consumer may be running concurrently, so only count what
+        // it held at the last quantum boundary plus what was sent since
+        current_size = m_cross_partition_occupancy +
+                       m_cross_partition_msgs.size();
+    } else if (m_time_last_time_pop < current_time) {
         // no pops this cycle - heap and stall queue size is correct
         current_size = m_prio_heap.size();
         current_stall_size = m_stall_map_size;
@@ -283,6 +291,13 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta,
     msg_ptr->setLastEnqueueTime(arrival_time);
     msg_ptr->setMsgCounter(m_msg_counter);
 
+    if (m_cross_partition) {
+        DPRINTF(RubyQueue, "Enqueue across partitions arrival_time: %lld, "
+                "Message: %s\n", arrival_time, *(message.get()));
+        m_cross_partition_msgs.push_back(message);
+        return;
+    }
+
     // Insert the message into the priority heap
     m_prio_heap.push_back(message);
     push_heap(m_prio_heap.begin(), m_prio_heap.end(), std::greater<MsgPtr>());
@@ -301,6 +316,31 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta,
     m_consumer->storeEventInfo(m_vnet_id);
 }
 
+void
+MessageBuffer::deliverCrossPartition(Tick current_time)
+{
+    for (MsgPtr &message : m_cross_partition_msgs) {
+        Tick arrival_time = message->getLastEnqueueTime();
+        panic_if(arrival_time < current_time,
+                 "%s: message arrives at %d, before the quantum boundary "
+                 "at %d. The quantum must not exceed the latency of links "
+                 "between partitions.", name(), arrival_time, current_time);
+
+        m_prio_heap.push_back(message);
+        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
+                  std::greater<MsgPtr>());
+        m_buf_msgs++;
+
+        assert(m_consumer != NULL);
+        m_consumer->scheduleEventAbsolute(arrival_time);
+        m_consumer->storeEventInfo(m_vnet_id);
+    }
+    m_cross_partition_msgs.clear();
+    m_cross_partition_occupancy = m_prio_heap.size() + m_stall_map_size;
+
+    assert((m_max_size == 0) || (m_cross_partition_occupancy <= m_max_size));
+}
+
 Tick
 MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
 {
@@ -412,10 +452,9 @@ MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
 }
 
 void
-MessageBuffer::reanalyzeList(std::list<MsgPtr> &lt, Tick schdTick)
+MessageBuffer::reanalyzeList(std::vector<MsgPtr> &lt, Tick schdTick)
 {
-    while (!lt.empty()) {
-        MsgPtr m = lt.front();
+    for (MsgPtr &m : lt) {
         assert(m->getLastEnqueueTime() <= schdTick);
 
         m_prio_heap.push_back(m);
@@ -426,16 +465,16 @@ MessageBuffer::reanalyzeList(std::list<MsgPtr> &lt, Tick schdTick)
 
         DPRINTF(RubyQueue, "Requeue arrival_time: %lld, Message: %s\n",
             schdTick, *(m.get()));
-
-        lt.pop_front();
     }
+    lt.clear();
 }
 
 void
 MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
 {
     DPRINTF(RubyQueue, "ReanalyzeMessages %#x\n", addr);
-    assert(m_stall_msg_map.count(addr) > 0);
+    std::vector<MsgPtr> *stalled = m_stall_msg_map.find(addr);
+    assert(stalled);
 
     //
     // Put all stalled messages associated with this address back on the
@@ -443,9 +482,9 @@ MessageBuffer::reanalyzeMessages(Addr addr, Tick current_time)
     // scheduled for the current cycle so that the previously stalled messages
     // will be observed before any younger messages that may arrive this cycle
     //
-    m_stall_map_size -= m_stall_msg_map[addr].size();
+    m_stall_map_size -= stalled->size();
     assert(m_stall_map_size >= 0);
-    reanalyzeList(m_stall_msg_map[addr], current_time);
+    reanalyzeList(*stalled, current_time);
     m_stall_msg_map.erase(addr);
 }
 
@@ -460,11 +499,11 @@ MessageBuffer::reanalyzeAllMessages(Tick current_time)
     // scheduled for the current cycle so that the previously stalled messages
     // will be observed before any younger messages that may arrive this cycle.
     //
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end(); ++map_iter) {
-        m_stall_map_size -= map_iter->second.size();
+    for (Addr addr : m_stall_msg_map.sortedKeys()) {
+        std::vector<MsgPtr> &stalled = *m_stall_msg_map.find(addr);
+        m_stall_map_size -= stalled.size();
         assert(m_stall_map_size >= 0);
-        reanalyzeList(map_iter->second, current_time);
+        reanalyzeList(stalled, current_time);
     }
     m_stall_msg_map.clear();
 }
@@ -509,7 +548,7 @@ void
 MessageBuffer::enqueueDeferredMessages(Addr addr, Tick curTime, Tick delay)
 {
     assert(!isDeferredMsgMapEmpty(addr));
-    std::vector<MsgPtr>& msg_vec = m_deferred_msg_map[addr];
+    std::vector<MsgPtr>& msg_vec = *m_deferred_msg_map.find(addr);
     assert(msg_vec.size() > 0);
 
     // enqueue all deferred messages associated with this address
@@ -598,16 +637,22 @@ MessageBuffer::functionalAccess(Packet *pkt, bool is_read, WriteMask *mask)
             num_functional_accesses++;
     }
 
+    // Messages held back until the next quantum boundary
+    for (const MsgPtr &pending : m_cross_partition_msgs) {
+        Message *msg = pending.get();
+        if (is_read && !mask && msg->functionalRead(pkt))
+            return 1;
+        else if (is_read && mask && msg->functionalRead(pkt, *mask))
+            num_functional_accesses++;
+        else if (!is_read && msg->functionalWrite(pkt))
+            num_functional_accesses++;
+    }
+
     // Check the stall queue and write any messages that may
     // correspond to the address in the packet.
-    for (StallMsgMapType::iterator map_iter = m_stall_msg_map.begin();
-         map_iter != m_stall_msg_map.end();
-         ++map_iter) {
-
-        for (std::list<MsgPtr>::iterator it = (map_iter->second).begin();
-            it != (map_iter->second).end(); ++it) {
-
-            Message *msg = (*it).get();
+    for (Addr addr : m_stall_msg_map.sortedKeys()) {
+        for (const MsgPtr &stalled : *m_stall_msg_map.find(addr)) {
+            Message *msg = stalled.get();
             if (is_read && !mask && msg->functionalRead(pkt))
                 return 1;
             else if (is_read && mask && msg->functionalRead(pkt, *mask))
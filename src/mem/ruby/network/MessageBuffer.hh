@@ -60,6 +60,7 @@
 #include "mem/port.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/common/FlatAddrMap.hh"
 #include "mem/ruby/network/dummy_port.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 #include "params/MessageBuffer.hh"
@@ -152,6 +153,21 @@ class MessageBuffer : public SimObject
     bool hasPrefetchRequest(Addr addr);
 
     void recycle(Tick current_time, Tick recycle_latency);
+
+    /**
+     * Make this buffer a link between two Ruby partitions, whose sender
+     * and consumer may run on different event queues. Enqueued messages
+     * are then held on the sender side until deliverCrossPartition(),
+     * which the network calls at every quantum boundary, and the sender
+     * only sees the occupancy of the last boundary.
+     */
+    void setCrossPartition() { m_cross_partition = true; }
+    bool isCrossPartition() const { return m_cross_partition; }
+
+    //! Hands the messages enqueued since the last quantum boundary to
+    //! the consumer. Must not run concurrently with the sender.
+    void deliverCrossPartition(Tick current_time);
+
     bool isEmpty() const { return m_prio_heap.size() == 0; }
     bool isStallMapEmpty() { return m_stall_msg_map.size() == 0; }
     unsigned int getStallMapSize() { return m_stall_msg_map.size(); }
@@ -200,7 +216,7 @@ class MessageBuffer : public SimObject
     int routingPriority() const { return m_routing_priority; }
 
   private:
-    void reanalyzeList(std::list<MsgPtr> &, Tick);
+    void reanalyzeList(std::vector<MsgPtr> &, Tick);
 
     uint32_t functionalAccess(Packet *pkt, bool is_read, WriteMask *mask);
 
@@ -212,9 +228,9 @@ class MessageBuffer : public SimObject
 
     std::function<void()> m_dequeue_callback;
 
-    // use a std::map for the stalled messages as this container is
-    // sorted and ensures a well-defined iteration order
-    typedef std::map<Addr, std::list<MsgPtr> > StallMsgMapType;
+    // the stall map is hashed, walks over all of it go through its
+    // sorted keys to keep a well-defined iteration order
+    typedef FlatAddrMap<std::vector<MsgPtr>> StallMsgMapType;
 
     /**
      * A map from line addresses to lists of stalled messages for that line.
@@ -236,7 +252,7 @@ class MessageBuffer : public SimObject
      * are deferred for enqueueing. Messages in this map are waiting to be
      * enqueued into the message buffer.
      */
-    typedef std::unordered_map<Addr, std::vector<MsgPtr>> DeferredMsgMapType;
+    typedef FlatAddrMap<std::vector<MsgPtr>> DeferredMsgMapType;
     DeferredMsgMapType m_deferred_msg_map;
 
     /**
@@ -290,6 +306,12 @@ class MessageBuffer : public SimObject
     int m_input_link_id;
     int m_vnet_id;
 
+    bool m_cross_partition;
+    //! Messages enqueued since the last quantum boundary, in order
+    std::vector<MsgPtr> m_cross_partition_msgs;
+    //! Heap and stall map size at the last quantum boundary
+    unsigned int m_cross_partition_occupancy;
+
     // Count the # of times I didn't have N slots available
     statistics::Scalar m_not_avail_count;
     statistics::Scalar m_msg_count;
@@ -51,6 +51,7 @@
 #include "mem/ruby/network/simple/Switch.hh"
 #include "mem/ruby/network/simple/Throttle.hh"
 #include "mem/ruby/profiler/Profiler.hh"
+#include "mem/ruby/slicc_interface/AbstractController.hh"
 
 namespace gem5
 {
@@ -61,6 +62,7 @@ namespace ruby
 SimpleNetwork::SimpleNetwork(const Params &p)
     : Network(p), m_buffer_size(p.buffer_size),
       m_endpoint_bandwidth(p.endpoint_bandwidth),
+      m_partition_quantum(0),
       networkStats(this)
 {
     // record the routers
@@ -101,6 +103,71 @@ SimpleNetwork::init()
     m_topology_ptr->createLinks(this);
 }
 
+SimpleNetwork::~SimpleNetwork()
+{
+    if (m_quantum_event && m_quantum_event->scheduled())
+        m_quantum_event->deschedule();
+}
+
+void
+SimpleNetwork::startup()
+{
+    Network::startup();
+
+    if (m_cross_partition_buffers.empty())
+        return;
+
+    inform("%s: %d link buffers between Ruby partitions, "
+           "synchronised every %d ticks\n", name(),
+           m_cross_partition_buffers.size(), m_partition_quantum);
+    m_quantum_event.reset(new QuantumEvent(
+        *this, curTick() + m_partition_quantum, m_partition_quantum));
+}
+
+void
+SimpleNetwork::deliverCrossPartition(EventQueue *eventq)
+{
+    for (auto &[consumer_eventq, buffer] : m_cross_partition_buffers) {
+        if (consumer_eventq == eventq)
+            buffer->deliverCrossPartition(curTick());
+    }
+}
+
+SimpleNetwork::QuantumEvent::QuantumEvent(SimpleNetwork &_network,
+                                          Tick when, Tick _quantum)
+    : Base(Event::Minimum_Pri, 0), network(_network), quantum(_quantum)
+{
+    schedule(when);
+}
+
+void
+SimpleNetwork::QuantumEvent::process()
+{
+    schedule(curTick() + quantum);
+}
+
+const char *
+SimpleNetwork::QuantumEvent::description() const
+{
+    return "Ruby partition quantum";
+}
+
+void
+SimpleNetwork::QuantumEvent::BarrierEvent::process()
+{
+    QuantumEvent *event = static_cast<QuantumEvent *>(_globalEvent);
+
+    // wait for every sender to reach the boundary
+    if (globalBarrier())
+        event->process();
+
+    event->network.deliverCrossPartition(curEventQueue());
+
+    // keep senders from running ahead while messages are delivered
+    globalBarrier();
+    curEventQueue()->handleAsyncInsertions();
+}
+
 // From a switch to an endpoint node
 void
 SimpleNetwork::makeExtOutLink(SwitchID src, NodeID global_dest,
@@ -112,6 +179,10 @@ SimpleNetwork::makeExtOutLink(SwitchID src, NodeID global_dest,
     assert(m_switches[src] != NULL);
 
     SimpleExtLink *simple_link = safe_cast<SimpleExtLink*>(link);
+    AbstractController *cntrl = simple_link->params().ext_node;
+    fatal_if(cntrl->eventQueue() != m_switches[src]->eventQueue(),
+             "%s and its router %s must share an event queue\n",
+             cntrl->name(), m_switches[src]->name());
 
     // some destinations don't use all vnets, but Switch requires the size
     // output buffer list to match the number of vnets
@@ -132,6 +203,11 @@ SimpleNetwork::makeExtInLink(NodeID global_src, SwitchID dest, BasicLink* link,
 {
     NodeID local_src = getLocalNodeID(global_src);
     assert(local_src < m_nodes);
+    AbstractController *cntrl =
+        safe_cast<BasicExtLink*>(link)->params().ext_node;
+    fatal_if(cntrl->eventQueue() != m_switches[dest]->eventQueue(),
+             "%s and its router %s must share an event queue\n",
+             cntrl->name(), m_switches[dest]->name());
     m_switches[dest]->addInPort(m_toNetQueues[local_src]);
 }
 
@@ -152,6 +228,28 @@ SimpleNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
                                 simple_link->m_bw_multiplier,
                                 false,
                                 dst_inport);
+    Switch *src_switch = m_switches[src];
+    Switch *dest_switch = m_switches[dest];
+    if (src_switch->getPartition() != dest_switch->getPartition()) {
+        // The link latency bounds the quantum: a message sent during a
+        // quantum must not arrive before the boundary that delivers it
+        Tick latency = src_switch->cyclesToTicks(simple_link->m_latency);
+        fatal_if(latency == 0, "Links between Ruby partitions need a "
+                 "non-zero latency\n");
+        m_partition_quantum = m_partition_quantum ?
+            std::min(m_partition_quantum, latency) : latency;
+        for (auto *buffer : simple_link->m_buffers) {
+            buffer->setCrossPartition();
+            m_cross_partition_buffers.emplace_back(
+                dest_switch->eventQueue(), buffer);
+        }
+    } else {
+        fatal_if(src_switch->eventQueue() != dest_switch->eventQueue(),
+                 "Routers %s and %s are in the same Ruby partition but "
+                 "use different event queues\n",
+                 src_switch->name(), dest_switch->name());
+    }
+
     // Maitain a global list of buffers (used for functional accesses only)
     m_int_link_buffers.insert(m_int_link_buffers.end(),
             simple_link->m_buffers.begin(), simple_link->m_buffers.end());
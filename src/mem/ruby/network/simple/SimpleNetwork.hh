@@ -42,10 +42,13 @@
 #define __MEM_RUBY_NETWORK_SIMPLE_SIMPLENETWORK_HH__
 
 #include <iostream>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "mem/ruby/network/Network.hh"
 #include "params/SimpleNetwork.hh"
+#include "sim/global_event.hh"
 
 namespace gem5
 {
@@ -64,9 +67,10 @@ class SimpleNetwork : public Network
     PARAMS(SimpleNetwork);
 
     SimpleNetwork(const Params &p);
-    ~SimpleNetwork() = default;
+    ~SimpleNetwork();
 
     void init();
+    void startup() override;
 
     int getBufferSize() { return m_buffer_size; }
     int getEndpointBandwidth() { return m_endpoint_bandwidth; }
@@ -92,7 +96,43 @@ class SimpleNetwork : public Network
     bool functionalRead(Packet *pkt, WriteMask &mask);
     uint32_t functionalWrite(Packet *pkt);
 
+    //! Quantum of the partitioned mode, 0 if all routers share a partition
+    Tick getPartitionQuantum() const { return m_partition_quantum; }
+
   private:
+    /**
+     * Global event ending every quantum of the partitioned mode. All
+     * event queues stop at the boundary and each one delivers the cross
+     * partition messages whose consumer it runs, in an order that does
+     * not depend on thread timing.
+     */
+    class QuantumEvent : public BaseGlobalEventTemplate<QuantumEvent>
+    {
+      public:
+        typedef BaseGlobalEventTemplate<QuantumEvent> Base;
+
+        class BarrierEvent : public Base::BarrierEvent
+        {
+          public:
+            BarrierEvent(Base *global_event, Priority p, Flags f)
+                : Base::BarrierEvent(global_event, p, f)
+            { }
+
+            void process() override;
+        };
+
+        QuantumEvent(SimpleNetwork &network, Tick when, Tick quantum);
+
+        //! Schedules the next boundary
+        void process() override;
+        const char *description() const override;
+
+        SimpleNetwork &network;
+        const Tick quantum;
+    };
+
+    void deliverCrossPartition(EventQueue *eventq);
+
     void addLink(SwitchID src, SwitchID dest, int link_latency);
     void makeLink(SwitchID src, SwitchID dest,
         const NetDest& routing_table_entry, int link_latency);
@@ -104,6 +144,12 @@ class SimpleNetwork : public Network
 
     std::unordered_map<int, Switch*> m_switches;
     std::vector<MessageBuffer*> m_int_link_buffers;
+
+    //! Links between partitions and the event queue of their consumer
+    std::vector<std::pair<EventQueue*, MessageBuffer*>>
+        m_cross_partition_buffers;
+    Tick m_partition_quantum;
+    std::unique_ptr<QuantumEvent> m_quantum_event;
     const int m_buffer_size;
     const int m_endpoint_bandwidth;
 
@@ -127,6 +127,13 @@ class Switch(BasicRouter):
         WeightBased(adaptive_routing=False), "Routing strategy to be used"
     )
 
+    partition = Param.UInt32(
+        0,
+        "Ruby partition of this router. Links between routers of different "
+        "partitions only deliver messages at quantum boundaries, so the "
+        "partitions can run on separate event queues.",
+    )
+
     def setup_buffers(self, network):
         def vnet_buffer_size(vnet):
             """
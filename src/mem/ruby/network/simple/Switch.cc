@@ -61,7 +61,8 @@ Switch::Switch(const Params &p)
     perfectSwitch(m_id, this, p.virt_nets),
     m_int_routing_latency(p.int_routing_latency),
     m_ext_routing_latency(p.ext_routing_latency),
-    m_routing_unit(*p.routing_unit), m_num_connected_buffers(0),
+    m_routing_unit(*p.routing_unit), m_partition(p.partition),
+    m_num_connected_buffers(0),
     switchStats(this)
 {
     m_port_buffers.reserve(p.port_buffers.size());
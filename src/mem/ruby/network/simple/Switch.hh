@@ -111,6 +111,8 @@ class Switch : public BasicRouter
 
     BaseRoutingUnit& getRoutingUnit() { return m_routing_unit; }
 
+    uint32_t getPartition() const { return m_partition; }
+
   private:
     // Private copy constructor and assignment operator
     Switch(const Switch& obj);
@@ -125,6 +127,8 @@ class Switch : public BasicRouter
 
     BaseRoutingUnit &m_routing_unit;
 
+    const uint32_t m_partition;
+
     unsigned m_num_connected_buffers;
     std::vector<MessageBuffer*> m_port_buffers;
 
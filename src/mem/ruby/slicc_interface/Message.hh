@@ -44,7 +44,9 @@
 #include <iostream>
 #include <memory>
 #include <stack>
+#include <utility>
 
+#include "base/block_pool.hh"
 #include "mem/packet.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/common/WriteMask.hh"
@@ -132,6 +134,19 @@ class Message
     int vnet;
 };
 
+/**
+ * Allocate a message together with its reference count from a pool of
+ * blocks of that message type's size, so protocols that send many short
+ * lived messages do not go through the heap for each of them.
+ */
+template <class MSG, class... Args>
+inline std::shared_ptr<MSG>
+allocateMessage(Args&&... args)
+{
+    return std::allocate_shared<MSG>(PoolAllocator<MSG>(),
+                                     std::forward<Args>(args)...);
+}
+
 inline bool
 operator>(const MsgPtr &lhs, const MsgPtr &rhs)
 {
@@ -44,7 +44,8 @@ namespace ruby
 {
 
 TBEStorage::TBEStorage(statistics::Group *parent, int number_of_TBEs)
-    : m_reserved(0), m_stats(parent)
+    : m_reserved(0), m_slot_entries(number_of_TBEs, 0), m_slots_used(0),
+      m_stats(parent)
 {
     for (int i = 0; i < number_of_TBEs; ++i)
         m_slots_avail.push(i);
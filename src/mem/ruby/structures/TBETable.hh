@@ -41,10 +41,12 @@
 #ifndef __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 #define __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 
+#include <deque>
 #include <iostream>
-#include <unordered_map>
+#include <vector>
 
 #include "mem/ruby/common/Address.hh"
+#include "mem/ruby/common/FlatAddrMap.hh"
 
 namespace gem5
 {
@@ -52,6 +54,10 @@ namespace gem5
 namespace ruby
 {
 
+// Entries live in a deque so that pointers handed out by lookup() stay
+// valid while other TBEs are allocated. Freed entries are reset and kept
+// for reuse, so a controller stops allocating once it has seen its peak
+// number of outstanding transactions.
 template<class ENTRY>
 class TBETable
 {
@@ -81,8 +87,23 @@ class TBETable
     TBETable(const TBETable& obj);
     TBETable& operator=(const TBETable& obj);
 
+    // Returns the allocated entries, in no particular order
+    std::vector<ENTRY*>
+    allocatedEntries()
+    {
+        std::vector<ENTRY*> entries;
+        entries.reserve(m_map.size());
+        m_map.forEach([&](Addr, int slot) {
+            entries.push_back(&m_entries[slot]);
+        });
+        return entries;
+    }
+
     // Data Members (m_prefix)
-    std::unordered_map<Addr, ENTRY> m_map;
+    // Index of each allocated address in m_entries
+    FlatAddrMap<int> m_map;
+    std::deque<ENTRY> m_entries;
+    std::vector<int> m_free_entries;
 
   private:
     int m_number_of_TBEs;
@@ -112,7 +133,15 @@ TBETable<ENTRY>::allocate(Addr address)
 {
     assert(!isPresent(address));
     assert(m_map.size() < m_number_of_TBEs);
-    m_map[address] = ENTRY();
+    int slot;
+    if (m_free_entries.empty()) {
+        slot = m_entries.size();
+        m_entries.emplace_back();
+    } else {
+        slot = m_free_entries.back();
+        m_free_entries.pop_back();
+    }
+    m_map[address] = slot;
 }
 
 template<class ENTRY>
@@ -121,6 +150,10 @@ TBETable<ENTRY>::deallocate(Addr address)
 {
     assert(isPresent(address));
     assert(m_map.size() > 0);
+    int slot = *m_map.find(address);
+    // Release what the entry holds now rather than on its next use
+    m_entries[slot] = ENTRY();
+    m_free_entries.push_back(slot);
     m_map.erase(address);
 }
 
@@ -136,8 +169,8 @@ template<class ENTRY>
 inline ENTRY*
 TBETable<ENTRY>::lookup(Addr address)
 {
-  if (m_map.find(address) != m_map.end()) return &(m_map.find(address)->second);
-  return NULL;
+    const int *slot = m_map.find(address);
+    return slot ? &m_entries[*slot] : NULL;
 }
 
 
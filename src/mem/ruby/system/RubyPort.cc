@@ -41,6 +41,8 @@
 
 #include "mem/ruby/system/RubyPort.hh"
 
+#include <algorithm>
+
 #include "base/compiler.hh"
 #include "cpu/testers/rubytest/RubyTester.hh"
 #include "debug/Config.hh"
@@ -64,6 +66,7 @@ RubyPort::RubyPort(const Params &p)
     : ClockedObject(p), m_ruby_system(p.ruby_system), m_version(p.version),
       m_controller(NULL), m_mandatory_q_ptr(NULL),
       m_usingRubyTester(p.using_ruby_tester), system(p.system),
+      deviceEvents(getEventQueue(0)),
       pioRequestPort(csprintf("%s.pio-request-port", name()), this),
       pioResponsePort(csprintf("%s.pio-response-port", name()), this),
       memRequestPort(csprintf("%s.mem-request-port", name()), this),
@@ -147,7 +150,8 @@ RubyPort::PioRequestPort::PioRequestPort(const std::string &_name,
 
 RubyPort::PioResponsePort::PioResponsePort(const std::string &_name,
                            RubyPort *_port)
-    : QueuedResponsePort(_name, _port, queue), queue(*_port, *this)
+    : QueuedResponsePort(_name, _port, queue),
+      queue(_port->deviceEvents, *this)
 {
     DPRINTF(RubyPort, "Created response pioport on sequencer %s\n", _name);
 }
@@ -155,7 +159,8 @@ RubyPort::PioResponsePort::PioResponsePort(const std::string &_name,
 RubyPort::MemRequestPort::MemRequestPort(const std::string &_name,
                            RubyPort *_port)
     : QueuedRequestPort(_name, _port, reqQueue, snoopRespQueue),
-      reqQueue(*_port, *this), snoopRespQueue(*_port, *this)
+      reqQueue(_port->deviceEvents, *this),
+      snoopRespQueue(_port->deviceEvents, *this)
 {
     DPRINTF(RubyPort, "Created request memport on ruby sequencer %s\n", _name);
 }
@@ -178,9 +183,11 @@ RubyPort::PioRequestPort::recvTimingResp(PacketPtr pkt)
     RubyPort *rp = static_cast<RubyPort *>(&owner);
     DPRINTF(RubyPort, "Response for address: 0x%#x\n", pkt->getAddr());
 
-    // send next cycle
-    rp->pioResponsePort.schedTimingResp(
-            pkt, curTick() + rp->m_ruby_system->clockPeriod());
+    // send next cycle, from the devices' event queue
+    Tick when = curTick() + rp->m_ruby_system->clockPeriod();
+    EventQueue::ScopedMigration migrate(rp->deviceEvents.eventQueue(),
+                                        inParallelMode);
+    rp->pioResponsePort.schedTimingResp(pkt, std::max(when, curTick()));
     return true;
 }
 
@@ -202,9 +209,12 @@ bool RubyPort::MemRequestPort::recvTimingResp(PacketPtr pkt)
     DPRINTF(RubyPort,  "Pio response for address %#x, going to %s\n",
             pkt->getAddr(), port->name());
 
-    // attempt to send the response in the next cycle
+    // attempt to send the response in the next cycle, from the event
+    // queue of the requesting core
     RubyPort *rp = static_cast<RubyPort *>(&owner);
-    port->schedTimingResp(pkt, curTick() + rp->m_ruby_system->clockPeriod());
+    Tick when = curTick() + rp->m_ruby_system->clockPeriod();
+    EventQueue::ScopedMigration migrate(rp->eventQueue(), inParallelMode);
+    port->schedTimingResp(pkt, std::max(when, curTick()));
 
     return true;
 }
@@ -218,6 +228,8 @@ RubyPort::PioResponsePort::recvTimingReq(PacketPtr pkt)
         AddrRangeList l = ruby_port->request_ports[i]->getAddrRanges();
         for (auto it = l.begin(); it != l.end(); ++it) {
             if (it->contains(pkt->getAddr())) {
+                EventQueue::ScopedMigration migrate(
+                    ruby_port->eventQueue(), inParallelMode);
                 // generally it is not safe to assume success here as
                 // the port could be blocked
                 [[maybe_unused]] bool success =
@@ -243,6 +255,8 @@ RubyPort::PioResponsePort::recvAtomic(PacketPtr pkt)
         AddrRangeList l = ruby_port->request_ports[i]->getAddrRanges();
         for (auto it = l.begin(); it != l.end(); ++it) {
             if (it->contains(pkt->getAddr())) {
+                EventQueue::ScopedMigration migrate(
+                    ruby_port->eventQueue(), inParallelMode);
                 return ruby_port->request_ports[i]->sendAtomic(pkt);
             }
         }
@@ -281,10 +295,13 @@ RubyPort::MemResponsePort::recvTimingReq(PacketPtr pkt)
             // route the response
             pkt->pushSenderState(new SenderState(this));
 
-            // send next cycle
+            // send next cycle, from the devices' event queue
             RubySystem *rs = ruby_port->m_ruby_system;
+            Tick when = curTick() + rs->clockPeriod();
+            EventQueue::ScopedMigration migrate(
+                ruby_port->deviceEvents.eventQueue(), inParallelMode);
             ruby_port->memRequestPort.schedTimingReq(pkt,
-                curTick() + rs->clockPeriod());
+                std::max(when, curTick()));
             return true;
         }
     }
@@ -348,7 +365,8 @@ RubyPort::MemResponsePort::recvAtomic(PacketPtr pkt)
             // route the response
             pkt->pushSenderState(new SenderState(this));
 
-            // send next cycle
+            EventQueue::ScopedMigration migrate(
+                ruby_port->deviceEvents.eventQueue(), inParallelMode);
             Tick req_ticks = ruby_port->memRequestPort.sendAtomic(pkt);
             return ruby_port->ticksToCycles(req_ticks);
         }
@@ -411,6 +429,8 @@ RubyPort::MemResponsePort::recvFunctional(PacketPtr pkt)
     if (!isPhysMemAddress(pkt)) {
         DPRINTF(RubyPort, "Pio Request for address: 0x%#x\n", pkt->getAddr());
         assert(rp->pioRequestPort.isConnected());
+        EventQueue::ScopedMigration migrate(rp->deviceEvents.eventQueue(),
+                                            inParallelMode);
         rp->pioRequestPort.sendFunctional(pkt);
         return;
     }
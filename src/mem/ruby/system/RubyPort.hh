@@ -204,6 +204,13 @@ class RubyPort : public ClockedObject
     bool m_usingRubyTester;
     System* system;
 
+    /**
+     * Devices behind the pio ports stay on the first event queue when
+     * partitioned Ruby gives each core a queue of its own, so pio
+     * traffic migrates to it and back.
+     */
+    EventManager deviceEvents;
+
     std::vector<MemResponsePort *> response_ports;
 
   private:
@@ -53,16 +53,47 @@ namespace gem5
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::eraseIfNullEntry(size_t sf_slot)
 {
-    SnoopItem& sf_item = sf_it->second;
-    if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
+    if (cachedLocations.isNull(sf_slot)) {
+        if (dirModel.enabled())
+            dirModel.remove(cachedLocations.key(sf_slot));
+        cachedLocations.erase(sf_slot);
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
 }
 
+size_t
+SnoopFilter::allocateItem(Addr line_addr)
+{
+    size_t sf_slot = cachedLocations.insert(line_addr);
+    touchDirectory(line_addr);
+    return sf_slot;
+}
+
+void
+SnoopFilter::touchDirectory(Addr line_addr)
+{
+    if (!dirModel.enabled())
+        return;
+
+    Addr victim = dirModel.access(line_addr);
+    if (victim == MaxAddr)
+        return;
+
+    // A real directory would have to invalidate the line in all its
+    // holders to free the entry.
+    stats.dirEvictions++;
+    size_t victim_slot = cachedLocations.find(victim);
+    if (victim_slot != SnoopFilterCache::npos) {
+        stats.backInvalidations +=
+            cachedLocations.holder(victim_slot).count();
+    }
+    DPRINTF(SnoopFilter, "%s:   directory evicted %#x for %#x\n",
+            __func__, victim, line_addr);
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
                            cpu_side_port)
@@ -78,8 +109,10 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    size_t sf_slot = cachedLocations.find(line_addr);
+    bool is_hit = (sf_slot != SnoopFilterCache::npos);
+    reqLookupResult.valid = is_hit || allocate;
+    reqLookupResult.lineAddr = line_addr;
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -87,12 +120,13 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
     if (!is_hit && !allocate)
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // If no hit in snoop filter create a new element
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        sf_slot = allocateItem(line_addr);
+    } else {
+        touchDirectory(line_addr);
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    SnoopItem sf_item = getItem(sf_slot);
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -125,6 +159,7 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 
             // Mark in-flight requests to distinguish later on
             sf_item.requested |= req_port;
+            setItem(sf_slot, sf_item);
             DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                     __func__,  sf_item.requested, sf_item.holder);
         } else {
@@ -148,6 +183,7 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         // it may not have the line anymore.
         if (!cpkt->isBlockCached()) {
             sf_item.holder &= ~req_port;
+            setItem(sf_slot, sf_item);
             DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                     __func__,  sf_item.requested, sf_item.holder);
         }
@@ -159,26 +195,30 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.valid) {
+        reqLookupResult.valid = false;
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.lineAddr == line_addr);
+        size_t sf_slot = cachedLocations.find(line_addr);
+        if (sf_slot == SnoopFilterCache::npos)
+            return;
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            setItem(sf_slot, retry_item);
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(sf_slot);
     }
 }
 
@@ -193,8 +233,8 @@ SnoopFilter::lookupSnoop(Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    size_t sf_slot = cachedLocations.find(line_addr);
+    bool is_hit = (sf_slot != SnoopFilterCache::npos);
 
     panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
@@ -217,7 +257,9 @@ SnoopFilter::lookupSnoop(Packet* cpkt)
         return snoopDown(lookupLatency);
     }
 
-    SnoopItem& sf_item = sf_it->second;
+    touchDirectory(line_addr);
+
+    SnoopItem sf_item = getItem(sf_slot);
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -245,9 +287,10 @@ SnoopFilter::lookupSnoop(Packet* cpkt)
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
         sf_item.holder = 0;
+        setItem(sf_slot, sf_item);
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(sf_slot);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -277,7 +320,10 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    size_t sf_slot = cachedLocations.find(line_addr);
+    if (sf_slot == SnoopFilterCache::npos)
+        sf_slot = allocateItem(line_addr);
+    SnoopItem sf_item = getItem(sf_slot);
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -306,6 +352,7 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     sf_item.holder |=  req_mask;
     sf_item.requested &= ~req_mask;
     assert((sf_item.requested | sf_item.holder).any());
+    setItem(sf_slot, sf_item);
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
 }
@@ -324,8 +371,8 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    size_t sf_slot = cachedLocations.find(line_addr);
+    bool is_hit = sf_slot != SnoopFilterCache::npos;
 
     // Nothing to do if it is not a hit
     if (!is_hit)
@@ -335,15 +382,16 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem sf_item = getItem(sf_slot);
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
         sf_item.holder = 0;
+        setItem(sf_slot, sf_item);
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(sf_slot);
     }
 }
 
@@ -366,12 +414,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    size_t sf_slot = cachedLocations.find(line_addr);
+    if (sf_slot == SnoopFilterCache::npos)
         return;
 
     SnoopMask response_mask = portToMask(cpu_side_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem sf_item = getItem(sf_slot);
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -390,12 +438,14 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~response_mask;
         }
-        eraseIfNullEntry(sf_it);
+        setItem(sf_slot, sf_item);
+        eraseIfNullEntry(sf_slot);
     } else {
         // Any other response implies that a cache above will have the
         // block.
         sf_item.holder |= response_mask;
         assert((sf_item.holder | sf_item.requested).any());
+        setItem(sf_slot, sf_item);
     }
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
@@ -418,9 +468,70 @@ SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
                "holder of the requested data."),
       ADD_STAT(hitMultiSnoops, statistics::units::Count::get(),
                "Number of snoops hitting in the snoop filter with multiple "
-               "(>1) holders of the requested data.")
+               "(>1) holders of the requested data."),
+      ADD_STAT(dirEvictions, statistics::units::Count::get(),
+               "Number of lines evicted from the modelled directory."),
+      ADD_STAT(backInvalidations, statistics::units::Count::get(),
+               "Number of holders that directory evictions would have "
+               "invalidated.")
 {}
 
+void
+SnoopFilter::DirectoryModel::init(const std::string &name, unsigned entries,
+                                  unsigned _assoc, unsigned line_shift)
+{
+    if (entries == 0)
+        return;
+
+    fatal_if(_assoc == 0 || entries % _assoc != 0,
+             "%s: directory entries (%d) must be a multiple of its "
+             "associativity (%d)\n", name, entries, _assoc);
+    unsigned num_sets = entries / _assoc;
+    fatal_if(!isPowerOf2(num_sets),
+             "%s: number of directory sets (%d) must be a power of 2\n",
+             name, num_sets);
+
+    assoc = _assoc;
+    setMask = num_sets - 1;
+    lineShift = line_shift;
+    tags.assign(entries, MaxAddr);
+    lastUse.assign(entries, 0);
+}
+
+Addr
+SnoopFilter::DirectoryModel::access(Addr line_addr)
+{
+    size_t base = setBase(line_addr);
+    size_t victim = base;
+    for (size_t way = base; way < base + assoc; way++) {
+        if (tags[way] == line_addr) {
+            lastUse[way] = ++useCount;
+            return MaxAddr;
+        }
+        // Prefer free ways, then the least recently used one.
+        if (tags[victim] != MaxAddr &&
+            (tags[way] == MaxAddr || lastUse[way] < lastUse[victim]))
+            victim = way;
+    }
+
+    Addr evicted = tags[victim];
+    tags[victim] = line_addr;
+    lastUse[victim] = ++useCount;
+    return evicted;
+}
+
+void
+SnoopFilter::DirectoryModel::remove(Addr line_addr)
+{
+    size_t base = setBase(line_addr);
+    for (size_t way = base; way < base + assoc; way++) {
+        if (tags[way] == line_addr) {
+            tags[way] = MaxAddr;
+            return;
+        }
+    }
+}
+
 void
 SnoopFilter::regStats()
 {
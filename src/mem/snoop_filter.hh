@@ -44,12 +44,13 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
+#include "mem/snoop_filter_cache.hh"
 #include "params/SnoopFilter.hh"
 #include "sim/sim_object.hh"
 #include "sim/system.hh"
@@ -96,11 +97,13 @@ class SnoopFilter : public SimObject
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
     SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
+        SimObject(p),
         linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
         maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
         stats(this)
     {
+        cachedLocations.init(1, floorLog2(linesize));
+        dirModel.init(name(), p.dir_entries, p.dir_assoc, floorLog2(linesize));
     }
 
     /**
@@ -125,6 +128,11 @@ class SnoopFilter : public SimObject
         fatal_if(id > SNOOP_MASK_SIZE,
                  "Snoop filter only supports %d snooping ports, got %d\n",
                  SNOOP_MASK_SIZE, id);
+
+        // store just enough mask words for the snooping ports
+        assert(cachedLocations.empty());
+        cachedLocations.init(std::max(1, (int)divCeil(id, 64)),
+                             floorLog2(linesize));
     }
 
     /**
@@ -221,9 +229,9 @@ class SnoopFilter : public SimObject
         SnoopMask holder;
     };
     /**
-     * HashMap of SnoopItems indexed by line address
+     * Table of SnoopItems indexed by line address
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    typedef gem5::SnoopFilterCache<SnoopMask> SnoopFilterCache;
 
     /**
      * Simple factory methods for standard return values.
@@ -261,11 +269,72 @@ class SnoopFilter : public SimObject
     /**
      * Removes snoop filter items which have no requestors and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(size_t sf_slot);
+
+    /** Reads the item stored in a slot of cachedLocations. */
+    SnoopItem
+    getItem(size_t sf_slot) const
+    {
+        return SnoopItem{cachedLocations.requested(sf_slot),
+                         cachedLocations.holder(sf_slot)};
+    }
+
+    /** Writes back an item to a slot of cachedLocations. */
+    void
+    setItem(size_t sf_slot, const SnoopItem &sf_item)
+    {
+        cachedLocations.setRequested(sf_slot, sf_item.requested);
+        cachedLocations.setHolder(sf_slot, sf_item.holder);
+    }
+
+    /** Inserts a new, empty item for a line. */
+    size_t allocateItem(Addr line_addr);
 
-    /** Simple hash set of cached addresses. */
+    /** Marks a tracked line as used in the directory model. */
+    void touchDirectory(Addr line_addr);
+
+    /** Open-addressing table of cached addresses. */
     SnoopFilterCache cachedLocations;
 
+    /**
+     * Optional model of a set-associative directory with a limited number
+     * of entries. Every line tracked by the filter is also placed in the
+     * model, and the lines it has to evict are counted as
+     * back-invalidations. The model only produces statistics: the filter
+     * itself stays precise, so coherence is not affected.
+     */
+    class DirectoryModel
+    {
+      public:
+        void init(const std::string &name, unsigned entries, unsigned assoc,
+                  unsigned line_shift);
+
+        bool enabled() const { return !tags.empty(); }
+
+        /**
+         * Allocates or touches line_addr.
+         * @return The evicted line, or MaxAddr if there was none.
+         */
+        Addr access(Addr line_addr);
+
+        /** Frees the entry of a line that is no longer tracked. */
+        void remove(Addr line_addr);
+
+      private:
+        size_t
+        setBase(Addr line_addr) const
+        {
+            return ((line_addr >> lineShift) & setMask) * assoc;
+        }
+
+        std::vector<Addr> tags;
+        std::vector<uint64_t> lastUse;
+        unsigned assoc = 0;
+        Addr setMask = 0;
+        unsigned lineShift = 0;
+        uint64_t useCount = 0;
+    } dirModel;
+
     /**
      * A request lookup must be followed by a call to finishRequest to inform
      * the operation's success. If a retry is needed, however, all changes
@@ -274,27 +343,22 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /**
+         * Line address of the entry found or created by lookupRequest.
+         * Slots can move when other entries are erased, so finishRequest
+         * looks the line up again.
+         */
+        Addr lineAddr = MaxAddr;
+
+        /** Whether lookupRequest left an entry to finish. */
+        bool valid = false;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
          * in case finishRequest needs to undo changes made in lookupRequest
          * (because of crossbar retry)
          */
-        SnoopItem retryItem;
-
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
-        {
-        }
-        ReqLookupResult() = delete;
+        SnoopItem retryItem{0, 0};
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -329,6 +393,9 @@ class SnoopFilter : public SimObject
         statistics::Scalar totSnoops;
         statistics::Scalar hitSingleSnoops;
         statistics::Scalar hitMultiSnoops;
+
+        statistics::Scalar dirEvictions;
+        statistics::Scalar backInvalidations;
     } stats;
 };
 
@@ -0,0 +1,215 @@
+#ifndef __MEM_SNOOP_FILTER_CACHE_HH__
+#define __MEM_SNOOP_FILTER_CACHE_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "base/intmath.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * Open-addressing hash table from line addresses to a pair of port masks
+ * (requested, holder), used as the storage of the snoop filter.
+ *
+ * Keys are probed linearly and deletion shifts the following entries
+ * back, so there are no tombstones. Keys and masks live in separate
+ * arrays; each mask is stored as just enough 64-bit words to cover the
+ * snooping ports, which is a single word for up to 64 ports.
+ *
+ * Slot numbers stay valid until the next insert or erase.
+ *
+ * @tparam Mask A std::bitset wide enough for every port.
+ */
+template <class Mask>
+class SnoopFilterCache
+{
+  public:
+    static constexpr size_t npos = size_t(-1);
+
+    /**
+     * @param mask_words 64-bit words stored per mask.
+     * @param line_shift log2 of the line size, dropped before hashing.
+     */
+    void
+    init(unsigned mask_words, unsigned line_shift)
+    {
+        assert(mask_words > 0 && mask_words * 64 <= Mask().size());
+        maskWords = mask_words;
+        lineShift = line_shift;
+        count = 0;
+        resize(InitialSlots);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    /** @return the slot of line_addr, or npos. */
+    size_t
+    find(Addr line_addr) const
+    {
+        for (size_t s = home(line_addr); ; s = (s + 1) & slotMask) {
+            if (keys[s] == line_addr)
+                return s;
+            if (keys[s] == Empty)
+                return npos;
+        }
+    }
+
+    /** Insert line_addr, which must not be present, with empty masks. */
+    size_t
+    insert(Addr line_addr)
+    {
+        assert(line_addr != Empty);
+        if ((count + 1) * 4 > keys.size() * 3)
+            resize(keys.size() * 2);
+        size_t s = home(line_addr);
+        while (keys[s] != Empty)
+            s = (s + 1) & slotMask;
+        keys[s] = line_addr;
+        count++;
+        return s;
+    }
+
+    /** Remove the entry in slot s; this may move other entries. */
+    void
+    erase(size_t s)
+    {
+        assert(keys[s] != Empty);
+        // Shift back every following entry of the probe run that would
+        // otherwise become unreachable.
+        size_t hole = s;
+        for (size_t j = (s + 1) & slotMask; keys[j] != Empty;
+             j = (j + 1) & slotMask) {
+            size_t k = home(keys[j]);
+            bool reachable = hole < j ? (hole < k && k <= j)
+                                      : (hole < k || k <= j);
+            if (!reachable) {
+                move(j, hole);
+                hole = j;
+            }
+        }
+        keys[hole] = Empty;
+        clearMasks(hole);
+        count--;
+    }
+
+    Addr key(size_t s) const { return keys[s]; }
+
+    Mask requested(size_t s) const { return load(requestedBits, s); }
+    Mask holder(size_t s) const { return load(holderBits, s); }
+
+    void
+    setRequested(size_t s, const Mask &mask)
+    {
+        store(requestedBits, s, mask);
+    }
+
+    void setHolder(size_t s, const Mask &mask) { store(holderBits, s, mask); }
+
+    /** @return whether neither mask of slot s has a bit set. */
+    bool
+    isNull(size_t s) const
+    {
+        for (unsigned w = 0; w < maskWords; w++) {
+            if (requestedBits[s * maskWords + w] |
+                holderBits[s * maskWords + w])
+                return false;
+        }
+        return true;
+    }
+
+  private:
+    /** Line addresses are aligned, so all ones is never a key. */
+    static constexpr Addr Empty = MaxAddr;
+    static constexpr size_t InitialSlots = 1024;
+
+    size_t
+    home(Addr line_addr) const
+    {
+        // Keep the secure bit, which sits below the line offset.
+        uint64_t h = ((line_addr >> lineShift) ^ (line_addr << 63)) *
+            0x9e3779b97f4a7c15ULL;
+        return (h >> (64 - slotBits)) & slotMask;
+    }
+
+    Mask
+    load(const std::vector<uint64_t> &bits, size_t s) const
+    {
+        const uint64_t *w = &bits[s * maskWords];
+        Mask mask(w[0]);
+        for (unsigned i = 1; i < maskWords; i++)
+            mask |= Mask(w[i]) << (64 * i);
+        return mask;
+    }
+
+    void
+    store(std::vector<uint64_t> &bits, size_t s, const Mask &mask)
+    {
+        uint64_t *w = &bits[s * maskWords];
+        const Mask word_mask(~0ULL);
+        for (unsigned i = 0; i < maskWords; i++)
+            w[i] = ((mask >> (64 * i)) & word_mask).to_ullong();
+    }
+
+    void
+    clearMasks(size_t s)
+    {
+        std::fill_n(&requestedBits[s * maskWords], maskWords, 0);
+        std::fill_n(&holderBits[s * maskWords], maskWords, 0);
+    }
+
+    void
+    move(size_t from, size_t to)
+    {
+        keys[to] = keys[from];
+        std::copy_n(&requestedBits[from * maskWords], maskWords,
+                    &requestedBits[to * maskWords]);
+        std::copy_n(&holderBits[from * maskWords], maskWords,
+                    &holderBits[to * maskWords]);
+    }
+
+    void
+    resize(size_t slots)
+    {
+        std::vector<Addr> old_keys(slots, Empty);
+        std::vector<uint64_t> old_requested(slots * maskWords, 0);
+        std::vector<uint64_t> old_holder(slots * maskWords, 0);
+        old_keys.swap(keys);
+        old_requested.swap(requestedBits);
+        old_holder.swap(holderBits);
+        slotBits = floorLog2(slots);
+        slotMask = slots - 1;
+
+        for (size_t o = 0; o < old_keys.size(); o++) {
+            if (old_keys[o] == Empty)
+                continue;
+            size_t s = home(old_keys[o]);
+            while (keys[s] != Empty)
+                s = (s + 1) & slotMask;
+            keys[s] = old_keys[o];
+            std::copy_n(&old_requested[o * maskWords], maskWords,
+                        &requestedBits[s * maskWords]);
+            std::copy_n(&old_holder[o * maskWords], maskWords,
+                        &holderBits[s * maskWords]);
+        }
+    }
+
+    std::vector<Addr> keys;
+    std::vector<uint64_t> requestedBits;
+    std::vector<uint64_t> holderBits;
+    unsigned maskWords = 1;
+    unsigned lineShift = 6;
+    unsigned slotBits = 0;
+    size_t slotMask = 0;
+    size_t count = 0;
+};
+
+} // namespace gem5
+
+#endif // __MEM_SNOOP_FILTER_CACHE_HH__
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+
+#include <bitset>
+#include <random>
+#include <unordered_map>
+
+#include "mem/snoop_filter_cache.hh"
+
+using namespace gem5;
+
+using Mask = std::bitset<256>;
+
+TEST(SnoopFilterCacheTest, InsertFindErase)
+{
+    SnoopFilterCache<Mask> cache;
+    cache.init(1, 6);
+
+    EXPECT_EQ(cache.find(0x1000), cache.npos);
+    size_t s = cache.insert(0x1000);
+    EXPECT_EQ(cache.find(0x1000), s);
+    EXPECT_TRUE(cache.isNull(s));
+
+    cache.setHolder(s, Mask(0x5));
+    EXPECT_EQ(cache.holder(cache.find(0x1000)), Mask(0x5));
+    EXPECT_FALSE(cache.isNull(s));
+
+    // The secure bit makes a distinct key.
+    size_t t = cache.insert(0x1001);
+    EXPECT_NE(t, s);
+    EXPECT_TRUE(cache.isNull(t));
+
+    cache.erase(cache.find(0x1000));
+    EXPECT_EQ(cache.find(0x1000), cache.npos);
+    EXPECT_EQ(cache.find(0x1001), t);
+    EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(SnoopFilterCacheTest, WideMasks)
+{
+    SnoopFilterCache<Mask> cache;
+    cache.init(3, 6);
+
+    Mask mask;
+    mask.set(0);
+    mask.set(70);
+    mask.set(191);
+    size_t s = cache.insert(0x40);
+    cache.setRequested(s, mask);
+    EXPECT_EQ(cache.requested(s), mask);
+    EXPECT_TRUE(cache.holder(s).none());
+}
+
+/** Random inserts and erases, checked against std::unordered_map. */
+TEST(SnoopFilterCacheTest, MatchesReference)
+{
+    SnoopFilterCache<Mask> cache;
+    cache.init(1, 6);
+    std::unordered_map<Addr, uint64_t> ref;
+    std::mt19937_64 rng(1);
+
+    for (int i = 0; i < 200000; i++) {
+        // A small address range forces long probe runs and collisions.
+        Addr line = (rng() % 4096) << 6;
+        size_t s = cache.find(line);
+        auto it = ref.find(line);
+        ASSERT_EQ(s == cache.npos, it == ref.end());
+        if (s == cache.npos) {
+            uint64_t val = rng() | 1;
+            cache.setHolder(cache.insert(line), Mask(val));
+            ref[line] = val;
+        } else {
+            ASSERT_EQ(cache.holder(s), Mask(it->second));
+            if (rng() % 2) {
+                cache.erase(s);
+                ref.erase(it);
+            }
+        }
+        ASSERT_EQ(cache.size(), ref.size());
+    }
+
+    for (const auto &[line, val] : ref) {
+        size_t s = cache.find(line);
+        ASSERT_NE(s, cache.npos);
+        EXPECT_EQ(cache.holder(s), Mask(val));
+    }
+}
@@ -44,6 +44,7 @@ import sys
 # import the wrapped C++ functions
 import _m5.drain
 import _m5.core
+import _m5.cxx_config
 from _m5.stats import updateEvents as updateStatEvents
 
 from . import stats
@@ -153,6 +154,50 @@ def instantiate(ckpt_dir=None):
     # a checkpoint, If so, this call will shift them to be at a valid time.
     updateStatEvents()
 
+# Objects built by instantiateFromIni(), None for a Python instantiation
+_ini_system = None
+
+def instantiateFromIni(ini_file, overrides=[]):
+    """Instantiate the system described by a config.ini written by an
+    earlier m5.instantiate(), without building the Python object graph.
+
+    overrides is a list of (object, param, value) strings applied on top
+    of the file. This needs a build with --with-cxx-config. The Python
+    hierarchy only has a bare Root standing for the C++ root, so
+    checkpoints, CPU switching and anything else that walks the Python
+    objects is not available. Use getIniObject() to reach the C++ objects.
+    """
+    global _instantiated
+    global _ini_system
+
+    if _instantiated:
+        fatal("m5.instantiate() called twice.")
+
+    _instantiated = True
+
+    ticks.fixGlobalFrequency()
+    stats.initSimStats()
+
+    _ini_system = _m5.cxx_config.IniSystem(ini_file)
+    for obj, param, value in overrides:
+        _ini_system.set_param(obj, param, str(value))
+    _ini_system.instantiate()
+
+    # The stats package reaches the C++ stat groups through the Python root
+    root = objects.Root(full_system=True)
+    root._ccObject = _ini_system.get_object('root')
+
+    stats.enable()
+    _ini_system.init_state()
+    updateStatEvents()
+
+def getIniObject(name):
+    """Return the C++ object of the given path built by instantiateFromIni().
+    """
+    if not _ini_system:
+        fatal("getIniObject() needs m5.instantiateFromIni()")
+    return _ini_system.get_object(name)
+
 need_startup = True
 def simulate(*args, **kwargs):
     global need_startup
@@ -162,8 +207,11 @@ def simulate(*args, **kwargs):
         fatal("m5.instantiate() must be called before m5.simulate().")
 
     if need_startup:
-        root = objects.Root.getInstance()
-        for obj in root.descendants(): obj.startup()
+        if _ini_system:
+            _ini_system.startup()
+        else:
+            root = objects.Root.getInstance()
+            for obj in root.descendants(): obj.startup()
         need_startup = False
 
         # Python exit handlers happen in reverse order.
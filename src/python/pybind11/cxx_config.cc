@@ -0,0 +1,109 @@
+#include <memory>
+#include <string>
+
+#include "base/logging.hh"
+#include "python/pybind11/pybind.hh"
+#include "sim/cxx_config.hh"
+#include "sim/cxx_config_ini.hh"
+#include "sim/cxx_manager.hh"
+#include "sim/init.hh"
+#include "sim/sim_object.hh"
+
+namespace py = pybind11;
+
+namespace gem5
+{
+
+namespace
+{
+
+/**
+ * SimObjects built by CxxConfigManager from a config.ini written by an
+ * earlier Python instantiation. The objects live as long as this does.
+ */
+class IniSystem
+{
+  public:
+    explicit IniSystem(const std::string &ini_file)
+    {
+        fatal_if(!cxxConfigDirectory().count("Root"),
+                 "Instantiating %s needs a build with --with-cxx-config.\n",
+                 ini_file);
+        fatal_if(!configFile.load(ini_file), "Cannot read %s.\n", ini_file);
+        manager = std::make_unique<CxxConfigManager>(configFile);
+    }
+
+    /** Override a parameter of the file, before instantiate() only. */
+    void
+    setParam(const std::string &object, const std::string &param,
+             const std::string &value)
+    {
+        try {
+            manager->setParam(object, param, value);
+        } catch (CxxConfigManager::Exception &e) {
+            fatal("Cannot set %s.%s: %s\n", object, param, e.message);
+        }
+    }
+
+    /**
+     * Build, connect and initialise every object, then give the stat
+     * groups the same hierarchy as a Python instantiation does.
+     */
+    void
+    instantiate()
+    {
+        try {
+            manager->instantiate();
+        } catch (CxxConfigManager::Exception &e) {
+            fatal("Config problem in sim object %s: %s\n", e.name, e.message);
+        }
+
+        for (auto &[name, object] : manager->objectsByName) {
+            if (name == "root")
+                continue;
+            const auto dot = name.rfind('.');
+            const std::string parent =
+                dot == std::string::npos ? "root" : name.substr(0, dot);
+            auto it = manager->objectsByName.find(parent);
+            panic_if(it == manager->objectsByName.end(),
+                     "No parent object %s for %s.\n", parent, name);
+            it->second->addStatGroup(name.substr(dot + 1).c_str(), object);
+        }
+    }
+
+    void initState() { manager->initState(); }
+    void startup() { manager->startup(); }
+
+    SimObject *
+    object(const std::string &name)
+    {
+        try {
+            return &manager->getObject<SimObject>(name);
+        } catch (CxxConfigManager::Exception &e) {
+            fatal("%s\n", e.message);
+        }
+    }
+
+  private:
+    CxxIniFile configFile;
+    std::unique_ptr<CxxConfigManager> manager;
+};
+
+void
+cxx_config_pybind(py::module_ &m_internal)
+{
+    py::module_ m = m_internal.def_submodule("cxx_config");
+
+    py::class_<IniSystem>(m, "IniSystem")
+        .def(py::init<const std::string &>())
+        .def("set_param", &IniSystem::setParam)
+        .def("instantiate", &IniSystem::instantiate)
+        .def("init_state", &IniSystem::initState)
+        .def("startup", &IniSystem::startup)
+        .def("get_object", &IniSystem::object,
+             py::return_value_policy::reference);
+}
+EmbeddedPyBind embed_("cxx_config", &cxx_config_pybind);
+
+} // anonymous namespace
+} // namespace gem5
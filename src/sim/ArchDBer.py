@@ -61,3 +61,33 @@ class ArchDBer(SimObject):
     dump_sms_train_trace = Param.Bool(False, "Dump sms train trace")
     dump_l1d_way_pre_trace = Param.Bool(False, "Dump l1d way predction trace")
     dump_lifetime = Param.Bool(False, "Dump inst lifetime")
+
+    # Trigger windows: with any trigger set, recording only happens inside
+    # windows opened by the triggers, from the start if dump_from_start is
+    # set and otherwise after start_recording()
+    trigger_inst_begin = Param.Counter(0,
+        "Open a window at this many committed instructions")
+    trigger_inst_end = Param.Counter(0,
+        "Close the instruction window at this many committed instructions, "
+        "0 keeps it open")
+    trigger_pc_low = Param.Addr(0, "Start of the PC range trigger")
+    trigger_pc_high = Param.Addr(0,
+        "End of the PC range trigger (exclusive), disabled if not above "
+        "trigger_pc_low")
+    trigger_pc_insts = Param.Counter(100000,
+        "Committed instructions recorded after the last PC range hit")
+    trigger_mpki = Param.Float(0,
+        "Record while cache misses per kilo-instruction are above this, "
+        "0 disables")
+    trigger_miss_level = Param.Int(1,
+        "Cache level whose demand misses count toward trigger_mpki")
+    trigger_ipc = Param.Float(0,
+        "Record while IPC, averaged over the cores, is below this, "
+        "0 disables")
+    trigger_interval = Param.Counter(100000,
+        "Rolling interval of the MPKI (instructions) and IPC (cycles) "
+        "triggers")
+    trigger_work_items = Param.Bool(False,
+        "Record between m5 workbegin and workend pseudo-instructions")
+    trigger_max_windows = Param.Unsigned(0,
+        "Stop opening windows after this many, 0 means no limit")
@@ -0,0 +1,17 @@
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import SimObject
+
+
+class MetricsServer(SimObject):
+    type = "MetricsServer"
+    cxx_header = "sim/metrics_server.hh"
+    cxx_class = "gem5::MetricsServer"
+
+    system = Param.System(Parent.any, "System whose CPUs are reported")
+    port = Param.Int(0, "Local TCP port to serve metrics on, 0 for none")
+    path = Param.String(
+        "", "UNIX-domain socket to serve metrics on, relative to the "
+        "output directory, empty for none")
+    stats = VectorParam.String(
+        [], "Statistics to report, named as in stats.txt")
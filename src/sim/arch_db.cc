@@ -1,12 +1,14 @@
 
 #include "sim/arch_db.hh"
 
+#include "base/cprintf.hh"
 #include "params/ArchDBer.hh"
+#include "sim/arch_db_trigger.hh"
 
 namespace gem5{
 
 ArchDBer::ArchDBer(const Params &p)
-    : SimObject(p), dumpGlobal(p.dump_from_start),
+    : SimObject(p), dumpGlobal(false),
     dumpRolling(p.enable_rolling),
     dumpMemTrace(p.dump_mem_trace),
     dumpL1PfTrace(p.dump_l1_pf_trace),
@@ -19,7 +21,10 @@ ArchDBer::ArchDBer(const Params &p)
     dumpL1WayPreTrace(p.dump_l1d_way_pre_trace),
     dumpLifetime(p.dump_lifetime),
     mem_db(nullptr), zErrMsg(nullptr),rc(0),
-    db_path(p.arch_db_file)
+    db_path(p.arch_db_file),
+    windowId(0), numWindows(0), maxWindows(p.trigger_max_windows),
+    triggerCommits(false), triggerCycles(false), triggerMisses(false),
+    triggerMissLevel(0)
 {
   int rc = sqlite3_open(":memory:", &mem_db);
   if (rc) {
@@ -33,13 +38,117 @@ ArchDBer::ArchDBer(const Params &p)
   for (const auto &s : p.table_cmds) {
     create_table(s);
   }
+  addWindowColumns();
+  create_table("CREATE TABLE ArchDBWindow("
+               "ID INTEGER PRIMARY KEY,"
+               "Cause TEXT,"
+               "StartTick INT NOT NULL,"
+               "EndTick INT NOT NULL,"
+               "StartInst INT NOT NULL,"
+               "EndInst INT NOT NULL);");
+
+  if (ArchDBTrigger::configured(p)) {
+    trigger = std::make_unique<ArchDBTrigger>(this, p);
+    triggerCommits = true;
+    triggerCycles = p.trigger_ipc > 0;
+    triggerMisses = p.trigger_mpki > 0;
+    triggerMissLevel = p.trigger_miss_level;
+    if (p.dump_from_start)
+      trigger->arm();
+  } else if (p.dump_from_start) {
+    openWindow("dump_from_start");
+  }
   registerExitCallback([this](){ save_db(); });
 }
 
+ArchDBer::~ArchDBer() = default;
+
 static int callback(void *NotUsed, int argc, char **argv, char **azColName){
   return 0;
 }
 
+static int
+tableNameCallback(void *names, int argc, char **argv, char **azColName)
+{
+  ((std::vector<std::string> *)names)->push_back(argv[0]);
+  return 0;
+}
+
+void
+ArchDBer::addWindowColumns()
+{
+  // Tag every row of the configured tables with the window it was written in
+  std::vector<std::string> names;
+  rc = sqlite3_exec(mem_db, "SELECT name FROM sqlite_master WHERE type='table';", tableNameCallback, &names,
+                    &zErrMsg);
+  fatal_if(rc != SQLITE_OK, "SQL error: %s\n", zErrMsg);
+  for (const auto &name : names) {
+    if (name.rfind("sqlite_", 0) == 0)
+      continue;
+    execmd("ALTER TABLE " + name + " ADD COLUMN WindowID INT NOT NULL DEFAULT 0;");
+  }
+}
+
+void
+ArchDBer::openWindow(const char *cause)
+{
+  if (dumpGlobal || (maxWindows && numWindows >= maxWindows))
+    return;
+  dumpGlobal = true;
+  windowId = ++numWindows;
+  execmd(csprintf("INSERT INTO ArchDBWindow(ID,Cause,StartTick,EndTick,StartInst,EndInst) "
+                  "VALUES(%lu,'%s',%lu,0,%lu,0);",
+                  windowId, cause, curTick(), trigger ? trigger->insts() : 0));
+  inform("ArchDB window %lu opened by %s\n", windowId, cause);
+}
+
+void
+ArchDBer::closeWindow()
+{
+  if (!dumpGlobal)
+    return;
+  execmd(csprintf("UPDATE ArchDBWindow SET EndTick=%lu,EndInst=%lu WHERE ID=%lu;",
+                  curTick(), trigger ? trigger->insts() : 0, windowId));
+  inform("ArchDB window %lu closed\n", windowId);
+  dumpGlobal = false;
+  windowId = 0;
+  if (maxWindows && numWindows >= maxWindows)
+    disableTriggers();
+}
+
+void
+ArchDBer::triggerCommit(Addr pc)
+{
+  trigger->commitInst(pc);
+}
+
+void
+ArchDBer::triggerCycle()
+{
+  trigger->cycle();
+}
+
+void
+ArchDBer::triggerMiss()
+{
+  trigger->cacheMiss();
+}
+
+void
+ArchDBer::workItem(bool begin)
+{
+  if (triggerCommits && trigger)
+    trigger->workItem(begin);
+}
+
+void
+ArchDBer::disableTriggers()
+{
+  triggerCommits = false;
+  triggerCycles = false;
+  triggerMisses = false;
+}
+
 void ArchDBer::create_table(const std::string &sql) {
   // create table
   rc = sqlite3_exec(mem_db, sql.c_str(), callback, 0, &zErrMsg);
@@ -48,10 +157,14 @@ void ArchDBer::create_table(const std::string &sql) {
 }
 
 void ArchDBer::start_recording() {
-  dumpGlobal = true;
+  if (trigger)
+    trigger->arm();
+  else
+    openWindow("start_recording");
 }
 
 void ArchDBer::save_db() {
+  closeWindow();
   warn("saving memdb to %s ...\n", db_path.c_str());
   sqlite3 *disk_db;
   sqlite3_backup *pBackup;
@@ -79,7 +192,7 @@ ArchDBer::execmd(std::string cmd)
 DBTraceManager *
 ArchDBer::addAndGetTrace(const char *name, std::vector<std::pair<std::string, DataType>> fields)
 {
-  _traces[name] = DBTraceManager(name, fields, mem_db);
+  _traces[name] = DBTraceManager(name, fields, mem_db, &windowId);
   return &_traces[name];
 }
 
@@ -92,9 +205,10 @@ ArchDBer::memTraceWrite(Tick tick, bool is_load, Addr pc, Addr vaddr, Addr paddr
 
   sprintf(
       memTraceSQLBuf,
-      "INSERT INTO MemTrace(Tick,IsLoad,PC,VADDR,PADDR,Issued,Translated,Completed,Committed,Writenback,PFSrc,SITE) "
-      "VALUES(%ld,%d,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%d,'%s');",
-      tick, is_load, pc, vaddr, paddr, issued, translated, completed, committed, writenback, pf_src, "CommitMemTrace");
+      "INSERT INTO MemTrace(Tick,IsLoad,PC,VADDR,PADDR,Issued,Translated,Completed,Committed,Writenback,PFSrc,SITE,"
+      "WindowID) VALUES(%ld,%d,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%d,'%s',%ld);",
+      tick, is_load, pc, vaddr, paddr, issued, translated, completed, committed, writenback, pf_src, "CommitMemTrace",
+      windowId);
   rc = sqlite3_exec(mem_db, memTraceSQLBuf, callback, 0, &zErrMsg);
   if (rc != SQLITE_OK) {
     fatal("SQL error: %s\n", zErrMsg);
@@ -108,9 +222,9 @@ ArchDBer::l1PFTraceWrite(Tick tick, Addr trigger_pc, Addr trigger_vaddr, Addr pf
   if (!dump_me) return;
 
   sprintf(memTraceSQLBuf,
-          "INSERT INTO L1PFTrace(Tick,TriggerPC,TriggerVAddr,PFVAddr,PFSrc,SITE) "
-          "VALUES(%ld,%ld,%ld,%ld,%d,'%s');",
-          tick, trigger_pc, trigger_vaddr, pf_vaddr, pf_src, "L1PFTrace");
+          "INSERT INTO L1PFTrace(Tick,TriggerPC,TriggerVAddr,PFVAddr,PFSrc,SITE,WindowID) "
+          "VALUES(%ld,%ld,%ld,%ld,%d,'%s',%ld);",
+          tick, trigger_pc, trigger_vaddr, pf_vaddr, pf_src, "L1PFTrace", windowId);
   rc = sqlite3_exec(mem_db, memTraceSQLBuf, callback, 0, &zErrMsg);
   if (rc != SQLITE_OK) {
     fatal("SQL error: %s\n", zErrMsg);
@@ -124,9 +238,9 @@ ArchDBer::bopTrainTraceWrite(Tick tick, Addr old_addr, Addr cur_addr, Addr offse
   if (!dump_me) return;
 
   sprintf(memTraceSQLBuf,
-          "INSERT INTO BOPTrainTrace(Tick,OldAddr,CurAddr,Offset,Score,Miss,SITE) "
-          "VALUES(%ld,%ld,%ld,%ld,%d,%d,'%s');",
-          tick, old_addr, cur_addr, offset, score, miss, "BOPTrain");
+          "INSERT INTO BOPTrainTrace(Tick,OldAddr,CurAddr,Offset,Score,Miss,SITE,WindowID) "
+          "VALUES(%ld,%ld,%ld,%ld,%d,%d,'%s',%ld);",
+          tick, old_addr, cur_addr, offset, score, miss, "BOPTrain", windowId);
   rc = sqlite3_exec(mem_db, memTraceSQLBuf, callback, 0, &zErrMsg);
   if (rc != SQLITE_OK) {
     fatal("SQL error: %s\n", zErrMsg);
@@ -140,9 +254,9 @@ ArchDBer::smsTrainTraceWrite(Tick tick, Addr old_addr, Addr cur_addr, Addr trigg
   if (!dump_me) return;
 
   sprintf(memTraceSQLBuf,
-          "INSERT INTO SMSTrainTrace(Tick,OldAddr,CurAddr,TriggerOffset,Conf,Miss,SITE) "
-          "VALUES(%ld,%ld,%ld,%ld,%d,%d,'%s');",
-          tick, old_addr, cur_addr, trigger_offset, conf, miss, "SMSTrain");
+          "INSERT INTO SMSTrainTrace(Tick,OldAddr,CurAddr,TriggerOffset,Conf,Miss,SITE,WindowID) "
+          "VALUES(%ld,%ld,%ld,%ld,%d,%d,'%s',%ld);",
+          tick, old_addr, cur_addr, trigger_offset, conf, miss, "SMSTrain", windowId);
   rc = sqlite3_exec(mem_db, memTraceSQLBuf, callback, 0, &zErrMsg);
   if (rc != SQLITE_OK) {
     fatal("SQL error: %s\n", zErrMsg);
@@ -161,9 +275,9 @@ void ArchDBer::L1MissTrace_write(
   if (!dump_me) return;
   char sql[512];
   sprintf(sql,
-    "INSERT INTO L1MissTrace(PC,SOURCE,PADDR,VADDR, STAMP, SITE) " \
-    "VALUES(%ld, %ld, %ld, %ld, %ld, '%s');",
-    pc,source,paddr,vaddr, stamp, site
+    "INSERT INTO L1MissTrace(PC,SOURCE,PADDR,VADDR, STAMP, SITE, WindowID) " \
+    "VALUES(%ld, %ld, %ld, %ld, %ld, '%s', %ld);",
+    pc,source,paddr,vaddr, stamp, site, windowId
   );
   rc = sqlite3_exec(mem_db, sql, callback, 0, &zErrMsg);
   if (rc != SQLITE_OK) {
@@ -179,9 +293,9 @@ ArchDBer::dcacheWayPreTrace(Tick tick, uint64_t pc, uint64_t vaddr, int way, int
         return;
     char sql[512];
     sprintf(sql,
-            "INSERT INTO dcacheWayPreTrace(PC,VADDR, WAY, Tick, IsWrite,SITE)"
-            "VALUES(%ld,%ld,%ld,%ld,%ld,'%s');",
-            pc, vaddr, (uint64_t)way, tick, (uint64_t)is_write, "dacheWayPre");
+            "INSERT INTO dcacheWayPreTrace(PC,VADDR, WAY, Tick, IsWrite,SITE,WindowID)"
+            "VALUES(%ld,%ld,%ld,%ld,%ld,'%s',%ld);",
+            pc, vaddr, (uint64_t)way, tick, (uint64_t)is_write, "dacheWayPre", windowId);
     rc = sqlite3_exec(mem_db, sql, callback, 0, &zErrMsg);
     if (rc != SQLITE_OK) {
         fatal("SQL error: %s\n", zErrMsg);
@@ -196,9 +310,9 @@ ArchDBer::evictTraceWrite(int cache_level, Tick tick, uint64_t paddr, uint64_t s
   if (!dump_me) return;
   char sql[512];
   sprintf(sql,
-    "INSERT INTO CacheEvictTrace(Tick, PADDR, STAMP, Level, SITE) " \
-    "VALUES(%ld, %ld, %ld, %ld, '%s');",
-    tick, paddr, stamp, (int64_t) cache_level, site
+    "INSERT INTO CacheEvictTrace(Tick, PADDR, STAMP, Level, SITE, WindowID) " \
+    "VALUES(%ld, %ld, %ld, %ld, '%s', %ld);",
+    tick, paddr, stamp, (int64_t) cache_level, site, windowId
   );
   rc = sqlite3_exec(mem_db, sql, callback, 0, &zErrMsg);
   if (rc != SQLITE_OK) {
@@ -214,7 +328,7 @@ DBTraceManager::init_table() {
   pos = sprintf(sql,
     "CREATE TABLE %s(" \
     "ID INTEGER PRIMARY KEY AUTOINCREMENT, " \
-    "TICK INT NOT NULL", _name.c_str());
+    "TICK INT NOT NULL,WindowID INT NOT NULL", _name.c_str());
   for (auto it = _fields.begin(); it != _fields.end(); it++) {
     switch (it->second) {
       case UINT64:
@@ -244,11 +358,11 @@ DBTraceManager::write_record(const Record &record)
 {
   char sql[1024];
   int pos = 0;
-  pos = sprintf(sql, "INSERT INTO %s(TICK", _name.c_str());
+  pos = sprintf(sql, "INSERT INTO %s(TICK,WindowID", _name.c_str());
   for (auto it = _fields.begin(); it != _fields.end(); it++) {
     pos += sprintf(sql+pos, ",%s", it->first.c_str());
   }
-  pos += sprintf(sql+pos, ") VALUES(%ld", record._tick);
+  pos += sprintf(sql+pos, ") VALUES(%ld,%ld", record._tick, _windowId ? *_windowId : 0);
   for (auto it = _fields.begin(); it != _fields.end(); it++) {
     switch (it->second) {
       case UINT64:
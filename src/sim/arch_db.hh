@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 
 #include "base/logging.hh"
 #include "base/types.hh"
@@ -20,6 +21,7 @@
 
 namespace gem5{
 
+class ArchDBTrigger;
 class BaseCache;
 
 class DBTraceManager
@@ -27,13 +29,16 @@ class DBTraceManager
   std::string _name;
   std::map<std::string, DataType> _fields;
   sqlite3 *_db;
+  const uint64_t *_windowId = nullptr;
 public:
-  DBTraceManager(const char *name, std::vector<std::pair<std::string, DataType>> fields, sqlite3 *db) {
+  DBTraceManager(const char *name, std::vector<std::pair<std::string, DataType>> fields, sqlite3 *db,
+                 const uint64_t *window_id) {
     _name = name;
     for (auto it = fields.begin(); it != fields.end(); it++) {
       _fields[it->first] = it->second;
     }
     _db = db;
+    _windowId = window_id;
   }
   DBTraceManager() {}
   void init_table();
@@ -45,10 +50,22 @@ class ArchDBer : public SimObject
   public:
     PARAMS(ArchDBer);
     ArchDBer(const Params &p);
+    ~ArchDBer();
 
-    //let db start recording
+    //let db start recording, or arm the triggers if there are any
     void start_recording();
 
+    /** Recording windows, rows written inside one carry its WindowID */
+    bool recording() const { return dumpGlobal; }
+    void openWindow(const char *cause);
+    void closeWindow();
+
+    /** Trigger hooks, a flag check unless a trigger needs them */
+    void commitInst(Addr pc) { if (triggerCommits) [[unlikely]] triggerCommit(pc); }
+    void cpuCycle() { if (triggerCycles) [[unlikely]] triggerCycle(); }
+    void cacheMiss(int cache_level) { if (triggerMisses && cache_level == triggerMissLevel) [[unlikely]] triggerMiss(); }
+    void workItem(bool begin);
+
     //variables from chisel generate cpp
     bool dumpGlobal;
     bool dumpRolling;
@@ -72,7 +89,24 @@ class ArchDBer : public SimObject
     // a trace corrsponds to a table
     std::map<std::string, DBTraceManager> _traces;
 
+    /** Open window, 0 outside windows */
+    uint64_t windowId;
+    uint64_t numWindows;
+    const uint64_t maxWindows;
+
+    std::unique_ptr<ArchDBTrigger> trigger;
+    bool triggerCommits;
+    bool triggerCycles;
+    bool triggerMisses;
+    int triggerMissLevel;
+
+    void triggerCommit(Addr pc);
+    void triggerCycle();
+    void triggerMiss();
+    void disableTriggers();
+
     void create_table(const std::string &sql);
+    void addWindowColumns();
 
     void save_db();
   public:
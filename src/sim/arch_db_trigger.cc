@@ -0,0 +1,112 @@
+#include "sim/arch_db_trigger.hh"
+
+#include <algorithm>
+
+#include "base/trace.hh"
+#include "debug/ArchDB.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+const char *causeNames[ArchDBTrigger::NumCauses] = {
+    "InstRange", "PCHit", "HighMPKI", "LowIPC", "WorkItem"
+};
+
+} // anonymous namespace
+
+ArchDBTrigger::ArchDBTrigger(ArchDBer *db, const ArchDBerParams &p)
+    : db(db),
+      instBegin(p.trigger_inst_begin),
+      instEnd(p.trigger_inst_end),
+      pcLow(p.trigger_pc_low),
+      pcHigh(p.trigger_pc_high),
+      pcInsts(p.trigger_pc_insts),
+      mpkiThreshold(p.trigger_mpki),
+      ipcThreshold(p.trigger_ipc),
+      missRolling("archdb_trigger_mpki", nullptr, p.trigger_interval),
+      ipcRolling("archdb_trigger_ipc", nullptr, p.trigger_interval)
+{
+    fatal_if(instEnd && instEnd <= instBegin,
+             "ArchDB trigger instruction range [%lu, %lu) is empty\n",
+             instBegin, instEnd);
+    fatal_if(p.trigger_interval == 0, "ArchDB trigger interval must be positive\n");
+
+    missRolling.setOnRoll([this](Counter misses, Counter insts) {
+        set(HighMPKI, misses * 1000.0 / insts > mpkiThreshold);
+    });
+    ipcRolling.setOnRoll([this](Counter insts, Counter cycles) {
+        set(LowIPC, double(insts) / cycles < ipcThreshold);
+    });
+}
+
+bool
+ArchDBTrigger::configured(const ArchDBerParams &p)
+{
+    return p.trigger_inst_begin || p.trigger_inst_end ||
+           p.trigger_pc_high > p.trigger_pc_low || p.trigger_mpki > 0 ||
+           p.trigger_ipc > 0 || p.trigger_work_items;
+}
+
+void
+ArchDBTrigger::commitInst(Addr pc)
+{
+    ++instCount;
+    if (instBegin || instEnd) {
+        set(InstRange, instCount >= instBegin && (!instEnd || instCount < instEnd));
+    }
+    if (pcHigh > pcLow) {
+        if (pc >= pcLow && pc < pcHigh) {
+            pcWindowEnd = instCount + pcInsts;
+            set(PCHit, true);
+        } else if (instCount >= pcWindowEnd) {
+            set(PCHit, false);
+        }
+    }
+    if (mpkiThreshold > 0)
+        missRolling.roll(1);
+    if (ipcThreshold > 0)
+        ipcRolling++;
+}
+
+void
+ArchDBTrigger::workItem(bool begin)
+{
+    workItems = begin ? workItems + 1 : std::max(workItems - 1, 0);
+    set(WorkItem, workItems > 0);
+}
+
+void
+ArchDBTrigger::arm()
+{
+    armed = true;
+    for (int cause = 0; cause < NumCauses; cause++) {
+        if (active & (1 << cause)) {
+            db->openWindow(causeNames[cause]);
+            break;
+        }
+    }
+}
+
+void
+ArchDBTrigger::set(Cause cause, bool on)
+{
+    unsigned bit = 1 << cause;
+    if (on == bool(active & bit))
+        return;
+
+    active = on ? (active | bit) : (active & ~bit);
+    DPRINTF(ArchDB, "Trigger %s %s at inst %lu\n", causeNames[cause],
+            on ? "on" : "off", instCount);
+    if (!armed)
+        return;
+    if (on && !db->recording()) {
+        db->openWindow(causeNames[cause]);
+    } else if (!active && db->recording()) {
+        db->closeWindow();
+    }
+}
+
+} // namespace gem5
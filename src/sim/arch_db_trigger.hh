@@ -0,0 +1,74 @@
+#ifndef __SIM_ARCH_DB_TRIGGER_HH__
+#define __SIM_ARCH_DB_TRIGGER_HH__
+
+#include "base/types.hh"
+#include "params/ArchDBer.hh"
+#include "sim/rolling.hh"
+
+namespace gem5
+{
+
+/**
+ * Opens and closes ArchDB recording windows on conditions seen during
+ * simulation: a committed instruction range, a committed PC inside an
+ * address range, an MPKI or IPC threshold crossed over a rolling interval,
+ * or m5 workbegin/workend pseudo-instructions. A window stays open while
+ * any condition holds, and conditions only open windows once armed.
+ */
+class ArchDBTrigger
+{
+  public:
+    enum Cause
+    {
+        InstRange = 0,
+        PCHit,
+        HighMPKI,
+        LowIPC,
+        WorkItem,
+        NumCauses
+    };
+
+    ArchDBTrigger(ArchDBer *db, const ArchDBerParams &p);
+
+    /** True if the parameters configure any condition */
+    static bool configured(const ArchDBerParams &p);
+
+    void commitInst(Addr pc);
+    void cycle() { ipcRolling.roll(1); }
+    void cacheMiss() { missRolling++; }
+    void workItem(bool begin);
+
+    /** Let conditions open windows, e.g. once warmup is over */
+    void arm();
+
+    Counter insts() const { return instCount; }
+
+  private:
+    void set(Cause cause, bool on);
+
+    ArchDBer *db;
+    bool armed = false;
+    /** Bit mask of the conditions that currently hold */
+    unsigned active = 0;
+
+    const Counter instBegin;
+    const Counter instEnd;
+    const Addr pcLow;
+    const Addr pcHigh;
+    const Counter pcInsts;
+    Counter pcWindowEnd = 0;
+    const double mpkiThreshold;
+    const double ipcThreshold;
+
+    /** Cache misses per committed instruction */
+    Rolling missRolling;
+    /** Committed instructions per cycle */
+    Rolling ipcRolling;
+
+    int workItems = 0;
+    Counter instCount = 0;
+};
+
+} // namespace gem5
+
+#endif // __SIM_ARCH_DB_TRIGGER_HH__
@@ -0,0 +1,235 @@
+#include "sim/metrics_server.hh"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <sstream>
+
+#include "base/cprintf.hh"
+#include "base/hostinfo.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "cpu/base.hh"
+#include "cpu/thread_context.hh"
+#include "sim/eventq.hh"
+#include "sim/root.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+std::string
+jsonNumber(double value)
+{
+    return std::isfinite(value) ? csprintf("%.6g", value) : "null";
+}
+
+} // anonymous namespace
+
+MetricsServer::ListenEvent::ListenEvent(MetricsServer *s, ListenSocket *l)
+    : PollEvent(l->getfd(), POLLIN), server(s), listener(l)
+{
+}
+
+void
+MetricsServer::ListenEvent::process(int revent)
+{
+    server->accept(listener);
+}
+
+MetricsServer::DataEvent::DataEvent(MetricsServer *s, int fd)
+    : PollEvent(fd, POLLIN), server(s)
+{
+}
+
+void
+MetricsServer::DataEvent::process(int revent)
+{
+    // Called from the poll queue, possibly on another thread
+    EventQueue::ScopedMigration migrate(server->eventQueue());
+
+    if (revent & POLLIN)
+        server->data(pfd.fd);
+    else if (revent & (POLLHUP | POLLERR | POLLNVAL))
+        server->detach(pfd.fd);
+}
+
+MetricsServer::MetricsServer(const Params &p)
+    : SimObject(p), system(p.system), statNames(p.stats),
+      startTime(std::chrono::steady_clock::now())
+{
+    fatal_if(!p.port && p.path.empty(),
+             "%s: needs a port or a path to serve metrics on\n", name());
+
+    if (p.port) {
+        if (ListenSocket::allDisabled()) {
+            warn("Sockets disabled, not serving metrics on a port, use "
+                 "--listener-mode=on or a UNIX-domain socket");
+        } else {
+            int port = p.port;
+            while (!tcpListener.listen(port, true))
+                port++;
+            inform("%s: serving metrics on port %d", name(), port);
+            listenEvents.emplace_back(new ListenEvent(this, &tcpListener));
+        }
+    }
+
+    if (!p.path.empty()) {
+        std::string path = simout.resolve(p.path);
+        fatal_if(!unixListener.listenUnix(path),
+                 "%s: cannot serve metrics on %s\n", name(), path);
+        inform("%s: serving metrics on %s", name(), path);
+        listenEvents.emplace_back(new ListenEvent(this, &unixListener));
+    }
+
+    for (auto &event : listenEvents)
+        pollQueue.schedule(event.get());
+}
+
+MetricsServer::~MetricsServer()
+{
+    while (!clients.empty())
+        detach(clients.begin()->first);
+}
+
+void
+MetricsServer::startup()
+{
+    // Statistics are registered once every SimObject has been created
+    for (const auto &stat_name : statNames) {
+        const statistics::Info *info = Root::root()->resolveStat(stat_name);
+        fatal_if(!info, "%s: no statistic named %s\n", name(), stat_name);
+        fatal_if(!dynamic_cast<const statistics::ScalarInfo *>(info) &&
+                 !dynamic_cast<const statistics::VectorInfo *>(info),
+                 "%s: %s is not a scalar, vector or formula\n", name(),
+                 stat_name);
+        stats.push_back(info);
+    }
+}
+
+void
+MetricsServer::accept(ListenSocket *listener)
+{
+    int fd = listener->accept();
+    if (fd < 0) {
+        warn("%s: accept failed: %s", name(), strerror(errno));
+        return;
+    }
+
+    Client &client = clients[fd];
+    client.event.reset(new DataEvent(this, fd));
+    client.lastTime = startTime;
+    pollQueue.schedule(client.event.get());
+}
+
+void
+MetricsServer::data(int fd)
+{
+    char buf[256];
+    ssize_t len = ::read(fd, buf, sizeof(buf));
+    if (len <= 0) {
+        if (len == 0 || errno != EINTR)
+            detach(fd);
+        return;
+    }
+
+    Client &client = clients[fd];
+    client.request.append(buf, len);
+    size_t end;
+    while ((end = client.request.find('\n')) != std::string::npos) {
+        client.request.erase(0, end + 1);
+
+        std::string reply = snapshot(client);
+        for (size_t sent = 0; sent < reply.size();) {
+            // Do not let a client that went away kill the simulator
+            ssize_t ret = ::send(fd, reply.data() + sent,
+                                 reply.size() - sent, MSG_NOSIGNAL);
+            if (ret < 0 && errno == EINTR)
+                continue;
+            if (ret <= 0) {
+                detach(fd);
+                return;
+            }
+            sent += ret;
+        }
+    }
+}
+
+void
+MetricsServer::detach(int fd)
+{
+    // The event leaves the poll queue before its descriptor is closed
+    clients.erase(fd);
+    ::close(fd);
+}
+
+std::string
+MetricsServer::snapshot(Client &client)
+{
+    auto now = std::chrono::steady_clock::now();
+    double window = std::chrono::duration<double>(now - client.lastTime)
+        .count();
+    Counter insts = BaseCPU::numSimulatedInsts();
+
+    std::ostringstream os;
+    ccprintf(os, "{\"tick\":%d,\"insts\":%d,\"ipc\":{", curTick(), insts);
+
+    // Report the CPUs that currently run the system's threads, which
+    // follows CPU switching
+    std::vector<BaseCPU *> cpus;
+    for (auto *tc : system->threads) {
+        if (std::find(cpus.begin(), cpus.end(), tc->getCpuPtr()) ==
+                cpus.end()) {
+            cpus.push_back(tc->getCpuPtr());
+        }
+    }
+    const char *sep = "";
+    for (auto *cpu : cpus) {
+        auto &last = client.lastCpus[cpu->name()];
+        Counter cpu_insts = cpu->totalInsts();
+        Cycles cycles = cpu->curCycle();
+        double ipc = cycles > last.second ?
+            double(cpu_insts - last.first) / (cycles - last.second) : NAN;
+        ccprintf(os, "%s\"%s\":%s", sep, cpu->name(), jsonNumber(ipc));
+        last = {cpu_insts, cycles};
+        sep = ",";
+    }
+
+    ccprintf(os, "},\"kips\":%s,\"rss_kb\":%d,\"host_seconds\":%s,"
+             "\"stats\":{",
+             jsonNumber((insts - client.lastInsts) / window / 1000),
+             rssUsage(),
+             jsonNumber(std::chrono::duration<double>(now - startTime)
+                        .count()));
+    // Stats such as the O3 hot counters are only brought up to date right
+    // before a dump, do the same here
+    if (!stats.empty())
+        Root::root()->preDumpStats();
+    sep = "";
+    for (int i = 0; i < stats.size(); i++) {
+        double value;
+        if (auto *scalar =
+                dynamic_cast<const statistics::ScalarInfo *>(stats[i])) {
+            value = scalar->result();
+        } else {
+            value = static_cast<const statistics::VectorInfo *>(stats[i])
+                ->total();
+        }
+        ccprintf(os, "%s\"%s\":%s", sep, statNames[i], jsonNumber(value));
+        sep = ",";
+    }
+    os << "}}\n";
+
+    client.lastTime = now;
+    client.lastInsts = insts;
+    return os.str();
+}
+
+} // namespace gem5
@@ -0,0 +1,90 @@
+#ifndef __SIM_METRICS_SERVER_HH__
+#define __SIM_METRICS_SERVER_HH__
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/pollevent.hh"
+#include "base/socket.hh"
+#include "base/stats/info.hh"
+#include "base/types.hh"
+#include "params/MetricsServer.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+class System;
+
+/**
+ * Serves a snapshot of the running simulation to local clients, so that
+ * job schedulers can watch progress without parsing logs. Every line a
+ * client sends is answered with one line of JSON holding the tick, the
+ * committed instructions, the IPC of each active CPU and the host KIPS
+ * since the client's previous request, the resident memory, and the
+ * configured statistics.
+ */
+class MetricsServer : public SimObject
+{
+  public:
+    PARAMS(MetricsServer);
+    MetricsServer(const Params &p);
+    ~MetricsServer();
+
+    void startup() override;
+
+  private:
+    class ListenEvent : public PollEvent
+    {
+      protected:
+        MetricsServer *server;
+        ListenSocket *listener;
+
+      public:
+        ListenEvent(MetricsServer *s, ListenSocket *l);
+        void process(int revent) override;
+    };
+
+    class DataEvent : public PollEvent
+    {
+      protected:
+        MetricsServer *server;
+
+      public:
+        DataEvent(MetricsServer *s, int fd);
+        void process(int revent) override;
+    };
+
+    /** State of a connected client, the window starts at its last request */
+    struct Client
+    {
+        std::unique_ptr<DataEvent> event;
+        std::string request;
+        std::chrono::steady_clock::time_point lastTime;
+        Counter lastInsts = 0;
+        /** Committed instructions and cycles of each CPU, by name */
+        std::map<std::string, std::pair<Counter, Cycles>> lastCpus;
+    };
+
+    void accept(ListenSocket *listener);
+    void data(int fd);
+    void detach(int fd);
+    std::string snapshot(Client &client);
+
+    System *system;
+    ListenSocket tcpListener;
+    ListenSocket unixListener;
+    std::vector<std::unique_ptr<ListenEvent>> listenEvents;
+    std::map<int, Client> clients;
+
+    std::vector<std::string> statNames;
+    std::vector<const statistics::Info *> stats;
+    std::chrono::steady_clock::time_point startTime;
+};
+
+} // namespace gem5
+
+#endif // __SIM_METRICS_SERVER_HH__
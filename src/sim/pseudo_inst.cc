@@ -500,6 +500,8 @@ workbegin(ThreadContext *tc, uint64_t workid, uint64_t threadid)
             threadid);
     tc->getCpuPtr()->workItemBegin();
     sys->workItemBegin(threadid, workid);
+    if (params.arch_db)
+        params.arch_db->workItem(true);
 
     //
     // If specified, determine if this is the specific work item the user
@@ -562,6 +564,8 @@ workend(ThreadContext *tc, uint64_t workid, uint64_t threadid)
     DPRINTF(WorkItems, "Work End workid: %d, threadid %d\n", workid, threadid);
     tc->getCpuPtr()->workItemEnd();
     sys->workItemEnd(threadid, workid);
+    if (params.arch_db)
+        params.arch_db->workItem(false);
 
     //
     // If specified, determine if this is the specific work item the user
@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 
 #include "base/types.hh"
 #include "sim/arch_db.hh"
@@ -24,6 +25,8 @@ class Rolling
     Counter base_interval;
     ArchDBer *archDBer;
     DBTraceManager *traceManager;
+    // Called with (value, base) at the end of every interval
+    std::function<void(Counter, Counter)> onRoll;
 
   public:
     Rolling(const char *name, const char *desc = nullptr,
@@ -46,6 +49,8 @@ class Rolling
       traceManager->init_table();
     }
 
+    void setOnRoll(std::function<void(Counter, Counter)> f) { onRoll = f; }
+
     void operator++(int) { value_interval++; }
 
     void operator++() { assert(false && "Not implemented\n"); }
@@ -69,15 +74,20 @@ class Rolling
       base += v;
       base_interval += v;
       bool dump = (base_interval >= interval);
-      if (dump && enabled)
+      if (dump && (enabled || onRoll))
       {
+        Counter interval_base = base_interval;
         Counter y_value = get_value_and_clean();
         Counter x_value = get_base_and_clean();
-        Record pt;
-        pt._tick = curTick() / 333;
-        pt._uint64_data["yAxisPt"] = y_value;
-        pt._uint64_data["xAxisPt"] = x_value;
-        traceManager->write_record(pt);
+        if (enabled) {
+          Record pt;
+          pt._tick = curTick() / 333;
+          pt._uint64_data["yAxisPt"] = y_value;
+          pt._uint64_data["xAxisPt"] = x_value;
+          traceManager->write_record(pt);
+        }
+        if (onRoll)
+          onRoll(y_value, interval_base);
       }
     }
 };
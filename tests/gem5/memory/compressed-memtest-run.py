@@ -0,0 +1,77 @@
+import argparse
+
+import m5
+from m5.objects import *
+m5.util.addToPath('../../../configs/')
+from common.Caches import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument('--validate-size-fast-path', action='store_true',
+                    help='Cross-check every size-only compression against '
+                         'the full encoding')
+args = parser.parse_args()
+
+nb_cores = 2
+cpus = [MemTest(max_loads = 2e4, progress_interval = 1e4)
+        for i in range(nb_cores) ]
+
+system = System(cpu = cpus,
+                physmem = SimpleMemory(),
+                membus = SystemXBar())
+system.voltage_domain = VoltageDomain()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+
+system.cpu_clk_domain = SrcClockDomain(clock = '2GHz',
+                                       voltage_domain = system.voltage_domain)
+
+# A compressed L2, with a sub-compressor of each kind that has a size-only
+# fast path and one that has not
+compressors = [ZeroCompressor(), RepeatedQwordsCompressor(), Base64Delta8(),
+               Base32Delta16(), FPC(), CPack()]
+for compressor in compressors:
+    compressor.validate_size_fast_path = args.validate_size_fast_path
+system.toL2Bus = L2XBar(clk_domain = system.cpu_clk_domain)
+system.l2c = L2Cache(clk_domain = system.cpu_clk_domain, size='16kB', assoc=8,
+                     tags = CompressedTags(),
+                     compressor = MultiCompressor(compressors = compressors,
+                         validate_size_fast_path =
+                             args.validate_size_fast_path))
+system.l2c.cpu_side = system.toL2Bus.mem_side_ports
+
+system.l2c.mem_side = system.membus.cpu_side_ports
+
+for cpu in cpus:
+    # All cpus are associated with cpu_clk_domain
+    cpu.clk_domain = system.cpu_clk_domain
+    cpu.l1c = L1Cache(size = '4kB', assoc = 4)
+    cpu.l1c.cpu_side = cpu.port
+    cpu.l1c.mem_side = system.toL2Bus.cpu_side_ports
+
+system.system_port = system.membus.cpu_side_ports
+
+system.physmem.port = system.membus.mem_side_ports
+
+root = Root( full_system = False, system = system )
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+exit_event = m5.simulate()
+if exit_event.getCause() != "maximum number of loads reached":
+    exit(1)
+
+# A fast path that disagrees with the full encoding panics. The full
+# encodings run for validation must not be counted: every sub-compressor
+# compresses each line exactly once, as the multi-compressor does
+def compressions(compressor):
+    return compressor.getCCObject().resolveStat('compressions').value
+
+multi_compressions = compressions(system.l2c.compressor)
+if multi_compressions == 0:
+    exit(1)
+for compressor in compressors:
+    if compressions(compressor) != multi_compressions:
+        print("%s: %d compressions, %d in %s" % (compressor.path(),
+              compressions(compressor), multi_compressions,
+              system.l2c.compressor.path()))
+        exit(1)
@@ -67,6 +67,17 @@ gem5_verify_config(
     valid_isas=(constants.null_tag,),
 )
 
+for name, args in (('compressed_memtest', []),
+                   ('compressed_memtest_validate',
+                    ['--validate-size-fast-path'])):
+    gem5_verify_config(
+        name=name,
+        verifiers=(), # No need for verfiers this will return non-zero on fail
+        config=joinpath(getcwd(), 'compressed-memtest-run.py'),
+        config_args = args,
+        valid_isas=(constants.null_tag,),
+    )
+
 null_tests = [
     ('garnet_synth_traffic', None, ['--sim-cycles', '5000000']),
     ('memcheck', None, ['--maxtick', '2000000000', '--prefetchers']),
@@ -0,0 +1,71 @@
+# Replay a synthetic strided load stream through
+# configs/example/pf_trace_replay.py and check that the prefetcher covers
+# some of its misses. Extra arguments are passed to pf_trace_replay.py.
+
+import os
+import runpy
+import struct
+import sys
+
+import m5
+
+MAGIC = b"XSPFTRC2"
+MISS = 1 << 0
+VALID_PC = 1 << 3
+FILL = 1 << 8
+
+ACCESSES = 8192
+STRIDE = 128
+ACCESS_TICKS = 10000
+FILL_TICKS = 50000
+
+
+def write_trace(path):
+    records = []
+    for i in range(ACCESSES):
+        addr = 0x80100000 + i * STRIDE
+        tick = i * ACCESS_TICKS
+        records.append((tick, addr, 8, MISS | VALID_PC))
+        records.append((tick + FILL_TICKS, addr & ~63, 64, FILL | VALID_PC))
+    records.sort(key=lambda r: r[0])
+
+    n = len(records)
+    with open(path, "wb") as f:
+        f.write(MAGIC)
+        f.write(struct.pack("<I", n))
+        f.write(struct.pack("<%dQ" % n, *[r[0] for r in records]))
+        f.write(struct.pack("<%dQ" % n, *[0x80000400] * n))
+        f.write(struct.pack("<%dQ" % n, *[r[1] for r in records]))
+        f.write(struct.pack("<%dQ" % n, *[r[1] for r in records]))
+        f.write(struct.pack("<%dH" % n, *[r[2] for r in records]))
+        f.write(struct.pack("<%dH" % n, *[0] * n))
+        f.write(struct.pack("<%dH" % n, *[r[3] for r in records]))
+        f.write(struct.pack("<%dB" % n, *[0] * n))
+
+
+def read_stat(stats, name):
+    with open(stats) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) > 1 and fields[0] == name:
+                return float(fields[1])
+    sys.exit("%s missing from %s" % (name, stats))
+
+
+trace = os.path.join(m5.options.outdir, "strided.pf.trace")
+write_trace(trace)
+
+config = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..",
+                      "..", "configs", "example", "pf_trace_replay.py")
+sys.argv = [config, "--trace", trace] + sys.argv[1:]
+runpy.run_path(config, run_name="__main__")
+
+m5.stats.dump()
+stats = os.path.join(m5.options.outdir, "stats.txt")
+accesses = read_stat(stats, "system.replayer.accesses")
+issued = read_stat(stats, "system.replayer.pfIssued")
+covered = read_stat(stats, "system.replayer.coveredMisses")
+print("accesses %d prefetches %d covered misses %d" %
+      (accesses, issued, covered))
+if accesses != ACCESSES or issued == 0 or covered == 0:
+    sys.exit("prefetcher did not replay the strided stream")
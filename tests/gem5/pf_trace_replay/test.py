@@ -0,0 +1,23 @@
+'''
+Replays a synthetic training trace on each prefetcher that
+configs/example/pf_trace_replay.py supports and checks that the strided
+stream gets covered.
+'''
+
+from testlib import *
+
+prefetchers = [
+    'XSStridePrefetcher',
+    'BertiPrefetcher',
+    'BOPPrefetcher',
+    'XSCompositePrefetcher',
+]
+
+for prefetcher in prefetchers:
+    gem5_verify_config(
+        name='pf_trace_replay_' + prefetcher,
+        verifiers=(), # The config exits non-zero if nothing was covered
+        config=joinpath(getcwd(), 'replay-run.py'),
+        config_args=['--prefetcher', prefetcher],
+        valid_isas=(constants.riscv_tag,),
+    )
@@ -8,6 +8,10 @@ parser.add_argument('sqldb')
 parser.add_argument('-v', '--visual', action='store_true', default=False)
 parser.add_argument('-z', '--zoom', action='store', type=float, default=1)
 parser.add_argument('-p', '--period', action='store', default=333)
+parser.add_argument('-w', '--window', action='store', type=int, default=None,
+                    help='only dump instructions of this ArchDB window')
+parser.add_argument('--pipeview', action='store_true', default=False,
+                    help='print O3PipeView lines for util/o3-pipeview.py')
 
 args = parser.parse_args()
 
@@ -64,6 +68,20 @@ def dump_txt(pos, records):
     print(records)
 
 
+# o3-pipeview.py stage name and the lifetime column it is read from
+pipeview_stages = [('decode', 'atdecode'), ('rename', 'atrename'),
+                   ('dispatch', 'atdispque'), ('issue', 'atissuearb'),
+                   ('complete', 'atwriteval')]
+
+
+def dump_pipeview(sn, inst):
+    pc = inst['pc'] + (1 << 64) if inst['pc'] < 0 else inst['pc']
+    print(f"O3PipeView:fetch:{inst['atfetch']}:{pc:#010x}:0:{sn}:{inst['disasm']}")
+    for name, col in pipeview_stages:
+        print(f'O3PipeView:{name}:{inst[col]}')
+    print(f"O3PipeView:retire:{inst['atcommit']}:store:0")
+
+
 dump = dump_txt
 if args.visual:
     dump = dump_visual
@@ -74,9 +92,20 @@ with sql.connect(sqldb) as con:
     col_name = [i[0] for i in cur.description]
     col_name = col_name[1:]
     col_name = [i.lower() for i in col_name]
+    window_col = col_name.index('windowid') if 'windowid' in col_name else None
+    if window_col is not None:
+        del col_name[window_col]
     rows = cur.fetchall()
     for row in rows:
+        sn = row[0]
         row = row[1:]
+        if window_col is not None:
+            if args.window is not None and row[window_col] != args.window:
+                continue
+            row = row[:window_col] + row[window_col + 1:]
+        if args.pipeview:
+            dump_pipeview(sn, dict(zip(col_name, row)))
+            continue
         pos = []
         records = []
         i = 0
@@ -85,7 +114,7 @@ with sql.connect(sqldb) as con:
                 pos.append(val//tick_per_cycle)
             elif col_name[i].startswith('pc'):
                 if val < 0:
-                    val = val + 1 << 64
+                    val = val + (1 << 64)
                 records.append(hex(val))
             else:
                 records.append(val)
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+# Check that partitioned Ruby gives the same results on one event queue
+# and on one event queue per partition.
+#
+# Runs the given configuration with --ruby-partition-mode=serial and
+# --ruby-partition-mode=parallel, then compares every statistic except the
+# host ones. Serial mode keeps the quantum synchronisation of the parallel
+# mode, so any difference points at state shared between partitions.
+#
+#   util/ruby_partition_check.py --gem5 build/RISCV_CHI/gem5.opt \
+#       --outdir partition_check -- configs/example/xiangshan.py --ruby \
+#       --num-cpus=4 --generic-rv-cpt=<gcpt> --mem-type=DDR4_2400_8x8 \
+#       --disable-difftest
+
+import argparse
+import os
+import subprocess
+import sys
+
+MODES = ["serial", "parallel"]
+
+
+def read_stats(path):
+    stats = {}
+    with open(path) as f:
+        dump = 0
+        for line in f:
+            if line.startswith("---------- Begin Simulation Statistics"):
+                dump += 1
+                continue
+            fields = line.split()
+            if len(fields) < 2 or fields[0].startswith("host_"):
+                continue
+            stats[(dump, fields[0])] = fields[1]
+    return stats
+
+
+def run(args, mode):
+    outdir = os.path.join(args.outdir, mode)
+    cmd = (
+        [args.gem5, "--outdir=" + outdir]
+        + args.config
+        + ["--ruby-partition-mode=" + mode]
+    )
+    print(" ".join(cmd), flush=True)
+    with open(os.path.join(args.outdir, mode + ".log"), "w") as log:
+        ret = subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT)
+    if ret != 0:
+        sys.exit("%s run failed with code %d" % (mode, ret))
+    return read_stats(os.path.join(outdir, "stats.txt"))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare serial and parallel partitioned Ruby runs"
+    )
+    parser.add_argument("--gem5", required=True, help="gem5 binary")
+    parser.add_argument("--outdir", default="ruby_partition_check")
+    parser.add_argument(
+        "--max-diffs",
+        type=int,
+        default=20,
+        help="Number of differing statistics to print",
+    )
+    parser.add_argument("config", nargs=argparse.REMAINDER)
+    args = parser.parse_args()
+    if args.config and args.config[0] == "--":
+        args.config = args.config[1:]
+    if not args.config:
+        parser.error("missing configuration script and its options")
+
+    os.makedirs(args.outdir, exist_ok=True)
+    serial, parallel = [run(args, mode) for mode in MODES]
+
+    diffs = sorted(
+        key
+        for key in serial.keys() | parallel.keys()
+        if serial.get(key) != parallel.get(key)
+    )
+    if not diffs:
+        print("OK: %d statistics match" % len(serial))
+        return
+
+    for dump, name in diffs[: args.max_diffs]:
+        print(
+            "dump %d %s: serial %s parallel %s"
+            % (
+                dump,
+                name,
+                serial.get((dump, name), "-"),
+                parallel.get((dump, name), "-"),
+            )
+        )
+    sys.exit("FAIL: %d of %d statistics differ" % (len(diffs), len(serial)))
+
+
+if __name__ == "__main__":
+    main()